@@ -0,0 +1,25 @@
+#version 330 core
+out vec4 out_colour;
+
+in vec2 v_tex;
+
+uniform sampler2D tex;
+
+// fade the whole chunk out once nothing has been stamped in to it for a while
+uniform float decal_time;
+uniform float last_stamp_time;
+uniform float hold_time;
+uniform float fade_time;
+
+void
+main()
+{
+  vec4 c = texture(tex, v_tex);
+
+  // the chunk is premultiplied by its alpha, and blended as such
+
+  float age = decal_time - last_stamp_time - hold_time;
+  float fade = 1.0 - clamp(age / max(fade_time, 0.0001), 0.0, 1.0);
+
+  out_colour = c * fade;
+}
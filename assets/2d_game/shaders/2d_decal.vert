@@ -0,0 +1,21 @@
+#version 330 core
+
+layout(location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+
+out vec2 v_tex;
+
+// shared by every program, uploaded once per frame
+layout(std140) uniform FrameData
+{
+  mat4 projection;
+  float time;
+};
+
+uniform mat4 model;
+
+void
+main()
+{
+  v_tex = vertex.zw;
+  gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
+}
@@ -9,9 +9,15 @@ out vec2 v_tex;
 out vec4 v_colour;
 out vec2 v_sprite_pos;
 
-uniform mat4 projection;
+// shared by every program, uploaded once per frame
+layout(std140) uniform FrameData
+{
+  mat4 projection;
+  float time;
+};
+
+uniform mat4 view; // identity for camera-space sprites, camera transform for static world-space chunks
 uniform bool shake;
-uniform float time;
 const float strength = 0.005;
 
 void
@@ -21,7 +27,7 @@ main()
   v_colour = colour;
   v_sprite_pos = sprite_pos;
 
-  gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
+  gl_Position = projection * view * model * vec4(vertex.xy, 0.0, 1.0);
 
   if (shake) {
     gl_Position.x += cos(time * 10) * strength;
@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "engine/grid.hpp"
+#include "engine/maths_core.hpp"
+using namespace fightingengine;
+
+static void
+BM_GridGetUniqueCells(benchmark::State& state)
+{
+  // sprite sized objects on a 100px physics grid, like game_2d
+  const int grid_size = 100;
+  const glm::vec2 size = glm::vec2(static_cast<float>(state.range(0)));
+
+  RandomState rnd;
+  std::vector<glm::vec2> positions(1024);
+  for (auto& pos : positions)
+    pos = glm::vec2(rand_det_s(rnd.rng, 0.0f, 4000.0f), rand_det_s(rnd.rng, 0.0f, 4000.0f));
+
+  std::vector<glm::ivec2> results;
+  size_t i = 0;
+  for (auto _ : state) {
+    game2d::grid::get_unique_cells(positions[i++ & 1023], size, grid_size, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GridGetUniqueCells)->Arg(16)->Arg(64)->Arg(250);
+
+static void
+BM_EncodeCantorPairing(benchmark::State& state)
+{
+  int x = 0;
+  for (auto _ : state) {
+    uint64_t p = encode_cantor_pairing_function(x, x + 7);
+    benchmark::DoNotOptimize(p);
+    x = (x + 1) & 0xFFFF;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeCantorPairing);
+
+static void
+BM_RandDet(benchmark::State& state)
+{
+  RandomState rnd;
+  for (auto _ : state) {
+    float f = rand_det_s(rnd.rng, 0.0f, 1.0f);
+    benchmark::DoNotOptimize(f);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RandDet);
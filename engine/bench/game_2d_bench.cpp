@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "engine/maths_core.hpp"
+#include "engine/opengl/render_backend.hpp"
+#include "engine/opengl/render_command.hpp"
+#include "engine/opengl/shader.hpp"
+using namespace fightingengine;
+
+#include "2d_game_object.hpp"
+#include "2d_physics.hpp"
+#include "opengl/sprite_renderer.hpp"
+#include "spritemap.hpp"
+using namespace game2d;
+
+// enemies and bullets scattered so density stays roughly constant as the count grows
+static std::vector<GameObject2D>
+make_entities(int count, uint32_t seed)
+{
+  RandomState rnd;
+  rnd.rng.seed(seed);
+  const float world_size = 40.0f * sqrt(static_cast<float>(count));
+
+  std::vector<GameObject2D> entities;
+  entities.reserve(count);
+  for (int i = 0; i < count; i++) {
+    GameObject2D obj = gameobject::create_generic(sprite::type::PERSON_2, 0, glm::vec4(1.0f));
+    obj.collision_layer = i % 4 == 0 ? CollisionLayer::Bullet : CollisionLayer::Enemy;
+    obj.pos = glm::vec2(rand_det_s(rnd.rng, 0.0f, world_size), rand_det_s(rnd.rng, 0.0f, world_size));
+    obj.angle_radians = rand_det_s(rnd.rng, 0.0f, PI);
+    entities.push_back(obj);
+  }
+  return entities;
+}
+
+static void
+BM_Broadphase(benchmark::State& state)
+{
+  std::vector<GameObject2D> entities = make_entities(static_cast<int>(state.range(0)), 1);
+
+  for (auto _ : state) {
+    std::vector<std::reference_wrapper<GameObject2D>> collidable(entities.begin(), entities.end());
+    std::map<uint64_t, Collision2D> collisions;
+    generate_filtered_broadphase_collisions(collidable, collisions);
+    benchmark::DoNotOptimize(collisions.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Broadphase)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void
+BM_SpritemapLookup(benchmark::State& state)
+{
+  const int sprite_count = static_cast<int>(sprite::type::ROCKET_2) + 1;
+  int i = 0;
+  for (auto _ : state) {
+    auto offset = sprite::spritemap::get_sprite_offset(static_cast<sprite::type>(i));
+    benchmark::DoNotOptimize(offset);
+    i = (i + 1) % sprite_count;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpritemapLookup);
+
+static void
+BM_EraseFlaggedEntities(benchmark::State& state)
+{
+  // one in ten dies each frame
+  std::vector<GameObject2D> prototype = make_entities(static_cast<int>(state.range(0)), 2);
+  for (size_t i = 0; i < prototype.size(); i += 10)
+    prototype[i].flag_for_delete = true;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<GameObject2D> entities = prototype;
+    state.ResumeTiming();
+
+    gameobject::erase_entities_that_are_flagged_for_delete(entities, 0.016f);
+    benchmark::DoNotOptimize(entities.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EraseFlaggedEntities)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void
+BM_SpriteVertexWrite(benchmark::State& state)
+{
+  // Shader reads from assets/, so run from a directory that has it
+  if (!std::filesystem::exists("assets/2d_game/shaders/2d_instanced.vert")) {
+    state.SkipWithError("assets/ not found in the working directory");
+    return;
+  }
+
+  NullRenderBackend backend;
+  RenderCommand::set_backend(&backend);
+  sprite_renderer::init();
+  Shader shader("2d_game/shaders/2d_instanced.vert", "2d_game/shaders/2d_instanced.frag");
+
+  const glm::ivec2 screen_wh = { 1280, 720 };
+  GameObject2D camera = gameobject::create_camera();
+  std::vector<GameObject2D> entities = make_entities(static_cast<int>(state.range(0)), 3);
+  for (auto& obj : entities)
+    obj.pos = glm::mod(obj.pos, glm::vec2(screen_wh)); // all on screen
+
+  for (auto _ : state) {
+    sprite_renderer::begin_batch();
+    for (const auto& obj : entities)
+      sprite_renderer::draw_instanced_sprite(camera, screen_wh, shader, obj, obj.render_size);
+    sprite_renderer::end_batch();
+    sprite_renderer::flush(shader);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+
+  sprite_renderer::shutdown();
+  RenderCommand::set_backend(nullptr);
+}
+BENCHMARK(BM_SpriteVertexWrite)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
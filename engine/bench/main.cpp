@@ -0,0 +1,34 @@
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// Defaults to json on stdout, so results can be diffed between revisions, e.g.
+//   fightingengine_bench --benchmark_out=before.json
+// any --benchmark_format / --benchmark_out_format passed in wins.
+
+int
+main(int argc, char** argv)
+{
+  bool has_format = false;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--benchmark_format", 18) == 0 || strncmp(argv[i], "--benchmark_out_format", 22) == 0)
+      has_format = true;
+  }
+
+  std::vector<char*> args(argv, argv + argc);
+  char format_json[] = "--benchmark_format=json";
+  char out_format_json[] = "--benchmark_out_format=json";
+  if (!has_format) {
+    args.push_back(format_json);
+    args.push_back(out_format_json);
+  }
+  int args_count = static_cast<int>(args.size());
+
+  benchmark::Initialize(&args_count, args.data());
+  if (benchmark::ReportUnrecognizedArguments(args_count, args.data()))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "engine/maths_core.hpp"
+using namespace fightingengine;
+
+#include "2d_game.hpp"
+#include "2d_game_object.hpp"
+#include "2d_rollback.hpp"
+#include "2d_state_hash.hpp"
+using namespace game2d;
+
+static void
+fill_keys(int frame, KeysAndState& keys)
+{
+  const float t = frame / 60.0f;
+  keys = KeysAndState();
+  keys.l_analogue_x = cos(t);
+  keys.l_analogue_y = sin(t);
+  keys.angle_around_player = t * 2.0f;
+  keys.shoot_pressed = true;
+}
+
+// a game with count enemies spread out around the player, some way in to a round.
+// counts stay small, update_physics() looks up every collision's entities linearly
+static void
+make_game(GameState& state, int count)
+{
+  game::init(state, { 1280, 720 }, 1);
+  state.entities_player[0].invulnerable = true;
+  state.entities_player[0].equipped_weapon = Weapons::PISTOL;
+  state.player_keys[0].use_keyboard = false;
+
+  const float radius = 40.0f * sqrt(static_cast<float>(count));
+  for (int i = 0; i < count; i++) {
+    GameObject2D enemy = gameobject::create_enemy(sprite_enemy_core, tex_unit_kenny_nl, enemy_colour, state.rnd);
+    enemy.pos = glm::vec2(rand_det_s(state.rnd.rng, -radius, radius), rand_det_s(state.rnd.rng, -radius, radius));
+    state.entities_enemies.push_back(enemy);
+  }
+  for (int frame = 0; frame < 60; frame++) {
+    fill_keys(frame, state.player_keys[0]);
+    rollback::step(state, 1.0f / 60.0f);
+  }
+}
+
+static void
+BM_RollbackSave(benchmark::State& state)
+{
+  GameState game;
+  make_game(game, static_cast<int>(state.range(0)));
+
+  std::vector<uint8_t> bytes;
+  for (auto _ : state) {
+    rollback::save(game, bytes);
+    benchmark::DoNotOptimize(bytes.data());
+  }
+  state.counters["frame_bytes"] = static_cast<double>(bytes.size());
+}
+BENCHMARK(BM_RollbackSave)->Arg(100)->Arg(1000)->Arg(2000)->Unit(benchmark::kMicrosecond);
+
+static void
+BM_RollbackLoad(benchmark::State& state)
+{
+  GameState game;
+  make_game(game, static_cast<int>(state.range(0)));
+  std::vector<uint8_t> bytes;
+  rollback::save(game, bytes);
+
+  for (auto _ : state) {
+    bool ok = rollback::load(bytes, game);
+    benchmark::DoNotOptimize(ok);
+  }
+  state.counters["frame_bytes"] = static_cast<double>(bytes.size());
+}
+BENCHMARK(BM_RollbackLoad)->Arg(100)->Arg(1000)->Arg(2000)->Unit(benchmark::kMicrosecond);
+
+// the per frame checksum peers and replays compare, against a frame's save and step
+static void
+BM_StateHash(benchmark::State& state)
+{
+  GameState game;
+  make_game(game, static_cast<int>(state.range(0)));
+
+  uint64_t hash = 0;
+  for (auto _ : state) {
+    hash = state_hash::hash(game);
+    benchmark::DoNotOptimize(hash);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StateHash)->Arg(100)->Arg(1000)->Arg(2000)->Unit(benchmark::kMicrosecond);
+
+// one frame without rollback, to compare the others against
+static void
+BM_RollbackStepOnly(benchmark::State& state)
+{
+  GameState game;
+  make_game(game, static_cast<int>(state.range(0)));
+  std::vector<uint8_t> bytes;
+  rollback::save(game, bytes);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    rollback::load(bytes, game);
+    state.ResumeTiming();
+    rollback::step(game, 1.0f / 60.0f);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RollbackStepOnly)->Arg(100)->Arg(1000)->Arg(2000)->Unit(benchmark::kMicrosecond);
+
+// a late input: go back range(1) frames and resimulate them all, as a render frame would
+static void
+BM_RollbackResimulate(benchmark::State& state)
+{
+  GameState game;
+  make_game(game, static_cast<int>(state.range(0)));
+  const int frames = static_cast<int>(state.range(1));
+
+  RollbackSession session(16);
+  session.reset(0);
+  for (int frame = 0; frame < frames; frame++) {
+    fill_keys(frame, game.player_keys[0]);
+    session.advance(game, 1.0f / 60.0f);
+  }
+
+  for (auto _ : state) {
+    bool ok = session.rollback(game, session.get_frame() - frames, 1.0f / 60.0f);
+    benchmark::DoNotOptimize(ok);
+  }
+  state.counters["frame_bytes"] = static_cast<double>(session.get_stats().frame_bytes);
+  state.SetItemsProcessed(state.iterations() * frames);
+}
+BENCHMARK(BM_RollbackResimulate)
+  ->Args({ 100, 8 })
+  ->Args({ 1000, 8 })
+  ->Args({ 2000, 8 })
+  ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,160 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "engine/maths_core.hpp"
+#include "engine/networking/bitstream.hpp"
+#include "engine/networking/interest.hpp"
+#include "engine/networking/snapshot.hpp"
+using namespace fightingengine;
+
+// count entities spread over the map, and the next tick with a tenth of them moved a few pixels
+struct SnapshotPair
+{
+  Snapshot baseline;
+  Snapshot current;
+};
+
+static SnapshotPair
+make_snapshots(const SnapshotSchema& schema, int count)
+{
+  RandomState rnd;
+  SnapshotPair pair;
+  pair.baseline.tick = 1;
+  for (int i = 0; i < count; i++) {
+    NetEntityState e;
+    e.id = 1 + i * 2;
+    e.type = static_cast<uint8_t>(i % 6);
+    e.flags = 1;
+    e.health = 3;
+    e.pos_x = snapshot::quantise_position(schema, rand_det_s(rnd.rng, -4000.0f, 4000.0f));
+    e.pos_y = snapshot::quantise_position(schema, rand_det_s(rnd.rng, -4000.0f, 4000.0f));
+    e.angle = snapshot::quantise_angle(schema, rand_det_s(rnd.rng, 0.0f, 2.0f * PI));
+    e.vel_x = snapshot::quantise_velocity(schema, rand_det_s(rnd.rng, -200.0f, 200.0f));
+    e.vel_y = snapshot::quantise_velocity(schema, rand_det_s(rnd.rng, -200.0f, 200.0f));
+    pair.baseline.entities.push_back(e);
+  }
+
+  pair.current = pair.baseline;
+  pair.current.tick = 2;
+  for (size_t i = 0; i < pair.current.entities.size(); i += 10) {
+    NetEntityState& e = pair.current.entities[i];
+    e.pos_x += snapshot::quantise_position(schema, rand_det_s(rnd.rng, -4.0f, 4.0f));
+    e.pos_y += snapshot::quantise_position(schema, rand_det_s(rnd.rng, -4.0f, 4.0f));
+    e.angle = snapshot::quantise_angle(schema, rand_det_s(rnd.rng, 0.0f, 2.0f * PI));
+  }
+  return pair;
+}
+
+static void
+BM_SnapshotEncodeFull(benchmark::State& state)
+{
+  SnapshotSchema schema;
+  SnapshotPair pair = make_snapshots(schema, static_cast<int>(state.range(0)));
+
+  BitWriter writer;
+  for (auto _ : state) {
+    writer.reset();
+    snapshot::encode(schema, pair.current, nullptr, writer);
+    benchmark::DoNotOptimize(writer.get_bytes().data());
+  }
+  state.counters["bytes"] = static_cast<double>(writer.get_bytes_written());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SnapshotEncodeFull)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void
+BM_SnapshotEncodeDelta(benchmark::State& state)
+{
+  SnapshotSchema schema;
+  SnapshotPair pair = make_snapshots(schema, static_cast<int>(state.range(0)));
+
+  BitWriter writer;
+  for (auto _ : state) {
+    writer.reset();
+    snapshot::encode(schema, pair.current, &pair.baseline, writer);
+    benchmark::DoNotOptimize(writer.get_bytes().data());
+  }
+  state.counters["bytes"] = static_cast<double>(writer.get_bytes_written());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SnapshotEncodeDelta)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void
+BM_SnapshotDecodeFull(benchmark::State& state)
+{
+  SnapshotSchema schema;
+  SnapshotPair pair = make_snapshots(schema, static_cast<int>(state.range(0)));
+  BitWriter writer;
+  snapshot::encode(schema, pair.current, nullptr, writer);
+
+  SnapshotHistory received;
+  Snapshot decoded;
+  for (auto _ : state) {
+    BitReader reader(writer.get_bytes().data(), writer.get_bytes().size());
+    bool ok = snapshot::decode(schema, reader, received, decoded);
+    benchmark::DoNotOptimize(ok);
+  }
+  state.counters["bytes"] = static_cast<double>(writer.get_bytes_written());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SnapshotDecodeFull)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void
+BM_SnapshotDecodeDelta(benchmark::State& state)
+{
+  SnapshotSchema schema;
+  SnapshotPair pair = make_snapshots(schema, static_cast<int>(state.range(0)));
+  BitWriter writer;
+  snapshot::encode(schema, pair.current, &pair.baseline, writer);
+
+  SnapshotHistory received;
+  received.add(pair.baseline);
+  Snapshot decoded;
+  for (auto _ : state) {
+    BitReader reader(writer.get_bytes().data(), writer.get_bytes().size());
+    bool ok = snapshot::decode(schema, reader, received, decoded);
+    benchmark::DoNotOptimize(ok);
+  }
+  state.counters["bytes"] = static_cast<double>(writer.get_bytes_written());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SnapshotDecodeDelta)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// a world of range(0) entities, range(1) clients looking at different parts of it.
+// per client cost should follow what's near the client, not the size of the world
+static void
+BM_InterestWriteSnapshots(benchmark::State& state)
+{
+  SnapshotSchema schema;
+  InterestConfig config;
+  SnapshotPair pair = make_snapshots(schema, static_cast<int>(state.range(0)));
+  InterestGrid grid(config.cell_size);
+
+  RandomState rnd;
+  std::vector<ClientInterest> clients(state.range(1));
+  for (ClientInterest& client : clients)
+    client.set_camera({ rand_det_s(rnd.rng, -4000.0f, 4000.0f), rand_det_s(rnd.rng, -4000.0f, 4000.0f) });
+
+  BitWriter writer;
+  uint64_t bytes = 0;
+  uint32_t tick = 1;
+  for (auto _ : state) {
+    Snapshot& world = (tick & 1) ? pair.baseline : pair.current;
+    world.tick = tick++;
+    grid.update(world, schema);
+    for (ClientInterest& client : clients) {
+      writer.reset();
+      client.write_snapshot(grid, world, schema, config, writer);
+      client.on_ack(world.tick); // as if every snapshot arrived
+      bytes += writer.get_bytes_written();
+    }
+  }
+  state.counters["bytes_per_client"] = static_cast<double>(bytes) / (state.iterations() * clients.size());
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_InterestWriteSnapshots)
+  ->Args({ 1000, 8 })
+  ->Args({ 10000, 8 })
+  ->Args({ 100000, 8 })
+  ->Unit(benchmark::kMicrosecond);
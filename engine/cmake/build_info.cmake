@@ -6,6 +6,16 @@ set(CPACK_PROJECT_VERSION ${PROJECT_VERSION})
 message("engine_info: ${CMAKE_SYSTEM_NAME}")
 message("engine_info: ${CMAKE_BUILD_TYPE}")
 
+#Opt in: count heap allocations per frame and per profiler zone
+option(FIGHTINGENGINE_TRACK_ALLOCATIONS "Replace global new/delete to count allocations" OFF)
+if(FIGHTINGENGINE_TRACK_ALLOCATIONS)
+    add_compile_definitions(FIGHTINGENGINE_TRACK_ALLOCATIONS)
+endif()
+
+#Log messages below this level are compiled out. 0 trace, 1 debug, 2 info, 3 warn, 4 error, 5 off
+set(FIGHTINGENGINE_LOG_LEVEL "0" CACHE STRING "Compile-time minimum log level")
+add_compile_definitions(FIGHTINGENGINE_LOG_LEVEL=${FIGHTINGENGINE_LOG_LEVEL})
+
 #VCPKG packages
 set (ENGINE_PACKAGES_CONFIG
     SDL2 glm assimp protobuf OpenAL SndFile GameNetworkingSockets
@@ -13,8 +13,14 @@
 #include <backends/imgui_impl_sdl.h>
 #include <imgui.h>
 
+// engine headers
+#include "engine/tools/cvars.hpp"
+#include "engine/tools/logger.hpp"
+
 namespace fightingengine {
 
+static CVar<float> cvar_fps_limit("app.fps_limit", 60.0f, "frame rate when limit_fps is on", 10.0f, 1000.0f);
+
 Application::Application(const std::string& name, int width, int height, bool vsync)
 {
   // const std::string kBuildStr(kGitSHA1Hash, 8);
@@ -65,7 +71,7 @@ Application::frame_end(Uint64& frame_start_time)
   float elapsed_ms = (frame_end_time - frame_start_time) / static_cast<float>(SDL_GetPerformanceFrequency()) * 1000.0f;
 
   if (limit_fps) {
-    auto delay = floor(1000.0f / fps_if_limited - elapsed_ms);
+    auto delay = floor(1000.0f / cvar_fps_limit.get() - elapsed_ms);
     if (delay > 0.0f)
       SDL_Delay(static_cast<Uint32>(delay));
   }
@@ -135,14 +141,14 @@ Application::frame_begin()
 void
 Application::on_window_close()
 {
-  printf("application close event recieved");
+  FE_LOG_INFO("application close event recieved");
   running = false;
 }
 
 void
 Application::on_window_resize(int w, int h)
 {
-  printf("application resize event recieved: %i %i ", w, h);
+  FE_LOG_INFO("application resize event recieved: {} {}", w, h);
   window_was_resized = true;
 
   if (w == 0 || h == 0) {
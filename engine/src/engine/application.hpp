@@ -29,8 +29,7 @@ public:
 
   float seconds_since_launch = 0.0f;
 
-  float fps_if_limited = 60.0f;
-  bool limit_fps = false;
+  bool limit_fps = false; // to the app.fps_limit cvar
 
   bool window_was_resized = false;
 
@@ -0,0 +1,134 @@
+// header
+#include "engine/networking/bitstream.hpp"
+
+// c system headers
+#include <cassert>
+
+namespace fightingengine {
+
+static uint32_t
+zigzag_encode(int32_t value)
+{
+  return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t
+zigzag_decode(uint32_t value)
+{
+  return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+static const int varuint_bits[] = { 4, 8, 16, 32 };
+
+//
+// BitWriter
+//
+
+void
+BitWriter::write_bits(uint32_t value, int bits)
+{
+  assert(bits > 0 && bits <= 32);
+  assert(bits == 32 || value < (1ull << bits));
+
+  scratch |= static_cast<uint64_t>(value) << scratch_bits;
+  scratch_bits += bits;
+  bits_written += bits;
+  while (scratch_bits >= 8) {
+    bytes.push_back(static_cast<uint8_t>(scratch & 0xFF));
+    scratch >>= 8;
+    scratch_bits -= 8;
+  }
+}
+
+void
+BitWriter::write_signed(int32_t value, int bits)
+{
+  write_bits(zigzag_encode(value), bits);
+}
+
+static uint32_t
+get_varuint_size_class(uint32_t value)
+{
+  uint32_t size_class = 0;
+  while (varuint_bits[size_class] != 32 && value >= (1u << varuint_bits[size_class]))
+    size_class += 1;
+  return size_class;
+}
+
+void
+BitWriter::write_varuint(uint32_t value)
+{
+  const uint32_t size_class = get_varuint_size_class(value);
+  write_bits(size_class, 2);
+  write_bits(value, varuint_bits[size_class]);
+}
+
+int
+BitWriter::get_varuint_bits(uint32_t value)
+{
+  return 2 + varuint_bits[get_varuint_size_class(value)];
+}
+
+void
+BitWriter::flush()
+{
+  if (scratch_bits > 0) {
+    bytes.push_back(static_cast<uint8_t>(scratch & 0xFF));
+    scratch = 0;
+    scratch_bits = 0;
+  }
+}
+
+void
+BitWriter::reset()
+{
+  bytes.clear();
+  scratch = 0;
+  scratch_bits = 0;
+  bits_written = 0;
+}
+
+//
+// BitReader
+//
+
+BitReader::BitReader(const uint8_t* data, size_t size)
+  : data(data)
+  , size(size)
+{}
+
+uint32_t
+BitReader::read_bits(int bits)
+{
+  assert(bits > 0 && bits <= 32);
+  if (bits_read + bits > size * 8) {
+    overflowed = true;
+    bits_read = size * 8;
+    return 0;
+  }
+
+  while (scratch_bits < bits) {
+    scratch |= static_cast<uint64_t>(data[next_byte++]) << scratch_bits;
+    scratch_bits += 8;
+  }
+  const uint32_t value = static_cast<uint32_t>(scratch & ((1ull << bits) - 1));
+  scratch >>= bits;
+  scratch_bits -= bits;
+  bits_read += bits;
+  return value;
+}
+
+int32_t
+BitReader::read_signed(int bits)
+{
+  return zigzag_decode(read_bits(bits));
+}
+
+uint32_t
+BitReader::read_varuint()
+{
+  const uint32_t size_class = read_bits(2);
+  return read_bits(varuint_bits[size_class]);
+}
+
+} // namespace fightingengine
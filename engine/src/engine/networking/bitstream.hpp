@@ -0,0 +1,67 @@
+#pragma once
+
+// c system headers
+#include <cstddef>
+#include <cstdint>
+
+// c++ standard library headers
+#include <vector>
+
+namespace fightingengine {
+
+// Packs values in to the fewest bits they need, least significant bit first.
+// Call flush() before reading get_bytes().
+class BitWriter
+{
+public:
+  // bits is 1..32, value must fit in bits
+  void write_bits(uint32_t value, int bits);
+  void write_bool(bool value) { write_bits(value ? 1 : 0, 1); }
+  // zigzag encoded, so small negative numbers stay small. value must fit in bits (with its sign)
+  void write_signed(int32_t value, int bits);
+  // 2 bit size class then 4, 8, 16 or 32 bits, for counts and id deltas that are usually small
+  void write_varuint(uint32_t value);
+  // what write_varuint(value) writes
+  [[nodiscard]] static int get_varuint_bits(uint32_t value);
+
+  void flush();
+  void reset();
+
+  [[nodiscard]] size_t get_bits_written() const { return bits_written; }
+  [[nodiscard]] size_t get_bytes_written() const { return (bits_written + 7) / 8; }
+  [[nodiscard]] const std::vector<uint8_t>& get_bytes() const { return bytes; }
+
+private:
+  std::vector<uint8_t> bytes;
+  uint64_t scratch = 0;
+  int scratch_bits = 0;
+  size_t bits_written = 0;
+};
+
+// Reads what a BitWriter wrote. Reading past the end returns zeros and sets is_overflowed(),
+// so a decoder can read a whole message and check once at the end.
+class BitReader
+{
+public:
+  BitReader(const uint8_t* data, size_t size);
+
+  [[nodiscard]] uint32_t read_bits(int bits);
+  [[nodiscard]] bool read_bool() { return read_bits(1) != 0; }
+  [[nodiscard]] int32_t read_signed(int bits);
+  [[nodiscard]] uint32_t read_varuint();
+
+  [[nodiscard]] bool is_overflowed() const { return overflowed; }
+  [[nodiscard]] size_t get_bits_read() const { return bits_read; }
+  [[nodiscard]] size_t get_bits_remaining() const { return size * 8 - bits_read; }
+
+private:
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  uint64_t scratch = 0;
+  int scratch_bits = 0;
+  size_t next_byte = 0;
+  size_t bits_read = 0;
+  bool overflowed = false;
+};
+
+} // namespace fightingengine
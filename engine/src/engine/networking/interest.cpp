@@ -0,0 +1,210 @@
+// header
+#include "engine/networking/interest.hpp"
+
+// c++ standard library headers
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+// engine headers
+#include "engine/grid.hpp"
+
+namespace fightingengine {
+
+//
+// InterestGrid
+//
+
+InterestGrid::InterestGrid(int cell_size)
+  : cell_size(cell_size > 0 ? cell_size : 1)
+{}
+
+uint64_t
+InterestGrid::get_key(glm::ivec2 cell)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(cell.x)) << 32) | static_cast<uint32_t>(cell.y);
+}
+
+glm::ivec2
+InterestGrid::get_cell(glm::vec2 world_pos) const
+{
+  return game2d::grid::convert_world_space_to_grid_space(world_pos, cell_size);
+}
+
+const std::vector<uint32_t>*
+InterestGrid::get_entities(glm::ivec2 cell) const
+{
+  auto it = cells.find(get_key(cell));
+  if (it == cells.end() || it->second.empty())
+    return nullptr;
+  return &it->second;
+}
+
+void
+InterestGrid::add_to_cell(uint32_t id, Tracked& t)
+{
+  std::vector<uint32_t>& ids = cells[get_key(t.cell)];
+  t.index_in_cell = static_cast<uint32_t>(ids.size());
+  ids.push_back(id);
+}
+
+void
+InterestGrid::remove_from_cell(const Tracked& t)
+{
+  // swap with the last, and fix up the index of the one that moved
+  std::vector<uint32_t>& ids = cells[get_key(t.cell)];
+  const uint32_t moved_id = ids.back();
+  ids[t.index_in_cell] = moved_id;
+  ids.pop_back();
+  if (t.index_in_cell < ids.size())
+    tracked[moved_id].index_in_cell = t.index_in_cell;
+}
+
+void
+InterestGrid::update(const Snapshot& world, const SnapshotSchema& schema)
+{
+  events.clear();
+  generation += 1;
+
+  for (const NetEntityState& e : world.entities) {
+    const glm::vec2 pos(snapshot::dequantise_position(schema, e.pos_x),
+                        snapshot::dequantise_position(schema, e.pos_y));
+    const glm::ivec2 cell = get_cell(pos);
+
+    auto [it, inserted] = tracked.try_emplace(e.id);
+    Tracked& t = it->second;
+    t.generation = generation;
+    if (inserted) {
+      t.cell = cell;
+      add_to_cell(e.id, t);
+      events.push_back({ CellEvent::Type::Enter, e.id, cell, cell });
+    } else if (t.cell != cell) {
+      const glm::ivec2 from = t.cell;
+      remove_from_cell(t);
+      t.cell = cell;
+      add_to_cell(e.id, t);
+      events.push_back({ CellEvent::Type::Move, e.id, from, cell });
+    }
+  }
+
+  // anything not seen this update has left the world
+  for (auto it = tracked.begin(); it != tracked.end();) {
+    if (it->second.generation != generation) {
+      events.push_back({ CellEvent::Type::Leave, it->first, it->second.cell, it->second.cell });
+      remove_from_cell(it->second);
+      it = tracked.erase(it);
+    } else
+      ++it;
+  }
+}
+
+//
+// ClientInterest
+//
+
+// tick, baseline, and the two counts at their widest
+static constexpr int snapshot_header_bits = 32 + 1 + 32 + 2 * 34;
+
+void
+ClientInterest::write_snapshot(const InterestGrid& grid,
+                               const Snapshot& world,
+                               const SnapshotSchema& schema,
+                               const InterestConfig& config,
+                               BitWriter& out)
+{
+  const Snapshot* baseline = client.has_ack ? sent.find(client.acked_tick) : nullptr;
+
+  stats = ClientInterestStats();
+  candidates.clear();
+  next_priority.clear();
+  relevant_ids.clear();
+  sent_ids.clear();
+  last.tick = world.tick;
+  last.entities.clear();
+
+  // everything in the client's cells is relevant. unchanged entities cost nothing, so always go in
+  const glm::ivec2 centre = grid.get_cell(camera);
+  const int r = config.view_radius_cells;
+  for (int y = centre.y - r; y <= centre.y + r; y++) {
+    for (int x = centre.x - r; x <= centre.x + r; x++) {
+      const std::vector<uint32_t>* ids = grid.get_entities({ x, y });
+      if (ids == nullptr)
+        continue;
+      const int distance = std::max(std::abs(x - centre.x), std::abs(y - centre.y));
+
+      for (uint32_t id : *ids) {
+        const NetEntityState* e = snapshot::find_entity(world, id);
+        if (e == nullptr)
+          continue;
+        stats.relevant += 1;
+        relevant_ids.push_back(id);
+
+        const NetEntityState* base = baseline ? snapshot::find_entity(*baseline, id) : nullptr;
+        const int bits = snapshot::get_entity_bits(schema, *e, base);
+        if (bits == 0) {
+          last.entities.push_back(*e);
+          continue;
+        }
+
+        auto p = priority.find(id);
+        float waited = p != priority.end() ? p->second : 0.0f;
+        waited += config.type_priority[e->type & 15] / static_cast<float>(1 + distance);
+        candidates.push_back({ e, base, waited, bits });
+      }
+    }
+  }
+
+  // most important first, until the budget runs out
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+    return a.priority > b.priority;
+  });
+  int budget = config.bytes_per_tick * 8 - snapshot_header_bits;
+
+  // whatever the client has that's out of view now is removed, and that's spent first.
+  // relevant entities it has always stay, with their latest or their old state
+  if (baseline) {
+    std::sort(relevant_ids.begin(), relevant_ids.end());
+    uint32_t prev_id = 0;
+    size_t r = 0;
+    for (const NetEntityState& e : baseline->entities) {
+      while (r < relevant_ids.size() && relevant_ids[r] < e.id)
+        r++;
+      if (r < relevant_ids.size() && relevant_ids[r] == e.id)
+        continue;
+      const int bits = snapshot::get_id_bits(e.id, prev_id);
+      prev_id = e.id;
+      budget -= bits;
+      stats.bits += bits;
+    }
+  }
+
+  for (const Candidate& c : candidates) {
+    // ids go as deltas in id order, so it's the gap from the nearest lower id already going.
+    // one that goes in later between them can only shorten the gap after it, so this never undercounts
+    auto next = sent_ids.lower_bound(c.e->id);
+    const uint32_t prev_id = next == sent_ids.begin() ? 0 : *std::prev(next);
+    const int bits = c.bits + snapshot::get_id_bits(c.e->id, prev_id) + (baseline ? 1 : 0);
+    if (bits <= budget) {
+      budget -= bits;
+      stats.bits += bits;
+      stats.updated += 1;
+      sent_ids.insert(next, c.e->id);
+      last.entities.push_back(*c.e);
+      continue;
+    }
+    // over budget: it keeps waiting. if the client already has it, keep sending its old state
+    // (which costs nothing) so it isn't removed
+    stats.deferred += 1;
+    next_priority[c.e->id] = c.priority;
+    if (c.base)
+      last.entities.push_back(*c.base);
+  }
+  priority.swap(next_priority);
+
+  snapshot::sort_by_id(last);
+  snapshot::encode(schema, last, baseline, out);
+  stats.bits += snapshot_header_bits;
+  sent.add(last); // after encoding, it can replace the baseline's slot
+}
+
+} // namespace fightingengine
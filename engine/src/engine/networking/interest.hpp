@@ -0,0 +1,134 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+// c++ standard library headers
+#include <array>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// other lib headers
+#include <glm/glm.hpp>
+
+// engine headers
+#include "engine/networking/bitstream.hpp"
+#include "engine/networking/snapshot.hpp"
+
+namespace fightingengine {
+
+struct InterestConfig
+{
+  int cell_size = 400;        // pixels, cells are grid::convert_world_space_to_grid_space cells
+  int view_radius_cells = 2;  // a client sees the cells this far (each way) from its camera's cell
+  int bytes_per_tick = 1200;  // snapshot budget per client, about one packet
+  std::array<float, 16> type_priority = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+                                          1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+};
+
+struct CellEvent
+{
+  enum class Type : uint8_t
+  {
+    Enter, // new entity
+    Move,  // crossed from one cell in to another
+    Leave, // gone from the world
+  };
+  Type type = Type::Enter;
+  uint32_t id = 0;
+  glm::ivec2 from{ 0, 0 };
+  glm::ivec2 to{ 0, 0 };
+};
+
+// Which replicated entities are in which cell. update() only touches an entity's cell lists
+// when it crosses in to another cell, and records that as a CellEvent.
+class InterestGrid
+{
+public:
+  explicit InterestGrid(int cell_size = 400);
+
+  // world must be sorted by id
+  void update(const Snapshot& world, const SnapshotSchema& schema);
+
+  [[nodiscard]] int get_cell_size() const { return cell_size; }
+  [[nodiscard]] glm::ivec2 get_cell(glm::vec2 world_pos) const;
+  // the ids of the entities in a cell, null if it's empty
+  [[nodiscard]] const std::vector<uint32_t>* get_entities(glm::ivec2 cell) const;
+  // since the last update()
+  [[nodiscard]] const std::vector<CellEvent>& get_events() const { return events; }
+  [[nodiscard]] size_t get_entity_count() const { return tracked.size(); }
+
+private:
+  struct Tracked
+  {
+    glm::ivec2 cell{ 0, 0 };
+    uint32_t index_in_cell = 0;
+    uint32_t generation = 0;
+  };
+
+  static uint64_t get_key(glm::ivec2 cell);
+  void add_to_cell(uint32_t id, Tracked& t);
+  void remove_from_cell(const Tracked& t);
+
+  int cell_size = 400;
+  uint32_t generation = 0;
+  std::unordered_map<uint32_t, Tracked> tracked;
+  std::unordered_map<uint64_t, std::vector<uint32_t>> cells; // ids
+  std::vector<CellEvent> events;
+};
+
+struct ClientInterestStats
+{
+  int relevant = 0; // entities in the client's cells
+  int updated = 0;  // sent with their latest state
+  int deferred = 0; // changed, but left for a later tick to stay in budget
+  int bits = 0;     // at most what's written, the counts are taken at their widest
+};
+
+// One client's view of the world: the cells around its camera, the snapshots sent to it,
+// and how long each entity near it has waited for an update.
+class ClientInterest
+{
+public:
+  void set_camera(glm::vec2 world_pos) { camera = world_pos; }
+  [[nodiscard]] glm::vec2 get_camera() const { return camera; }
+
+  // Builds this client's snapshot of world and encodes it against the newest snapshot it acked.
+  // Only entities in its cells are included. Changed entities are sent most important first
+  // (priority builds up each tick an entity waits, faster for near ones and by type_priority)
+  // until bytes_per_tick is spent; the rest keep the state the client already has, for free.
+  void write_snapshot(const InterestGrid& grid,
+                      const Snapshot& world,
+                      const SnapshotSchema& schema,
+                      const InterestConfig& config,
+                      BitWriter& out);
+
+  void on_ack(uint32_t tick) { snapshot::on_ack(client, tick); }
+
+  [[nodiscard]] const Snapshot& get_last_snapshot() const { return last; }
+  [[nodiscard]] const ClientInterestStats& get_stats() const { return stats; }
+
+private:
+  struct Candidate
+  {
+    const NetEntityState* e = nullptr;
+    const NetEntityState* base = nullptr;
+    float priority = 0.0f;
+    int bits = 0;
+  };
+
+  glm::vec2 camera{ 0.0f, 0.0f };
+  SnapshotHistory sent;
+  SnapshotClientState client;
+  Snapshot last;
+  ClientInterestStats stats;
+
+  std::unordered_map<uint32_t, float> priority;
+  std::unordered_map<uint32_t, float> next_priority;
+  std::vector<Candidate> candidates;
+  std::vector<uint32_t> relevant_ids;
+  std::set<uint32_t> sent_ids; // changed entities going this tick
+};
+
+} // namespace fightingengine
@@ -0,0 +1,170 @@
+// header
+#include "engine/networking/load_test.hpp"
+
+// c++ standard library headers
+#include <algorithm>
+#include <iomanip>
+
+// engine headers
+#include "engine/tick_scheduler.hpp"
+#include "engine/tools/zone_profiler.hpp"
+
+namespace fightingengine {
+
+//
+// LoadTestReport
+//
+
+void
+LoadTestReport::write_json(std::ostream& out) const
+{
+  out << std::fixed << std::setprecision(4);
+  out << "{\n";
+  out << "  \"clients\": " << clients << ",\n";
+  out << "  \"ticks\": " << ticks << ",\n";
+  out << "  \"wall_time_s\": " << wall_time_s << ",\n";
+  out << "  \"sim_time_s\": " << sim_time_s << ",\n";
+  out << "  \"bots\": { \"sent\": " << bot_messages_sent << ", \"received\": " << bot_messages_received
+      << ", \"bytes_received\": " << bot_bytes_received << " },\n";
+  out << "  \"network\": { \"sent\": " << network.messages_sent << ", \"bytes_sent\": " << network.bytes_sent
+      << ", \"delivered\": " << network.messages_delivered << ", \"lost\": " << network.messages_lost
+      << ", \"resent\": " << network.messages_resent << ", \"dropped\": " << network.messages_dropped << " },\n";
+  const double sim_time = sim_time_s > 0.0 ? sim_time_s : 1.0;
+  out << "  \"throughput\": { \"messages_per_s\": " << network.messages_delivered / sim_time
+      << ", \"bytes_per_s\": " << network.bytes_sent / sim_time << " },\n";
+  out << "  \"server_tick\": { \"p50_ms\": " << tick_p50_us * 1e-3 << ", \"p99_ms\": " << tick_p99_us * 1e-3
+      << ", \"max_ms\": " << tick_max_us * 1e-3 << " },\n";
+  out << "  \"latency\": { \"samples\": " << latency_samples << ", \"p50_ms\": " << latency_p50_us * 1e-3
+      << ", \"p99_ms\": " << latency_p99_us * 1e-3 << ", \"p99.9_ms\": " << latency_p999_us * 1e-3
+      << ", \"max_ms\": " << latency_max_us * 1e-3 << " }";
+  if (!extra.empty()) {
+    out << ",\n  \"extra\": {";
+    for (size_t i = 0; i < extra.size(); i++)
+      out << (i ? ", " : " ") << "\"" << extra[i].first << "\": " << extra[i].second;
+    out << " }";
+  }
+  out << "\n}\n";
+}
+
+//
+// LoadTestContext
+//
+
+uint64_t
+LoadTestContext::get_time_ns() const
+{
+  return network->get_time_ns();
+}
+
+void
+LoadTestContext::send(const void* data, uint32_t size, bool reliable)
+{
+  if (endpoint->send(endpoint->get_id(), data, size, reliable))
+    report->bot_messages_sent += 1;
+}
+
+void
+LoadTestContext::record_latency(uint64_t sent_ns)
+{
+  const uint64_t now_ns = network->get_time_ns();
+  latency->record(now_ns > sent_ns ? (now_ns - sent_ns) / 1000 : 0);
+  report->latency_samples += 1;
+}
+
+//
+// LoadTest
+//
+
+static constexpr int latency_window = 1 << 20;
+
+LoadTest::LoadTest(const LoadTestConfig& config)
+  : config(config)
+  , network(config.link, config.seed)
+{}
+
+LoadTestReport
+LoadTest::run(const ServerTick& server_tick, const MakeBot& make_bot)
+{
+  LoadTestReport report;
+  const uint64_t total_ticks = static_cast<uint64_t>(config.duration_s * config.tick_rate_hz);
+  const uint64_t period_ns = static_cast<uint64_t>(1e9 / config.tick_rate_hz);
+
+  LatencyHistogram tick_times(total_ticks > 0 ? static_cast<int>(total_ticks) : 1);
+  LatencyHistogram latency(latency_window);
+
+  TickSchedulerConfig scheduler_config;
+  scheduler_config.tick_rate_hz = config.tick_rate_hz;
+  FixedTickScheduler scheduler(scheduler_config);
+
+  // reserved, contexts point in to it
+  std::vector<Bot> bots;
+  bots.reserve(config.clients > 0 ? config.clients : 0);
+  std::vector<TransportEvent> events;
+  std::vector<TransportMessage> messages;
+
+  const uint64_t start_ns = zone_profiler::now_ns();
+  for (uint64_t tick = 0; tick < total_ticks; tick++) {
+    if (config.realtime)
+      scheduler.wait_for_next_tick();
+    network.update(config.realtime ? zone_profiler::now_ns() - start_ns : tick * period_ns);
+
+    for (int i = 0; i < config.connects_per_tick && static_cast<int>(bots.size()) < config.clients; i++) {
+      Bot& b = bots.emplace_back();
+      b.endpoint = &network.connect();
+      b.bot = make_bot(static_cast<int>(bots.size() - 1));
+      b.ctx.network = &network;
+      b.ctx.endpoint = b.endpoint;
+      b.ctx.latency = &latency;
+      b.ctx.report = &report;
+      b.ctx.rng.seed(config.seed + static_cast<uint32_t>(bots.size()));
+      b.ctx.delta_time_s = 1.0f / config.tick_rate_hz;
+      b.ctx.bot_index = static_cast<int>(bots.size() - 1);
+    }
+
+    const uint64_t server_start_ns = zone_profiler::now_ns();
+    server_tick();
+    tick_times.record((zone_profiler::now_ns() - server_start_ns) / 1000);
+
+    for (Bot& b : bots) {
+      if (!b.endpoint->is_connected())
+        continue;
+
+      events.clear();
+      b.endpoint->poll_events(events);
+      for (const TransportEvent& e : events) {
+        if (e.type == TransportEvent::Type::Connected)
+          b.bot->on_connected(b.ctx);
+      }
+
+      messages.clear();
+      b.endpoint->receive(messages);
+      for (const TransportMessage& m : messages) {
+        report.bot_messages_received += 1;
+        report.bot_bytes_received += m.payload.size();
+        b.bot->on_message(b.ctx, m.payload);
+      }
+
+      b.bot->update(b.ctx);
+    }
+
+    if (config.realtime)
+      scheduler.end_tick();
+    report.ticks += 1;
+  }
+
+  report.clients = static_cast<int>(bots.size());
+  report.wall_time_s = (zone_profiler::now_ns() - start_ns) * 1e-9;
+  report.sim_time_s = config.realtime ? report.wall_time_s : report.ticks * period_ns * 1e-9;
+  report.network = network.get_stats();
+  // percentiles are bucketed, and can land a little past the real max
+  report.tick_max_us = tick_times.get_max();
+  report.tick_p50_us = std::min(tick_times.get_percentile(50.0f), report.tick_max_us);
+  report.tick_p99_us = std::min(tick_times.get_percentile(99.0f), report.tick_max_us);
+  report.latency_max_us = latency.get_max();
+  report.latency_p50_us = std::min(latency.get_percentile(50.0f), report.latency_max_us);
+  report.latency_p99_us = std::min(latency.get_percentile(99.0f), report.latency_max_us);
+  report.latency_p999_us = std::min(latency.get_percentile(99.9f), report.latency_max_us);
+  return report;
+}
+
+} // namespace fightingengine
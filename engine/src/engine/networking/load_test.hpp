@@ -0,0 +1,134 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+// c++ standard library headers
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// engine headers
+#include "engine/networking/loopback_transport.hpp"
+#include "engine/tools/latency_histogram.hpp"
+
+namespace fightingengine {
+
+struct LoadTestConfig
+{
+  int clients = 100;
+  int connects_per_tick = 20; // clients join over a few ticks, rather than all at once
+  float duration_s = 10.0f;
+  float tick_rate_hz = 60.0f;
+  // true: ticks run on a FixedTickScheduler, and an overloaded server shows up as latency.
+  // false: time moves one tick per tick, as fast as the server and bots can go
+  bool realtime = true;
+  LinkConditions link;
+  uint32_t seed = 1;
+};
+
+struct LoadTestReport
+{
+  int clients = 0;
+  uint64_t ticks = 0;
+  double wall_time_s = 0.0;
+  double sim_time_s = 0.0;
+
+  uint64_t bot_messages_sent = 0;
+  uint64_t bot_messages_received = 0;
+  uint64_t bot_bytes_received = 0;
+  LoopbackStats network;
+
+  // the server's tick, microseconds
+  uint64_t tick_p50_us = 0;
+  uint64_t tick_p99_us = 0;
+  uint64_t tick_max_us = 0;
+  // what bots recorded with record_latency(), microseconds. percentiles are over the last million samples
+  uint64_t latency_samples = 0;
+  uint64_t latency_p50_us = 0;
+  uint64_t latency_p99_us = 0;
+  uint64_t latency_p999_us = 0;
+  uint64_t latency_max_us = 0;
+
+  // anything else the server has to report, e.g. queue depths, written as they are
+  std::vector<std::pair<std::string, double>> extra;
+
+  // as json, in the same shape as the game_2d --bench summary
+  void write_json(std::ostream& out) const;
+};
+
+class LoadTestContext;
+
+// What one simulated client does. The harness makes one per client.
+class LoadTestBot
+{
+public:
+  virtual ~LoadTestBot() = default;
+
+  virtual void on_connected(LoadTestContext&) {}
+  // every tick while connected, after its messages
+  virtual void update(LoadTestContext& ctx) = 0;
+  virtual void on_message(LoadTestContext& ctx, std::string_view payload) = 0;
+};
+
+// A bot's view of the harness
+class LoadTestContext
+{
+public:
+  [[nodiscard]] uint64_t get_time_ns() const;
+  [[nodiscard]] float get_delta_time_s() const { return delta_time_s; }
+  [[nodiscard]] int get_bot_index() const { return bot_index; }
+  [[nodiscard]] std::minstd_rand& get_rng() { return rng; }
+
+  // to the server
+  void send(const void* data, uint32_t size, bool reliable);
+  // sent_ns is a get_time_ns() from when the thing being timed was sent
+  void record_latency(uint64_t sent_ns);
+
+private:
+  friend class LoadTest;
+
+  LoopbackNetwork* network = nullptr;
+  LoopbackEndpoint* endpoint = nullptr;
+  LatencyHistogram* latency = nullptr;
+  LoadTestReport* report = nullptr;
+  std::minstd_rand rng;
+  float delta_time_s = 0.0f;
+  int bot_index = 0;
+};
+
+// Runs a server against config.clients bots over a LoopbackNetwork, in this thread:
+//   LoadTest test(config);
+//   ChatServer server(test.get_server_transport());
+//   LoadTestReport report = test.run([&] { server.Tick(); }, [](int i) { return std::make_unique<ChatBot>(i); });
+class LoadTest
+{
+public:
+  using ServerTick = std::function<void()>;
+  using MakeBot = std::function<std::unique_ptr<LoadTestBot>(int index)>;
+
+  explicit LoadTest(const LoadTestConfig& config);
+
+  [[nodiscard]] Transport& get_server_transport() { return network.get_server(); }
+  [[nodiscard]] LoopbackNetwork& get_network() { return network; }
+
+  LoadTestReport run(const ServerTick& server_tick, const MakeBot& make_bot);
+
+private:
+  struct Bot
+  {
+    std::unique_ptr<LoadTestBot> bot;
+    LoopbackEndpoint* endpoint = nullptr;
+    LoadTestContext ctx;
+  };
+
+  LoadTestConfig config;
+  LoopbackNetwork network;
+};
+
+} // namespace fightingengine
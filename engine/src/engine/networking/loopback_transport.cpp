@@ -0,0 +1,179 @@
+// header
+#include "engine/networking/loopback_transport.hpp"
+
+// c++ standard library headers
+#include <algorithm>
+#include <functional>
+
+namespace fightingengine {
+
+//
+// LoopbackEndpoint
+//
+
+void
+LoopbackEndpoint::poll_events(std::vector<TransportEvent>& out)
+{
+  for (TransportEvent& e : events)
+    out.push_back(std::move(e));
+  events.clear();
+}
+
+void
+LoopbackEndpoint::receive(std::vector<TransportMessage>& messages)
+{
+  held.clear();
+  held.swap(inbox);
+  for (const Arrived& a : held)
+    messages.push_back({ a.conn, std::string_view(*a.payload) });
+}
+
+bool
+LoopbackEndpoint::send(ConnectionId conn, const void* data, uint32_t size, bool reliable)
+{
+  auto payload = std::make_shared<const std::string>(static_cast<const char*>(data), size);
+  if (id != invalid_connection)
+    return conn == id && network.send(id, true, std::move(payload), reliable);
+  return network.send(conn, false, std::move(payload), reliable);
+}
+
+int
+LoopbackEndpoint::broadcast(const ConnectionId* conns, int count, const void* data, uint32_t size, bool reliable)
+{
+  auto payload = std::make_shared<const std::string>(static_cast<const char*>(data), size);
+  int failed = 0;
+  for (int i = 0; i < count; i++) {
+    const bool ok = id != invalid_connection ? conns[i] == id && network.send(id, true, payload, reliable)
+                                             : network.send(conns[i], false, payload, reliable);
+    failed += ok ? 0 : 1;
+  }
+  return failed;
+}
+
+void
+LoopbackEndpoint::close(ConnectionId conn, const char* reason)
+{
+  if (id != invalid_connection) {
+    if (conn == id)
+      network.close(id, false, reason);
+  } else
+    network.close(conn, true, reason);
+}
+
+bool
+LoopbackEndpoint::is_connected() const
+{
+  if (id == invalid_connection)
+    return true;
+  return network.links[id - 1].open;
+}
+
+//
+// LoopbackNetwork
+//
+
+LoopbackNetwork::LoopbackNetwork(const LinkConditions& link, uint32_t seed)
+  : link(link)
+  , rng(seed)
+  , server(new LoopbackEndpoint(*this, invalid_connection))
+{}
+
+float
+LoopbackNetwork::roll()
+{
+  return static_cast<float>(rng() - rng.min()) / (static_cast<float>(rng.max() - rng.min()) + 1.0f);
+}
+
+LoopbackEndpoint&
+LoopbackNetwork::connect()
+{
+  const ConnectionId id = static_cast<ConnectionId>(clients.size() + 1);
+  clients.emplace_back(new LoopbackEndpoint(*this, id));
+  links.push_back({ true, now_ns, now_ns });
+
+  const std::string description = "loopback client " + std::to_string(id);
+  server->events.push_back({ TransportEvent::Type::Connected, id, false, description, "" });
+  clients.back()->events.push_back({ TransportEvent::Type::Connected, id, false, "loopback server", "" });
+  return *clients.back();
+}
+
+void
+LoopbackNetwork::disconnect(ConnectionId client)
+{
+  close(client, false, "client disconnected");
+}
+
+LoopbackEndpoint*
+LoopbackNetwork::get_client(ConnectionId client)
+{
+  if (client == invalid_connection || client > clients.size())
+    return nullptr;
+  return clients[client - 1].get();
+}
+
+void
+LoopbackNetwork::close(ConnectionId client, bool by_server, const char* reason)
+{
+  if (client == invalid_connection || client > links.size() || !links[client - 1].open)
+    return;
+  links[client - 1].open = false;
+
+  // the end that closed it doesn't hear about it
+  LoopbackEndpoint& other = by_server ? *clients[client - 1] : *server;
+  const std::string description = by_server ? "loopback server" : "loopback client " + std::to_string(client);
+  other.events.push_back({ TransportEvent::Type::Disconnected, client, false, description, reason ? reason : "" });
+}
+
+bool
+LoopbackNetwork::send(ConnectionId client, bool to_server, std::shared_ptr<const std::string> payload, bool reliable)
+{
+  if (client == invalid_connection || client > links.size() || !links[client - 1].open)
+    return false;
+  stats.messages_sent += 1;
+  stats.bytes_sent += payload->size();
+
+  const float latency_ns = link.latency_ms * 1e6f;
+  uint64_t arrive_ns = now_ns + static_cast<uint64_t>(latency_ns + roll() * link.jitter_ms * 1e6f);
+  if (link.loss > 0.0f && roll() < link.loss) {
+    if (!reliable) {
+      stats.messages_lost += 1;
+      return true; // as far as the sender knows, it went
+    }
+    // noticed missing and sent again
+    stats.messages_resent += 1;
+    arrive_ns += static_cast<uint64_t>(2.0f * latency_ns);
+  }
+
+  if (reliable) {
+    Link& l = links[client - 1];
+    uint64_t& last = to_server ? l.last_reliable_to_server_ns : l.last_reliable_to_client_ns;
+    arrive_ns = std::max(arrive_ns, last);
+    last = arrive_ns;
+  }
+
+  in_flight.push_back({ arrive_ns, next_sequence++, client, to_server, std::move(payload) });
+  std::push_heap(in_flight.begin(), in_flight.end(), std::greater<InFlight>());
+  return true;
+}
+
+void
+LoopbackNetwork::update(uint64_t time_ns)
+{
+  now_ns = std::max(now_ns, time_ns);
+
+  while (!in_flight.empty() && in_flight.front().arrive_ns <= now_ns) {
+    std::pop_heap(in_flight.begin(), in_flight.end(), std::greater<InFlight>());
+    InFlight m = std::move(in_flight.back());
+    in_flight.pop_back();
+
+    if (!links[m.client - 1].open) {
+      stats.messages_dropped += 1;
+      continue;
+    }
+    LoopbackEndpoint& to = m.to_server ? *server : *clients[m.client - 1];
+    to.inbox.push_back({ m.client, std::move(m.payload) });
+    stats.messages_delivered += 1;
+  }
+}
+
+} // namespace fightingengine
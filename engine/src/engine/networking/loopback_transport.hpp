@@ -0,0 +1,145 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+// c++ standard library headers
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// engine headers
+#include "engine/networking/transport.hpp"
+
+namespace fightingengine {
+
+// What the in-process network does to each message
+struct LinkConditions
+{
+  float latency_ms = 0.0f; // one way
+  float jitter_ms = 0.0f;  // a random extra delay, up to this
+  float loss = 0.0f;       // [0, 1]. lost unreliable messages are gone, lost reliable ones arrive a round trip late
+};
+
+struct LoopbackStats
+{
+  uint64_t messages_sent = 0;
+  uint64_t bytes_sent = 0;
+  uint64_t messages_delivered = 0;
+  uint64_t messages_lost = 0;    // unreliable, dropped
+  uint64_t messages_resent = 0;  // reliable, delayed
+  uint64_t messages_dropped = 0; // the connection closed before they arrived
+};
+
+class LoopbackNetwork;
+
+// One end of the in-process network: the server, or one client
+class LoopbackEndpoint : public Transport
+{
+public:
+  LoopbackEndpoint(const LoopbackEndpoint&) = delete;
+  LoopbackEndpoint& operator=(const LoopbackEndpoint&) = delete;
+
+  void poll_events(std::vector<TransportEvent>& events) override;
+  void receive(std::vector<TransportMessage>& messages) override;
+  bool send(ConnectionId conn, const void* data, uint32_t size, bool reliable) override;
+  int broadcast(const ConnectionId* conns, int count, const void* data, uint32_t size, bool reliable) override;
+  void flush(ConnectionId) override {}
+  void close(ConnectionId conn, const char* reason) override;
+
+  // a client's only connection, to the server. invalid_connection for the server end
+  [[nodiscard]] ConnectionId get_id() const { return id; }
+  [[nodiscard]] bool is_connected() const;
+
+private:
+  friend class LoopbackNetwork;
+
+  struct Arrived
+  {
+    ConnectionId conn = invalid_connection;
+    std::shared_ptr<const std::string> payload;
+  };
+
+  LoopbackEndpoint(LoopbackNetwork& network, ConnectionId id)
+    : network(network)
+    , id(id)
+  {}
+
+  LoopbackNetwork& network;
+  ConnectionId id = invalid_connection;
+  std::vector<TransportEvent> events;
+  std::vector<Arrived> inbox;
+  std::vector<Arrived> held; // the payloads handed out by the last receive()
+};
+
+// A server and any number of clients in one process, with latency, jitter and loss.
+// Time only moves when update() is called, so it can run in real time or as fast as it can.
+// Reliable messages arrive in the order they were sent, unreliable ones can overtake each other.
+//   LoopbackNetwork network(link);
+//   Server server(network.get_server());
+//   LoopbackEndpoint& client = network.connect();
+//   each tick: network.update(now_ns); server.tick(); ... client.receive(messages) ...
+class LoopbackNetwork
+{
+public:
+  explicit LoopbackNetwork(const LinkConditions& link = LinkConditions(), uint32_t seed = 1);
+
+  [[nodiscard]] LoopbackEndpoint& get_server() { return *server; }
+
+  // a new client, connected straight away. both ends see the connection as the same id
+  LoopbackEndpoint& connect();
+  // the client hangs up
+  void disconnect(ConnectionId client);
+  [[nodiscard]] LoopbackEndpoint* get_client(ConnectionId client);
+  [[nodiscard]] size_t get_client_count() const { return clients.size(); }
+
+  // moves time on to now_ns, and delivers everything due by then
+  void update(uint64_t now_ns);
+  [[nodiscard]] uint64_t get_time_ns() const { return now_ns; }
+
+  void set_link(const LinkConditions& conditions) { link = conditions; }
+  [[nodiscard]] const LinkConditions& get_link() const { return link; }
+  [[nodiscard]] const LoopbackStats& get_stats() const { return stats; }
+
+private:
+  friend class LoopbackEndpoint;
+
+  struct InFlight
+  {
+    uint64_t arrive_ns = 0;
+    uint64_t sequence = 0; // keeps messages due at the same time in order
+    ConnectionId client = invalid_connection;
+    bool to_server = false;
+    std::shared_ptr<const std::string> payload;
+
+    bool operator>(const InFlight& other) const
+    {
+      return arrive_ns != other.arrive_ns ? arrive_ns > other.arrive_ns : sequence > other.sequence;
+    }
+  };
+
+  struct Link
+  {
+    bool open = false;
+    uint64_t last_reliable_to_server_ns = 0;
+    uint64_t last_reliable_to_client_ns = 0;
+  };
+
+  bool send(ConnectionId client, bool to_server, std::shared_ptr<const std::string> payload, bool reliable);
+  void close(ConnectionId client, bool by_server, const char* reason);
+  [[nodiscard]] float roll(); // [0, 1)
+
+  LinkConditions link;
+  std::minstd_rand rng;
+  uint64_t now_ns = 0;
+  uint64_t next_sequence = 0;
+  LoopbackStats stats;
+
+  std::unique_ptr<LoopbackEndpoint> server;
+  std::vector<std::unique_ptr<LoopbackEndpoint>> clients; // client id - 1
+  std::vector<Link> links;                                // client id - 1
+  std::vector<InFlight> in_flight;                        // a min heap on arrive_ns
+};
+
+} // namespace fightingengine
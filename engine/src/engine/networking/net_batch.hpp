@@ -0,0 +1,176 @@
+#pragma once
+
+// c system headers
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// c++ standard library headers
+#include <atomic>
+#include <new>
+#include <string_view>
+#include <vector>
+
+// other lib headers
+#include <steam/isteamnetworkingutils.h>
+#include <steam/steamnetworkingsockets.h>
+
+// Batched receive and send on top of GameNetworkingSockets.
+// Like net_common.hpp, define STEAMNETWORKINGSOCKETS_OPENSOURCE before including this.
+
+namespace net_common {
+
+// Receives up to max_messages at a time in to a reusable array,
+// instead of one ReceiveMessages call (and one copy) per message.
+// Payloads are read in place with get_payload() until release().
+class ReceiveBatch
+{
+public:
+  static constexpr int max_messages = 256;
+
+  ReceiveBatch() = default;
+  ~ReceiveBatch() { release(); }
+  ReceiveBatch(const ReceiveBatch&) = delete;
+  ReceiveBatch& operator=(const ReceiveBatch&) = delete;
+
+  // releases the last batch, then receives the next. returns the number received, -1 on error
+  int receive_on_poll_group(ISteamNetworkingSockets* iface, HSteamNetPollGroup poll_group)
+  {
+    release();
+    int n = iface->ReceiveMessagesOnPollGroup(poll_group, messages, max_messages);
+    count = n > 0 ? n : 0;
+    return n;
+  }
+
+  int receive_on_connection(ISteamNetworkingSockets* iface, HSteamNetConnection conn)
+  {
+    release();
+    int n = iface->ReceiveMessagesOnConnection(conn, messages, max_messages);
+    count = n > 0 ? n : 0;
+    return n;
+  }
+
+  void release()
+  {
+    for (int i = 0; i < count; i++)
+      messages[i]->Release();
+    count = 0;
+  }
+
+  [[nodiscard]] int size() const { return count; }
+  [[nodiscard]] bool is_full() const { return count == max_messages; }
+  [[nodiscard]] const SteamNetworkingMessage_t* get(int i) const { return messages[i]; }
+  [[nodiscard]] HSteamNetConnection get_connection(int i) const { return messages[i]->m_conn; }
+
+  // points in to the message, valid until release()
+  [[nodiscard]] std::string_view get_payload(int i) const
+  {
+    return std::string_view(static_cast<const char*>(messages[i]->m_pData), messages[i]->m_cbSize);
+  }
+
+private:
+  SteamNetworkingMessage_t* messages[max_messages] = {};
+  int count = 0;
+};
+
+// One copy of a payload shared by every message in a broadcast.
+// Each message holds a reference, the last one to be freed by the library frees the payload.
+struct SharedPayload
+{
+  std::atomic<int> refs;
+  uint32_t size;
+  // data follows
+
+  [[nodiscard]] char* get_data() { return reinterpret_cast<char*>(this + 1); }
+
+  [[nodiscard]] static SharedPayload* create(const void* data, uint32_t size)
+  {
+    SharedPayload* payload = static_cast<SharedPayload*>(malloc(sizeof(SharedPayload) + size));
+    new (&payload->refs) std::atomic<int>(1);
+    payload->size = size;
+    memcpy(payload->get_data(), data, size);
+    return payload;
+  }
+
+  void add_ref() { refs.fetch_add(1, std::memory_order_relaxed); }
+
+  void release()
+  {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      refs.~atomic();
+      free(this);
+    }
+  }
+
+  // m_pfnFreeData for messages pointing at a SharedPayload (kept in m_nUserData)
+  static void free_message_data(SteamNetworkingMessage_t* msg)
+  {
+    reinterpret_cast<SharedPayload*>(static_cast<intptr_t>(msg->m_nUserData))->release();
+  }
+};
+
+struct BroadcastResult
+{
+  int sent = 0;
+  int failed = 0;
+};
+
+// Sends data to every connection in conns with one SendMessages call (per batch of 256),
+// sharing one copy of the payload. send_flags are k_nSteamNetworkingSend_*.
+inline BroadcastResult
+broadcast(ISteamNetworkingSockets* iface,
+          const HSteamNetConnection* conns,
+          int conn_count,
+          const void* data,
+          uint32_t size,
+          int send_flags)
+{
+  BroadcastResult result;
+  if (conn_count <= 0)
+    return result;
+
+  constexpr int batch_size = 256;
+  SteamNetworkingMessage_t* messages[batch_size];
+  int64 message_results[batch_size];
+
+  SharedPayload* payload = SharedPayload::create(data, size);
+  for (int start = 0; start < conn_count; start += batch_size) {
+    const int n = conn_count - start < batch_size ? conn_count - start : batch_size;
+    for (int i = 0; i < n; i++) {
+      // no buffer of its own, it points at the shared one
+      SteamNetworkingMessage_t* msg = SteamNetworkingUtils()->AllocateMessage(0);
+      payload->add_ref();
+      msg->m_conn = conns[start + i];
+      msg->m_pData = payload->get_data();
+      msg->m_cbSize = static_cast<int>(size);
+      msg->m_nFlags = send_flags;
+      msg->m_nUserData = static_cast<int64>(reinterpret_cast<intptr_t>(payload));
+      msg->m_pfnFreeData = SharedPayload::free_message_data;
+      messages[i] = msg;
+    }
+
+    // the library takes ownership of every message, even the ones that fail
+    iface->SendMessages(n, messages, message_results);
+    for (int i = 0; i < n; i++) {
+      if (message_results[i] < 0)
+        result.failed += 1;
+      else
+        result.sent += 1;
+    }
+  }
+  payload->release();
+  return result;
+}
+
+inline BroadcastResult
+broadcast(ISteamNetworkingSockets* iface,
+          const std::vector<HSteamNetConnection>& conns,
+          const void* data,
+          uint32_t size,
+          int send_flags)
+{
+  return broadcast(iface, conns.data(), static_cast<int>(conns.size()), data, size, send_flags);
+}
+
+} // namespace net_common
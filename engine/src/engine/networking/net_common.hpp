@@ -21,6 +21,9 @@
 #include <steam/steam_api.h>
 #endif
 
+// engine headers
+#include "engine/tools/logger.hpp"
+
 #ifdef WIN32
 #include <windows.h> // Ug, for NukeProcess -- see below
 #else
@@ -50,14 +53,33 @@ NukeProcess(int rc)
 #endif
 }
 
+// GameNetworkingSockets calls this from its own threads too, so it goes through the logger
 static void
 DebugOutput(ESteamNetworkingSocketsDebugOutputType eType, const char* pszMsg)
 {
-  SteamNetworkingMicroseconds time =
-    SteamNetworkingUtils()->GetLocalTimestamp() - g_logTimeZero;
-  printf("%10.6f %s\n", time * 1e-6, pszMsg);
-  fflush(stdout);
+  using fightingengine::LogLevel;
+  LogLevel level = LogLevel::Trace;
+  if (eType <= k_ESteamNetworkingSocketsDebugOutputType_Error)
+    level = LogLevel::Error;
+  else if (eType <= k_ESteamNetworkingSocketsDebugOutputType_Warning)
+    level = LogLevel::Warn;
+  else if (eType <= k_ESteamNetworkingSocketsDebugOutputType_Msg)
+    level = LogLevel::Info;
+  else if (eType <= k_ESteamNetworkingSocketsDebugOutputType_Verbose)
+    level = LogLevel::Debug;
+
+  if (fightingengine::logger::is_enabled(level)) {
+    static fightingengine::LogSite sites[] = {
+      { __FILE__, __LINE__, LogLevel::Trace }, { __FILE__, __LINE__, LogLevel::Debug },
+      { __FILE__, __LINE__, LogLevel::Info },  { __FILE__, __LINE__, LogLevel::Warn },
+      { __FILE__, __LINE__, LogLevel::Error },
+    };
+    fightingengine::logger::write(sites[static_cast<int>(level)], "{}", pszMsg);
+  }
+
   if (eType == k_ESteamNetworkingSocketsDebugOutputType_Bug) {
+    // write out what's queued. not stop(): this can be one of GameNetworkingSockets' threads
+    fightingengine::logger::flush();
     fflush(stdout);
     fflush(stderr);
     NukeProcess(1);
@@ -89,12 +111,17 @@ Printf(const char* fmt, ...)
   char* nl = strchr(text, '\0') - 1;
   if (nl >= text && *nl == '\n')
     *nl = '\0';
-  DebugOutput(k_ESteamNetworkingSocketsDebugOutputType_Msg, text);
+
+  // chat and connection messages, not rate limited
+  static fightingengine::LogSite site{ __FILE__, __LINE__, fightingengine::LogLevel::Info, false };
+  fightingengine::logger::write(site, "{}", text);
 }
 
 static void
 InitSteamDatagramConnectionSockets()
 {
+  fightingengine::logger::start();
+
 #ifdef STEAMNETWORKINGSOCKETS_OPENSOURCE
   SteamDatagramErrMsg errMsg;
   if (!GameNetworkingSockets_Init(nullptr, errMsg))
@@ -138,6 +165,8 @@ ShutdownSteamDatagramConnectionSockets()
 #else
   SteamDatagramClient_Kill();
 #endif
+
+  fightingengine::logger::stop();
 }
 
 // ---- Non-blocking console user input.
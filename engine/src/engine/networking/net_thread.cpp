@@ -0,0 +1,313 @@
+// header
+#include "engine/networking/net_thread.hpp"
+
+// c++ standard library headers
+#include <algorithm>
+#include <chrono>
+
+// engine headers
+#include "engine/tools/zone_profiler.hpp"
+
+namespace fightingengine {
+
+static void
+raise_to(std::atomic<uint64_t>& high_water, uint64_t value)
+{
+  // only the network thread writes it, so no CAS
+  if (value > high_water.load(std::memory_order_relaxed))
+    high_water.store(value, std::memory_order_relaxed);
+}
+
+//
+// SimQueueTransport
+//
+
+SimQueueTransport::SimQueueTransport(const NetThreadConfig& config, MpscRing<NetOutbound>& outbound)
+  : config(config)
+  , inbound(config.inbound_capacity)
+  , outbound(outbound)
+{}
+
+void
+SimQueueTransport::poll_events(std::vector<TransportEvent>& events)
+{
+  flush_waiting();
+
+  int connects = 0;
+  int taken = 0;
+  NetInbound* in = nullptr;
+  while (taken < config.max_inbound_per_tick && (in = inbound.front()) != nullptr) {
+    switch (in->type) {
+      case NetInbound::Type::Connected:
+        if (connects == config.max_connects_per_tick) {
+          connects_deferred.fetch_add(1, std::memory_order_relaxed);
+          return; // the rest waits, in order, for the next tick
+        }
+        connects += 1;
+        events.push_back({ TransportEvent::Type::Connected, in->conn, false, std::move(in->data), "" });
+        break;
+      case NetInbound::Type::Disconnected:
+        events.push_back(
+          { TransportEvent::Type::Disconnected, in->conn, in->problem, std::move(in->data), std::move(in->reason) });
+        break;
+      case NetInbound::Type::Message:
+        arrived.push_back(std::move(*in));
+        break;
+    }
+    inbound.pop();
+    taken += 1;
+  }
+  if (taken == config.max_inbound_per_tick)
+    inbound_budget_hits.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+SimQueueTransport::receive(std::vector<TransportMessage>& messages)
+{
+  held.clear();
+  held.swap(arrived);
+  for (const NetInbound& in : held)
+    messages.push_back({ in.conn, std::string_view(in.data) });
+}
+
+bool
+SimQueueTransport::push_in_order(NetOutbound&& out)
+{
+  flush_waiting();
+  if (waiting.empty() && outbound.try_push(std::move(out)))
+    return true;
+  outbound_deferred.fetch_add(1, std::memory_order_relaxed);
+  waiting.push_back(std::move(out));
+  return true;
+}
+
+void
+SimQueueTransport::flush_waiting()
+{
+  while (!waiting.empty() && outbound.try_push(std::move(waiting.front())))
+    waiting.pop_front();
+}
+
+bool
+SimQueueTransport::send(ConnectionId conn, const void* data, uint32_t size, bool reliable)
+{
+  auto payload = std::make_shared<const std::string>(static_cast<const char*>(data), size);
+  NetOutbound out{ NetOutbound::Type::Send, reliable, conn, std::move(payload) };
+  if (reliable)
+    return push_in_order(std::move(out));
+
+  // a snapshot that can't go now is stale by the time it could
+  if (outbound.try_push(std::move(out)))
+    return true;
+  outbound_dropped.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+int
+SimQueueTransport::broadcast(const ConnectionId* conns, int count, const void* data, uint32_t size, bool reliable)
+{
+  auto payload = std::make_shared<const std::string>(static_cast<const char*>(data), size);
+  int failed = 0;
+  for (int i = 0; i < count; i++) {
+    NetOutbound out{ NetOutbound::Type::Send, reliable, conns[i], payload };
+    if (reliable)
+      push_in_order(std::move(out));
+    else if (!outbound.try_push(std::move(out))) {
+      outbound_dropped.fetch_add(1, std::memory_order_relaxed);
+      failed += 1;
+    }
+  }
+  return failed;
+}
+
+void
+SimQueueTransport::close(ConnectionId conn, const char* reason)
+{
+  push_in_order({ NetOutbound::Type::Close, true, conn, std::make_shared<const std::string>(reason) });
+}
+
+void
+SimQueueTransport::set_name(ConnectionId conn, const char* name)
+{
+  push_in_order({ NetOutbound::Type::SetName, true, conn, std::make_shared<const std::string>(name) });
+}
+
+SimQueueStats
+SimQueueTransport::get_stats() const
+{
+  SimQueueStats s;
+  s.connects_deferred = connects_deferred.load(std::memory_order_relaxed);
+  s.inbound_budget_hits = inbound_budget_hits.load(std::memory_order_relaxed);
+  s.outbound_dropped = outbound_dropped.load(std::memory_order_relaxed);
+  s.outbound_deferred = outbound_deferred.load(std::memory_order_relaxed);
+  return s;
+}
+
+//
+// NetworkThread
+//
+
+NetworkThread::NetworkThread(Transport& transport, const NetThreadConfig& config)
+  : transport(transport)
+  , config(config)
+  , outbound(config.outbound_capacity)
+{
+  const int count = std::max(1, config.sim_threads);
+  this->config.sim_threads = count;
+  for (int i = 0; i < count; i++)
+    sims.emplace_back(new SimQueueTransport(this->config, outbound));
+  overflow.resize(count);
+  connection_counts.resize(count, 0);
+}
+
+NetworkThread::~NetworkThread()
+{
+  stop();
+}
+
+void
+NetworkThread::start()
+{
+  if (running.exchange(true))
+    return;
+  thread = std::thread([this]() {
+    zone_profiler::set_thread_name("network");
+    while (running.load(std::memory_order_acquire)) {
+      if (!pass())
+        std::this_thread::sleep_for(std::chrono::nanoseconds(config.idle_sleep_ns));
+    }
+  });
+}
+
+void
+NetworkThread::stop()
+{
+  if (!running.exchange(false))
+    return;
+  thread.join();
+  pass();
+}
+
+int
+NetworkThread::pick_sim() const
+{
+  return static_cast<int>(std::min_element(connection_counts.begin(), connection_counts.end()) -
+                          connection_counts.begin());
+}
+
+void
+NetworkThread::route(int sim, NetInbound&& in)
+{
+  if (overflow[sim].empty() && sims[sim]->inbound.try_push(std::move(in)))
+    return;
+  inbound_deferred.fetch_add(1, std::memory_order_relaxed);
+  overflow[sim].push_back(std::move(in));
+}
+
+bool
+NetworkThread::pass()
+{
+  PROFILE_ZONE("net_thread::pass");
+  bool busy = false;
+  passes.fetch_add(1, std::memory_order_relaxed);
+
+  // what the simulation threads sent, first: replies shouldn't wait behind new input
+  NetOutbound out;
+  sent_to.clear();
+  while (outbound.try_pop(out)) {
+    busy = true;
+    switch (out.type) {
+      case NetOutbound::Type::Send:
+        transport.send(out.conn, out.data->data(), static_cast<uint32_t>(out.data->size()), out.reliable);
+        sent_to.push_back(out.conn);
+        outbound_messages.fetch_add(1, std::memory_order_relaxed);
+        break;
+      case NetOutbound::Type::Close: {
+        // a simulation thread only closes its own connections, and hears nothing more about them
+        transport.close(out.conn, out.data->c_str());
+        auto it = owner.find(out.conn);
+        if (it != owner.end()) {
+          connection_counts[it->second] -= 1;
+          owner.erase(it);
+        }
+        break;
+      }
+      case NetOutbound::Type::SetName:
+        transport.set_name(out.conn, out.data->c_str());
+        break;
+    }
+    out.data.reset();
+  }
+  std::sort(sent_to.begin(), sent_to.end());
+  sent_to.erase(std::unique(sent_to.begin(), sent_to.end()), sent_to.end());
+  for (ConnectionId conn : sent_to)
+    transport.flush(conn);
+
+  // anything still waiting for room goes ahead of anything new
+  bool behind = false;
+  for (size_t i = 0; i < sims.size(); i++) {
+    std::deque<NetInbound>& waiting = overflow[i];
+    while (!waiting.empty() && sims[i]->inbound.try_push(std::move(waiting.front())))
+      waiting.pop_front();
+    behind |= !waiting.empty();
+  }
+
+  // events are never dropped, a simulation thread has to hear about every connect and disconnect
+  events.clear();
+  transport.poll_events(events);
+  for (TransportEvent& e : events) {
+    busy = true;
+    int sim = 0;
+    if (e.type == TransportEvent::Type::Connected) {
+      sim = pick_sim();
+      owner[e.conn] = sim;
+      connection_counts[sim] += 1;
+      route(sim, { NetInbound::Type::Connected, e.conn, false, std::move(e.description), "" });
+    } else {
+      auto it = owner.find(e.conn);
+      if (it == owner.end())
+        continue;
+      sim = it->second;
+      connection_counts[sim] -= 1;
+      owner.erase(it);
+      route(sim, { NetInbound::Type::Disconnected, e.conn, e.problem, std::move(e.description), std::move(e.reason) });
+    }
+  }
+
+  // and while a simulation thread is behind, messages stay in the transport rather than piling up here
+  if (behind)
+    receive_paused_passes.fetch_add(1, std::memory_order_relaxed);
+  else {
+    messages.clear();
+    transport.receive(messages);
+    for (const TransportMessage& m : messages) {
+      auto it = owner.find(m.conn);
+      if (it == owner.end())
+        continue;
+      busy = true;
+      route(it->second, { NetInbound::Type::Message, m.conn, false, std::string(m.payload), "" });
+    }
+    inbound_messages.fetch_add(messages.size(), std::memory_order_relaxed);
+  }
+
+  for (const auto& sim : sims)
+    raise_to(max_inbound_depth, sim->inbound.size());
+  connections.store(owner.size(), std::memory_order_relaxed);
+  return busy;
+}
+
+NetThreadStats
+NetworkThread::get_stats() const
+{
+  NetThreadStats s;
+  s.passes = passes.load(std::memory_order_relaxed);
+  s.inbound_messages = inbound_messages.load(std::memory_order_relaxed);
+  s.outbound_messages = outbound_messages.load(std::memory_order_relaxed);
+  s.inbound_deferred = inbound_deferred.load(std::memory_order_relaxed);
+  s.receive_paused_passes = receive_paused_passes.load(std::memory_order_relaxed);
+  s.max_inbound_depth = max_inbound_depth.load(std::memory_order_relaxed);
+  s.connections = connections.load(std::memory_order_relaxed);
+  return s;
+}
+
+} // namespace fightingengine
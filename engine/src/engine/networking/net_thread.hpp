@@ -0,0 +1,187 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+// c++ standard library headers
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// engine headers
+#include "engine/networking/transport.hpp"
+#include "engine/tools/mpsc_ring.hpp"
+#include "engine/tools/spsc_ring.hpp"
+
+namespace fightingengine {
+
+struct NetThreadConfig
+{
+  int sim_threads = 1;
+  size_t inbound_capacity = 4096;   // per simulation thread
+  size_t outbound_capacity = 16384; // shared by the simulation threads
+  // a simulation thread takes at most this much a tick, the rest waits for the next one,
+  // so a burst of connections or messages is spread over ticks rather than stalling one
+  int max_connects_per_tick = 16;
+  int max_inbound_per_tick = 4096;
+  uint64_t idle_sleep_ns = 250000; // the network thread, after a pass with nothing to do
+};
+
+// network thread -> simulation thread
+struct NetInbound
+{
+  enum class Type : uint8_t
+  {
+    Connected,
+    Disconnected,
+    Message,
+  };
+  Type type = Type::Message;
+  ConnectionId conn = invalid_connection;
+  bool problem = false;
+  std::string data; // the payload, or the event's description
+  std::string reason;
+};
+
+// simulation thread -> network thread
+struct NetOutbound
+{
+  enum class Type : uint8_t
+  {
+    Send,
+    Close,
+    SetName,
+  };
+  Type type = Type::Send;
+  bool reliable = false;
+  ConnectionId conn = invalid_connection;
+  std::shared_ptr<const std::string> data; // the payload (one copy for a broadcast), close reason or name
+};
+
+// Where the queues between the threads back up
+struct NetThreadStats
+{
+  uint64_t passes = 0;
+  uint64_t inbound_messages = 0;
+  uint64_t outbound_messages = 0;
+  uint64_t inbound_deferred = 0;      // found a simulation thread's queue full, and waited on the network thread
+  uint64_t receive_paused_passes = 0; // didn't receive from the transport, something was still waiting
+  uint64_t max_inbound_depth = 0;     // the fullest a simulation thread's queue has been
+  uint64_t connections = 0;
+};
+
+struct SimQueueStats
+{
+  uint64_t connects_deferred = 0;  // ticks that hit max_connects_per_tick with more waiting
+  uint64_t inbound_budget_hits = 0; // ticks that hit max_inbound_per_tick
+  uint64_t outbound_dropped = 0;   // unreliable, the outbound queue was full
+  uint64_t outbound_deferred = 0;  // reliable, the outbound queue was full, waited on the simulation thread
+};
+
+class NetworkThread;
+
+// A simulation thread's end of a NetworkThread, for a server running on that thread.
+// poll_events() takes this tick's share of the queue (events and messages both), receive() hands out its messages.
+// Sends never block: unreliable ones are dropped if the queue is full, reliable ones wait here and go in order.
+class SimQueueTransport : public Transport
+{
+public:
+  SimQueueTransport(const SimQueueTransport&) = delete;
+  SimQueueTransport& operator=(const SimQueueTransport&) = delete;
+
+  void poll_events(std::vector<TransportEvent>& events) override;
+  void receive(std::vector<TransportMessage>& messages) override;
+  bool send(ConnectionId conn, const void* data, uint32_t size, bool reliable) override;
+  int broadcast(const ConnectionId* conns, int count, const void* data, uint32_t size, bool reliable) override;
+  // the network thread flushes what it sends, this only retries what's waiting here
+  void flush(ConnectionId) override { flush_waiting(); }
+  void close(ConnectionId conn, const char* reason) override;
+  void set_name(ConnectionId conn, const char* name) override;
+
+  // any thread
+  [[nodiscard]] SimQueueStats get_stats() const;
+
+private:
+  friend class NetworkThread;
+  SimQueueTransport(const NetThreadConfig& config, MpscRing<NetOutbound>& outbound);
+
+  const NetThreadConfig& config;
+  SpscRing<NetInbound> inbound;
+  MpscRing<NetOutbound>& outbound;
+
+  std::vector<NetInbound> arrived; // messages taken by poll_events(), for receive()
+  std::vector<NetInbound> held;    // the payloads handed out by the last receive()
+  std::deque<NetOutbound> waiting; // reliable, for room in outbound
+
+  std::atomic<uint64_t> connects_deferred{ 0 };
+  std::atomic<uint64_t> inbound_budget_hits{ 0 };
+  std::atomic<uint64_t> outbound_dropped{ 0 };
+  std::atomic<uint64_t> outbound_deferred{ 0 };
+
+  bool push_in_order(NetOutbound&& out);
+  void flush_waiting();
+};
+
+// Owns a Transport on a thread of its own, and shares its connections between simulation threads
+// (each connection stays on one, the one with the fewest when it connected).
+// A slow tick only delays its own clients, and a burst of connections queues up instead of stalling a tick:
+//   NetworkThread net(transport, config);
+//   net.start();
+//   simulation thread i: Server server(net.get_sim_transport(i)); every tick: server.tick()
+//   net.stop();
+class NetworkThread
+{
+public:
+  NetworkThread(Transport& transport, const NetThreadConfig& config = NetThreadConfig());
+  ~NetworkThread();
+  NetworkThread(const NetworkThread&) = delete;
+  NetworkThread& operator=(const NetworkThread&) = delete;
+
+  // runs pass() on a thread of its own until stop()
+  void start();
+  // then one more pass on this thread, for anything sent since
+  void stop();
+
+  // sends what the simulation threads queued, then hands out events and messages.
+  // call this instead of start() to run it on a thread of your own. true if there was anything to do
+  bool pass();
+
+  [[nodiscard]] SimQueueTransport& get_sim_transport(int index) { return *sims[index]; }
+  [[nodiscard]] int get_sim_count() const { return static_cast<int>(sims.size()); }
+  // any thread
+  [[nodiscard]] NetThreadStats get_stats() const;
+
+private:
+  Transport& transport;
+  NetThreadConfig config;
+  MpscRing<NetOutbound> outbound;
+  std::vector<std::unique_ptr<SimQueueTransport>> sims;
+  std::vector<std::deque<NetInbound>> overflow; // per simulation thread, waiting for room in its queue
+  std::vector<int> connection_counts;           // per simulation thread
+  std::unordered_map<ConnectionId, int> owner;
+
+  std::thread thread;
+  std::atomic<bool> running{ false };
+
+  // reused every pass
+  std::vector<TransportEvent> events;
+  std::vector<TransportMessage> messages;
+  std::vector<ConnectionId> sent_to;
+
+  std::atomic<uint64_t> passes{ 0 };
+  std::atomic<uint64_t> inbound_messages{ 0 };
+  std::atomic<uint64_t> outbound_messages{ 0 };
+  std::atomic<uint64_t> inbound_deferred{ 0 };
+  std::atomic<uint64_t> receive_paused_passes{ 0 };
+  std::atomic<uint64_t> max_inbound_depth{ 0 };
+  std::atomic<uint64_t> connections{ 0 };
+
+  void route(int sim, NetInbound&& in);
+  [[nodiscard]] int pick_sim() const;
+};
+
+} // namespace fightingengine
@@ -0,0 +1,464 @@
+// header
+#include "engine/networking/snapshot.hpp"
+
+// c system headers
+#include <cassert>
+#include <cmath>
+
+// c++ standard library headers
+#include <algorithm>
+
+namespace fightingengine {
+
+static constexpr float two_pi = 6.28318530718f;
+
+enum FieldMask : uint32_t
+{
+  FIELD_POS = 1 << 0,
+  FIELD_ANGLE = 1 << 1,
+  FIELD_VEL = 1 << 2,
+  FIELD_STATE = 1 << 3, // type, flags, health
+
+  FIELD_COUNT = 4
+};
+
+bool
+NetEntityState::operator==(const NetEntityState& other) const
+{
+  return id == other.id && type == other.type && flags == other.flags && health == other.health &&
+         angle == other.angle && pos_x == other.pos_x && pos_y == other.pos_y && vel_x == other.vel_x &&
+         vel_y == other.vel_y;
+}
+
+//
+// SnapshotHistory
+//
+
+SnapshotHistory::SnapshotHistory(size_t capacity)
+  : slots(capacity > 0 ? capacity : 1)
+{}
+
+void
+SnapshotHistory::add(const Snapshot& snapshot)
+{
+  Slot& slot = slots[snapshot.tick % slots.size()];
+  slot.valid = true;
+  slot.snapshot = snapshot;
+}
+
+const Snapshot*
+SnapshotHistory::find(uint32_t tick) const
+{
+  const Slot& slot = slots[tick % slots.size()];
+  if (slot.valid && slot.snapshot.tick == tick)
+    return &slot.snapshot;
+  return nullptr;
+}
+
+void
+SnapshotHistory::clear()
+{
+  for (Slot& slot : slots)
+    slot.valid = false;
+}
+
+namespace snapshot {
+
+static int32_t
+clamp_signed(const float value, const int bits)
+{
+  const float max = static_cast<float>((1 << (bits - 1)) - 1);
+  return static_cast<int32_t>(std::lround(std::clamp(value, -max, max)));
+}
+
+static bool
+fits_signed(const int32_t value, const int bits)
+{
+  const int32_t max = (1 << (bits - 1)) - 1;
+  return value >= -max && value <= max;
+}
+
+int32_t
+quantise_position(const SnapshotSchema& schema, float pixels)
+{
+  return clamp_signed(pixels / schema.pos_resolution, schema.pos_bits);
+}
+
+float
+dequantise_position(const SnapshotSchema& schema, int32_t value)
+{
+  return static_cast<float>(value) * schema.pos_resolution;
+}
+
+int32_t
+quantise_velocity(const SnapshotSchema& schema, float pixels_per_second)
+{
+  return clamp_signed(pixels_per_second / schema.vel_resolution, schema.vel_bits);
+}
+
+float
+dequantise_velocity(const SnapshotSchema& schema, int32_t value)
+{
+  return static_cast<float>(value) * schema.vel_resolution;
+}
+
+uint16_t
+quantise_angle(const SnapshotSchema& schema, float radians)
+{
+  const uint32_t steps = 1u << schema.angle_bits;
+  float wrapped = std::fmod(radians, two_pi);
+  if (wrapped < 0.0f)
+    wrapped += two_pi;
+  uint32_t value = static_cast<uint32_t>(std::lround(wrapped / two_pi * steps));
+  return static_cast<uint16_t>(value & (steps - 1));
+}
+
+float
+dequantise_angle(const SnapshotSchema& schema, uint16_t value)
+{
+  return static_cast<float>(value) / static_cast<float>(1u << schema.angle_bits) * two_pi;
+}
+
+void
+sort_by_id(Snapshot& snapshot)
+{
+  std::sort(snapshot.entities.begin(),
+            snapshot.entities.end(),
+            [](const NetEntityState& a, const NetEntityState& b) { return a.id < b.id; });
+}
+
+const NetEntityState*
+find_entity(const Snapshot& snapshot, uint32_t id)
+{
+  auto it = std::lower_bound(snapshot.entities.begin(),
+                             snapshot.entities.end(),
+                             id,
+                             [](const NetEntityState& e, uint32_t id) { return e.id < id; });
+  if (it != snapshot.entities.end() && it->id == id)
+    return &(*it);
+  return nullptr;
+}
+
+//
+// encode
+//
+
+static void
+write_state(const SnapshotSchema& schema, const NetEntityState& e, BitWriter& out)
+{
+  out.write_bits(e.type, schema.type_bits);
+  out.write_bits(e.flags, schema.flag_bits);
+  out.write_bits(e.health, schema.health_bits);
+}
+
+static void
+write_full(const SnapshotSchema& schema, const NetEntityState& e, BitWriter& out)
+{
+  write_state(schema, e, out);
+  out.write_signed(e.pos_x, schema.pos_bits);
+  out.write_signed(e.pos_y, schema.pos_bits);
+  out.write_bits(e.angle, schema.angle_bits);
+  out.write_signed(e.vel_x, schema.vel_bits);
+  out.write_signed(e.vel_y, schema.vel_bits);
+}
+
+static uint32_t
+get_changed_fields(const NetEntityState& e, const NetEntityState& base)
+{
+  uint32_t mask = 0;
+  if (e.pos_x != base.pos_x || e.pos_y != base.pos_y)
+    mask |= FIELD_POS;
+  if (e.angle != base.angle)
+    mask |= FIELD_ANGLE;
+  if (e.vel_x != base.vel_x || e.vel_y != base.vel_y)
+    mask |= FIELD_VEL;
+  if (e.type != base.type || e.flags != base.flags || e.health != base.health)
+    mask |= FIELD_STATE;
+  return mask;
+}
+
+int
+get_entity_bits(const SnapshotSchema& schema, const NetEntityState& e, const NetEntityState* base)
+{
+  const int state_bits = schema.type_bits + schema.flag_bits + schema.health_bits;
+  if (base == nullptr)
+    return state_bits + 2 * schema.pos_bits + schema.angle_bits + 2 * schema.vel_bits;
+
+  const uint32_t mask = get_changed_fields(e, *base);
+  if (mask == 0)
+    return 0;
+  int bits = FIELD_COUNT;
+  if (mask & FIELD_POS) {
+    const bool small = fits_signed(e.pos_x - base->pos_x, schema.pos_delta_bits) &&
+                       fits_signed(e.pos_y - base->pos_y, schema.pos_delta_bits);
+    bits += 1 + 2 * (small ? schema.pos_delta_bits : schema.pos_bits);
+  }
+  if (mask & FIELD_ANGLE)
+    bits += schema.angle_bits;
+  if (mask & FIELD_VEL)
+    bits += 2 * schema.vel_bits;
+  if (mask & FIELD_STATE)
+    bits += state_bits;
+  return bits;
+}
+
+int
+get_id_bits(uint32_t id, uint32_t prev_id)
+{
+  return BitWriter::get_varuint_bits(id - prev_id);
+}
+
+static void
+write_changes(const SnapshotSchema& schema,
+              const NetEntityState& e,
+              const NetEntityState& base,
+              uint32_t mask,
+              BitWriter& out)
+{
+  out.write_bits(mask, FIELD_COUNT);
+  if (mask & FIELD_POS) {
+    const int32_t dx = e.pos_x - base.pos_x;
+    const int32_t dy = e.pos_y - base.pos_y;
+    const bool small = fits_signed(dx, schema.pos_delta_bits) && fits_signed(dy, schema.pos_delta_bits);
+    out.write_bool(small);
+    if (small) {
+      out.write_signed(dx, schema.pos_delta_bits);
+      out.write_signed(dy, schema.pos_delta_bits);
+    } else {
+      out.write_signed(e.pos_x, schema.pos_bits);
+      out.write_signed(e.pos_y, schema.pos_bits);
+    }
+  }
+  if (mask & FIELD_ANGLE)
+    out.write_bits(e.angle, schema.angle_bits);
+  if (mask & FIELD_VEL) {
+    out.write_signed(e.vel_x, schema.vel_bits);
+    out.write_signed(e.vel_y, schema.vel_bits);
+  }
+  if (mask & FIELD_STATE)
+    write_state(schema, e, out);
+}
+
+void
+encode(const SnapshotSchema& schema, const Snapshot& current, const Snapshot* baseline, BitWriter& out)
+{
+  assert(std::is_sorted(current.entities.begin(),
+                        current.entities.end(),
+                        [](const NetEntityState& a, const NetEntityState& b) { return a.id < b.id; }));
+
+  out.write_bits(current.tick, 32);
+  out.write_bool(baseline != nullptr);
+  if (baseline == nullptr) {
+    out.write_varuint(static_cast<uint32_t>(current.entities.size()));
+    uint32_t prev_id = 0;
+    for (const NetEntityState& e : current.entities) {
+      out.write_varuint(e.id - prev_id);
+      prev_id = e.id;
+      write_full(schema, e, out);
+    }
+    out.flush();
+    return;
+  }
+  out.write_bits(baseline->tick, 32);
+
+  // walk both lists by id: in baseline only is removed, in current only is new
+  std::vector<uint32_t> removed;
+  std::vector<const NetEntityState*> changed;
+  std::vector<uint32_t> changed_masks; // 0 for new
+  size_t b = 0;
+  for (const NetEntityState& e : current.entities) {
+    while (b < baseline->entities.size() && baseline->entities[b].id < e.id)
+      removed.push_back(baseline->entities[b++].id);
+    if (b < baseline->entities.size() && baseline->entities[b].id == e.id) {
+      const uint32_t mask = get_changed_fields(e, baseline->entities[b++]);
+      if (mask != 0) {
+        changed.push_back(&e);
+        changed_masks.push_back(mask);
+      }
+    } else {
+      changed.push_back(&e);
+      changed_masks.push_back(0);
+    }
+  }
+  for (; b < baseline->entities.size(); b++)
+    removed.push_back(baseline->entities[b].id);
+
+  out.write_varuint(static_cast<uint32_t>(removed.size()));
+  uint32_t prev_id = 0;
+  for (uint32_t id : removed) {
+    out.write_varuint(id - prev_id);
+    prev_id = id;
+  }
+
+  out.write_varuint(static_cast<uint32_t>(changed.size()));
+  prev_id = 0;
+  for (size_t i = 0; i < changed.size(); i++) {
+    const NetEntityState& e = *changed[i];
+    out.write_varuint(e.id - prev_id);
+    prev_id = e.id;
+    const bool is_new = changed_masks[i] == 0;
+    out.write_bool(is_new);
+    if (is_new)
+      write_full(schema, e, out);
+    else
+      write_changes(schema, e, *find_entity(*baseline, e.id), changed_masks[i], out);
+  }
+  out.flush();
+}
+
+void
+encode_for_client(const SnapshotSchema& schema,
+                  const Snapshot& current,
+                  const SnapshotHistory& sent,
+                  const SnapshotClientState& client,
+                  BitWriter& out)
+{
+  const Snapshot* baseline = client.has_ack ? sent.find(client.acked_tick) : nullptr;
+  encode(schema, current, baseline, out);
+}
+
+void
+on_ack(SnapshotClientState& client, uint32_t tick)
+{
+  // tick is newer if it's ahead, allowing for wrap around
+  if (!client.has_ack || static_cast<int32_t>(tick - client.acked_tick) > 0) {
+    client.has_ack = true;
+    client.acked_tick = tick;
+  }
+}
+
+//
+// decode
+//
+
+static void
+read_state(const SnapshotSchema& schema, BitReader& in, NetEntityState& e)
+{
+  e.type = static_cast<uint8_t>(in.read_bits(schema.type_bits));
+  e.flags = static_cast<uint8_t>(in.read_bits(schema.flag_bits));
+  e.health = static_cast<uint8_t>(in.read_bits(schema.health_bits));
+}
+
+static void
+read_full(const SnapshotSchema& schema, BitReader& in, NetEntityState& e)
+{
+  read_state(schema, in, e);
+  e.pos_x = in.read_signed(schema.pos_bits);
+  e.pos_y = in.read_signed(schema.pos_bits);
+  e.angle = static_cast<uint16_t>(in.read_bits(schema.angle_bits));
+  e.vel_x = in.read_signed(schema.vel_bits);
+  e.vel_y = in.read_signed(schema.vel_bits);
+}
+
+static void
+read_changes(const SnapshotSchema& schema, BitReader& in, NetEntityState& e)
+{
+  const uint32_t mask = in.read_bits(FIELD_COUNT);
+  if (mask & FIELD_POS) {
+    if (in.read_bool()) {
+      e.pos_x += in.read_signed(schema.pos_delta_bits);
+      e.pos_y += in.read_signed(schema.pos_delta_bits);
+    } else {
+      e.pos_x = in.read_signed(schema.pos_bits);
+      e.pos_y = in.read_signed(schema.pos_bits);
+    }
+  }
+  if (mask & FIELD_ANGLE)
+    e.angle = static_cast<uint16_t>(in.read_bits(schema.angle_bits));
+  if (mask & FIELD_VEL) {
+    e.vel_x = in.read_signed(schema.vel_bits);
+    e.vel_y = in.read_signed(schema.vel_bits);
+  }
+  if (mask & FIELD_STATE)
+    read_state(schema, in, e);
+}
+
+// a count can't be more than the bits left, so garbage can't make us allocate gigabytes
+static bool
+read_count(BitReader& in, uint32_t& count)
+{
+  count = in.read_varuint();
+  return !in.is_overflowed() && count <= in.get_bits_remaining();
+}
+
+bool
+decode(const SnapshotSchema& schema, BitReader& in, const SnapshotHistory& received, Snapshot& out)
+{
+  out.tick = in.read_bits(32);
+  out.entities.clear();
+  const bool has_baseline = in.read_bool();
+
+  if (!has_baseline) {
+    uint32_t count = 0;
+    if (!read_count(in, count))
+      return false;
+    out.entities.resize(count);
+    uint32_t prev_id = 0;
+    for (NetEntityState& e : out.entities) {
+      e.id = prev_id + in.read_varuint();
+      prev_id = e.id;
+      read_full(schema, in, e);
+    }
+    return !in.is_overflowed();
+  }
+
+  const Snapshot* baseline = received.find(in.read_bits(32));
+  if (baseline == nullptr || in.is_overflowed())
+    return false;
+
+  uint32_t removed_count = 0;
+  if (!read_count(in, removed_count))
+    return false;
+  std::vector<uint32_t> removed(removed_count);
+  uint32_t prev_id = 0;
+  for (uint32_t& id : removed) {
+    id = prev_id + in.read_varuint();
+    prev_id = id;
+  }
+
+  uint32_t changed_count = 0;
+  if (!read_count(in, changed_count))
+    return false;
+  std::vector<NetEntityState> changed(changed_count);
+  prev_id = 0;
+  for (NetEntityState& e : changed) {
+    const uint32_t id = prev_id + in.read_varuint();
+    prev_id = id;
+    if (in.read_bool())
+      read_full(schema, in, e);
+    else {
+      const NetEntityState* base = find_entity(*baseline, id);
+      if (base == nullptr)
+        return false;
+      e = *base;
+      read_changes(schema, in, e);
+    }
+    e.id = id;
+  }
+  if (in.is_overflowed())
+    return false;
+
+  // merge: baseline, minus removed, with changed replacing or adding
+  out.entities.reserve(baseline->entities.size() + changed.size());
+  size_t r = 0;
+  size_t c = 0;
+  for (const NetEntityState& base : baseline->entities) {
+    while (c < changed.size() && changed[c].id < base.id)
+      out.entities.push_back(changed[c++]);
+    while (r < removed.size() && removed[r] < base.id)
+      r++;
+    if (r < removed.size() && removed[r] == base.id)
+      continue;
+    if (c < changed.size() && changed[c].id == base.id)
+      out.entities.push_back(changed[c++]);
+    else
+      out.entities.push_back(base);
+  }
+  for (; c < changed.size(); c++)
+    out.entities.push_back(changed[c]);
+  return true;
+}
+
+} // namespace snapshot
+
+} // namespace fightingengine
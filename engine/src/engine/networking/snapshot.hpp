@@ -0,0 +1,148 @@
+#pragma once
+
+// c system headers
+#include <cstddef>
+#include <cstdint>
+
+// c++ standard library headers
+#include <vector>
+
+// engine headers
+#include "engine/networking/bitstream.hpp"
+
+namespace fightingengine {
+
+// How entity state is quantised on the wire. Both ends must use the same schema.
+struct SnapshotSchema
+{
+  float pos_resolution = 0.125f; // pixels per step
+  int pos_bits = 22;             // signed, so +-262144 pixels at the default resolution
+  int pos_delta_bits = 8;        // signed, moves smaller than this go as a delta from the baseline
+  float vel_resolution = 0.25f;  // pixels per second per step
+  int vel_bits = 16;             // signed
+  int angle_bits = 10;
+  int type_bits = 4;
+  int flag_bits = 8;
+  int health_bits = 8;
+};
+
+// One replicated entity, already quantised (see snapshot::quantise_*),
+// so the sender and receiver compare exactly the same values.
+struct NetEntityState
+{
+  uint32_t id = 0;
+  uint8_t type = 0;   // game defined, e.g. collision layer
+  uint8_t flags = 0;  // game defined bits
+  uint8_t health = 0; // game defined
+  uint16_t angle = 0;
+  int32_t pos_x = 0;
+  int32_t pos_y = 0;
+  int32_t vel_x = 0;
+  int32_t vel_y = 0;
+
+  bool operator==(const NetEntityState& other) const;
+  bool operator!=(const NetEntityState& other) const { return !(*this == other); }
+};
+
+// The replicated world at one tick. entities are sorted by id.
+struct Snapshot
+{
+  uint32_t tick = 0;
+  std::vector<NetEntityState> entities;
+};
+
+// The last few snapshots, looked up by tick. The server keeps the ones it sent,
+// the client keeps the ones it received, so both can find the same baseline.
+class SnapshotHistory
+{
+public:
+  explicit SnapshotHistory(size_t capacity = 64);
+
+  // replaces whatever was in the slot for this tick
+  void add(const Snapshot& snapshot);
+  [[nodiscard]] const Snapshot* find(uint32_t tick) const;
+  void clear();
+
+  [[nodiscard]] size_t get_capacity() const { return slots.size(); }
+
+private:
+  struct Slot
+  {
+    bool valid = false;
+    Snapshot snapshot;
+  };
+  std::vector<Slot> slots;
+};
+
+// What the server knows about one client's copy of the world
+struct SnapshotClientState
+{
+  bool has_ack = false;
+  uint32_t acked_tick = 0; // newest snapshot the client decoded
+};
+
+namespace snapshot {
+
+// the wire format is:
+//   tick, has baseline (+ baseline tick)
+//   removed ids, delta coded
+//   changed entities: id delta, new or not, then every field (new) or a mask of changed fields
+// entities that didn't change since the baseline cost nothing.
+
+[[nodiscard]] int32_t
+quantise_position(const SnapshotSchema& schema, float pixels);
+[[nodiscard]] float
+dequantise_position(const SnapshotSchema& schema, int32_t value);
+
+[[nodiscard]] int32_t
+quantise_velocity(const SnapshotSchema& schema, float pixels_per_second);
+[[nodiscard]] float
+dequantise_velocity(const SnapshotSchema& schema, int32_t value);
+
+// any angle, wrapped in to [0, 2pi)
+[[nodiscard]] uint16_t
+quantise_angle(const SnapshotSchema& schema, float radians);
+[[nodiscard]] float
+dequantise_angle(const SnapshotSchema& schema, uint16_t value);
+
+void
+sort_by_id(Snapshot& snapshot);
+
+// binary search, snapshot must be sorted by id
+[[nodiscard]] const NetEntityState*
+find_entity(const Snapshot& snapshot, uint32_t id);
+
+// what encode() spends on e against its baseline entity (null if it's new), not counting its id.
+// 0 if nothing changed
+[[nodiscard]] int
+get_entity_bits(const SnapshotSchema& schema, const NetEntityState& e, const NetEntityState* base);
+
+// what encode() spends on an id, written as the delta from the id before it in the same list
+// (0 for the first). a changed entity has an is new bit on top when there's a baseline
+[[nodiscard]] int
+get_id_bits(uint32_t id, uint32_t prev_id);
+
+// baseline can be null, for a full snapshot. current must be sorted by id.
+void
+encode(const SnapshotSchema& schema, const Snapshot& current, const Snapshot* baseline, BitWriter& out);
+
+// baselines are looked up in received. returns false if the data is malformed
+// or its baseline isn't in received any more (the sender will fall back to a full snapshot)
+bool
+decode(const SnapshotSchema& schema, BitReader& in, const SnapshotHistory& received, Snapshot& out);
+
+// encodes against the newest snapshot the client acked, if sent still has it
+void
+encode_for_client(const SnapshotSchema& schema,
+                  const Snapshot& current,
+                  const SnapshotHistory& sent,
+                  const SnapshotClientState& client,
+                  BitWriter& out);
+
+// acks can arrive out of order, only newer ones move the baseline forward
+void
+on_ack(SnapshotClientState& client, uint32_t tick);
+
+} // namespace snapshot
+
+} // namespace fightingengine
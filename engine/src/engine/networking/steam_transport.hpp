@@ -0,0 +1,189 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+// c++ standard library headers
+#include <string_view>
+#include <vector>
+
+// engine headers
+#include "engine/networking/net_batch.hpp"
+#include "engine/networking/transport.hpp"
+
+// other lib headers
+#include <steam/isteamnetworkingutils.h>
+#include <steam/steamnetworkingsockets.h>
+
+// A fightingengine::Transport over GameNetworkingSockets, for a server.
+// Like net_common.hpp, define STEAMNETWORKINGSOCKETS_OPENSOURCE before including this.
+
+namespace net_common {
+
+// Listens on a port, accepts every connection and puts it in one poll group.
+// A connection's ConnectionId is its HSteamNetConnection.
+// Only one can poll_events() at a time: the library's status callback is a plain function.
+class SteamServerTransport : public fightingengine::Transport
+{
+public:
+  SteamServerTransport()
+    : iface(SteamNetworkingSockets())
+  {}
+  ~SteamServerTransport() override { shutdown(); }
+  SteamServerTransport(const SteamServerTransport&) = delete;
+  SteamServerTransport& operator=(const SteamServerTransport&) = delete;
+
+  // false if the port can't be listened on
+  bool listen(uint16 port)
+  {
+    SteamNetworkingIPAddr local_addr;
+    local_addr.Clear();
+    local_addr.m_port = port;
+    SteamNetworkingConfigValue_t opt;
+    opt.SetPtr(k_ESteamNetworkingConfig_Callback_ConnectionStatusChanged, (void*)on_status_changed_callback);
+    listen_socket = iface->CreateListenSocketIP(local_addr, 1, &opt);
+    if (listen_socket == k_HSteamListenSocket_Invalid)
+      return false;
+    poll_group = iface->CreatePollGroup();
+    return poll_group != k_HSteamNetPollGroup_Invalid;
+  }
+
+  // stops listening. close() every connection first to let them linger
+  void shutdown()
+  {
+    release_held();
+    if (listen_socket != k_HSteamListenSocket_Invalid)
+      iface->CloseListenSocket(listen_socket);
+    listen_socket = k_HSteamListenSocket_Invalid;
+    if (poll_group != k_HSteamNetPollGroup_Invalid)
+      iface->DestroyPollGroup(poll_group);
+    poll_group = k_HSteamNetPollGroup_Invalid;
+  }
+
+  void poll_events(std::vector<fightingengine::TransportEvent>& events) override
+  {
+    pending_events = &events;
+    callback_instance() = this;
+    iface->RunCallbacks();
+    callback_instance() = nullptr;
+    pending_events = nullptr;
+  }
+
+  void receive(std::vector<fightingengine::TransportMessage>& messages) override
+  {
+    release_held();
+    if (poll_group == k_HSteamNetPollGroup_Invalid)
+      return;
+
+    SteamNetworkingMessage_t* batch[ReceiveBatch::max_messages];
+    for (;;) {
+      const int n = iface->ReceiveMessagesOnPollGroup(poll_group, batch, ReceiveBatch::max_messages);
+      for (int i = 0; i < n; i++) {
+        held.push_back(batch[i]);
+        const std::string_view payload(static_cast<const char*>(batch[i]->m_pData), batch[i]->m_cbSize);
+        messages.push_back({ batch[i]->m_conn, payload });
+      }
+      // a batch that isn't full means there's nothing else waiting
+      if (n < ReceiveBatch::max_messages)
+        break;
+    }
+  }
+
+  bool send(fightingengine::ConnectionId conn, const void* data, uint32_t size, bool reliable) override
+  {
+    const int flags = reliable ? k_nSteamNetworkingSend_Reliable : k_nSteamNetworkingSend_Unreliable;
+    return iface->SendMessageToConnection(conn, data, size, flags, nullptr) == k_EResultOK;
+  }
+
+  int broadcast(const fightingengine::ConnectionId* conns,
+                int count,
+                const void* data,
+                uint32_t size,
+                bool reliable) override
+  {
+    // a ConnectionId is a HSteamNetConnection
+    const int flags = reliable ? k_nSteamNetworkingSend_Reliable : k_nSteamNetworkingSend_Unreliable;
+    return net_common::broadcast(iface, conns, count, data, size, flags).failed;
+  }
+
+  void flush(fightingengine::ConnectionId conn) override { iface->FlushMessagesOnConnection(conn); }
+
+  // linger, so what's queued still goes out
+  void close(fightingengine::ConnectionId conn, const char* reason) override
+  {
+    iface->CloseConnection(conn, 0, reason, true);
+  }
+
+  void set_name(fightingengine::ConnectionId conn, const char* name) override
+  {
+    iface->SetConnectionName(conn, name);
+  }
+
+private:
+  ISteamNetworkingSockets* iface = nullptr;
+  HSteamListenSocket listen_socket = k_HSteamListenSocket_Invalid;
+  HSteamNetPollGroup poll_group = k_HSteamNetPollGroup_Invalid;
+  std::vector<SteamNetworkingMessage_t*> held; // the payloads handed out by the last receive()
+  std::vector<fightingengine::TransportEvent>* pending_events = nullptr;
+
+  void release_held()
+  {
+    for (SteamNetworkingMessage_t* msg : held)
+      msg->Release();
+    held.clear();
+  }
+
+  void on_status_changed(SteamNetConnectionStatusChangedCallback_t* info)
+  {
+    const HSteamNetConnection conn = info->m_hConn;
+    switch (info->m_info.m_eState) {
+      case k_ESteamNetworkingConnectionState_ClosedByPeer:
+      case k_ESteamNetworkingConnectionState_ProblemDetectedLocally: {
+        // only news if it was accepted. either way it has to be closed on this end to be destroyed
+        if (info->m_eOldState == k_ESteamNetworkingConnectionState_Connected) {
+          fightingengine::TransportEvent e;
+          e.type = fightingengine::TransportEvent::Type::Disconnected;
+          e.conn = conn;
+          e.problem = info->m_info.m_eState == k_ESteamNetworkingConnectionState_ProblemDetectedLocally;
+          e.description = info->m_info.m_szConnectionDescription;
+          e.reason = info->m_info.m_szEndDebug;
+          pending_events->push_back(std::move(e));
+        }
+        iface->CloseConnection(conn, 0, nullptr, false);
+        break;
+      }
+
+      case k_ESteamNetworkingConnectionState_Connecting: {
+        // accepting can fail if the client has already gone
+        if (iface->AcceptConnection(conn) != k_EResultOK || !iface->SetConnectionPollGroup(conn, poll_group)) {
+          iface->CloseConnection(conn, 0, nullptr, false);
+          break;
+        }
+        fightingengine::TransportEvent e;
+        e.type = fightingengine::TransportEvent::Type::Connected;
+        e.conn = conn;
+        e.description = info->m_info.m_szConnectionDescription;
+        pending_events->push_back(std::move(e));
+        break;
+      }
+
+      default:
+        // None (destroyed connections) and Connected (right after accepting) aren't news
+        break;
+    }
+  }
+
+  static SteamServerTransport*& callback_instance()
+  {
+    static SteamServerTransport* instance = nullptr;
+    return instance;
+  }
+
+  static void on_status_changed_callback(SteamNetConnectionStatusChangedCallback_t* info)
+  {
+    if (callback_instance() != nullptr)
+      callback_instance()->on_status_changed(info);
+  }
+};
+
+} // namespace net_common
@@ -0,0 +1,63 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+// c++ standard library headers
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fightingengine {
+
+// on each end, one id per connection. 0 is never a connection
+using ConnectionId = uint32_t;
+constexpr ConnectionId invalid_connection = 0;
+
+struct TransportEvent
+{
+  enum class Type : uint8_t
+  {
+    Connected,
+    Disconnected,
+  };
+  Type type = Type::Connected;
+  ConnectionId conn = invalid_connection;
+  bool problem = false;    // Disconnected: dropped by a problem, rather than closed by the peer
+  std::string description; // who, for logs
+  std::string reason;      // Disconnected: why
+};
+
+struct TransportMessage
+{
+  ConnectionId conn = invalid_connection;
+  std::string_view payload; // valid until the next receive()
+};
+
+// What a server or client needs from the network, so the same code can run over
+// real sockets (SteamServerTransport) or in process (LoopbackNetwork).
+// Everything is called from one thread.
+class Transport
+{
+public:
+  virtual ~Transport() = default;
+
+  // connections that opened or closed since the last call, appended to events
+  virtual void poll_events(std::vector<TransportEvent>& events) = 0;
+  // every message that arrived since the last call, appended to messages.
+  // the last call's payloads are released
+  virtual void receive(std::vector<TransportMessage>& messages) = 0;
+
+  virtual bool send(ConnectionId conn, const void* data, uint32_t size, bool reliable) = 0;
+  // one copy of the payload to every connection in conns. returns how many sends failed
+  virtual int broadcast(const ConnectionId* conns, int count, const void* data, uint32_t size, bool reliable) = 0;
+  // sends what's queued for conn now, rather than waiting to batch it with more
+  virtual void flush(ConnectionId conn) = 0;
+  // sends what's already queued, then closes. there's no Disconnected event for this end
+  virtual void close(ConnectionId conn, const char* reason) = 0;
+
+  // for debugging
+  virtual void set_name(ConnectionId, const char*) {}
+};
+
+} // namespace fightingengine
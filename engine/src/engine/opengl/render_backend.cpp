@@ -0,0 +1,370 @@
+// header
+#include "engine/opengl/render_backend.hpp"
+
+// c++ standard library headers
+#include <iostream>
+
+// other library headers
+#include <GL/glew.h>
+#include <SDL2/SDL.h>
+
+// your project headers
+#include "engine/opengl/shader.hpp"
+
+namespace fightingengine {
+
+static GLenum
+gl_target(BufferTarget target)
+{
+  switch (target) {
+    case BufferTarget::ARRAY:
+      return GL_ARRAY_BUFFER;
+    case BufferTarget::ELEMENT:
+      return GL_ELEMENT_ARRAY_BUFFER;
+    case BufferTarget::UNIFORM:
+      return GL_UNIFORM_BUFFER;
+  }
+  return GL_ARRAY_BUFFER;
+}
+
+void
+GLRenderBackend::init()
+{
+  // Enable Multi Sampling
+  SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
+  SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
+  glEnable(GL_MULTISAMPLE);
+
+  // Enable Faceculling
+  // glEnable(GL_CULL_FACE);
+  // glDisable(GL_CULL_FACE);
+  glDepthFunc(GL_LESS);
+
+  // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+}
+
+//
+// state
+//
+
+void
+GLRenderBackend::set_viewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+  glViewport(x, y, width, height);
+}
+
+void
+GLRenderBackend::set_clear_colour(const glm::vec4& colour)
+{
+  glClearColor(colour.r, colour.g, colour.b, colour.a);
+}
+
+void
+GLRenderBackend::clear()
+{
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void
+GLRenderBackend::set_depth_testing(bool toggle)
+{
+  if (toggle)
+    glEnable(GL_DEPTH_TEST);
+  else
+    glDisable(GL_DEPTH_TEST);
+}
+
+void
+GLRenderBackend::set_blending(bool toggle)
+{
+  if (toggle)
+    glEnable(GL_BLEND);
+  else
+    glDisable(GL_BLEND);
+}
+
+void
+GLRenderBackend::set_blend_func(unsigned int src_rgb, unsigned int dst_rgb, unsigned int src_a, unsigned int dst_a)
+{
+  glBlendFuncSeparate(src_rgb, dst_rgb, src_a, dst_a);
+}
+
+void
+GLRenderBackend::use_program(unsigned int program)
+{
+  glUseProgram(program);
+}
+
+void
+GLRenderBackend::bind_vertex_array(unsigned int vao)
+{
+  glBindVertexArray(vao);
+}
+
+void
+GLRenderBackend::bind_buffer(BufferTarget target, unsigned int buffer)
+{
+  glBindBuffer(gl_target(target), buffer);
+}
+
+void
+GLRenderBackend::bind_buffer_base(unsigned int binding, unsigned int buffer)
+{
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+}
+
+void
+GLRenderBackend::bind_texture(int unit, unsigned int texture)
+{
+  glActiveTexture(GL_TEXTURE0 + unit);
+  glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void
+GLRenderBackend::bind_framebuffer(unsigned int fbo)
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+}
+
+//
+// resources
+//
+
+unsigned int
+GLRenderBackend::create_vertex_array()
+{
+  unsigned int vao;
+  glGenVertexArrays(1, &vao);
+  return vao;
+}
+
+unsigned int
+GLRenderBackend::create_buffer()
+{
+  unsigned int buffer;
+  glGenBuffers(1, &buffer);
+  return buffer;
+}
+
+unsigned int
+GLRenderBackend::create_texture(int width, int height)
+{
+  // restore the binding afterwards, so RenderCommand's cached state stays valid
+  GLint previous = 0;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+
+  unsigned int texture;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  glBindTexture(GL_TEXTURE_2D, previous);
+  return texture;
+}
+
+unsigned int
+GLRenderBackend::create_framebuffer(unsigned int colour_texture)
+{
+  GLint previous = 0;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+
+  unsigned int fbo;
+  glGenFramebuffers(1, &fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colour_texture, 0);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    std::cerr << "framebuffer " << fbo << " incomplete" << std::endl;
+
+  glBindFramebuffer(GL_FRAMEBUFFER, previous);
+  return fbo;
+}
+
+void
+GLRenderBackend::delete_vertex_array(unsigned int vao)
+{
+  glDeleteVertexArrays(1, &vao);
+}
+
+void
+GLRenderBackend::delete_buffer(unsigned int buffer)
+{
+  glDeleteBuffers(1, &buffer);
+}
+
+void
+GLRenderBackend::delete_texture(unsigned int texture)
+{
+  glDeleteTextures(1, &texture);
+}
+
+void
+GLRenderBackend::delete_framebuffer(unsigned int fbo)
+{
+  glDeleteFramebuffers(1, &fbo);
+}
+
+void
+GLRenderBackend::buffer_data(BufferTarget target, size_t size, const void* data, BufferUsage usage)
+{
+  glBufferData(gl_target(target), size, data, usage == BufferUsage::STATIC ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW);
+}
+
+void
+GLRenderBackend::buffer_sub_data(BufferTarget target, size_t offset, size_t size, const void* data)
+{
+  glBufferSubData(gl_target(target), offset, size, data);
+}
+
+void
+GLRenderBackend::vertex_attribute(unsigned int index, int components, size_t stride, size_t offset)
+{
+  glEnableVertexAttribArray(index);
+  glVertexAttribPointer(index, components, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(stride), (const void*)offset);
+}
+
+//
+// shaders
+//
+
+static unsigned int
+compile_shader(const std::string& src, unsigned int gl_shader_type, std::string type)
+{
+  const char* code = src.c_str();
+  unsigned int shader_id = glCreateShader(gl_shader_type);
+  glShaderSource(shader_id, 1, &code, NULL);
+  glCompileShader(shader_id);
+  check_compile_errors(shader_id, type);
+  return shader_id;
+}
+
+unsigned int
+GLRenderBackend::create_program(const std::string& vert_src, const std::string& frag_src)
+{
+  unsigned int vert_shader = compile_shader(vert_src, GL_VERTEX_SHADER, "VERTEX");
+  unsigned int frag_shader = compile_shader(frag_src, GL_FRAGMENT_SHADER, "FRAGMENT");
+
+  unsigned int ID = glCreateProgram();
+  glAttachShader(ID, vert_shader);
+  glAttachShader(ID, frag_shader);
+
+  glLinkProgram(ID);
+  check_compile_errors(ID, "PROGRAM");
+
+  glDeleteShader(vert_shader);
+  glDeleteShader(frag_shader);
+
+  return ID;
+}
+
+void
+GLRenderBackend::delete_program(unsigned int program)
+{
+  glDeleteProgram(program);
+}
+
+void
+GLRenderBackend::get_active_uniforms(unsigned int program, std::vector<std::pair<std::string, int>>& uniforms)
+{
+  uniforms.clear();
+
+  int count = 0;
+  int max_length = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+  std::vector<char> buffer(max_length + 1);
+  for (int i = 0; i < count; i++) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(program, i, static_cast<GLsizei>(buffer.size()), &length, &size, &type, buffer.data());
+
+    std::string name(buffer.data(), length);
+    int location = glGetUniformLocation(program, name.c_str());
+    if (location == -1)
+      continue; // member of a uniform block
+
+    uniforms.push_back({ name, location });
+
+    // arrays are reported as "name[0]", allow them to be looked up as "name" as well
+    if (size > 1 && name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+      uniforms.push_back({ name.substr(0, name.size() - 3), location });
+  }
+}
+
+int
+GLRenderBackend::get_uniform_location(unsigned int program, const std::string& name)
+{
+  return glGetUniformLocation(program, name.c_str());
+}
+
+void
+GLRenderBackend::bind_uniform_block(unsigned int program, const std::string& name, unsigned int binding)
+{
+  unsigned int index = glGetUniformBlockIndex(program, name.c_str());
+  if (index == GL_INVALID_INDEX) {
+    printf("ERROR: Uniform block not found: %s \n", name.c_str());
+    return;
+  }
+  glUniformBlockBinding(program, index, binding);
+}
+
+void
+GLRenderBackend::set_uniform(int location, UniformType type, const void* value)
+{
+  const float* f = static_cast<const float*>(value);
+  switch (type) {
+    case UniformType::INT:
+      glUniform1i(location, *static_cast<const int*>(value));
+      break;
+    case UniformType::UINT:
+      glUniform1ui(location, *static_cast<const unsigned int*>(value));
+      break;
+    case UniformType::FLOAT:
+      glUniform1f(location, *f);
+      break;
+    case UniformType::VEC2:
+      glUniform2fv(location, 1, f);
+      break;
+    case UniformType::VEC3:
+      glUniform3fv(location, 1, f);
+      break;
+    case UniformType::VEC4:
+      glUniform4fv(location, 1, f);
+      break;
+    case UniformType::MAT2:
+      glUniformMatrix2fv(location, 1, GL_FALSE, f);
+      break;
+    case UniformType::MAT3:
+      glUniformMatrix3fv(location, 1, GL_FALSE, f);
+      break;
+    case UniformType::MAT4:
+      glUniformMatrix4fv(location, 1, GL_FALSE, f);
+      break;
+  }
+}
+
+//
+// draws
+//
+
+void
+GLRenderBackend::draw_indexed(int index_count, int base_vertex)
+{
+  if (base_vertex == 0)
+    glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, nullptr);
+  else
+    glDrawElementsBaseVertex(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, nullptr, base_vertex);
+}
+
+void
+GLRenderBackend::draw_triangle_strip(int first, int vertex_count)
+{
+  glDrawArrays(GL_TRIANGLE_STRIP, first, vertex_count);
+}
+
+} // namespace fightingengine
@@ -0,0 +1,283 @@
+#pragma once
+
+// c++ standard library headers
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// other library headers
+#include <glm/glm.hpp>
+
+namespace fightingengine {
+
+enum class BufferTarget
+{
+  ARRAY,
+  ELEMENT,
+  UNIFORM
+};
+
+enum class BufferUsage
+{
+  STATIC,
+  DYNAMIC
+};
+
+enum class UniformType
+{
+  INT,
+  UINT,
+  FLOAT,
+  VEC2,
+  VEC3,
+  VEC4,
+  MAT2,
+  MAT3,
+  MAT4
+};
+
+// Everything the renderers ask of the gpu goes through a RenderBackend.
+// The GL backend is the default, the null and recording backends need no context,
+// so the cpu side of rendering (batching, culling, sorting) can run headless.
+class RenderBackend
+{
+public:
+  virtual ~RenderBackend() = default;
+
+  virtual void init() = 0;
+
+  // state
+  virtual void set_viewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+  virtual void set_clear_colour(const glm::vec4& colour) = 0;
+  virtual void clear() = 0;
+  virtual void set_depth_testing(bool toggle) = 0;
+  virtual void set_blending(bool toggle) = 0;
+  virtual void set_blend_func(unsigned int src_rgb, unsigned int dst_rgb, unsigned int src_a, unsigned int dst_a) = 0;
+  virtual void use_program(unsigned int program) = 0;
+  virtual void bind_vertex_array(unsigned int vao) = 0;
+  virtual void bind_buffer(BufferTarget target, unsigned int buffer) = 0;
+  virtual void bind_buffer_base(unsigned int binding, unsigned int buffer) = 0; // uniform buffers
+  virtual void bind_texture(int unit, unsigned int texture) = 0;
+  virtual void bind_framebuffer(unsigned int fbo) = 0;
+
+  // resources
+  virtual unsigned int create_vertex_array() = 0;
+  virtual unsigned int create_buffer() = 0;
+  virtual unsigned int create_texture(int width, int height) = 0; // rgba8, nearest, clamped to edge
+  virtual unsigned int create_framebuffer(unsigned int colour_texture) = 0;
+  virtual void delete_vertex_array(unsigned int vao) = 0;
+  virtual void delete_buffer(unsigned int buffer) = 0;
+  virtual void delete_texture(unsigned int texture) = 0;
+  virtual void delete_framebuffer(unsigned int fbo) = 0;
+
+  // act on the buffer currently bound to the target
+  virtual void buffer_data(BufferTarget target, size_t size, const void* data, BufferUsage usage) = 0;
+  virtual void buffer_sub_data(BufferTarget target, size_t offset, size_t size, const void* data) = 0;
+
+  // float attribute of the currently bound array buffer, stored in the bound vao
+  virtual void vertex_attribute(unsigned int index, int components, size_t stride, size_t offset) = 0;
+
+  // shaders
+  virtual unsigned int create_program(const std::string& vert_src, const std::string& frag_src) = 0;
+  virtual void delete_program(unsigned int program) = 0;
+  virtual void get_active_uniforms(unsigned int program, std::vector<std::pair<std::string, int>>& uniforms) = 0;
+  virtual int get_uniform_location(unsigned int program, const std::string& name) = 0;
+  virtual void bind_uniform_block(unsigned int program, const std::string& name, unsigned int binding) = 0;
+  virtual void set_uniform(int location, UniformType type, const void* value) = 0; // on the bound program
+
+  // draws
+  virtual void draw_indexed(int index_count, int base_vertex) = 0; // triangles, uint32_t indices
+  virtual void draw_triangle_strip(int first, int vertex_count) = 0;
+};
+
+class GLRenderBackend : public RenderBackend
+{
+public:
+  void init() override;
+
+  void set_viewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+  void set_clear_colour(const glm::vec4& colour) override;
+  void clear() override;
+  void set_depth_testing(bool toggle) override;
+  void set_blending(bool toggle) override;
+  void set_blend_func(unsigned int src_rgb, unsigned int dst_rgb, unsigned int src_a, unsigned int dst_a) override;
+  void use_program(unsigned int program) override;
+  void bind_vertex_array(unsigned int vao) override;
+  void bind_buffer(BufferTarget target, unsigned int buffer) override;
+  void bind_buffer_base(unsigned int binding, unsigned int buffer) override;
+  void bind_texture(int unit, unsigned int texture) override;
+  void bind_framebuffer(unsigned int fbo) override;
+
+  unsigned int create_vertex_array() override;
+  unsigned int create_buffer() override;
+  unsigned int create_texture(int width, int height) override;
+  unsigned int create_framebuffer(unsigned int colour_texture) override;
+  void delete_vertex_array(unsigned int vao) override;
+  void delete_buffer(unsigned int buffer) override;
+  void delete_texture(unsigned int texture) override;
+  void delete_framebuffer(unsigned int fbo) override;
+
+  void buffer_data(BufferTarget target, size_t size, const void* data, BufferUsage usage) override;
+  void buffer_sub_data(BufferTarget target, size_t offset, size_t size, const void* data) override;
+  void vertex_attribute(unsigned int index, int components, size_t stride, size_t offset) override;
+
+  unsigned int create_program(const std::string& vert_src, const std::string& frag_src) override;
+  void delete_program(unsigned int program) override;
+  void get_active_uniforms(unsigned int program, std::vector<std::pair<std::string, int>>& uniforms) override;
+  int get_uniform_location(unsigned int program, const std::string& name) override;
+  void bind_uniform_block(unsigned int program, const std::string& name, unsigned int binding) override;
+  void set_uniform(int location, UniformType type, const void* value) override;
+
+  void draw_indexed(int index_count, int base_vertex) override;
+  void draw_triangle_strip(int first, int vertex_count) override;
+};
+
+// Does nothing, but hands out unique ids. Use to measure the cpu cost of rendering.
+class NullRenderBackend : public RenderBackend
+{
+public:
+  void init() override {}
+
+  void set_viewport(uint32_t, uint32_t, uint32_t, uint32_t) override {}
+  void set_clear_colour(const glm::vec4&) override {}
+  void clear() override {}
+  void set_depth_testing(bool) override {}
+  void set_blending(bool) override {}
+  void set_blend_func(unsigned int, unsigned int, unsigned int, unsigned int) override {}
+  void use_program(unsigned int) override {}
+  void bind_vertex_array(unsigned int) override {}
+  void bind_buffer(BufferTarget, unsigned int) override {}
+  void bind_buffer_base(unsigned int, unsigned int) override {}
+  void bind_texture(int, unsigned int) override {}
+  void bind_framebuffer(unsigned int) override {}
+
+  unsigned int create_vertex_array() override { return next_id++; }
+  unsigned int create_buffer() override { return next_id++; }
+  unsigned int create_texture(int, int) override { return next_id++; }
+  unsigned int create_framebuffer(unsigned int) override { return next_id++; }
+  void delete_vertex_array(unsigned int) override {}
+  void delete_buffer(unsigned int) override {}
+  void delete_texture(unsigned int) override {}
+  void delete_framebuffer(unsigned int) override {}
+
+  void buffer_data(BufferTarget, size_t, const void*, BufferUsage) override {}
+  void buffer_sub_data(BufferTarget, size_t, size_t, const void*) override {}
+  void vertex_attribute(unsigned int, int, size_t, size_t) override {}
+
+  unsigned int create_program(const std::string&, const std::string&) override { return next_id++; }
+  void delete_program(unsigned int) override {}
+  void get_active_uniforms(unsigned int, std::vector<std::pair<std::string, int>>& uniforms) override
+  {
+    uniforms.clear();
+  }
+  int get_uniform_location(unsigned int program, const std::string& name) override;
+  void bind_uniform_block(unsigned int, const std::string&, unsigned int) override {}
+  void set_uniform(int, UniformType, const void*) override {}
+
+  void draw_indexed(int, int) override {}
+  void draw_triangle_strip(int, int) override {}
+
+protected:
+  unsigned int next_id = 1;
+
+  // uniform locations are made up, but stable per program and name
+  std::unordered_map<std::string, int> uniform_locations;
+};
+
+enum class RenderOp
+{
+  SET_VIEWPORT,
+  SET_CLEAR_COLOUR,
+  CLEAR,
+  SET_DEPTH_TESTING,
+  SET_BLENDING,
+  SET_BLEND_FUNC,
+  USE_PROGRAM,
+  BIND_VERTEX_ARRAY,
+  BIND_BUFFER,
+  BIND_BUFFER_BASE,
+  BIND_TEXTURE,
+  BIND_FRAMEBUFFER,
+  CREATE_VERTEX_ARRAY,
+  CREATE_BUFFER,
+  CREATE_TEXTURE,
+  CREATE_FRAMEBUFFER,
+  DELETE_VERTEX_ARRAY,
+  DELETE_BUFFER,
+  DELETE_TEXTURE,
+  DELETE_FRAMEBUFFER,
+  BUFFER_DATA,
+  BUFFER_SUB_DATA,
+  VERTEX_ATTRIBUTE,
+  CREATE_PROGRAM,
+  DELETE_PROGRAM,
+  BIND_UNIFORM_BLOCK,
+  SET_UNIFORM,
+  DRAW_INDEXED,
+  DRAW_TRIANGLE_STRIP
+};
+
+struct RecordedCommand
+{
+  RenderOp op;
+  int64_t args[4] = { 0, 0, 0, 0 };
+  uint64_t data_hash = 0; // of any data uploaded, so snapshots compare contents not pointers
+};
+
+// Captures the command stream, e.g. to compare against a snapshot in a test.
+class RecordingRenderBackend : public NullRenderBackend
+{
+public:
+  std::vector<RecordedCommand> commands;
+
+  // stats, kept until clear()
+  int draw_calls = 0;
+  int64_t indices_drawn = 0;
+  int64_t bytes_uploaded = 0;
+
+  void clear_recording();
+
+  // one command per line, stable between runs
+  [[nodiscard]] std::string to_string() const;
+
+  void set_viewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+  void set_clear_colour(const glm::vec4& colour) override;
+  void clear() override;
+  void set_depth_testing(bool toggle) override;
+  void set_blending(bool toggle) override;
+  void set_blend_func(unsigned int src_rgb, unsigned int dst_rgb, unsigned int src_a, unsigned int dst_a) override;
+  void use_program(unsigned int program) override;
+  void bind_vertex_array(unsigned int vao) override;
+  void bind_buffer(BufferTarget target, unsigned int buffer) override;
+  void bind_buffer_base(unsigned int binding, unsigned int buffer) override;
+  void bind_texture(int unit, unsigned int texture) override;
+  void bind_framebuffer(unsigned int fbo) override;
+
+  unsigned int create_vertex_array() override;
+  unsigned int create_buffer() override;
+  unsigned int create_texture(int width, int height) override;
+  unsigned int create_framebuffer(unsigned int colour_texture) override;
+  void delete_vertex_array(unsigned int vao) override;
+  void delete_buffer(unsigned int buffer) override;
+  void delete_texture(unsigned int texture) override;
+  void delete_framebuffer(unsigned int fbo) override;
+
+  void buffer_data(BufferTarget target, size_t size, const void* data, BufferUsage usage) override;
+  void buffer_sub_data(BufferTarget target, size_t offset, size_t size, const void* data) override;
+  void vertex_attribute(unsigned int index, int components, size_t stride, size_t offset) override;
+
+  unsigned int create_program(const std::string& vert_src, const std::string& frag_src) override;
+  void delete_program(unsigned int program) override;
+  void bind_uniform_block(unsigned int program, const std::string& name, unsigned int binding) override;
+  void set_uniform(int location, UniformType type, const void* value) override;
+
+  void draw_indexed(int index_count, int base_vertex) override;
+  void draw_triangle_strip(int first, int vertex_count) override;
+
+private:
+  void record(RenderOp op, int64_t a = 0, int64_t b = 0, int64_t c = 0, int64_t d = 0, uint64_t hash = 0);
+};
+
+} // namespace fightingengine
@@ -0,0 +1,325 @@
+// header
+#include "engine/opengl/render_backend.hpp"
+
+// c++ standard library headers
+#include <sstream>
+
+namespace fightingengine {
+
+// fnv-1a
+static uint64_t
+hash_bytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+  if (data == nullptr)
+    return hash;
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+static size_t
+uniform_size(UniformType type)
+{
+  switch (type) {
+    case UniformType::INT:
+    case UniformType::UINT:
+    case UniformType::FLOAT:
+      return 4;
+    case UniformType::VEC2:
+      return 8;
+    case UniformType::VEC3:
+      return 12;
+    case UniformType::VEC4:
+    case UniformType::MAT2:
+      return 16;
+    case UniformType::MAT3:
+      return 36;
+    case UniformType::MAT4:
+      return 64;
+  }
+  return 0;
+}
+
+//
+// NullRenderBackend
+//
+
+int
+NullRenderBackend::get_uniform_location(unsigned int program, const std::string& name)
+{
+  std::string key = std::to_string(program) + ":" + name;
+  auto it = uniform_locations.find(key);
+  if (it != uniform_locations.end())
+    return it->second;
+
+  int location = static_cast<int>(uniform_locations.size());
+  uniform_locations[key] = location;
+  return location;
+}
+
+//
+// RecordingRenderBackend
+//
+
+void
+RecordingRenderBackend::record(RenderOp op, int64_t a, int64_t b, int64_t c, int64_t d, uint64_t hash)
+{
+  RecordedCommand cmd;
+  cmd.op = op;
+  cmd.args[0] = a;
+  cmd.args[1] = b;
+  cmd.args[2] = c;
+  cmd.args[3] = d;
+  cmd.data_hash = hash;
+  commands.push_back(cmd);
+}
+
+void
+RecordingRenderBackend::clear_recording()
+{
+  commands.clear();
+  draw_calls = 0;
+  indices_drawn = 0;
+  bytes_uploaded = 0;
+}
+
+std::string
+RecordingRenderBackend::to_string() const
+{
+  static const char* names[] = { "set_viewport",
+                                 "set_clear_colour",
+                                 "clear",
+                                 "set_depth_testing",
+                                 "set_blending",
+                                 "set_blend_func",
+                                 "use_program",
+                                 "bind_vertex_array",
+                                 "bind_buffer",
+                                 "bind_buffer_base",
+                                 "bind_texture",
+                                 "bind_framebuffer",
+                                 "create_vertex_array",
+                                 "create_buffer",
+                                 "create_texture",
+                                 "create_framebuffer",
+                                 "delete_vertex_array",
+                                 "delete_buffer",
+                                 "delete_texture",
+                                 "delete_framebuffer",
+                                 "buffer_data",
+                                 "buffer_sub_data",
+                                 "vertex_attribute",
+                                 "create_program",
+                                 "delete_program",
+                                 "bind_uniform_block",
+                                 "set_uniform",
+                                 "draw_indexed",
+                                 "draw_triangle_strip" };
+
+  std::stringstream ss;
+  for (const RecordedCommand& cmd : commands) {
+    ss << names[static_cast<int>(cmd.op)] << " " << cmd.args[0] << " " << cmd.args[1] << " " << cmd.args[2] << " "
+       << cmd.args[3];
+    if (cmd.data_hash != 0)
+      ss << " #" << std::hex << cmd.data_hash << std::dec;
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+void
+RecordingRenderBackend::set_viewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+  record(RenderOp::SET_VIEWPORT, x, y, width, height);
+}
+
+void
+RecordingRenderBackend::set_clear_colour(const glm::vec4& colour)
+{
+  record(RenderOp::SET_CLEAR_COLOUR, 0, 0, 0, 0, hash_bytes(&colour[0], sizeof(float) * 4));
+}
+
+void
+RecordingRenderBackend::clear()
+{
+  record(RenderOp::CLEAR);
+}
+
+void
+RecordingRenderBackend::set_depth_testing(bool toggle)
+{
+  record(RenderOp::SET_DEPTH_TESTING, toggle);
+}
+
+void
+RecordingRenderBackend::set_blending(bool toggle)
+{
+  record(RenderOp::SET_BLENDING, toggle);
+}
+
+void
+RecordingRenderBackend::set_blend_func(unsigned int src_rgb, unsigned int dst_rgb, unsigned int src_a, unsigned int dst_a)
+{
+  record(RenderOp::SET_BLEND_FUNC, src_rgb, dst_rgb, src_a, dst_a);
+}
+
+void
+RecordingRenderBackend::use_program(unsigned int program)
+{
+  record(RenderOp::USE_PROGRAM, program);
+}
+
+void
+RecordingRenderBackend::bind_vertex_array(unsigned int vao)
+{
+  record(RenderOp::BIND_VERTEX_ARRAY, vao);
+}
+
+void
+RecordingRenderBackend::bind_buffer(BufferTarget target, unsigned int buffer)
+{
+  record(RenderOp::BIND_BUFFER, static_cast<int64_t>(target), buffer);
+}
+
+void
+RecordingRenderBackend::bind_buffer_base(unsigned int binding, unsigned int buffer)
+{
+  record(RenderOp::BIND_BUFFER_BASE, binding, buffer);
+}
+
+void
+RecordingRenderBackend::bind_texture(int unit, unsigned int texture)
+{
+  record(RenderOp::BIND_TEXTURE, unit, texture);
+}
+
+void
+RecordingRenderBackend::bind_framebuffer(unsigned int fbo)
+{
+  record(RenderOp::BIND_FRAMEBUFFER, fbo);
+}
+
+unsigned int
+RecordingRenderBackend::create_vertex_array()
+{
+  unsigned int id = NullRenderBackend::create_vertex_array();
+  record(RenderOp::CREATE_VERTEX_ARRAY, id);
+  return id;
+}
+
+unsigned int
+RecordingRenderBackend::create_buffer()
+{
+  unsigned int id = NullRenderBackend::create_buffer();
+  record(RenderOp::CREATE_BUFFER, id);
+  return id;
+}
+
+unsigned int
+RecordingRenderBackend::create_texture(int width, int height)
+{
+  unsigned int id = NullRenderBackend::create_texture(width, height);
+  record(RenderOp::CREATE_TEXTURE, id, width, height);
+  return id;
+}
+
+unsigned int
+RecordingRenderBackend::create_framebuffer(unsigned int colour_texture)
+{
+  unsigned int id = NullRenderBackend::create_framebuffer(colour_texture);
+  record(RenderOp::CREATE_FRAMEBUFFER, id, colour_texture);
+  return id;
+}
+
+void
+RecordingRenderBackend::delete_vertex_array(unsigned int vao)
+{
+  record(RenderOp::DELETE_VERTEX_ARRAY, vao);
+}
+
+void
+RecordingRenderBackend::delete_buffer(unsigned int buffer)
+{
+  record(RenderOp::DELETE_BUFFER, buffer);
+}
+
+void
+RecordingRenderBackend::delete_texture(unsigned int texture)
+{
+  record(RenderOp::DELETE_TEXTURE, texture);
+}
+
+void
+RecordingRenderBackend::delete_framebuffer(unsigned int fbo)
+{
+  record(RenderOp::DELETE_FRAMEBUFFER, fbo);
+}
+
+void
+RecordingRenderBackend::buffer_data(BufferTarget target, size_t size, const void* data, BufferUsage usage)
+{
+  record(RenderOp::BUFFER_DATA, static_cast<int64_t>(target), size, static_cast<int64_t>(usage), 0, hash_bytes(data, size));
+  if (data != nullptr)
+    bytes_uploaded += size;
+}
+
+void
+RecordingRenderBackend::buffer_sub_data(BufferTarget target, size_t offset, size_t size, const void* data)
+{
+  record(RenderOp::BUFFER_SUB_DATA, static_cast<int64_t>(target), offset, size, 0, hash_bytes(data, size));
+  bytes_uploaded += size;
+}
+
+void
+RecordingRenderBackend::vertex_attribute(unsigned int index, int components, size_t stride, size_t offset)
+{
+  record(RenderOp::VERTEX_ATTRIBUTE, index, components, stride, offset);
+}
+
+unsigned int
+RecordingRenderBackend::create_program(const std::string& vert_src, const std::string& frag_src)
+{
+  unsigned int id = NullRenderBackend::create_program(vert_src, frag_src);
+  uint64_t hash = hash_bytes(vert_src.data(), vert_src.size());
+  hash = hash_bytes(frag_src.data(), frag_src.size(), hash);
+  record(RenderOp::CREATE_PROGRAM, id, 0, 0, 0, hash);
+  return id;
+}
+
+void
+RecordingRenderBackend::delete_program(unsigned int program)
+{
+  record(RenderOp::DELETE_PROGRAM, program);
+}
+
+void
+RecordingRenderBackend::bind_uniform_block(unsigned int program, const std::string& name, unsigned int binding)
+{
+  record(RenderOp::BIND_UNIFORM_BLOCK, program, binding, 0, 0, hash_bytes(name.data(), name.size()));
+}
+
+void
+RecordingRenderBackend::set_uniform(int location, UniformType type, const void* value)
+{
+  record(RenderOp::SET_UNIFORM, location, static_cast<int64_t>(type), 0, 0, hash_bytes(value, uniform_size(type)));
+}
+
+void
+RecordingRenderBackend::draw_indexed(int index_count, int base_vertex)
+{
+  record(RenderOp::DRAW_INDEXED, index_count, base_vertex);
+  draw_calls += 1;
+  indices_drawn += index_count;
+}
+
+void
+RecordingRenderBackend::draw_triangle_strip(int first, int vertex_count)
+{
+  record(RenderOp::DRAW_TRIANGLE_STRIP, first, vertex_count);
+  draw_calls += 1;
+}
+
+} // namespace fightingengine
@@ -4,13 +4,61 @@
 
 // other library headers
 #include <GL/glew.h>
-#include <SDL2/SDL.h>
 
 namespace fightingengine {
 
+static GLRenderBackend s_gl_backend;
+static RenderBackend* s_backend = &s_gl_backend;
+
+// the driver state as last set through RenderCommand
+static const unsigned int unknown_state = 0xFFFFFFFF;
+static const int max_texture_units = 16;
+
+struct render_state
+{
+  unsigned int program = unknown_state;
+  unsigned int vao = unknown_state;
+  unsigned int array_buffer = unknown_state;
+  unsigned int textures[max_texture_units];
+  unsigned int blending = unknown_state;
+  unsigned int depth_testing = unknown_state;
+  unsigned int blend_func[4];
+
+  RenderStateStats stats;
+};
+static render_state s_state;
+
+// returns true if the state needs setting
+static bool
+state_changed(unsigned int& cached, unsigned int value)
+{
+  if (cached == value) {
+    s_state.stats.skipped += 1;
+    return false;
+  }
+  cached = value;
+  s_state.stats.issued += 1;
+  return true;
+}
+
+void
+RenderCommand::set_backend(RenderBackend* backend)
+{
+  s_backend = backend != nullptr ? backend : &s_gl_backend;
+  invalidate_state_cache();
+}
+
+RenderBackend&
+RenderCommand::get_backend()
+{
+  return *s_backend;
+}
+
 void
 RenderCommand::init()
 {
+  invalidate_state_cache();
+
   // printf("(render_command) Init opengl... \n");
 
   // #ifdef _DEBUG
@@ -20,14 +68,12 @@ RenderCommand::init()
   //   // glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
   // #endif
 
-  // Enable Multi Sampling
-  SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
-  SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
-  glEnable(GL_MULTISAMPLE);
+  // multisampling, depth func etc
+  s_backend->init();
 
-  glEnable(GL_BLEND);
+  set_blending(true);
   // glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
   // Enable depth testing
   set_depth_testing(true);
@@ -43,41 +89,116 @@ RenderCommand::init()
   // passed in between framebuffers to remain in linear-space and only have the
   // last framebuffer apply gamma correction before being sent to the monitor.
   // glEnable(GL_FRAMEBUFFER_SRGB);
-
-  // Enable Faceculling
-  // glEnable(GL_CULL_FACE);
-  // glDisable(GL_CULL_FACE);
-  glDepthFunc(GL_LESS);
-
-  // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 }
 
 void
 RenderCommand::set_depth_testing(bool toggle)
 {
-  if (toggle)
-    glEnable(GL_DEPTH_TEST);
-  else
-    glDisable(GL_DEPTH_TEST);
+  if (state_changed(s_state.depth_testing, toggle ? 1 : 0))
+    s_backend->set_depth_testing(toggle);
 }
 
 void
 RenderCommand::set_viewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
 {
   // printf("(render_command) setting viewport... \n");
-  glViewport(x, y, width, height);
+  s_backend->set_viewport(x, y, width, height);
 }
 
 void
 RenderCommand::set_clear_colour(const glm::vec4& color)
 {
-  glClearColor(color.r, color.g, color.b, color.a);
+  s_backend->set_clear_colour(color);
 }
 
 void
 RenderCommand::clear()
 {
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  s_backend->clear();
+}
+
+void
+RenderCommand::use_program(unsigned int program)
+{
+  if (state_changed(s_state.program, program))
+    s_backend->use_program(program);
+}
+
+void
+RenderCommand::bind_vertex_array(unsigned int vao)
+{
+  if (state_changed(s_state.vao, vao))
+    s_backend->bind_vertex_array(vao);
+}
+
+void
+RenderCommand::bind_array_buffer(unsigned int vbo)
+{
+  if (state_changed(s_state.array_buffer, vbo))
+    s_backend->bind_buffer(BufferTarget::ARRAY, vbo);
+}
+
+void
+RenderCommand::bind_texture(int unit, unsigned int texture)
+{
+  if (unit < 0 || unit >= max_texture_units) {
+    s_backend->bind_texture(unit, texture);
+    s_state.stats.issued += 1;
+    return;
+  }
+
+  if (state_changed(s_state.textures[unit], texture))
+    s_backend->bind_texture(unit, texture);
+}
+
+void
+RenderCommand::set_blending(bool toggle)
+{
+  if (state_changed(s_state.blending, toggle ? 1 : 0))
+    s_backend->set_blending(toggle);
+}
+
+void
+RenderCommand::set_blend_func(unsigned int src_rgb, unsigned int dst_rgb, unsigned int src_a, unsigned int dst_a)
+{
+  if (s_state.blend_func[0] == src_rgb && s_state.blend_func[1] == dst_rgb && s_state.blend_func[2] == src_a &&
+      s_state.blend_func[3] == dst_a) {
+    s_state.stats.skipped += 1;
+    return;
+  }
+  s_state.blend_func[0] = src_rgb;
+  s_state.blend_func[1] = dst_rgb;
+  s_state.blend_func[2] = src_a;
+  s_state.blend_func[3] = dst_a;
+  s_state.stats.issued += 1;
+
+  s_backend->set_blend_func(src_rgb, dst_rgb, src_a, dst_a);
+}
+
+void
+RenderCommand::invalidate_state_cache()
+{
+  s_state.program = unknown_state;
+  s_state.vao = unknown_state;
+  s_state.array_buffer = unknown_state;
+  for (int i = 0; i < max_texture_units; i++)
+    s_state.textures[i] = unknown_state;
+  s_state.blending = unknown_state;
+  s_state.depth_testing = unknown_state;
+  for (int i = 0; i < 4; i++)
+    s_state.blend_func[i] = unknown_state;
+}
+
+RenderStateStats
+RenderCommand::get_state_stats()
+{
+  return s_state.stats;
+}
+
+void
+RenderCommand::reset_state_stats()
+{
+  s_state.stats = RenderStateStats();
 }
 
 } // namespace fightingengine
@@ -3,11 +3,25 @@
 // other library headers
 #include <glm/glm.hpp>
 
+// your project headers
+#include "engine/opengl/render_backend.hpp"
+
 namespace fightingengine {
 
+struct RenderStateStats
+{
+  int issued = 0;  // state changes that reached the driver
+  int skipped = 0; // state changes dropped because the state was already set
+};
+
 class RenderCommand
 {
 public:
+  // defaults to the GL backend. pass nullptr to go back to it.
+  // note: the backend must outlive its use, RenderCommand doesn't own it
+  static void set_backend(RenderBackend* backend);
+  static RenderBackend& get_backend();
+
   static void init();
 
   static void set_viewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
@@ -17,6 +31,23 @@ public:
   static void set_depth_testing(bool toggle);
 
   static void clear();
+
+  //
+  // Cached state. These only call in to the driver if the state would change.
+  //
+
+  static void use_program(unsigned int program);
+  static void bind_vertex_array(unsigned int vao);
+  static void bind_array_buffer(unsigned int vbo);
+  static void bind_texture(int unit, unsigned int texture); // GL_TEXTURE_2D
+  static void set_blending(bool toggle);
+  static void set_blend_func(unsigned int src_rgb, unsigned int dst_rgb, unsigned int src_a, unsigned int dst_a);
+
+  // call if anything changed gl state without going through RenderCommand
+  static void invalidate_state_cache();
+
+  static RenderStateStats get_state_stats();
+  static void reset_state_stats();
 };
 
 } // namespace fightingengine
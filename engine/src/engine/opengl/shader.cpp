@@ -12,6 +12,7 @@
 #include <GL/glew.h>
 
 // your project headers
+#include "engine/opengl/render_command.hpp"
 #include "engine/opengl/util.hpp"
 
 #define SHADER_ASSET_PATH "assets/"
@@ -40,49 +41,18 @@ check_compile_errors(unsigned int shader, std::string type)
   }
 }
 
-void
-reload_shader_program(unsigned int* id, const std::string& vert_path, const std::string& frag_path)
-{
-  printf("Reloading shader: %s %s \n", vert_path.c_str(), frag_path.c_str());
-
-  // Create a new shader program from the given file names. Halt on failure.
-  unsigned int new_id = create_opengl_shader(vert_path, frag_path);
-
-  if (new_id) {
-    glDeleteProgram(*id);
-    *id = new_id;
-  }
-}
-
 unsigned int
 create_opengl_shader(const std::string& vert_path, const std::string& frag_path)
 {
-  // OpenGL ShaderTypes
-  // GL_VERTEX_SHADER VERTEX
-  // GL_COMPUTE_SHADER COMPUTE
-  // GL_FRAGMENT_SHADER FRAGMENT
-  // GL_GEOMETRY_SHADER VERTEX
-
-  unsigned int vert_shader = load_shader_from_disk(SHADER_ASSET_PATH + vert_path, GL_VERTEX_SHADER, "VERTEX");
-  unsigned int frag_shader = load_shader_from_disk(SHADER_ASSET_PATH + frag_path, GL_FRAGMENT_SHADER, "FRAGMENT");
-
-  unsigned int ID = glCreateProgram();
-  glAttachShader(ID, vert_shader);
-  glAttachShader(ID, frag_shader);
-
-  glLinkProgram(ID);
-  check_compile_errors(ID, "PROGRAM");
-
-  glDeleteShader(vert_shader);
-  glDeleteShader(frag_shader);
-
-  return ID;
+  // compiled and linked by the current render backend
+  std::string vert_code = read_shader_from_disk(SHADER_ASSET_PATH + vert_path);
+  std::string frag_code = read_shader_from_disk(SHADER_ASSET_PATH + frag_path);
+  return RenderCommand::get_backend().create_program(vert_code, frag_code);
 }
 
-unsigned int
-load_shader_from_disk(const std::string& path, unsigned int gl_shader_type, std::string type)
+std::string
+read_shader_from_disk(const std::string& path)
 {
-  unsigned int shader_id;
   std::string code;
   {
     const char* compute_shader_path = path.c_str();
@@ -109,6 +79,14 @@ load_shader_from_disk(const std::string& path, unsigned int gl_shader_type, std:
       exit(1);
     }
   }
+  return code;
+}
+
+unsigned int
+load_shader_from_disk(const std::string& path, unsigned int gl_shader_type, std::string type)
+{
+  unsigned int shader_id;
+  std::string code = read_shader_from_disk(path);
 
   const char* csCode = code.c_str();
   shader_id = glCreateShader(gl_shader_type);
@@ -124,86 +102,199 @@ load_shader_from_disk(const std::string& path, unsigned int gl_shader_type, std:
 //
 
 Shader::Shader(const std::string& vert_path, const std::string& frag_path)
+  : vert_path(vert_path)
+  , frag_path(frag_path)
 {
   ID = create_opengl_shader(vert_path, frag_path);
+  reflect_uniforms();
+}
+
+bool
+Shader::reload()
+{
+  printf("Reloading shader: %s %s \n", vert_path.c_str(), frag_path.c_str());
+
+  unsigned int new_id = create_opengl_shader(vert_path, frag_path);
+  if (!new_id)
+    return false;
+
+  RenderCommand::get_backend().delete_program(ID);
+  ID = new_id;
+  RenderCommand::invalidate_state_cache(); // the old program id can be reused
+
+  reflect_uniforms();
+  for (const auto& block : uniform_blocks)
+    RenderCommand::get_backend().bind_uniform_block(ID, block.first, block.second);
+  return true;
 }
 
 void
 Shader::bind()
 {
-  glUseProgram(ID);
+  RenderCommand::use_program(ID);
 }
 
 void
 Shader::unbind()
 {
-  glUseProgram(0);
+  RenderCommand::use_program(0);
+}
+
+void
+Shader::reflect_uniforms()
+{
+  uniform_locations.clear();
+
+  std::vector<std::pair<std::string, int>> uniforms;
+  RenderCommand::get_backend().get_active_uniforms(ID, uniforms);
+  for (const auto& u : uniforms)
+    uniform_locations[u.first] = u.second;
+}
+
+UniformHandle
+Shader::get_uniform(const std::string& name) const
+{
+  auto it = uniform_locations.find(name);
+  if (it != uniform_locations.end())
+    return { it->second };
+
+  // e.g. an array element other than [0], or an inactive uniform (location -1).
+  // ask the driver once and remember the answer.
+  int location = RenderCommand::get_backend().get_uniform_location(ID, name);
+  uniform_locations[name] = location;
+  return { location };
+}
+
+void
+Shader::bind_uniform_block(const std::string& name, unsigned int binding)
+{
+  RenderCommand::get_backend().bind_uniform_block(ID, name, binding);
+
+  for (auto& block : uniform_blocks) {
+    if (block.first == name) {
+      block.second = binding;
+      return;
+    }
+  }
+  uniform_blocks.push_back({ name, binding });
+}
+
+void
+Shader::set_bool(UniformHandle u, bool value) const
+{
+  int v = (int)value;
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::INT, &v);
+}
+void
+Shader::set_int(UniformHandle u, int value) const
+{
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::INT, &value);
+}
+void
+Shader::set_uint(UniformHandle u, unsigned int value) const
+{
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::UINT, &value);
+}
+void
+Shader::set_float(UniformHandle u, float value) const
+{
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::FLOAT, &value);
+}
+void
+Shader::set_vec2(UniformHandle u, const glm::vec2& value) const
+{
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::VEC2, &value[0]);
+}
+void
+Shader::set_vec3(UniformHandle u, const glm::vec3& value) const
+{
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::VEC3, &value[0]);
+}
+void
+Shader::set_vec4(UniformHandle u, const glm::vec4& value) const
+{
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::VEC4, &value[0]);
+}
+void
+Shader::set_mat2(UniformHandle u, const glm::mat2& mat) const
+{
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::MAT2, &mat[0][0]);
+}
+void
+Shader::set_mat3(UniformHandle u, const glm::mat3& mat) const
+{
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::MAT3, &mat[0][0]);
+}
+void
+Shader::set_mat4(UniformHandle u, const glm::mat4& mat) const
+{
+  RenderCommand::get_backend().set_uniform(u.location, UniformType::MAT4, &mat[0][0]);
 }
 
 void
 Shader::set_bool(const std::string& name, bool value) const
 {
-  glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+  set_bool(get_uniform(name), value);
 }
 void
 Shader::set_int(const std::string& name, int value) const
 {
-  glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+  set_int(get_uniform(name), value);
 }
 void
 Shader::set_uint(const std::string& name, unsigned int value) const
 {
-  glUniform1ui(glGetUniformLocation(ID, name.c_str()), value);
+  set_uint(get_uniform(name), value);
 }
 void
 Shader::set_float(const std::string& name, float value) const
 {
-  glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+  set_float(get_uniform(name), value);
 }
 void
 Shader::set_vec2(const std::string& name, const glm::vec2& value) const
 {
-  glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+  set_vec2(get_uniform(name), value);
 }
 void
 Shader::set_vec2(const std::string& name, float x, float y) const
 {
-  glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+  set_vec2(get_uniform(name), glm::vec2(x, y));
 }
 void
 Shader::set_vec3(const std::string& name, const glm::vec3& value) const
 {
-  glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+  set_vec3(get_uniform(name), value);
 }
 void
 Shader::set_vec3(const std::string& name, float x, float y, float z) const
 {
-  glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+  set_vec3(get_uniform(name), glm::vec3(x, y, z));
 }
 void
 Shader::set_vec4(const std::string& name, const glm::vec4& value) const
 {
-  glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+  set_vec4(get_uniform(name), value);
 }
 void
 Shader::set_vec4(const std::string& name, float x, float y, float z, float w)
 {
-  glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+  set_vec4(get_uniform(name), glm::vec4(x, y, z, w));
 }
 void
 Shader::set_mat2(const std::string& name, const glm::mat2& mat) const
 {
-  glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+  set_mat2(get_uniform(name), mat);
 }
 void
 Shader::set_mat3(const std::string& name, const glm::mat3& mat) const
 {
-  glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+  set_mat3(get_uniform(name), mat);
 }
 void
 Shader::set_mat4(const std::string& name, const glm::mat4& mat) const
 {
-  glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+  set_mat4(get_uniform(name), mat);
 }
 
 int
@@ -3,6 +3,7 @@
 // c++ standard library headers
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // other library headers
@@ -13,15 +14,21 @@ namespace fightingengine {
 void
 check_compile_errors(unsigned int shader, std::string type);
 
-void
-reload_shader_program(unsigned int* id, const std::string& vert_path, const std::string& frag_path);
-
 [[nodiscard]] unsigned int
 create_opengl_shader(const std::string& vert_path, const std::string& frag_path);
 
+[[nodiscard]] std::string
+read_shader_from_disk(const std::string& path);
+
 [[nodiscard]] unsigned int
 load_shader_from_disk(const std::string& path, unsigned int gl_shader_type, std::string type);
 
+// a uniform location resolved ahead of time, see Shader::get_uniform()
+struct UniformHandle
+{
+  int location = -1;
+};
+
 class Shader
 {
 public:
@@ -32,6 +39,36 @@ public:
   void bind();
   void unbind();
 
+  // recompiles from the same files. if that works the new program replaces ID, its uniforms are
+  // reflected and its uniform blocks bound to the same points as before. uniform values start
+  // over, and handles from get_uniform() can move, so get them and set them again.
+  // returns false and keeps the old program if it doesn't compile
+  bool reload();
+
+  // caches the location of every active uniform, called on creation and reload()
+  void reflect_uniforms();
+
+  // a hashed lookup. a name reflect_uniforms() didn't see (e.g. an array element other than [0])
+  // asks the driver the first time, then is cached too. -1 if the uniform isn't active
+  [[nodiscard]] UniformHandle get_uniform(const std::string& name) const;
+
+  // points the named uniform block at a UniformBuffer binding point, and again after a reload()
+  void bind_uniform_block(const std::string& name, unsigned int binding);
+
+  // set uniforms via a pre-resolved handle (use these in per-frame code)
+  void set_bool(UniformHandle u, bool value) const;
+  void set_int(UniformHandle u, int value) const;
+  void set_uint(UniformHandle u, unsigned int value) const;
+  void set_float(UniformHandle u, float value) const;
+  void set_vec2(UniformHandle u, const glm::vec2& value) const;
+  void set_vec3(UniformHandle u, const glm::vec3& value) const;
+  void set_vec4(UniformHandle u, const glm::vec4& value) const;
+  void set_mat2(UniformHandle u, const glm::mat2& mat) const;
+  void set_mat3(UniformHandle u, const glm::mat3& mat) const;
+  void set_mat4(UniformHandle u, const glm::mat4& mat) const;
+
+  // set uniforms by name
+
   void set_bool(const std::string& name, bool value) const;
   void set_int(const std::string& name, int value) const;
   void set_uint(const std::string& name, unsigned int value) const;
@@ -52,6 +89,14 @@ public:
   void set_compute_buffer_bind_location(const std::string& name);
 
 private:
+  std::string vert_path;
+  std::string frag_path;
+
+  // name -> location, filled by reflect_uniforms()
+  mutable std::unordered_map<std::string, int> uniform_locations;
+
+  // name -> binding point, for reload()
+  std::vector<std::pair<std::string, unsigned int>> uniform_blocks;
 };
 
 } // namespace fightingengine
@@ -0,0 +1,38 @@
+// header
+#include "engine/opengl/uniform_buffer.hpp"
+
+// your project headers
+#include "engine/opengl/render_command.hpp"
+
+namespace fightingengine {
+
+UniformBuffer::UniformBuffer(size_t size, unsigned int binding)
+  : binding(binding)
+  , size(size)
+{
+  RenderBackend& backend = RenderCommand::get_backend();
+  ID = backend.create_buffer();
+  backend.bind_buffer(BufferTarget::UNIFORM, ID);
+  backend.buffer_data(BufferTarget::UNIFORM, size, nullptr, BufferUsage::DYNAMIC);
+  backend.bind_buffer(BufferTarget::UNIFORM, 0);
+
+  backend.bind_buffer_base(binding, ID);
+}
+
+void
+UniformBuffer::update(const void* data, size_t size, size_t offset) const
+{
+  RenderBackend& backend = RenderCommand::get_backend();
+  backend.bind_buffer(BufferTarget::UNIFORM, ID);
+  backend.buffer_sub_data(BufferTarget::UNIFORM, offset, size, data);
+  backend.bind_buffer(BufferTarget::UNIFORM, 0);
+}
+
+void
+UniformBuffer::destroy()
+{
+  RenderCommand::get_backend().delete_buffer(ID);
+  ID = 0;
+}
+
+} // namespace fightingengine
@@ -0,0 +1,24 @@
+#pragma once
+
+// c++ standard library headers
+#include <cstddef>
+
+namespace fightingengine {
+
+// Data shared between shader programs, e.g. the projection matrix.
+// Upload it once and every program with a matching uniform block sees it.
+// Note: the layout of the c++ struct must match the std140 block in the shader.
+class UniformBuffer
+{
+public:
+  unsigned int ID = 0;
+  unsigned int binding = 0;
+  size_t size = 0;
+
+  UniformBuffer(size_t size, unsigned int binding);
+
+  void update(const void* data, size_t size, size_t offset = 0) const;
+  void destroy();
+};
+
+} // namespace fightingengine
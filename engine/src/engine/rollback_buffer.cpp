@@ -0,0 +1,45 @@
+// header
+#include "engine/rollback_buffer.hpp"
+
+namespace fightingengine {
+
+RollbackBuffer::RollbackBuffer(size_t capacity)
+  : slots(capacity > 0 ? capacity : 1)
+{}
+
+std::vector<uint8_t>&
+RollbackBuffer::save(uint32_t frame)
+{
+  Slot& slot = slots[frame % slots.size()];
+  slot.valid = true;
+  slot.frame = frame;
+  slot.bytes.clear();
+  return slot.bytes;
+}
+
+const std::vector<uint8_t>*
+RollbackBuffer::find(uint32_t frame) const
+{
+  const Slot& slot = slots[frame % slots.size()];
+  if (slot.valid && slot.frame == frame)
+    return &slot.bytes;
+  return nullptr;
+}
+
+std::vector<uint8_t>*
+RollbackBuffer::find(uint32_t frame)
+{
+  Slot& slot = slots[frame % slots.size()];
+  if (slot.valid && slot.frame == frame)
+    return &slot.bytes;
+  return nullptr;
+}
+
+void
+RollbackBuffer::clear()
+{
+  for (Slot& slot : slots)
+    slot.valid = false;
+}
+
+} // namespace fightingengine
@@ -0,0 +1,39 @@
+#pragma once
+
+// c system headers
+#include <cstddef>
+#include <cstdint>
+
+// c++ standard library headers
+#include <vector>
+
+namespace fightingengine {
+
+// The last few frames of simulation state, each one flat block of bytes, looked up by frame.
+// What goes in a frame is up to the game, it only has to be memcpy-able. Slots keep their
+// memory when they're reused, so once the ring has gone round saving doesn't allocate.
+class RollbackBuffer
+{
+public:
+  explicit RollbackBuffer(size_t capacity = 16);
+
+  // the emptied slot for frame, for the caller to fill. replaces whatever frame was there
+  [[nodiscard]] std::vector<uint8_t>& save(uint32_t frame);
+  // null if frame was never saved, or is older than capacity frames
+  [[nodiscard]] const std::vector<uint8_t>* find(uint32_t frame) const;
+  [[nodiscard]] std::vector<uint8_t>* find(uint32_t frame);
+  void clear();
+
+  [[nodiscard]] size_t get_capacity() const { return slots.size(); }
+
+private:
+  struct Slot
+  {
+    bool valid = false;
+    uint32_t frame = 0;
+    std::vector<uint8_t> bytes;
+  };
+  std::vector<Slot> slots;
+};
+
+} // namespace fightingengine
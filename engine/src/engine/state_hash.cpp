@@ -0,0 +1,91 @@
+// header
+#include "engine/state_hash.hpp"
+
+namespace fightingengine {
+
+// xxhash3's accumulate: a lane adds the pair of words it's given to its neighbour,
+// and the product of the pair's halves once they're xored with the lane's key to itself.
+// the keys move on with each block of the stream, or the sums wouldn't care what order whole
+// blocks came in. finish() runs each lane through a 64 bit finaliser so every bit of every lane counts
+
+static constexpr uint64_t lane_keys[8] = {
+  0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull, 0xdb979083e96dd4deull, 0x1f67b3b7a4a44072ull,
+  0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull, 0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull,
+};
+
+static uint64_t
+mix(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+void
+StateHasher::reset(uint64_t seed)
+{
+  for (int i = 0; i < lane_count; i++)
+    lanes[i] = mix(seed + i);
+  buffered = 0;
+  word_count = 0;
+}
+
+void
+StateHasher::hash_blocks(const uint32_t* words, size_t blocks)
+{
+  // on the stack, so they stay in registers
+  uint64_t l[lane_count];
+  std::memcpy(l, lanes, sizeof(l));
+  uint64_t block_key = word_count / block_words * 0x9e3779b97f4a7c15ull;
+  for (size_t b = 0; b < blocks; b++, words += block_words, block_key += 0x9e3779b97f4a7c15ull) {
+    for (int i = 0; i < lane_count; i++) {
+      const uint64_t pair = words[2 * i] | static_cast<uint64_t>(words[2 * i + 1]) << 32;
+      const uint64_t keyed = pair ^ (lane_keys[i] + block_key);
+      l[i ^ 1] += pair;
+      l[i] += (keyed & 0xffffffffull) * (keyed >> 32);
+    }
+  }
+  std::memcpy(lanes, l, sizeof(l));
+  word_count += blocks * block_words;
+}
+
+void
+StateHasher::flush()
+{
+  hash_blocks(buffer, buffer_words / block_words);
+  buffered = 0;
+}
+
+void
+StateHasher::add_words(const uint32_t* words, size_t count)
+{
+  // a word's lane is where it is in the whole stream, so top up the buffer first
+  while (count > 0 && buffered != 0) {
+    add(*words++);
+    count -= 1;
+  }
+  const size_t blocks = count / block_words;
+  hash_blocks(words, blocks);
+  for (size_t i = blocks * block_words; i < count; i++)
+    add(words[i]);
+}
+
+uint64_t
+StateHasher::finish() const
+{
+  StateHasher rest = *this;
+  const size_t blocks = rest.buffered / block_words;
+  rest.hash_blocks(rest.buffer, blocks);
+
+  uint64_t h = get_word_count() * 0x9e3779b97f4a7c15ull;
+  for (int i = 0; i < lane_count; i++)
+    h = mix(h ^ mix(rest.lanes[i])) + i;
+  for (size_t i = blocks * block_words, n = 1; i < rest.buffered; i++, n++)
+    h = mix(h ^ (static_cast<uint64_t>(rest.buffer[i]) << 32 | n));
+  return mix(h);
+}
+
+} // namespace fightingengine
@@ -0,0 +1,61 @@
+#pragma once
+
+// c system headers
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace fightingengine {
+
+// A 64 bit checksum of simulation state, fed 32 bit values in whatever order the game walks its state.
+// Two states that were fed the same values give the same hash, on any machine.
+// Not for security: it's to notice when two simulations that should agree don't.
+//
+// Values are hashed a block at a time, each pair of words in a block going to its own 64 bit lane
+// with one 32x32 multiply. The lanes don't depend on each other, so a block is a few vector
+// instructions. add_words() over a flat array is the fast way in, add() buffers a value at a time.
+class StateHasher
+{
+public:
+  explicit StateHasher(uint64_t seed = 0) { reset(seed); }
+
+  void reset(uint64_t seed = 0);
+
+  void add(uint32_t word)
+  {
+    buffer[buffered++] = word;
+    if (buffered == buffer_words)
+      flush();
+  }
+  void add(int32_t value) { add(static_cast<uint32_t>(value)); }
+  void add(bool value) { add(static_cast<uint32_t>(value ? 1 : 0)); }
+  // bit for bit, so 0.0f and -0.0f hash differently. a simulation that gets one where the other got
+  // the other has already gone different ways
+  void add(float value)
+  {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    add(bits);
+  }
+
+  void add_words(const uint32_t* words, size_t count);
+
+  // the hash of everything added so far. more can be added after
+  [[nodiscard]] uint64_t finish() const;
+  [[nodiscard]] uint64_t get_word_count() const { return word_count + buffered; }
+
+private:
+  static constexpr int lane_count = 8;
+  static constexpr int block_words = 2 * lane_count;
+  static constexpr int buffer_words = 4 * block_words;
+
+  void flush();
+  void hash_blocks(const uint32_t* words, size_t blocks);
+
+  uint64_t lanes[lane_count];
+  uint32_t buffer[buffer_words];
+  size_t buffered = 0;
+  uint64_t word_count = 0; // in the lanes, not counting what's buffered
+};
+
+} // namespace fightingengine
@@ -0,0 +1,86 @@
+// header
+#include "engine/tick_scheduler.hpp"
+
+// c++ standard library headers
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// engine headers
+#include "engine/tools/zone_profiler.hpp"
+
+namespace fightingengine {
+
+static uint64_t
+hz_to_period_ns(float tick_rate_hz)
+{
+  return static_cast<uint64_t>(1e9 / std::max(tick_rate_hz, 1.0f));
+}
+
+FixedTickScheduler::FixedTickScheduler(const TickSchedulerConfig& config)
+  : config(config)
+  , period_ns(hz_to_period_ns(config.tick_rate_hz))
+{
+  reset();
+}
+
+void
+FixedTickScheduler::reset()
+{
+  start_ns = zone_profiler::now_ns();
+  next_tick = 0;
+}
+
+void
+FixedTickScheduler::set_tick_rate(float tick_rate_hz)
+{
+  config.tick_rate_hz = tick_rate_hz;
+  period_ns = hz_to_period_ns(tick_rate_hz);
+  reset();
+}
+
+uint64_t
+FixedTickScheduler::wait_for_next_tick()
+{
+  uint64_t deadline = start_ns + next_tick * period_ns;
+  uint64_t now = zone_profiler::now_ns();
+
+  // too far behind: drop the ticks we can't make up, and carry on from now
+  if (now > deadline) {
+    const uint64_t behind = (now - deadline) / period_ns;
+    if (behind > static_cast<uint64_t>(config.max_catch_up_ticks)) {
+      const uint64_t skip = behind - config.max_catch_up_ticks;
+      stats.skipped_ticks += skip;
+      next_tick += skip;
+      deadline = start_ns + next_tick * period_ns;
+    }
+  }
+
+  // sleep most of the way, then spin the rest
+  if (now + config.spin_ns < deadline)
+    std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - now - config.spin_ns));
+  while ((now = zone_profiler::now_ns()) < deadline)
+    std::this_thread::yield();
+
+  const uint64_t wake_error = now - deadline;
+  stats.max_wake_error_ns = std::max(stats.max_wake_error_ns, wake_error);
+  if (wake_error > period_ns / 4)
+    stats.late_ticks += 1;
+
+  tick_begin_ns = now;
+  next_tick += 1;
+  stats.ticks += 1;
+  return tick++;
+}
+
+void
+FixedTickScheduler::end_tick()
+{
+  const uint64_t work_ns = zone_profiler::now_ns() - tick_begin_ns;
+  stats.last_work_ns = work_ns;
+  stats.max_work_ns = std::max(stats.max_work_ns, work_ns);
+  if (work_ns > period_ns)
+    stats.overruns += 1;
+}
+
+} // namespace fightingengine
@@ -0,0 +1,65 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+namespace fightingengine {
+
+struct TickSchedulerConfig
+{
+  float tick_rate_hz = 60.0f;
+  // sleep until this close to the deadline, then spin. OS sleeps routinely overshoot by a millisecond or more
+  uint64_t spin_ns = 1500000;
+  // if more than this many ticks behind, skip ahead instead of running them all back to back
+  int max_catch_up_ticks = 4;
+};
+
+struct TickStats
+{
+  uint64_t ticks = 0;
+  uint64_t overruns = 0;      // ticks whose work took longer than one period
+  uint64_t skipped_ticks = 0; // dropped to catch up after falling too far behind
+  uint64_t late_ticks = 0;    // started more than a quarter of a period after their deadline
+  uint64_t last_work_ns = 0;
+  uint64_t max_work_ns = 0;
+  uint64_t max_wake_error_ns = 0; // how late a tick started, past its deadline
+};
+
+// Runs a loop at a fixed rate with absolute deadlines, so timing doesn't drift
+// and a slow tick is made up by the next ones:
+//   FixedTickScheduler scheduler(config);
+//   while (running) {
+//     scheduler.wait_for_next_tick();
+//     // receive, simulate, send
+//     scheduler.end_tick();
+//   }
+class FixedTickScheduler
+{
+public:
+  explicit FixedTickScheduler(const TickSchedulerConfig& config = TickSchedulerConfig());
+
+  // sleeps, then spins, until the next tick's deadline. returns the tick number, from 0
+  uint64_t wait_for_next_tick();
+  // records how long the tick's work took
+  void end_tick();
+
+  // restarts the deadlines from now, e.g. after a long pause
+  void reset();
+  void set_tick_rate(float tick_rate_hz);
+
+  [[nodiscard]] uint64_t get_tick() const { return tick; }
+  [[nodiscard]] uint64_t get_period_ns() const { return period_ns; }
+  [[nodiscard]] float get_delta_time_s() const { return static_cast<float>(period_ns) * 1e-9f; }
+  [[nodiscard]] const TickStats& get_stats() const { return stats; }
+
+private:
+  TickSchedulerConfig config;
+  uint64_t period_ns = 0;
+  uint64_t start_ns = 0;    // deadline of tick 0
+  uint64_t next_tick = 0;   // ticks since start_ns, including skipped ones
+  uint64_t tick = 0;        // ticks actually run
+  uint64_t tick_begin_ns = 0;
+  TickStats stats;
+};
+
+} // namespace fightingengine
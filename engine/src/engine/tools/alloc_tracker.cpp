@@ -0,0 +1,166 @@
+// header
+#include "engine/tools/alloc_tracker.hpp"
+
+// c system headers
+// clang-format off
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
+#include "windows.h"
+#include "psapi.h"
+#else
+#include <unistd.h>
+#endif
+// clang-format on
+
+// c++ standard library headers
+#include <atomic>
+#include <new>
+
+namespace fightingengine {
+
+namespace alloc_tracker {
+
+// Plain counters only: anything that allocates in here would recurse.
+static thread_local AllocCounters t_counters;
+static std::atomic<uint64_t> s_allocs{ 0 };
+static std::atomic<uint64_t> s_frees{ 0 };
+static std::atomic<uint64_t> s_bytes_allocated{ 0 };
+static std::atomic<uint64_t> s_bytes_freed{ 0 };
+
+static void
+record_alloc(size_t size)
+{
+  t_counters.allocs += 1;
+  t_counters.bytes_allocated += size;
+  s_allocs.fetch_add(1, std::memory_order_relaxed);
+  s_bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+}
+
+static void
+record_free(size_t size)
+{
+  t_counters.frees += 1;
+  t_counters.bytes_freed += size;
+  s_frees.fetch_add(1, std::memory_order_relaxed);
+  s_bytes_freed.fetch_add(size, std::memory_order_relaxed);
+}
+
+AllocCounters
+get_thread_counters()
+{
+  return t_counters;
+}
+
+AllocCounters
+get_global_counters()
+{
+  AllocCounters counters;
+  counters.allocs = s_allocs.load(std::memory_order_relaxed);
+  counters.frees = s_frees.load(std::memory_order_relaxed);
+  counters.bytes_allocated = s_bytes_allocated.load(std::memory_order_relaxed);
+  counters.bytes_freed = s_bytes_freed.load(std::memory_order_relaxed);
+  return counters;
+}
+
+uint64_t
+get_resident_bytes()
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return 0;
+  return static_cast<uint64_t>(pmc.WorkingSetSize);
+#else
+  // second field of statm is resident pages
+  FILE* f = fopen("/proc/self/statm", "r");
+  if (f == nullptr)
+    return 0;
+  unsigned long long size = 0;
+  unsigned long long resident = 0;
+  int read = fscanf(f, "%llu %llu", &size, &resident);
+  fclose(f);
+  if (read != 2)
+    return 0;
+  return static_cast<uint64_t>(resident) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+} // namespace alloc_tracker
+
+AllocationBudget::AllocationBudget(uint64_t max_allocs_per_frame, int warmup_frames)
+  : max_allocs_per_frame(max_allocs_per_frame)
+  , warmup_frames(warmup_frames)
+{}
+
+bool
+AllocationBudget::check_frame(const AllocCounters& frame)
+{
+  frames_seen += 1;
+  if (frames_seen <= warmup_frames)
+    return true;
+
+  frames_checked += 1;
+  worst_frame_allocs = frame.allocs > worst_frame_allocs ? frame.allocs : worst_frame_allocs;
+  if (frame.allocs <= max_allocs_per_frame)
+    return true;
+
+  frames_over_budget += 1;
+  return false;
+}
+
+} // namespace fightingengine
+
+#ifdef FIGHTINGENGINE_TRACK_ALLOCATIONS
+
+// Each block is prefixed with its size, so frees know how many bytes they release.
+// Aligned new/delete aren't replaced, the defaults don't route through these.
+static constexpr size_t alloc_header_size = alignof(std::max_align_t);
+
+void*
+operator new(size_t size)
+{
+  void* block = std::malloc(size + alloc_header_size);
+  if (block == nullptr)
+    throw std::bad_alloc();
+  *static_cast<size_t*>(block) = size;
+  fightingengine::alloc_tracker::record_alloc(size);
+  return static_cast<char*>(block) + alloc_header_size;
+}
+
+void*
+operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+  if (ptr == nullptr)
+    return;
+  char* block = static_cast<char*>(ptr) - alloc_header_size;
+  fightingengine::alloc_tracker::record_free(*reinterpret_cast<size_t*>(block));
+  std::free(block);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+  operator delete(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+void
+operator delete[](void* ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+#endif // FIGHTINGENGINE_TRACK_ALLOCATIONS
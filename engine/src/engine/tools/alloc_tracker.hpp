@@ -0,0 +1,77 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+namespace fightingengine {
+
+struct AllocCounters
+{
+  uint64_t allocs = 0;
+  uint64_t frees = 0;
+  uint64_t bytes_allocated = 0;
+  uint64_t bytes_freed = 0;
+};
+
+[[nodiscard]] inline AllocCounters
+operator-(const AllocCounters& a, const AllocCounters& b)
+{
+  return {
+    a.allocs - b.allocs, a.frees - b.frees, a.bytes_allocated - b.bytes_allocated, a.bytes_freed - b.bytes_freed
+  };
+}
+
+namespace alloc_tracker {
+
+// Counting replaces the global operator new/delete, so it's opt in:
+// configure with -DFIGHTINGENGINE_TRACK_ALLOCATIONS=ON.
+// Otherwise every counter reads zero.
+[[nodiscard]] constexpr bool
+is_enabled()
+{
+#ifdef FIGHTINGENGINE_TRACK_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+// allocations made by the calling thread
+[[nodiscard]] AllocCounters
+get_thread_counters();
+
+// allocations made by every thread
+[[nodiscard]] AllocCounters
+get_global_counters();
+
+// resident set size (working set on windows), or 0 if unknown
+[[nodiscard]] uint64_t
+get_resident_bytes();
+
+} // namespace alloc_tracker
+
+// For allocation regression runs: once warmed up, a steady-state frame
+// shouldn't allocate more than max_allocs_per_frame.
+class AllocationBudget
+{
+public:
+  AllocationBudget(uint64_t max_allocs_per_frame, int warmup_frames);
+
+  // returns false if the frame went over budget
+  bool check_frame(const AllocCounters& frame);
+
+  [[nodiscard]] bool passed() const { return frames_over_budget == 0; }
+  [[nodiscard]] int get_frames_checked() const { return frames_checked; }
+  [[nodiscard]] int get_frames_over_budget() const { return frames_over_budget; }
+  [[nodiscard]] uint64_t get_worst_frame_allocs() const { return worst_frame_allocs; }
+
+private:
+  uint64_t max_allocs_per_frame;
+  int warmup_frames;
+  int frames_seen = 0;
+  int frames_checked = 0;
+  int frames_over_budget = 0;
+  uint64_t worst_frame_allocs = 0;
+};
+
+} // namespace fightingengine
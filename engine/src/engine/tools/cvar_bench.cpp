@@ -0,0 +1,150 @@
+// header
+#include "engine/tools/cvar_bench.hpp"
+
+// c system headers
+#include <cstdio>
+
+namespace fightingengine {
+
+static CVar<int> cvar_bench_frames("bench.frames_per_value", 300, "frames each value is timed for", 10, 100000);
+static CVar<int> cvar_bench_warmup("bench.warmup_frames", 30, "frames skipped after changing the value", 0, 10000);
+
+bool
+CVarBench::start(CVarBase& cvar_to_bench,
+                 const std::vector<std::string>& values_to_bench,
+                 int frames,
+                 int warmup,
+                 Profiler::Stage stage_to_time)
+{
+  cancel();
+  if (values_to_bench.empty() || frames <= 0)
+    return false;
+
+  cvar = &cvar_to_bench;
+  original_value = cvar->to_string();
+  values = values_to_bench;
+  frames_per_value = frames;
+  warmup_frames = warmup;
+  stage = stage_to_time;
+  histogram.set_window(frames);
+  results.clear();
+  report_ready = false;
+  value_index = 0;
+  begin_value();
+  return true;
+}
+
+void
+CVarBench::cancel()
+{
+  if (cvar == nullptr)
+    return;
+  cvar->set_from_string(original_value);
+  cvar = nullptr;
+}
+
+void
+CVarBench::begin_value()
+{
+  cvar->set_from_string(values[value_index]);
+  frame = 0;
+  sum_ms = 0.0;
+  histogram.reset();
+}
+
+void
+CVarBench::update(const Profiler& profiler)
+{
+  if (cvar != nullptr)
+    update(profiler.get_time(stage));
+}
+
+void
+CVarBench::update(float stage_ms)
+{
+  if (cvar == nullptr)
+    return;
+
+  frame += 1;
+  if (frame <= warmup_frames)
+    return;
+
+  histogram.record(static_cast<uint64_t>(stage_ms * 1000.0f));
+  sum_ms += stage_ms;
+  if (frame < warmup_frames + frames_per_value)
+    return;
+
+  Result result;
+  result.value = cvar->to_string(); // as clamped, rather than as typed
+  result.frames = frames_per_value;
+  result.mean_ms = static_cast<float>(sum_ms / frames_per_value);
+  result.percentiles.p50_ms = histogram.get_percentile(50.0f) / 1000.0f;
+  result.percentiles.p95_ms = histogram.get_percentile(95.0f) / 1000.0f;
+  result.percentiles.p99_ms = histogram.get_percentile(99.0f) / 1000.0f;
+  result.percentiles.max_ms = histogram.get_max() / 1000.0f;
+  results.push_back(result);
+
+  value_index += 1;
+  if (value_index < values.size())
+    begin_value();
+  else {
+    cancel();
+    report_ready = true;
+  }
+}
+
+bool
+CVarBench::take_report(std::vector<std::string>& output)
+{
+  if (!report_ready)
+    return false;
+  report_ready = false;
+
+  output.push_back("bench " + std::string(Profiler::stageNames[static_cast<uint8_t>(stage)]) + " over " +
+                   std::to_string(frames_per_value) + " frames per value:");
+  for (const Result& r : results) {
+    char line[256];
+    snprintf(line,
+             sizeof(line),
+             "  %-12s mean %7.3fms  p50 %7.3fms  p95 %7.3fms  p99 %7.3fms  max %7.3fms",
+             r.value.c_str(),
+             r.mean_ms,
+             r.percentiles.p50_ms,
+             r.percentiles.p95_ms,
+             r.percentiles.p99_ms,
+             r.percentiles.max_ms);
+    output.push_back(line);
+  }
+  return true;
+}
+
+bool
+CVarBench::execute(const std::string& command_line, std::vector<std::string>& output)
+{
+  std::vector<std::string> args = cvars::split_args(command_line);
+  if (args.empty() || (args[0] != "bench" && args[0] != "BENCH"))
+    return false;
+
+  if (args.size() == 2 && args[1] == "cancel") {
+    cancel();
+    output.push_back("bench cancelled");
+    return true;
+  }
+  if (args.size() < 4) {
+    output.push_back("[error] usage: bench <name> <value> <value> [...], or bench cancel");
+    return true;
+  }
+  CVarBase* target = cvars::find(args[1]);
+  if (target == nullptr) {
+    output.push_back("[error] no cvar named '" + args[1] + "'");
+    return true;
+  }
+
+  std::vector<std::string> bench_values(args.begin() + 2, args.end());
+  start(*target, bench_values, cvar_bench_frames.get(), cvar_bench_warmup.get());
+  output.push_back("benching " + args[1] + " with " + std::to_string(bench_values.size()) + " values, " +
+                   std::to_string(cvar_bench_frames.get()) + " frames each");
+  return true;
+}
+
+} // namespace fightingengine
@@ -0,0 +1,68 @@
+#pragma once
+
+// c++ standard library headers
+#include <string>
+#include <vector>
+
+// engine headers
+#include "engine/tools/cvars.hpp"
+#include "engine/tools/latency_histogram.hpp"
+#include "engine/tools/profiler.hpp"
+
+namespace fightingengine {
+
+// A/B tests a cvar on the live build: each value is held for a number of frames
+// (after a short warmup, to let caches and pools settle) and the frame time of one
+// profiler stage is compared across values. The cvar is put back when it's done.
+class CVarBench
+{
+public:
+  struct Result
+  {
+    std::string value;
+    int frames = 0;
+    float mean_ms = 0.0f;
+    Profiler::StagePercentiles percentiles;
+  };
+
+  bool start(CVarBase& cvar,
+             const std::vector<std::string>& values,
+             int frames_per_value = 300,
+             int warmup_frames = 30,
+             Profiler::Stage stage = Profiler::Stage::UpdateLoop);
+  void cancel();
+
+  // call once per frame, after Profiler::new_frame()
+  void update(const Profiler& profiler);
+  void update(float stage_ms);
+
+  [[nodiscard]] bool is_running() const { return cvar != nullptr; }
+  [[nodiscard]] const std::vector<Result>& get_results() const { return results; }
+
+  // returns true once, when a bench finishes, with a line per value
+  bool take_report(std::vector<std::string>& output);
+
+  // bench <name> <value> <value> [...]
+  // returns false if the line isn't a bench command
+  bool execute(const std::string& command_line, std::vector<std::string>& output);
+
+private:
+  void begin_value();
+
+  CVarBase* cvar = nullptr;
+  std::string original_value;
+  std::vector<std::string> values;
+  int frames_per_value = 0;
+  int warmup_frames = 0;
+  Profiler::Stage stage = Profiler::Stage::UpdateLoop;
+
+  size_t value_index = 0;
+  int frame = 0;
+  double sum_ms = 0.0;
+  LatencyHistogram histogram;
+
+  std::vector<Result> results;
+  bool report_ready = false;
+};
+
+} // namespace fightingengine
@@ -0,0 +1,162 @@
+// header
+#include "engine/tools/cvars.hpp"
+
+// c++ standard library headers
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace fightingengine {
+
+// function statics, so cvars declared at namespace scope in other files can register during static init
+static std::mutex&
+get_registry_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::map<std::string, CVarBase*>&
+get_registry()
+{
+  static std::map<std::string, CVarBase*> registry;
+  return registry;
+}
+
+CVarBase::CVarBase(const char* name, const char* description, Type type)
+  : name(name)
+  , description(description)
+  , type(type)
+{
+  std::lock_guard<std::mutex> lock(get_registry_mutex());
+  get_registry()[name] = this; // a duplicate name replaces the older cvar
+}
+
+CVarBase::~CVarBase()
+{
+  std::lock_guard<std::mutex> lock(get_registry_mutex());
+  auto it = get_registry().find(name);
+  if (it != get_registry().end() && it->second == this)
+    get_registry().erase(it);
+}
+
+namespace cvars {
+
+CVarBase*
+find(const std::string& name)
+{
+  std::lock_guard<std::mutex> lock(get_registry_mutex());
+  auto it = get_registry().find(name);
+  return it != get_registry().end() ? it->second : nullptr;
+}
+
+std::vector<CVarBase*>
+get_all()
+{
+  std::lock_guard<std::mutex> lock(get_registry_mutex());
+  std::vector<CVarBase*> all;
+  all.reserve(get_registry().size());
+  for (const auto& [name, cvar] : get_registry())
+    all.push_back(cvar);
+  return all;
+}
+
+std::vector<std::string>
+split_args(const std::string& command_line)
+{
+  std::vector<std::string> args;
+  std::istringstream ss(command_line);
+  std::string arg;
+  while (ss >> arg)
+    args.push_back(arg);
+  return args;
+}
+
+static std::string
+to_lower(std::string str)
+{
+  for (char& c : str)
+    c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return str;
+}
+
+static std::string
+describe(const CVarBase& cvar)
+{
+  std::string line = std::string(cvar.get_name()) + " = " + cvar.to_string();
+  if (cvar.to_string() != cvar.get_default_string())
+    line += " (default " + cvar.get_default_string() + ")";
+  return line;
+}
+
+static void
+set_value(CVarBase& cvar, const std::string& value, std::vector<std::string>& output)
+{
+  if (!cvar.set_from_string(value)) {
+    output.push_back("[error] can't set " + std::string(cvar.get_name()) + " to '" + value + "', range is " +
+                     cvar.get_range_string());
+    return;
+  }
+  output.push_back(describe(cvar));
+}
+
+bool
+execute(const std::string& command_line, std::vector<std::string>& output)
+{
+  std::vector<std::string> args = split_args(command_line);
+  if (args.empty())
+    return false;
+  const std::string verb = to_lower(args[0]);
+
+  if (verb == "list") {
+    const std::string filter = args.size() > 1 ? args[1] : "";
+    for (CVarBase* cvar : get_all()) {
+      if (!filter.empty() && strstr(cvar->get_name(), filter.c_str()) == nullptr)
+        continue;
+      output.push_back(describe(*cvar) + "  [" + cvar->get_range_string() + "] " + cvar->get_description());
+    }
+    return true;
+  }
+
+  if (verb == "get" || verb == "set" || verb == "reset") {
+    if (args.size() < 2 || (verb == "set" && args.size() < 3)) {
+      output.push_back("[error] usage: " + verb + (verb == "set" ? " <name> <value>" : " <name>"));
+      return true;
+    }
+    if (verb == "reset" && args[1] == "all") {
+      for (CVarBase* cvar : get_all())
+        cvar->reset();
+      output.push_back("reset every cvar");
+      return true;
+    }
+    CVarBase* cvar = find(args[1]);
+    if (cvar == nullptr) {
+      output.push_back("[error] no cvar named '" + args[1] + "'");
+      return true;
+    }
+    if (verb == "set")
+      set_value(*cvar, args[2], output);
+    else {
+      if (verb == "reset")
+        cvar->reset();
+      output.push_back(describe(*cvar));
+    }
+    return true;
+  }
+
+  // "<name>" and "<name> <value>"
+  CVarBase* cvar = find(args[0]);
+  if (cvar == nullptr)
+    return false;
+  if (args.size() > 1)
+    set_value(*cvar, args[1], output);
+  else
+    output.push_back(describe(*cvar) + "  [" + cvar->get_range_string() + "] " + cvar->get_description());
+  return true;
+}
+
+} // namespace cvars
+
+} // namespace fightingengine
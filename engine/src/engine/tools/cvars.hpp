@@ -0,0 +1,180 @@
+#pragma once
+
+// c system headers
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+// c++ standard library headers
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace fightingengine {
+
+// A named tuning knob that can be changed at runtime (e.g. from the console).
+// Declare them at namespace scope next to the code that reads them:
+//   static CVar<int> cvar_grid_size("physics.grid_size", 100, "broadphase cell size in pixels", 8, 1024);
+// and read with cvar_grid_size.get(), a relaxed atomic load, so reading never takes a lock.
+class CVarBase
+{
+public:
+  enum class Type : uint8_t
+  {
+    Int,
+    Float,
+    Bool,
+  };
+
+  CVarBase(const char* name, const char* description, Type type);
+  virtual ~CVarBase();
+
+  CVarBase(const CVarBase&) = delete;
+  CVarBase& operator=(const CVarBase&) = delete;
+
+  [[nodiscard]] const char* get_name() const { return name; }
+  [[nodiscard]] const char* get_description() const { return description; }
+  [[nodiscard]] Type get_type() const { return type; }
+
+  [[nodiscard]] virtual std::string to_string() const = 0;
+  [[nodiscard]] virtual std::string get_default_string() const = 0;
+  [[nodiscard]] virtual std::string get_range_string() const = 0;
+  // returns false (and leaves the value alone) if str doesn't parse. out of range values are clamped
+  virtual bool set_from_string(const std::string& str) = 0;
+  virtual void reset() = 0;
+
+private:
+  const char* name;
+  const char* description;
+  Type type;
+};
+
+template<typename T>
+class CVar final : public CVarBase
+{
+  static_assert(std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, bool>,
+                "CVar is int, float or bool");
+
+public:
+  CVar(const char* name,
+       T default_value,
+       const char* description,
+       T min_value = std::numeric_limits<T>::lowest(),
+       T max_value = std::numeric_limits<T>::max())
+    : CVarBase(name, description, get_cvar_type())
+    , default_value(default_value)
+    , min_value(min_value)
+    , max_value(max_value)
+    , value(default_value)
+  {}
+
+  [[nodiscard]] T get() const { return value.load(std::memory_order_relaxed); }
+  void set(T v) { value.store(std::clamp(v, min_value, max_value), std::memory_order_relaxed); }
+  [[nodiscard]] T get_default() const { return default_value; }
+
+  [[nodiscard]] std::string to_string() const override { return format(get()); }
+  [[nodiscard]] std::string get_default_string() const override { return format(default_value); }
+  [[nodiscard]] std::string get_range_string() const override
+  {
+    if constexpr (std::is_same_v<T, bool>)
+      return "0..1";
+    else
+      return format(min_value) + ".." + format(max_value);
+  }
+
+  bool set_from_string(const std::string& str) override
+  {
+    T parsed{};
+    if (!parse(str, parsed))
+      return false;
+    set(parsed);
+    return true;
+  }
+
+  void reset() override { set(default_value); }
+
+private:
+  static constexpr Type get_cvar_type()
+  {
+    if constexpr (std::is_same_v<T, int>)
+      return Type::Int;
+    else if constexpr (std::is_same_v<T, float>)
+      return Type::Float;
+    else
+      return Type::Bool;
+  }
+
+  static std::string format(T v)
+  {
+    if constexpr (std::is_same_v<T, bool>)
+      return v ? "1" : "0";
+    else
+      return std::to_string(v);
+  }
+
+  static bool parse(const std::string& str, T& out)
+  {
+    if (str.empty())
+      return false;
+    char* end = nullptr;
+    if constexpr (std::is_same_v<T, bool>) {
+      if (str == "true" || str == "on")
+        out = true;
+      else if (str == "false" || str == "off")
+        out = false;
+      else {
+        errno = 0;
+        long v = std::strtol(str.c_str(), &end, 10);
+        if (errno == ERANGE)
+          return false;
+        out = v != 0;
+      }
+    } else if constexpr (std::is_same_v<T, int>) {
+      errno = 0;
+      long v = std::strtol(str.c_str(), &end, 10);
+      if (errno == ERANGE || v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max())
+        return false; // "4294967297" would wrap to 1 when narrowed
+      out = static_cast<int>(v);
+    } else {
+      out = std::strtof(str.c_str(), &end);
+      if (!std::isfinite(out))
+        return false; // "nan" and "inf" parse, but would get through the clamp or pin to a bound
+    }
+    return end == nullptr || *end == '\0';
+  }
+
+  const T default_value;
+  const T min_value;
+  const T max_value;
+  std::atomic<T> value;
+};
+
+namespace cvars {
+
+[[nodiscard]] CVarBase*
+find(const std::string& name);
+
+// sorted by name
+[[nodiscard]] std::vector<CVarBase*>
+get_all();
+
+// Runs a console command:
+//   list [filter]    every cvar containing filter
+//   get <name>       or just <name>
+//   set <name> <v>   or just <name> <v>
+//   reset <name|all>
+// Returns false if the line isn't a cvar command. Messages for the user are appended to output.
+bool
+execute(const std::string& command_line, std::vector<std::string>& output);
+
+// splits on whitespace
+[[nodiscard]] std::vector<std::string>
+split_args(const std::string& command_line);
+
+} // namespace cvars
+
+} // namespace fightingengine
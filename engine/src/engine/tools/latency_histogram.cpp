@@ -0,0 +1,103 @@
+// header
+#include "engine/tools/latency_histogram.hpp"
+
+// c system headers
+#include <cassert>
+
+namespace fightingengine {
+
+LatencyHistogram::LatencyHistogram(int window)
+{
+  set_window(window);
+}
+
+void
+LatencyHistogram::set_window(int window)
+{
+  assert(window > 0);
+  samples.assign(window, 0);
+  reset();
+}
+
+void
+LatencyHistogram::reset()
+{
+  buckets.fill(0);
+  next_sample = 0;
+  count = 0;
+}
+
+int
+LatencyHistogram::get_bucket_index(uint64_t value_us)
+{
+  const uint64_t max_value = (uint64_t(1) << max_value_bits) - 1;
+  if (value_us > max_value)
+    value_us = max_value;
+
+  // the first two powers of two are linear
+  if (value_us < 2 * sub_bucket_count)
+    return static_cast<int>(value_us);
+
+  int msb = 63;
+  while ((value_us >> msb) == 0)
+    msb--;
+  int shift = msb - sub_bucket_bits;
+  return (shift + 1) * sub_bucket_count + static_cast<int>((value_us >> shift) - sub_bucket_count);
+}
+
+uint64_t
+LatencyHistogram::get_bucket_upper_bound(int index)
+{
+  if (index < 2 * sub_bucket_count)
+    return static_cast<uint64_t>(index);
+
+  int shift = index / sub_bucket_count - 1;
+  uint64_t sub = static_cast<uint64_t>(index % sub_bucket_count + sub_bucket_count);
+  return ((sub + 1) << shift) - 1;
+}
+
+void
+LatencyHistogram::record(uint64_t value_us)
+{
+  const int window = get_window();
+
+  // evict the oldest value once the window is full
+  if (count == window)
+    buckets[get_bucket_index(samples[next_sample])] -= 1;
+  else
+    count += 1;
+
+  samples[next_sample] = value_us;
+  next_sample = (next_sample + 1) % window;
+  buckets[get_bucket_index(value_us)] += 1;
+}
+
+uint64_t
+LatencyHistogram::get_percentile(float p) const
+{
+  if (count == 0)
+    return 0;
+
+  // the rank of the value at percentile p, 1 based
+  int rank = static_cast<int>(p / 100.0f * count + 0.5f);
+  rank = rank < 1 ? 1 : (rank > count ? count : rank);
+
+  int seen = 0;
+  for (int i = 0; i < bucket_count; i++) {
+    seen += buckets[i];
+    if (seen >= rank)
+      return get_bucket_upper_bound(i);
+  }
+  return get_bucket_upper_bound(bucket_count - 1);
+}
+
+uint64_t
+LatencyHistogram::get_max() const
+{
+  uint64_t max = 0;
+  for (int i = 0; i < count; i++)
+    max = samples[i] > max ? samples[i] : max;
+  return max;
+}
+
+} // namespace fightingengine
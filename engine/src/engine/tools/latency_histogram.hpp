@@ -0,0 +1,47 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+// c++ standard library headers
+#include <array>
+#include <vector>
+
+namespace fightingengine {
+
+// An HDR-style log-linear histogram of microsecond values.
+// Each power of two is split in to 32 sub-buckets, so a reported
+// percentile is within ~3% of the recorded value, from 1us up to ~67s.
+// Only the last "window" values are kept, so percentiles roll with the frames.
+class LatencyHistogram
+{
+public:
+  static constexpr int sub_bucket_bits = 5;
+  static constexpr int sub_bucket_count = 1 << sub_bucket_bits;
+  static constexpr int max_value_bits = 26;
+  static constexpr int bucket_count = (max_value_bits - sub_bucket_bits + 1) * sub_bucket_count;
+
+  explicit LatencyHistogram(int window = 600);
+
+  void record(uint64_t value_us);
+  void reset();
+  void set_window(int window);
+
+  // p in [0, 100]. Returns the upper bound of the bucket the percentile lands in.
+  [[nodiscard]] uint64_t get_percentile(float p) const;
+  // exact, not bucketed
+  [[nodiscard]] uint64_t get_max() const;
+  [[nodiscard]] int get_count() const { return count; }
+  [[nodiscard]] int get_window() const { return static_cast<int>(samples.size()); }
+
+  [[nodiscard]] static int get_bucket_index(uint64_t value_us);
+  [[nodiscard]] static uint64_t get_bucket_upper_bound(int index);
+
+private:
+  std::array<uint32_t, bucket_count> buckets{};
+  std::vector<uint64_t> samples; // ring of the values in the window
+  int next_sample = 0;
+  int count = 0;
+};
+
+} // namespace fightingengine
@@ -0,0 +1,365 @@
+// header
+#include "engine/tools/logger.hpp"
+
+// c system headers
+#include <cinttypes>
+#include <cstdio>
+
+// c++ standard library headers
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// engine headers
+#include "engine/tools/mpsc_ring.hpp"
+#include "engine/tools/zone_profiler.hpp"
+
+namespace fightingengine {
+
+namespace logger {
+
+namespace detail {
+std::atomic<uint8_t> runtime_level{ static_cast<uint8_t>(LogLevel::Info) };
+} // namespace detail
+
+static constexpr uint64_t rate_limit_window_ns = 1000000000;
+
+static const uint64_t s_time_zero_ns = zone_profiler::now_ns();
+static std::atomic<uint32_t> s_next_thread_id{ 0 };
+static thread_local uint32_t t_thread_id = UINT32_MAX;
+
+static std::atomic<uint32_t> s_max_per_site_per_second{ 20 };
+static std::atomic<uint64_t> s_dropped{ 0 };
+static std::atomic<uint64_t> s_written{ 0 };
+
+// the writer thread, and what it owns while running
+static std::atomic<bool> s_running{ false };
+static std::unique_ptr<MpscRing<LogRecord>> s_ring;
+static std::atomic<uint64_t> s_pushed{ 0 };
+static std::atomic<uint32_t> s_producers{ 0 }; // in submit() with the ring, stop() waits these out
+static std::thread s_writer;
+static std::mutex s_writer_mutex;
+static std::condition_variable s_writer_cv;
+static std::condition_variable s_drained_cv;
+static bool s_stopping = false;
+static uint64_t s_processed = 0; // guarded by s_writer_mutex
+static bool s_to_stdout = true;
+static FILE* s_file = nullptr;
+
+// serialises writers when there's no background thread
+static std::mutex s_sync_mutex;
+
+static uint32_t
+get_thread_id()
+{
+  if (t_thread_id == UINT32_MAX)
+    t_thread_id = s_next_thread_id.fetch_add(1, std::memory_order_relaxed);
+  return t_thread_id;
+}
+
+static void
+write_line(const std::string& line)
+{
+  if (s_to_stdout)
+    fwrite(line.data(), 1, line.size(), stdout);
+  if (s_file)
+    fwrite(line.data(), 1, line.size(), s_file);
+  s_written.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void
+flush_outputs()
+{
+  if (s_to_stdout)
+    fflush(stdout);
+  if (s_file)
+    fflush(s_file);
+}
+
+static void
+writer_loop()
+{
+  std::string line;
+  LogRecord record;
+  std::unique_lock<std::mutex> lock(s_writer_mutex);
+  for (;;) {
+    lock.unlock();
+    uint64_t count = 0;
+    while (s_ring->try_pop(record)) {
+      format_line(record, line);
+      write_line(line);
+      count += 1;
+    }
+    if (count > 0)
+      flush_outputs();
+    lock.lock();
+
+    s_processed += count;
+    s_drained_cv.notify_all();
+    if (s_stopping && s_processed >= s_pushed.load(std::memory_order_acquire))
+      break;
+    // producers only wake the writer for errors and flushes, otherwise it polls
+    s_writer_cv.wait_for(lock, std::chrono::milliseconds(5));
+  }
+}
+
+bool
+start(const LoggerConfig& config)
+{
+  if (s_running)
+    stop();
+
+  set_level(config.level);
+  s_max_per_site_per_second = config.max_per_site_per_second;
+  s_to_stdout = config.to_stdout;
+  if (!config.file_path.empty()) {
+    s_file = fopen(config.file_path.c_str(), "w");
+    if (s_file == nullptr) {
+      fprintf(stderr, "(logger) failed to open %s\n", config.file_path.c_str());
+      return false;
+    }
+  }
+
+  s_ring = std::make_unique<MpscRing<LogRecord>>(config.capacity);
+  s_pushed = 0;
+  s_processed = 0;
+  s_stopping = false;
+  s_writer = std::thread(writer_loop);
+  s_running = true;
+  return true;
+}
+
+void
+stop()
+{
+  if (!s_running)
+    return;
+  s_running = false; // new messages are written synchronously from here
+
+  // anyone who saw s_running before it went false is still pushing. once they're done nothing
+  // else touches the ring, and s_pushed is final so the writer drains everything
+  while (s_producers.load() != 0)
+    std::this_thread::yield();
+
+  {
+    std::lock_guard<std::mutex> lock(s_writer_mutex);
+    s_stopping = true;
+  }
+  s_writer_cv.notify_one();
+  s_writer.join();
+  s_ring.reset();
+
+  if (s_file) {
+    fclose(s_file);
+    s_file = nullptr;
+  }
+  s_to_stdout = true;
+}
+
+void
+flush()
+{
+  if (!s_running) {
+    fflush(stdout);
+    return;
+  }
+  uint64_t target = s_pushed.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(s_writer_mutex);
+  s_writer_cv.notify_one();
+  s_drained_cv.wait(lock, [target] { return s_processed >= target; });
+}
+
+void
+set_level(LogLevel level)
+{
+  detail::runtime_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+LogLevel
+get_level()
+{
+  return static_cast<LogLevel>(detail::runtime_level.load(std::memory_order_relaxed));
+}
+
+uint64_t
+get_dropped_count()
+{
+  return s_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t
+get_written_count()
+{
+  return s_written.load(std::memory_order_relaxed);
+}
+
+const char*
+get_level_name(LogLevel level)
+{
+  switch (level) {
+    case LogLevel::Trace:
+      return "TRACE";
+    case LogLevel::Debug:
+      return "DEBUG";
+    case LogLevel::Info:
+      return "INFO";
+    case LogLevel::Warn:
+      return "WARN";
+    case LogLevel::Error:
+      return "ERROR";
+    default:
+      return "OFF";
+  }
+}
+
+static void
+append_arg(const LogRecord& record, const LogArg& arg, std::string& out)
+{
+  char buf[32];
+  int len = 0;
+  switch (arg.type) {
+    case LogArg::Type::Int:
+      len = snprintf(buf, sizeof(buf), "%" PRId64, arg.i);
+      break;
+    case LogArg::Type::Uint:
+      len = snprintf(buf, sizeof(buf), "%" PRIu64, arg.u);
+      break;
+    case LogArg::Type::Double:
+      len = snprintf(buf, sizeof(buf), "%g", arg.d);
+      break;
+    case LogArg::Type::Bool:
+      out += arg.u ? "true" : "false";
+      return;
+    case LogArg::Type::String:
+      out.append(record.payload + arg.str_offset, arg.str_len);
+      return;
+    case LogArg::Type::Pointer:
+      len = snprintf(buf, sizeof(buf), "%p", arg.p);
+      break;
+  }
+  if (len > 0)
+    out.append(buf, len < static_cast<int>(sizeof(buf)) ? len : sizeof(buf) - 1);
+}
+
+void
+format_message(const LogRecord& record, std::string& out)
+{
+  out.clear();
+  if (record.fmt == nullptr)
+    return;
+  int next_arg = 0;
+  for (const char* c = record.fmt; *c != '\0'; c++) {
+    if (c[0] == '{' && c[1] == '}' && next_arg < record.arg_count) {
+      append_arg(record, record.args[next_arg++], out);
+      c++;
+    } else
+      out += *c;
+  }
+}
+
+void
+format_line(const LogRecord& record, std::string& out)
+{
+  std::string message;
+  format_message(record, message);
+
+  // just the file name, not the whole build path
+  const char* file = record.file ? record.file : "";
+  for (const char* c = file; *c != '\0'; c++) {
+    if (*c == '/' || *c == '\\')
+      file = c + 1;
+  }
+
+  char prefix[128];
+  double seconds = static_cast<double>(record.ts_ns - s_time_zero_ns) * 1e-9;
+  snprintf(prefix,
+           sizeof(prefix),
+           "%10.6f [%-5s] t%u %s:%i ",
+           seconds,
+           get_level_name(record.level),
+           record.thread_id,
+           file,
+           record.line);
+
+  out.clear();
+  out += prefix;
+  out += message;
+  if (record.suppressed > 0)
+    out += " (" + std::to_string(record.suppressed) + " more suppressed)";
+  out += '\n';
+}
+
+namespace detail {
+
+bool
+allow(LogSite& site, uint32_t& suppressed)
+{
+  uint32_t max = s_max_per_site_per_second.load(std::memory_order_relaxed);
+  if (!site.rate_limited || max == 0) {
+    suppressed = 0;
+    return true;
+  }
+
+  uint64_t now = zone_profiler::now_ns();
+  uint64_t window_start = site.window_start_ns.load(std::memory_order_relaxed);
+  if (now - window_start >= rate_limit_window_ns &&
+      site.window_start_ns.compare_exchange_strong(window_start, now, std::memory_order_relaxed))
+    site.in_window.store(0, std::memory_order_relaxed);
+
+  if (site.in_window.fetch_add(1, std::memory_order_relaxed) >= max) {
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+  return true;
+}
+
+void
+copy_string(LogRecord& record, LogArg& arg, const char* str, size_t len)
+{
+  arg.type = LogArg::Type::String;
+  size_t space = LogRecord::max_string_bytes - record.payload_used;
+  if (len > space)
+    len = space;
+  if (len > 0)
+    memcpy(record.payload + record.payload_used, str, len);
+  arg.str_offset = record.payload_used;
+  arg.str_len = static_cast<uint16_t>(len);
+  record.payload_used += static_cast<uint16_t>(len);
+}
+
+void
+submit(LogRecord& record)
+{
+  record.ts_ns = zone_profiler::now_ns();
+  record.thread_id = get_thread_id();
+
+  // counted before s_running is checked, so stop() can't free the ring under a push.
+  // both sequentially consistent: either stop() sees this producer, or this sees s_running go false
+  s_producers.fetch_add(1);
+  if (s_running.load()) {
+    bool pushed = s_ring->try_push(record);
+    if (pushed)
+      s_pushed.fetch_add(1, std::memory_order_release);
+    else
+      s_dropped.fetch_add(1, std::memory_order_relaxed);
+    s_producers.fetch_sub(1, std::memory_order_release);
+    if (pushed && record.level >= LogLevel::Error)
+      s_writer_cv.notify_one();
+    return;
+  }
+  s_producers.fetch_sub(1, std::memory_order_release);
+
+  std::string line;
+  format_line(record, line);
+  std::lock_guard<std::mutex> lock(s_sync_mutex);
+  write_line(line);
+  flush_outputs();
+}
+
+} // namespace detail
+
+} // namespace logger
+
+} // namespace fightingengine
@@ -0,0 +1,238 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+#include <cstring>
+
+// c++ standard library headers
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Messages below this level are compiled out. 0 trace, 1 debug, 2 info, 3 warn, 4 error, 5 off
+#ifndef FIGHTINGENGINE_LOG_LEVEL
+#define FIGHTINGENGINE_LOG_LEVEL 0
+#endif
+
+namespace fightingengine {
+
+enum class LogLevel : uint8_t
+{
+  Trace = 0,
+  Debug,
+  Info,
+  Warn,
+  Error,
+  Off,
+};
+
+// One argument, captured by value. Strings are copied in to the record's payload.
+struct LogArg
+{
+  enum class Type : uint8_t
+  {
+    Int,
+    Uint,
+    Double,
+    Bool,
+    String,
+    Pointer,
+  };
+  Type type = Type::Int;
+  uint16_t str_offset = 0;
+  uint16_t str_len = 0;
+  union
+  {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void* p;
+  };
+};
+
+// What goes through the ring. Fixed size, so the hot path never allocates,
+// and the text isn't formatted until the writer thread gets to it.
+struct LogRecord
+{
+  static constexpr int max_args = 8;
+  static constexpr int max_string_bytes = 224; // longer strings are truncated
+
+  LogLevel level = LogLevel::Info;
+  uint8_t arg_count = 0;
+  uint16_t payload_used = 0;
+  uint32_t thread_id = 0;
+  uint32_t suppressed = 0; // messages from this site dropped by the rate limit since the last one
+  uint64_t ts_ns = 0;
+  const char* fmt = nullptr; // must outlive the logger, e.g. a string literal
+  const char* file = nullptr;
+  int line = 0;
+  LogArg args[max_args];
+  char payload[max_string_bytes];
+};
+
+// One per call site (a function static, made by the FE_LOG macros)
+struct LogSite
+{
+  const char* file = nullptr;
+  int line = 0;
+  LogLevel level = LogLevel::Info;
+  bool rate_limited = true;
+
+  std::atomic<uint64_t> window_start_ns{ 0 };
+  std::atomic<uint32_t> in_window{ 0 };
+  std::atomic<uint32_t> suppressed{ 0 };
+};
+
+struct LoggerConfig
+{
+  LogLevel level = LogLevel::Info;
+  size_t capacity = 4096;                // records, rounded up to a power of two
+  uint32_t max_per_site_per_second = 20; // 0 for no limit
+  bool to_stdout = true;
+  std::string file_path; // empty for no log file
+};
+
+// Severity-filtered, rate-limited logging that's safe to call from the frame thread.
+// Callers copy their arguments in to a fixed size record and push it to a lock-free
+// ring; a background thread formats and writes it. If the ring is full the record is
+// dropped (and counted), the caller never blocks on io.
+// Before start() (or after stop()) messages are formatted and written immediately.
+namespace logger {
+
+bool
+start(const LoggerConfig& config = LoggerConfig());
+
+// writes everything still in the ring, then joins the writer thread.
+// call once the other threads have stopped logging.
+void
+stop();
+
+// blocks until everything logged so far has been written
+void
+flush();
+
+void
+set_level(LogLevel level);
+
+[[nodiscard]] LogLevel
+get_level();
+
+[[nodiscard]] uint64_t
+get_dropped_count();
+
+[[nodiscard]] uint64_t
+get_written_count();
+
+[[nodiscard]] const char*
+get_level_name(LogLevel level);
+
+// "{}" in fmt is replaced by the next argument
+void
+format_message(const LogRecord& record, std::string& out);
+
+// timestamp, level, file:line, message
+void
+format_line(const LogRecord& record, std::string& out);
+
+namespace detail {
+
+extern std::atomic<uint8_t> runtime_level;
+
+// returns false if the site is over its rate limit
+bool
+allow(LogSite& site, uint32_t& suppressed);
+
+void
+copy_string(LogRecord& record, LogArg& arg, const char* str, size_t len);
+
+void
+submit(LogRecord& record);
+
+template<typename T>
+struct always_false : std::false_type
+{};
+
+template<typename T>
+void
+capture(LogRecord& record, const T& value)
+{
+  if (record.arg_count >= LogRecord::max_args)
+    return;
+  LogArg& arg = record.args[record.arg_count++];
+
+  using D = std::decay_t<T>;
+  if constexpr (std::is_same_v<D, bool>) {
+    arg.type = LogArg::Type::Bool;
+    arg.u = value ? 1 : 0;
+  } else if constexpr (std::is_enum_v<D>) {
+    arg.type = LogArg::Type::Int;
+    arg.i = static_cast<int64_t>(value);
+  } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+    arg.type = LogArg::Type::Int;
+    arg.i = value;
+  } else if constexpr (std::is_integral_v<D>) {
+    arg.type = LogArg::Type::Uint;
+    arg.u = value;
+  } else if constexpr (std::is_floating_point_v<D>) {
+    arg.type = LogArg::Type::Double;
+    arg.d = value;
+  } else if constexpr (std::is_same_v<D, std::string> || std::is_same_v<D, std::string_view>)
+    copy_string(record, arg, value.data(), value.size());
+  else if constexpr (std::is_convertible_v<D, const char*>) {
+    const char* str = value;
+    copy_string(record, arg, str, str ? strlen(str) : 0);
+  } else if constexpr (std::is_pointer_v<D>) {
+    arg.type = LogArg::Type::Pointer;
+    arg.p = value;
+  } else
+    static_assert(always_false<D>::value, "unsupported log argument type");
+}
+
+} // namespace detail
+
+[[nodiscard]] inline bool
+is_enabled(LogLevel level)
+{
+  return static_cast<uint8_t>(level) >= detail::runtime_level.load(std::memory_order_relaxed);
+}
+
+// prefer the FE_LOG macros, which make the site and strip disabled levels
+template<typename... Args>
+void
+write(LogSite& site, const char* fmt, const Args&... args)
+{
+  uint32_t suppressed = 0;
+  if (!detail::allow(site, suppressed))
+    return;
+
+  LogRecord record;
+  record.level = site.level;
+  record.file = site.file;
+  record.line = site.line;
+  record.fmt = fmt;
+  record.suppressed = suppressed;
+  (detail::capture(record, args), ...);
+  detail::submit(record);
+}
+
+} // namespace logger
+
+} // namespace fightingengine
+
+// usage: FE_LOG_WARN("(EnemySpawner) gave up after {} iterations", iterations);
+#define FE_LOG(lvl, fmt, ...)                                                                                         \
+  do {                                                                                                                 \
+    if constexpr (static_cast<int>(lvl) >= FIGHTINGENGINE_LOG_LEVEL) {                                                 \
+      if (fightingengine::logger::is_enabled(lvl)) {                                                                   \
+        static fightingengine::LogSite fe_log_site{ __FILE__, __LINE__, lvl };                                         \
+        fightingengine::logger::write(fe_log_site, fmt, ##__VA_ARGS__);                                                \
+      }                                                                                                                \
+    }                                                                                                                  \
+  } while (0)
+
+#define FE_LOG_TRACE(fmt, ...) FE_LOG(fightingengine::LogLevel::Trace, fmt, ##__VA_ARGS__)
+#define FE_LOG_DEBUG(fmt, ...) FE_LOG(fightingengine::LogLevel::Debug, fmt, ##__VA_ARGS__)
+#define FE_LOG_INFO(fmt, ...) FE_LOG(fightingengine::LogLevel::Info, fmt, ##__VA_ARGS__)
+#define FE_LOG_WARN(fmt, ...) FE_LOG(fightingengine::LogLevel::Warn, fmt, ##__VA_ARGS__)
+#define FE_LOG_ERROR(fmt, ...) FE_LOG(fightingengine::LogLevel::Error, fmt, ##__VA_ARGS__)
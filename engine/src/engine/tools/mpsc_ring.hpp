@@ -0,0 +1,90 @@
+#pragma once
+
+// c system headers
+#include <cstddef>
+#include <cstdint>
+
+// c++ standard library headers
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace fightingengine {
+
+// Bounded multi-producer single-consumer queue (Vyukov's sequence-per-slot ring).
+// Producers claim a slot with one CAS and never wait on each other or on the consumer:
+// if the ring is full, try_push() fails and the caller decides what to drop.
+// capacity is rounded up to a power of two.
+template<typename T>
+class MpscRing
+{
+public:
+  explicit MpscRing(size_t capacity)
+  {
+    size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+    mask = size - 1;
+    slots = std::make_unique<Slot[]>(size);
+    for (size_t i = 0; i < size; i++)
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  MpscRing(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+
+  // any thread
+  bool try_push(const T& value) { return push(value); }
+  bool try_push(T&& value) { return push(std::move(value)); }
+
+  // the single consumer thread only
+  bool try_pop(T& value)
+  {
+    Slot& slot = slots[tail & mask];
+    size_t seq = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(tail + 1) < 0)
+      return false; // empty, or the producer hasn't finished writing yet
+    value = std::move(slot.value);
+    slot.sequence.store(tail + mask + 1, std::memory_order_release);
+    tail += 1;
+    return true;
+  }
+
+  [[nodiscard]] size_t capacity() const { return mask + 1; }
+
+private:
+  struct Slot
+  {
+    std::atomic<size_t> sequence{ 0 };
+    T value;
+  };
+
+  size_t mask = 0;
+  std::unique_ptr<Slot[]> slots;
+  alignas(64) std::atomic<size_t> head{ 0 }; // shared by the producers
+  alignas(64) size_t tail = 0;               // only touched by the consumer
+
+  template<typename U>
+  bool push(U&& value)
+  {
+    size_t pos = head.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = slots[pos & mask];
+      size_t seq = slot.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          slot.value = std::forward<U>(value);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0)
+        return false; // full
+      else
+        pos = head.load(std::memory_order_relaxed);
+    }
+  }
+
+};
+
+} // namespace fightingengine
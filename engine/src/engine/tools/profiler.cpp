@@ -7,6 +7,7 @@
 
 // c++ standard library headers
 #include <numeric>
+#include <utility>
 
 namespace fightingengine {
 
@@ -16,12 +17,56 @@ Profiler::get_entry_index(int8_t offset) const
   return (current_entry + frames_data_live + offset) % frames_data_live;
 }
 
+Profiler::Profiler()
+{
+  set_percentile_window(600);
+}
+
 void
 Profiler::new_frame()
 {
   auto& prevEntry = entries[current_entry];
   current_entry = (current_entry + 1) % frames_data_live;
-  prevEntry.frame_end = entries[current_entry].frame_start = std::chrono::system_clock::now();
+  prevEntry.frame_end = entries[current_entry].frame_start = ProfilerClock::now();
+
+  // the entry is reused every frames_data_live frames, stages not begun this frame mustn't keep old times
+  for (DeltaTime& stage : entries[current_entry].stages)
+    stage = DeltaTime();
+
+  uint64_t now = zone_profiler::now_ns();
+  last_zone_frame.start_ns = zone_frame_start_ns != 0 ? zone_frame_start_ns : now;
+  last_zone_frame.end_ns = now;
+  last_zone_frame.events.clear();
+  zone_profiler::collect(last_zone_frame.events);
+  bool first_frame = zone_frame_start_ns == 0;
+  zone_frame_start_ns = now;
+
+  AllocCounters allocs = alloc_tracker::get_global_counters();
+  last_frame_allocs = allocs - frame_alloc_start;
+  frame_alloc_start = allocs;
+
+  if (first_frame)
+    return;
+  frame_index += 1;
+
+  for (int i = 0; i < static_cast<int>(Stage::_count); i++) {
+    const DeltaTime& stage = prevEntry.stages[i];
+    if (!stage.scope_time_finalized)
+      continue;
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(stage._end - stage._start).count();
+    stage_histograms[i].record(us > 0 ? static_cast<uint64_t>(us) : 0);
+  }
+
+  std::chrono::duration<float, std::milli> frame_ms = prevEntry.frame_end - prevEntry.frame_start;
+  if (frame_ms.count() > frame_budget_ms) {
+    if (spikes.size() == max_spikes)
+      spikes.pop_front();
+    SpikeSnapshot spike;
+    spike.frame_index = frame_index;
+    spike.frame_ms = frame_ms.count();
+    spike.zones = last_zone_frame;
+    spikes.push_back(std::move(spike));
+  }
 }
 
 float
@@ -33,12 +78,32 @@ Profiler::get_time(const Stage& request) const
   std::chrono::duration<float, std::milli> fltStart = stage._start - entry.frame_start;
   float startTimestamp = fltStart.count();
 
-  std::chrono::duration<float, std::milli> fltEnd = stage._end - entry.frame_end;
+  std::chrono::duration<float, std::milli> fltEnd = stage._end - entry.frame_start;
   float endTimestamp = fltEnd.count();
 
   return endTimestamp - startTimestamp;
 }
 
+Profiler::StagePercentiles
+Profiler::get_percentiles(const Stage& request) const
+{
+  const LatencyHistogram& histogram = stage_histograms[static_cast<uint8_t>(request)];
+
+  StagePercentiles result;
+  result.p50_ms = histogram.get_percentile(50.0f) / 1000.0f;
+  result.p95_ms = histogram.get_percentile(95.0f) / 1000.0f;
+  result.p99_ms = histogram.get_percentile(99.0f) / 1000.0f;
+  result.max_ms = histogram.get_max() / 1000.0f;
+  return result;
+}
+
+void
+Profiler::set_percentile_window(int frames)
+{
+  for (LatencyHistogram& histogram : stage_histograms)
+    histogram.set_window(frames);
+}
+
 float
 Profiler::get_average_time(const Stage& request) const
 {
@@ -76,8 +141,9 @@ Profiler::begin(const Stage& stage)
   assert(frames_data_live < 255);
   auto& delta_time = entries[current_entry].stages[static_cast<uint8_t>(stage)];
 
-  delta_time._start = std::chrono::system_clock::now();
+  delta_time._start = ProfilerClock::now();
   delta_time.scope_time_finalized = false;
+  delta_time.zone_start_ns = zone_profiler::begin_zone();
 }
 
 void
@@ -86,8 +152,9 @@ Profiler::end(const Stage& stage)
   auto& delta_time = entries[current_entry].stages[static_cast<uint8_t>(stage)];
   assert(!delta_time.scope_time_finalized);
 
-  delta_time._end = std::chrono::system_clock::now();
+  delta_time._end = ProfilerClock::now();
   delta_time.scope_time_finalized = true;
+  zone_profiler::end_zone(stageNames[static_cast<uint8_t>(stage)].data(), delta_time.zone_start_ns);
 }
 
 } // namespace fightingengine
\ No newline at end of file
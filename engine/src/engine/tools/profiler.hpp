@@ -6,9 +6,15 @@
 // c++ standard library header
 #include <array>
 #include <chrono>
+#include <deque>
 #include <map>
 #include <string_view>
 
+// engine headers
+#include "engine/tools/alloc_tracker.hpp"
+#include "engine/tools/latency_histogram.hpp"
+#include "engine/tools/zone_profiler.hpp"
+
 namespace fightingengine {
 class Profiler
 {
@@ -32,9 +38,10 @@ public:
   // profiler.begin(STAGE) and profiler.end(STAGE)
   struct DeltaTime
   {
-    std::chrono::system_clock::time_point _start;
-    std::chrono::system_clock::time_point _end;
+    ProfilerClock::time_point _start;
+    ProfilerClock::time_point _end;
     bool scope_time_finalized = false;
+    uint64_t zone_start_ns = 0; // stages are also recorded as zones
   };
 
   static constexpr std::array<std::string_view, static_cast<uint8_t>(Stage::_count)> stageNames = {
@@ -46,11 +53,29 @@ public:
   // every frame for the application has one "Entry".
   struct Entry
   {
-    std::chrono::system_clock::time_point frame_start;
-    std::chrono::system_clock::time_point frame_end;
+    ProfilerClock::time_point frame_start;
+    ProfilerClock::time_point frame_end;
     std::array<DeltaTime, static_cast<uint8_t>(Stage::_count)> stages;
   };
 
+  struct StagePercentiles
+  {
+    float p50_ms = 0.0f;
+    float p95_ms = 0.0f;
+    float p99_ms = 0.0f;
+    float max_ms = 0.0f;
+  };
+
+  // The full zone tree of a frame that went over budget
+  struct SpikeSnapshot
+  {
+    uint64_t frame_index = 0;
+    float frame_ms = 0.0f;
+    ZoneFrame zones;
+  };
+
+  Profiler();
+
   void new_frame();
   void begin(const Stage& stage);
   void end(const Stage& stage);
@@ -60,6 +85,23 @@ public:
   // returns average milliseconds the the last "frames_data_live" frames took
   [[nodiscard]] float get_average_time(const Stage& request) const;
 
+  // rolling percentiles over the last "get_percentile_window()" frames
+  [[nodiscard]] StagePercentiles get_percentiles(const Stage& request) const;
+  void set_percentile_window(int frames);
+  [[nodiscard]] int get_percentile_window() const { return stage_histograms[0].get_window(); }
+
+  // every zone (from any thread) that finished during the last frame
+  [[nodiscard]] const ZoneFrame& get_last_zone_frame() const { return last_zone_frame; }
+
+  // heap allocations from every thread during the last frame (zero unless alloc_tracker is enabled)
+  [[nodiscard]] const AllocCounters& get_last_frame_allocations() const { return last_frame_allocs; }
+
+  // frames longer than the budget have their zones kept, newest last
+  void set_frame_budget_ms(float budget_ms) { frame_budget_ms = budget_ms; }
+  [[nodiscard]] float get_frame_budget_ms() const { return frame_budget_ms; }
+  [[nodiscard]] const std::deque<SpikeSnapshot>& get_spikes() const { return spikes; }
+  void clear_spikes() { spikes.clear(); }
+
 private:
   uint8_t get_entry_index(int8_t offset) const;
 
@@ -71,6 +113,19 @@ private:
   std::array<Entry, frames_data_live> entries;
 
   uint8_t current_entry = frames_data_live - 1;
+
+  ZoneFrame last_zone_frame;
+  uint64_t zone_frame_start_ns = 0;
+
+  AllocCounters frame_alloc_start;
+  AllocCounters last_frame_allocs;
+
+  std::array<LatencyHistogram, static_cast<uint8_t>(Stage::_count)> stage_histograms;
+
+  static constexpr int max_spikes = 16;
+  float frame_budget_ms = 1000.0f / 60.0f;
+  uint64_t frame_index = 0;
+  std::deque<SpikeSnapshot> spikes;
 };
 
 } // namespace fightingengine
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+// c system headers
+#include <cstddef>
+#include <cstdint>
+
+// c++ standard library headers
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace fightingengine {
+
+// Bounded single-producer single-consumer queue. Each side owns one index and
+// only reads the other's, so a push or pop is a load and a store, no CAS.
+// Like MpscRing, a full ring fails try_push() and the producer decides what to do.
+// capacity is rounded up to a power of two.
+template<typename T>
+class SpscRing
+{
+public:
+  explicit SpscRing(size_t capacity)
+  {
+    size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+    mask = size - 1;
+    slots = std::make_unique<T[]>(size);
+  }
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  // the producer thread only
+  bool try_push(const T& value) { return push(value); }
+  bool try_push(T&& value) { return push(std::move(value)); }
+
+  // the consumer thread only. the oldest value, or nullptr if empty. stays queued until pop()
+  T* front()
+  {
+    const size_t t = tail.load(std::memory_order_relaxed);
+    if (t == cached_head) {
+      cached_head = head.load(std::memory_order_acquire);
+      if (t == cached_head)
+        return nullptr;
+    }
+    return &slots[t & mask];
+  }
+
+  // the consumer thread only, after front() returned a value
+  void pop() { tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  bool try_pop(T& value)
+  {
+    T* v = front();
+    if (v == nullptr)
+      return false;
+    value = std::move(*v);
+    pop();
+    return true;
+  }
+
+  // either thread. a snapshot, it can be out of date as soon as it's returned
+  [[nodiscard]] size_t size() const
+  {
+    const size_t t = tail.load(std::memory_order_acquire); // first, so it can't pass the head read after it
+    return head.load(std::memory_order_acquire) - t;
+  }
+  [[nodiscard]] size_t capacity() const { return mask + 1; }
+
+private:
+  size_t mask = 0;
+  std::unique_ptr<T[]> slots;
+  alignas(64) std::atomic<size_t> head{ 0 }; // written by the producer
+  size_t cached_tail = 0;                    // the producer's last look at tail
+  alignas(64) std::atomic<size_t> tail{ 0 }; // written by the consumer
+  size_t cached_head = 0;                    // the consumer's last look at head
+
+  template<typename U>
+  bool push(U&& value)
+  {
+    const size_t h = head.load(std::memory_order_relaxed);
+    if (h - cached_tail > mask) {
+      cached_tail = tail.load(std::memory_order_acquire);
+      if (h - cached_tail > mask)
+        return false; // full
+    }
+    slots[h & mask] = std::forward<U>(value);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+} // namespace fightingengine
@@ -0,0 +1,170 @@
+// header
+#include "engine/tools/trace_writer.hpp"
+
+// c++ standard library headers
+#include <iomanip>
+#include <iostream>
+
+namespace fightingengine {
+
+TraceWriter::TraceWriter(size_t max_pending_records)
+  : max_pending_records(max_pending_records)
+{}
+
+TraceWriter::~TraceWriter()
+{
+  stop();
+}
+
+bool
+TraceWriter::start(const std::string& path)
+{
+  if (capturing)
+    return false;
+
+  file.open(path, std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "(trace) failed to open " << path << std::endl;
+    return false;
+  }
+  file << "{\"traceEvents\":[\n";
+  file << std::fixed << std::setprecision(3);
+
+  this->path = path;
+  capture_start_ns = zone_profiler::now_ns();
+  first_record = true;
+  records_written = 0;
+  dropped = 0;
+  batch.clear();
+  pending.clear();
+  stopping = false;
+  capturing = true;
+
+  writer = std::thread(&TraceWriter::writer_loop, this);
+  std::cout << "(trace) capturing to " << path << std::endl;
+  return true;
+}
+
+void
+TraceWriter::stop()
+{
+  if (!capturing)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cv.notify_one();
+  writer.join();
+  capturing = false;
+
+  // thread names last, as threads can start part way through a capture
+  for (const auto& name : zone_profiler::get_thread_names()) {
+    file << (first_record ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << name.first
+         << ",\"args\":{\"name\":\"" << name.second << "\"}}";
+    first_record = false;
+  }
+  file << "\n]}\n";
+  file.close();
+
+  std::cout << "(trace) wrote " << records_written << " records to " << path << " (dropped " << dropped << ")"
+            << std::endl;
+}
+
+void
+TraceWriter::add_counter(const char* name, double value)
+{
+  if (!capturing)
+    return;
+
+  TraceRecord r;
+  r.type = 'C';
+  r.name = name;
+  r.ts_ns = zone_profiler::now_ns();
+  r.value = value;
+  batch.push_back(r);
+}
+
+void
+TraceWriter::submit_frame(const ZoneFrame& frame)
+{
+  if (!capturing)
+    return;
+
+  TraceRecord marker;
+  marker.type = 'i';
+  marker.name = "frame";
+  marker.ts_ns = frame.start_ns;
+  batch.push_back(marker);
+
+  for (const ZoneEvent& e : frame.events) {
+    TraceRecord r;
+    r.type = 'X';
+    r.name = e.name;
+    r.ts_ns = e.start_ns;
+    r.dur_ns = e.end_ns - e.start_ns;
+    r.thread_id = e.thread_id;
+    batch.push_back(r);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pending.size() + batch.size() > max_pending_records)
+      dropped += batch.size(); // the writer has fallen behind
+    else
+      pending.insert(pending.end(), batch.begin(), batch.end());
+  }
+  batch.clear();
+  cv.notify_one();
+}
+
+void
+TraceWriter::writer_loop()
+{
+  std::vector<TraceRecord> writing;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [this]() { return stopping || !pending.empty(); });
+      if (pending.empty() && stopping)
+        break;
+      writing.swap(pending);
+    }
+
+    for (const TraceRecord& r : writing)
+      write_record(r);
+    writing.clear();
+  }
+
+  file.flush();
+}
+
+void
+TraceWriter::write_record(const TraceRecord& r)
+{
+  // microseconds since the capture started
+  double ts_us = r.ts_ns >= capture_start_ns ? (r.ts_ns - capture_start_ns) / 1000.0 : 0.0;
+
+  file << (first_record ? "" : ",\n");
+  first_record = false;
+
+  switch (r.type) {
+    case 'X':
+      file << "{\"name\":\"" << r.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << r.thread_id << ",\"ts\":" << ts_us
+           << ",\"dur\":" << r.dur_ns / 1000.0 << "}";
+      break;
+    case 'i':
+      file << "{\"name\":\"" << r.name << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":" << ts_us << "}";
+      break;
+    case 'C':
+      file << "{\"name\":\"" << r.name << "\",\"ph\":\"C\",\"pid\":0,\"ts\":" << ts_us << ",\"args\":{\"value\":"
+           << r.value << "}}";
+      break;
+  }
+
+  records_written += 1;
+}
+
+} // namespace fightingengine
@@ -0,0 +1,82 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+// c++ standard library headers
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// engine headers
+#include "engine/tools/zone_profiler.hpp"
+
+namespace fightingengine {
+
+struct TraceRecord
+{
+  char type = 'X'; // 'X' zone, 'i' frame marker, 'C' counter
+  const char* name = nullptr;
+  uint64_t ts_ns = 0;
+  uint64_t dur_ns = 0;
+  uint32_t thread_id = 0;
+  double value = 0.0;
+};
+
+// Streams profiler zones, frame markers and counters to a Chrome trace-event
+// json file (open with chrome://tracing or ui.perfetto.dev).
+// Formatting and writing happens on a background thread. Memory is bounded:
+// if the writer falls behind by more than max_pending_records, new records are dropped.
+class TraceWriter
+{
+public:
+  explicit TraceWriter(size_t max_pending_records = 1 << 20);
+  ~TraceWriter();
+
+  TraceWriter(const TraceWriter&) = delete;
+  TraceWriter& operator=(const TraceWriter&) = delete;
+
+  bool start(const std::string& path);
+  void stop();
+  [[nodiscard]] bool is_capturing() const { return capturing; }
+
+  // counters are timestamped now, and sent with the next submit_frame()
+  void add_counter(const char* name, double value);
+
+  // call once per frame, e.g. with Profiler::get_last_zone_frame()
+  void submit_frame(const ZoneFrame& frame);
+
+  [[nodiscard]] uint64_t get_dropped_count() const { return dropped; }
+  [[nodiscard]] uint64_t get_records_written() const { return records_written; }
+  [[nodiscard]] const std::string& get_path() const { return path; }
+
+private:
+  void writer_loop();
+  void write_record(const TraceRecord& r);
+
+  size_t max_pending_records;
+  bool capturing = false;
+  std::string path;
+  std::ofstream file;
+  uint64_t capture_start_ns = 0;
+  bool first_record = true;
+
+  // only touched by the thread calling submit_frame()
+  std::vector<TraceRecord> batch;
+  uint64_t dropped = 0;
+
+  // shared with the writer thread
+  std::thread writer;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<TraceRecord> pending;
+  bool stopping = false;
+
+  // only touched by the writer thread until it's joined
+  uint64_t records_written = 0;
+};
+
+} // namespace fightingengine
@@ -0,0 +1,179 @@
+// header
+#include "engine/tools/zone_profiler.hpp"
+
+// c++ standard library headers
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// engine headers
+#include "engine/tools/alloc_tracker.hpp"
+
+namespace fightingengine {
+
+namespace zone_profiler {
+
+static constexpr uint64_t zone_buffer_size = 4096; // power of two
+static constexpr uint64_t zone_buffer_mask = zone_buffer_size - 1;
+static constexpr uint16_t max_alloc_depth = 32; // deeper zones don't count allocations
+
+// single producer (the owning thread), single consumer (whoever calls collect())
+struct ThreadZoneBuffer
+{
+  uint32_t thread_id = 0;
+  std::string name;
+  uint16_t depth = 0; // only touched by the owning thread
+  std::array<AllocCounters, max_alloc_depth> alloc_start;
+
+  std::array<ZoneEvent, zone_buffer_size> events;
+  std::atomic<uint64_t> head{ 0 }; // written by the producer
+  std::atomic<uint64_t> tail{ 0 }; // written by the consumer
+  std::atomic<uint64_t> dropped{ 0 };
+
+  // guarded by s_registry_mutex
+  bool exited = false; // the owning thread is gone, free once its zones are collected
+  bool free = false;   // waiting in s_free_buffers for the next new thread
+};
+
+// a thread can exit with zones still to be collected, so its buffer is only
+// handed to the next new thread after collect() has drained it
+static std::mutex s_registry_mutex;
+static std::vector<std::unique_ptr<ThreadZoneBuffer>> s_buffers;
+static std::vector<ThreadZoneBuffer*> s_free_buffers;
+static thread_local ThreadZoneBuffer* t_buffer = nullptr;
+
+// kept apart from t_buffer so end_zone() reads a plain pointer
+struct ThreadBufferOwner
+{
+  ThreadZoneBuffer* buffer = nullptr;
+
+  ~ThreadBufferOwner()
+  {
+    if (buffer == nullptr)
+      return;
+    std::lock_guard<std::mutex> lock(s_registry_mutex);
+    buffer->exited = true;
+    t_buffer = nullptr;
+  }
+};
+static thread_local ThreadBufferOwner t_owner;
+
+static ThreadZoneBuffer&
+get_thread_buffer()
+{
+  if (t_buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(s_registry_mutex);
+    if (!s_free_buffers.empty()) {
+      t_buffer = s_free_buffers.back();
+      s_free_buffers.pop_back();
+      t_buffer->depth = 0;
+      t_buffer->free = false;
+    } else {
+      s_buffers.push_back(std::make_unique<ThreadZoneBuffer>());
+      t_buffer = s_buffers.back().get();
+      t_buffer->thread_id = static_cast<uint32_t>(s_buffers.size() - 1);
+    }
+    t_buffer->name = "thread " + std::to_string(t_buffer->thread_id);
+    t_owner.buffer = t_buffer;
+  }
+  return *t_buffer;
+}
+
+uint64_t
+begin_zone()
+{
+  ThreadZoneBuffer& buffer = get_thread_buffer();
+  if (alloc_tracker::is_enabled() && buffer.depth < max_alloc_depth)
+    buffer.alloc_start[buffer.depth] = alloc_tracker::get_thread_counters();
+  buffer.depth += 1;
+  return now_ns();
+}
+
+void
+end_zone(const char* name, uint64_t start_ns)
+{
+  uint64_t end_ns = now_ns();
+
+  ThreadZoneBuffer& buffer = *t_buffer; // begin_zone() registered it
+  buffer.depth -= 1;
+
+  uint64_t head = buffer.head.load(std::memory_order_relaxed);
+  uint64_t tail = buffer.tail.load(std::memory_order_acquire);
+  if (head - tail >= zone_buffer_size) {
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  ZoneEvent& e = buffer.events[head & zone_buffer_mask];
+  e.name = name;
+  e.start_ns = start_ns;
+  e.end_ns = end_ns;
+  e.thread_id = buffer.thread_id;
+  e.depth = buffer.depth;
+  e.allocs = 0;
+  e.alloc_bytes = 0;
+  if (alloc_tracker::is_enabled() && buffer.depth < max_alloc_depth) {
+    AllocCounters allocs = alloc_tracker::get_thread_counters() - buffer.alloc_start[buffer.depth];
+    e.allocs = static_cast<uint32_t>(allocs.allocs);
+    e.alloc_bytes = allocs.bytes_allocated;
+  }
+
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void
+set_thread_name(const std::string& name)
+{
+  ThreadZoneBuffer& buffer = get_thread_buffer();
+  std::lock_guard<std::mutex> lock(s_registry_mutex);
+  buffer.name = name;
+}
+
+std::vector<std::pair<uint32_t, std::string>>
+get_thread_names()
+{
+  std::lock_guard<std::mutex> lock(s_registry_mutex);
+  std::vector<std::pair<uint32_t, std::string>> names;
+  for (const auto& buffer : s_buffers)
+    names.push_back({ buffer->thread_id, buffer->name });
+  return names;
+}
+
+void
+collect(std::vector<ZoneEvent>& events)
+{
+  // the lock stops s_buffers changing underneath us, producers only take it to register or exit
+  std::lock_guard<std::mutex> lock(s_registry_mutex);
+
+  for (const auto& buffer : s_buffers) {
+    if (buffer->free)
+      continue;
+    uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+    uint64_t head = buffer->head.load(std::memory_order_acquire);
+    for (uint64_t i = tail; i < head; i++)
+      events.push_back(buffer->events[i & zone_buffer_mask]);
+    buffer->tail.store(head, std::memory_order_release);
+
+    // an exited thread can't write any more, so those were its last zones
+    if (buffer->exited) {
+      buffer->exited = false;
+      buffer->free = true;
+      s_free_buffers.push_back(buffer.get());
+    }
+  }
+}
+
+uint64_t
+get_dropped_count()
+{
+  std::lock_guard<std::mutex> lock(s_registry_mutex);
+  uint64_t dropped = 0;
+  for (const auto& buffer : s_buffers)
+    dropped += buffer->dropped.load(std::memory_order_relaxed);
+  return dropped;
+}
+
+} // namespace zone_profiler
+
+} // namespace fightingengine
@@ -0,0 +1,101 @@
+#pragma once
+
+// c system headers
+#include <cstdint>
+
+// c++ standard library headers
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fightingengine {
+
+// monotonic, unlike system_clock, so zones can't go backwards when the wall clock changes
+using ProfilerClock = std::chrono::steady_clock;
+
+// A timed, named scope. Written once when the zone ends.
+struct ZoneEvent
+{
+  const char* name = nullptr; // must outlive the profiler, e.g. a string literal
+  uint64_t start_ns = 0;
+  uint64_t end_ns = 0;
+  uint32_t thread_id = 0;
+  uint16_t depth = 0; // 0 for outermost zones
+  uint32_t allocs = 0; // heap allocations inside the zone, if alloc_tracker is enabled
+  uint64_t alloc_bytes = 0;
+};
+
+// Every zone that finished during one frame
+struct ZoneFrame
+{
+  uint64_t start_ns = 0;
+  uint64_t end_ns = 0;
+  std::vector<ZoneEvent> events;
+};
+
+namespace zone_profiler {
+
+[[nodiscard]] inline uint64_t
+now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(ProfilerClock::now().time_since_epoch()).count();
+}
+
+// Each thread writes to its own ring buffer without locking (the buffer is only
+// registered under a lock, on the thread's first zone). The budget is tens of
+// nanoseconds per zone: two clock reads and one event write.
+// If a buffer fills up before it's collected, new zones are dropped.
+// When a thread exits its buffer is reused by the next new thread (and its
+// thread id with it), once collect() has taken the last of its zones.
+
+// returns the start time, prefer PROFILE_ZONE() over calling these directly
+[[nodiscard]] uint64_t
+begin_zone();
+void
+end_zone(const char* name, uint64_t start_ns);
+
+// shown instead of the thread id
+void
+set_thread_name(const std::string& name);
+[[nodiscard]] std::vector<std::pair<uint32_t, std::string>>
+get_thread_names();
+
+// moves every thread's finished zones in to events.
+// only one thread should collect (usually the main thread, once per frame)
+void
+collect(std::vector<ZoneEvent>& events);
+
+[[nodiscard]] uint64_t
+get_dropped_count();
+
+} // namespace zone_profiler
+
+class ScopedZone
+{
+public:
+  explicit ScopedZone(const char* name)
+    : name(name)
+    , start_ns(zone_profiler::begin_zone())
+  {}
+  ~ScopedZone() { zone_profiler::end_zone(name, start_ns); }
+
+  ScopedZone(const ScopedZone&) = delete;
+  ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+  const char* name;
+  uint64_t start_ns;
+};
+
+} // namespace fightingengine
+
+#define FE_PROFILE_CONCAT_INNER(a, b) a##b
+#define FE_PROFILE_CONCAT(a, b) FE_PROFILE_CONCAT_INNER(a, b)
+
+// e.g. PROFILE_ZONE("physics::sort_x");
+#ifndef FIGHTINGENGINE_DISABLE_PROFILER
+#define PROFILE_ZONE(name) fightingengine::ScopedZone FE_PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
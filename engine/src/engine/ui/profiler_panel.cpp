@@ -4,7 +4,9 @@
 
 // standard lib headers
 // clang-format off
+#include <cstdio>
 #include <string>
+#include <string_view>
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
 #include "windows.h"
 #include "psapi.h"
@@ -14,6 +16,10 @@
 // other library headers
 #include <imgui.h>
 
+// engine headers
+#include "engine/opengl/render_command.hpp"
+#include "engine/tools/alloc_tracker.hpp"
+
 using namespace fightingengine;
 
 namespace fightingengine {
@@ -69,6 +75,62 @@ public:
   }
 };
 
+// one lane per thread, one row per zone depth
+static void
+draw_flame_view(const ZoneFrame& frame)
+{
+  if (frame.end_ns <= frame.start_ns)
+    return;
+
+  const float row_height = 16.0f;
+  const float width = ImGui::GetContentRegionAvail().x;
+  const double ns_to_px = width / static_cast<double>(frame.end_ns - frame.start_ns);
+
+  int max_depth = 0;
+  uint32_t max_thread = 0;
+  for (const ZoneEvent& e : frame.events) {
+    max_depth = e.depth > max_depth ? e.depth : max_depth;
+    max_thread = e.thread_id > max_thread ? e.thread_id : max_thread;
+  }
+  const float lane_height = row_height * (max_depth + 1);
+  const float height = lane_height * (max_thread + 1);
+
+  ImDrawList* draw_list = ImGui::GetWindowDrawList();
+  ImVec2 origin = ImGui::GetCursorScreenPos();
+
+  for (const ZoneEvent& e : frame.events) {
+    float x0 = origin.x + static_cast<float>((e.start_ns - frame.start_ns) * ns_to_px);
+    float x1 = origin.x + static_cast<float>((e.end_ns - frame.start_ns) * ns_to_px);
+    if (e.start_ns < frame.start_ns)
+      x0 = origin.x; // started last frame
+    float y0 = origin.y + e.thread_id * lane_height + e.depth * row_height;
+    ImVec2 tl(x0, y0);
+    ImVec2 br(x1 > x0 + 1.0f ? x1 : x0 + 1.0f, y0 + row_height - 1.0f);
+
+    // colour by name, so a zone keeps its colour between frames
+    size_t h = std::hash<std::string_view>{}(e.name);
+    ImU32 colour = IM_COL32(80 + (h & 0x7F), 80 + ((h >> 8) & 0x7F), 80 + ((h >> 16) & 0x7F), 255);
+    draw_list->AddRectFilled(tl, br, colour);
+
+    draw_list->PushClipRect(tl, br, true);
+    draw_list->AddText(ImVec2(x0 + 2.0f, y0), IM_COL32(0, 0, 0, 255), e.name);
+    draw_list->PopClipRect();
+
+    if (ImGui::IsMouseHoveringRect(tl, br)) {
+      if (alloc_tracker::is_enabled())
+        ImGui::SetTooltip("%s %.3f ms\n%u allocs (%llu bytes)",
+                          e.name,
+                          (e.end_ns - e.start_ns) / 1000000.0,
+                          e.allocs,
+                          static_cast<unsigned long long>(e.alloc_bytes));
+      else
+        ImGui::SetTooltip("%s %.3f ms", e.name, (e.end_ns - e.start_ns) / 1000000.0);
+    }
+  }
+
+  ImGui::Dummy(ImVec2(width, height));
+}
+
 void
 draw(const Profiler& profiler, const float delta_time_s)
 {
@@ -114,10 +176,121 @@ draw(const Profiler& profiler, const float delta_time_s)
   ImGui::Text("~~ %s %f ms ~~", profiler.stageNames[(uint8_t)Profiler::Stage::UpdateLoop].data(), (time));
   ImGui::Separator();
 
+  //
+  // Percentiles
+  //
+
+  if (ImGui::CollapsingHeader("Percentiles")) {
+    ImGui::Text("last %i frames (ms)", profiler.get_percentile_window());
+    ImGui::Columns(5, "percentiles");
+    ImGui::Text("stage");
+    ImGui::NextColumn();
+    ImGui::Text("p50");
+    ImGui::NextColumn();
+    ImGui::Text("p95");
+    ImGui::NextColumn();
+    ImGui::Text("p99");
+    ImGui::NextColumn();
+    ImGui::Text("max");
+    ImGui::NextColumn();
+    ImGui::Separator();
+    for (uint8_t i = 0; i < static_cast<uint8_t>(Profiler::Stage::_count); i++) {
+      Profiler::StagePercentiles p = profiler.get_percentiles(static_cast<Profiler::Stage>(i));
+      ImGui::Text("%s", profiler.stageNames[i].data());
+      ImGui::NextColumn();
+      ImGui::Text("%.2f", p.p50_ms);
+      ImGui::NextColumn();
+      ImGui::Text("%.2f", p.p95_ms);
+      ImGui::NextColumn();
+      ImGui::Text("%.2f", p.p99_ms);
+      ImGui::NextColumn();
+      ImGui::Text("%.2f", p.max_ms);
+      ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+  }
+  ImGui::Separator();
+
+  //
+  // Render state changes
+  //
+
+  RenderStateStats state_stats = RenderCommand::get_state_stats();
+  ImGui::Text("GL state changes issued: %i skipped: %i", state_stats.issued, state_stats.skipped);
+  ImGui::Separator();
+
+  //
+  // Zones
+  //
+
+  if (ImGui::CollapsingHeader("Flame View")) {
+    const ZoneFrame& frame = profiler.get_last_zone_frame();
+    ImGui::Text("zones: %i dropped: %i",
+                static_cast<int>(frame.events.size()),
+                static_cast<int>(zone_profiler::get_dropped_count()));
+    draw_flame_view(frame);
+  }
+
+  if (ImGui::CollapsingHeader("Spikes")) {
+    const auto& spikes = profiler.get_spikes();
+    ImGui::Text("frames over %.2f ms: %i", profiler.get_frame_budget_ms(), static_cast<int>(spikes.size()));
+
+    static uint64_t selected_frame = 0;
+    for (auto it = spikes.rbegin(); it != spikes.rend(); ++it) {
+      char label[64];
+      snprintf(label,
+               sizeof(label),
+               "frame %llu: %.2f ms",
+               static_cast<unsigned long long>(it->frame_index),
+               it->frame_ms);
+      if (ImGui::Selectable(label, selected_frame == it->frame_index))
+        selected_frame = it->frame_index;
+    }
+    for (const auto& spike : spikes) {
+      if (spike.frame_index == selected_frame)
+        draw_flame_view(spike.zones);
+    }
+  }
+  ImGui::Separator();
+
+  //
+  // Heap allocations
+  //
+
+  if (alloc_tracker::is_enabled()) {
+    const AllocCounters& frame_allocs = profiler.get_last_frame_allocations();
+    AllocCounters total = alloc_tracker::get_global_counters();
+    ImGui::Text("allocs this frame: %llu (%llu bytes) frees: %llu",
+                static_cast<unsigned long long>(frame_allocs.allocs),
+                static_cast<unsigned long long>(frame_allocs.bytes_allocated),
+                static_cast<unsigned long long>(frame_allocs.frees));
+    ImGui::Text("live heap: %llu bytes in %llu blocks",
+                static_cast<unsigned long long>(total.bytes_allocated - total.bytes_freed),
+                static_cast<unsigned long long>(total.allocs - total.frees));
+
+    if (ImGui::CollapsingHeader("Allocating Zones")) {
+      // indented by depth, a parent's count includes its children
+      const ZoneFrame& frame = profiler.get_last_zone_frame();
+      for (const ZoneEvent& e : frame.events) {
+        if (e.allocs > 0)
+          ImGui::Text("%*s%s: %u (%llu bytes)",
+                      e.depth * 2,
+                      "",
+                      e.name,
+                      e.allocs,
+                      static_cast<unsigned long long>(e.alloc_bytes));
+      }
+    }
+  } else
+    ImGui::Text("heap allocations: build with FIGHTINGENGINE_TRACK_ALLOCATIONS");
+  ImGui::Separator();
+
   //
   // Memory Usage Info
   //
 
+  ImGui::Text("Resident Memory: %s", std::to_string(alloc_tracker::get_resident_bytes()).c_str());
+
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
 
   // https://stackoverflow.com/questions/63166/how-to-determine-cpu-and-memory-consumption-from-inside-a-process
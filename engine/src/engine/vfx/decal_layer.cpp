@@ -0,0 +1,136 @@
+// header
+#include "engine/vfx/decal_layer.hpp"
+
+// c++ lib headers
+#include <algorithm>
+
+// engine headers
+#include "engine/grid.hpp"
+
+namespace fightingengine {
+
+DecalLayer::DecalLayer(int chunk_size, int max_chunks, float hold_time_s, float fade_time_s)
+  : chunk_size(chunk_size)
+  , max_chunks(max_chunks)
+  , hold_time_s(hold_time_s)
+  , fade_time_s(fade_time_s)
+{
+  render_target_dirty.resize(max_chunks, false);
+  for (int i = max_chunks - 1; i >= 0; i--)
+    free_render_targets.push_back(i);
+}
+
+void
+DecalLayer::stamp(const Decal& decal)
+{
+  // decals can be rotated, so use the bounding square of the rotated quad
+  float radius = glm::max(decal.size.x, decal.size.y) * 0.5f * 1.4143f;
+  glm::vec2 center = decal.pos + decal.size * 0.5f;
+  glm::vec2 tl = center - glm::vec2(radius, radius);
+  glm::vec2 size = glm::vec2(radius, radius) * 2.0f;
+
+  game2d::grid::get_unique_cells(tl, size, chunk_size, cells);
+  for (const glm::ivec2& cell : cells) {
+    DecalChunk& chunk = acquire_chunk(cell);
+    chunk.last_stamp_time_s = time_s;
+    pending.push_back({ { cell.x, cell.y }, decal });
+  }
+}
+
+std::map<std::pair<int, int>, DecalChunk>::iterator
+DecalLayer::release_chunk(std::map<std::pair<int, int>, DecalChunk>::iterator it)
+{
+  free_render_targets.push_back(it->second.render_target);
+  render_target_dirty[it->second.render_target] = true;
+
+  // drop any stamps still queued for the chunk
+  const std::pair<int, int> key = it->first;
+  pending.erase(
+    std::remove_if(pending.begin(), pending.end(), [&key](const PendingStamp& p) { return p.key == key; }),
+    pending.end());
+
+  return chunks.erase(it);
+}
+
+DecalChunk&
+DecalLayer::acquire_chunk(const glm::ivec2& coord)
+{
+  std::pair<int, int> key = { coord.x, coord.y };
+  auto it = chunks.find(key);
+  if (it != chunks.end())
+    return it->second;
+
+  if (free_render_targets.empty()) {
+    // out of render targets: evict the chunk that was stamped longest ago
+    auto oldest = std::min_element(chunks.begin(), chunks.end(), [](const auto& a, const auto& b) {
+      return a.second.last_stamp_time_s < b.second.last_stamp_time_s;
+    });
+    release_chunk(oldest);
+    chunks_evicted += 1;
+  }
+
+  DecalChunk chunk;
+  chunk.coord = coord;
+  chunk.render_target = free_render_targets.back();
+  chunk.last_stamp_time_s = time_s;
+  free_render_targets.pop_back();
+
+  return chunks.emplace(key, chunk).first->second;
+}
+
+void
+DecalLayer::update(const float delta_time_s)
+{
+  time_s += delta_time_s;
+
+  // bounded by max_chunks, not by the number of decals
+  auto it = chunks.begin();
+  while (it != chunks.end()) {
+    if (get_chunk_alpha(it->second) <= 0.0f) {
+      it = release_chunk(it);
+      chunks_released += 1;
+    } else
+      ++it;
+  }
+}
+
+void
+DecalLayer::take_pending(std::vector<DecalBatch>& batches)
+{
+  batches.clear();
+  if (pending.empty())
+    return;
+
+  std::stable_sort(pending.begin(), pending.end(), [](const PendingStamp& a, const PendingStamp& b) {
+    return a.key < b.key;
+  });
+
+  for (const PendingStamp& p : pending) {
+    if (batches.empty() || batches.back().coord != glm::ivec2(p.key.first, p.key.second)) {
+      const DecalChunk& chunk = chunks.at(p.key);
+
+      DecalBatch batch;
+      batch.coord = chunk.coord;
+      batch.render_target = chunk.render_target;
+      batch.clear_first = render_target_dirty[chunk.render_target];
+      render_target_dirty[chunk.render_target] = false;
+      batches.push_back(batch);
+    }
+    batches.back().decals.push_back(p.decal);
+  }
+
+  pending.clear();
+}
+
+float
+DecalLayer::get_chunk_alpha(const DecalChunk& chunk) const
+{
+  float age = time_s - chunk.last_stamp_time_s;
+  if (age <= hold_time_s)
+    return 1.0f;
+  if (fade_time_s <= 0.0f)
+    return 0.0f;
+  return glm::clamp(1.0f - (age - hold_time_s) / fade_time_s, 0.0f, 1.0f);
+}
+
+} // namespace fightingengine
@@ -0,0 +1,98 @@
+#pragma once
+
+// c++ lib headers
+#include <map>
+#include <utility>
+#include <vector>
+
+// other lib headers
+#include <glm/glm.hpp>
+
+namespace fightingengine {
+
+// A decal is stamped once into an off-screen render target and then forgotten about.
+// The DecalLayer only does the CPU-side bookkeeping: which world-space chunk each
+// stamp lands in, which render target slot each chunk owns, and when a chunk has
+// faded out and its slot can be recycled. The GPU side lives with the renderer.
+
+struct Decal
+{
+  glm::vec2 pos = { 0.0f, 0.0f }; // in pixels, top-left
+  glm::vec2 size = { 0.0f, 0.0f };
+  float angle_radians = 0.0f;
+  glm::vec4 colour = { 1.0f, 1.0f, 1.0f, 1.0f };
+  glm::ivec2 sprite_offset = { 0, 0 };
+};
+
+struct DecalChunk
+{
+  glm::ivec2 coord = { 0, 0 };
+  int render_target = -1;
+  float last_stamp_time_s = 0.0f;
+};
+
+// all the stamps that need rendering into one chunk's render target
+struct DecalBatch
+{
+  glm::ivec2 coord = { 0, 0 };
+  int render_target = -1;
+  bool clear_first = false;
+  std::vector<Decal> decals;
+};
+
+class DecalLayer
+{
+public:
+  DecalLayer(int chunk_size, int max_chunks, float hold_time_s, float fade_time_s);
+
+  // queue a decal. it is stamped into every chunk it overlaps.
+  void stamp(const Decal& decal);
+
+  // advances time and releases chunks that have completely faded out
+  void update(const float delta_time_s);
+
+  // groups the queued stamps by chunk and empties the queue
+  void take_pending(std::vector<DecalBatch>& batches);
+
+  [[nodiscard]] const std::map<std::pair<int, int>, DecalChunk>& get_chunks() const { return chunks; }
+  [[nodiscard]] size_t get_pending_count() const { return pending.size(); }
+  [[nodiscard]] int get_chunk_size() const { return chunk_size; }
+  [[nodiscard]] int get_max_chunks() const { return max_chunks; }
+  [[nodiscard]] float get_time() const { return time_s; }
+  [[nodiscard]] float get_hold_time() const { return hold_time_s; }
+  [[nodiscard]] float get_fade_time() const { return fade_time_s; }
+
+  // the same fade the composition shader applies, 1.0 is fully visible
+  [[nodiscard]] float get_chunk_alpha(const DecalChunk& chunk) const;
+
+  // stats
+  int chunks_evicted = 0;
+  int chunks_released = 0;
+
+private:
+  DecalChunk& acquire_chunk(const glm::ivec2& coord);
+  // frees the chunk's render target and drops its queued stamps
+  std::map<std::pair<int, int>, DecalChunk>::iterator release_chunk(
+    std::map<std::pair<int, int>, DecalChunk>::iterator it);
+
+  struct PendingStamp
+  {
+    std::pair<int, int> key;
+    Decal decal;
+  };
+
+  int chunk_size;
+  int max_chunks;
+  float hold_time_s;
+  float fade_time_s;
+  float time_s = 0.0f;
+
+  std::map<std::pair<int, int>, DecalChunk> chunks;
+  std::vector<int> free_render_targets;
+  // render targets that were recycled and still hold old decals
+  std::vector<bool> render_target_dirty;
+  std::vector<PendingStamp> pending;
+  std::vector<glm::ivec2> cells; // scratch
+};
+
+} // namespace fightingengine
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "engine/tools/alloc_tracker.hpp"
+#include "engine/tools/zone_profiler.hpp"
+using namespace fightingengine;
+
+TEST(AllocTracker, CountsThreadAllocations)
+{
+  if (!alloc_tracker::is_enabled())
+    GTEST_SKIP() << "built without FIGHTINGENGINE_TRACK_ALLOCATIONS";
+
+  AllocCounters before = alloc_tracker::get_thread_counters();
+  {
+    auto a = std::make_unique<int[]>(16);
+    auto b = std::make_unique<int>(1);
+  }
+  AllocCounters used = alloc_tracker::get_thread_counters() - before;
+
+  ASSERT_EQ(2, used.allocs);
+  ASSERT_EQ(2, used.frees);
+  ASSERT_EQ(16 * sizeof(int) + sizeof(int), used.bytes_allocated);
+  ASSERT_EQ(used.bytes_allocated, used.bytes_freed);
+}
+
+TEST(AllocTracker, ZonesRecordTheirAllocations)
+{
+  if (!alloc_tracker::is_enabled())
+    GTEST_SKIP() << "built without FIGHTINGENGINE_TRACK_ALLOCATIONS";
+
+  std::vector<ZoneEvent> events;
+  zone_profiler::collect(events); // drain anything from earlier tests
+  events.clear();
+  events.reserve(16);
+
+  {
+    PROFILE_ZONE("allocating");
+    auto a = std::make_unique<int>(1);
+  }
+  zone_profiler::collect(events);
+
+  ASSERT_EQ(1, events.size());
+  ASSERT_EQ(1, events[0].allocs);
+  ASSERT_EQ(sizeof(int), events[0].alloc_bytes);
+}
+
+TEST(AllocTracker, ResidentMemoryIsReported)
+{
+  ASSERT_GT(alloc_tracker::get_resident_bytes(), 0);
+}
+
+TEST(AllocationBudget, FailsOnlyAfterWarmup)
+{
+  AllocationBudget budget(4, 2);
+
+  AllocCounters heavy;
+  heavy.allocs = 100;
+  AllocCounters light;
+  light.allocs = 3;
+
+  ASSERT_TRUE(budget.check_frame(heavy)); // warming up
+  ASSERT_TRUE(budget.check_frame(heavy));
+  ASSERT_TRUE(budget.check_frame(light));
+  ASSERT_TRUE(budget.passed());
+
+  ASSERT_FALSE(budget.check_frame(heavy));
+  ASSERT_FALSE(budget.passed());
+  ASSERT_EQ(2, budget.get_frames_checked());
+  ASSERT_EQ(1, budget.get_frames_over_budget());
+  ASSERT_EQ(100, budget.get_worst_frame_allocs());
+}
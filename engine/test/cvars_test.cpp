@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "engine/tools/cvar_bench.hpp"
+#include "engine/tools/cvars.hpp"
+using namespace fightingengine;
+
+TEST(CVars, RegisterParseAndClamp)
+{
+  CVar<int> grid("test.grid_size", 100, "cell size", 8, 1024);
+  CVar<float> rate("test.spawn_rate", 1.0f, "seconds between spawns", 0.0f, 10.0f);
+  CVar<bool> enabled("test.enabled", true, "on or off");
+
+  ASSERT_EQ(&grid, cvars::find("test.grid_size"));
+  ASSERT_EQ(nullptr, cvars::find("test.missing"));
+
+  ASSERT_TRUE(grid.set_from_string("64"));
+  ASSERT_EQ(64, grid.get());
+  ASSERT_FALSE(grid.set_from_string("64px"));
+  ASSERT_EQ(64, grid.get());
+  ASSERT_FALSE(grid.set_from_string("4294967297")); // out of int range, not wrapped to 1
+  ASSERT_FALSE(grid.set_from_string("-99999999999999999999"));
+  ASSERT_EQ(64, grid.get());
+  grid.set(1);
+  ASSERT_EQ(8, grid.get());
+
+  ASSERT_TRUE(rate.set_from_string("0.25"));
+  ASSERT_FLOAT_EQ(0.25f, rate.get());
+  ASSERT_FALSE(rate.set_from_string("nan"));
+  ASSERT_FALSE(rate.set_from_string("-inf"));
+  ASSERT_FLOAT_EQ(0.25f, rate.get());
+  ASSERT_TRUE(enabled.set_from_string("off"));
+  ASSERT_FALSE(enabled.get());
+  ASSERT_FALSE(enabled.set_from_string("99999999999999999999"));
+  ASSERT_FALSE(enabled.get());
+
+  rate.reset();
+  ASSERT_FLOAT_EQ(1.0f, rate.get());
+}
+
+TEST(CVars, UnregistersOnDestruction)
+{
+  {
+    CVar<int> temp("test.temp", 1, "");
+    ASSERT_NE(nullptr, cvars::find("test.temp"));
+  }
+  ASSERT_EQ(nullptr, cvars::find("test.temp"));
+}
+
+TEST(CVars, ConsoleCommands)
+{
+  CVar<int> batch("test.batch_quads", 5000, "quads per draw call", 64, 5000);
+  std::vector<std::string> output;
+
+  ASSERT_TRUE(cvars::execute("set test.batch_quads 256", output));
+  ASSERT_EQ(256, batch.get());
+  ASSERT_EQ("test.batch_quads = 256 (default 5000)", output.back());
+
+  ASSERT_TRUE(cvars::execute("test.batch_quads 512", output));
+  ASSERT_EQ(512, batch.get());
+
+  ASSERT_TRUE(cvars::execute("set test.batch_quads lots", output));
+  ASSERT_NE(std::string::npos, output.back().find("[error]"));
+  ASSERT_EQ(512, batch.get());
+
+  output.clear();
+  ASSERT_TRUE(cvars::execute("list test.batch", output));
+  ASSERT_EQ(1, output.size());
+  ASSERT_NE(std::string::npos, output[0].find("quads per draw call"));
+
+  ASSERT_TRUE(cvars::execute("reset test.batch_quads", output));
+  ASSERT_EQ(5000, batch.get());
+
+  ASSERT_FALSE(cvars::execute("not_a_command", output));
+}
+
+TEST(CVarBench, RunsEachValueThenRestores)
+{
+  CVar<int> batch("test.bench_batch", 5000, "", 64, 5000);
+  CVarBench bench;
+  ASSERT_TRUE(bench.start(batch, { "256", "1024" }, 10, 2));
+  ASSERT_TRUE(bench.is_running());
+  ASSERT_EQ(256, batch.get());
+
+  for (int i = 0; i < 12; i++)
+    bench.update(i < 2 ? 100.0f : 2.0f); // warmup frames are ignored
+  ASSERT_EQ(1024, batch.get());
+  for (int i = 0; i < 12; i++)
+    bench.update(4.0f);
+
+  ASSERT_FALSE(bench.is_running());
+  ASSERT_EQ(5000, batch.get());
+
+  const auto& results = bench.get_results();
+  ASSERT_EQ(2, results.size());
+  ASSERT_EQ("256", results[0].value);
+  ASSERT_NEAR(2.0f, results[0].mean_ms, 0.001f);
+  ASSERT_NEAR(2.0f, results[0].percentiles.max_ms, 0.001f);
+  ASSERT_NEAR(4.0f, results[1].mean_ms, 0.001f);
+
+  std::vector<std::string> report;
+  ASSERT_TRUE(bench.take_report(report));
+  ASSERT_EQ(3, report.size());
+  ASSERT_FALSE(bench.take_report(report));
+}
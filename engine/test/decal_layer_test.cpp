@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include "engine/vfx/decal_layer.hpp"
+using namespace fightingengine;
+
+static Decal
+make_decal(glm::vec2 pos)
+{
+  Decal d;
+  d.pos = pos;
+  d.size = { 10.0f, 10.0f };
+  return d;
+}
+
+TEST(DecalLayer, StampAllocatesChunk)
+{
+  DecalLayer layer(100, 4, 1.0f, 1.0f);
+  layer.stamp(make_decal({ 40.0f, 40.0f }));
+
+  ASSERT_EQ(1, layer.get_chunks().size());
+  ASSERT_EQ(1, layer.get_pending_count());
+}
+
+TEST(DecalLayer, StampOnChunkEdgeLandsInEveryChunkItOverlaps)
+{
+  DecalLayer layer(100, 4, 1.0f, 1.0f);
+  layer.stamp(make_decal({ 95.0f, 95.0f }));
+
+  ASSERT_EQ(4, layer.get_chunks().size());
+  ASSERT_EQ(4, layer.get_pending_count());
+}
+
+TEST(DecalLayer, TakePendingGroupsByChunk)
+{
+  DecalLayer layer(100, 4, 1.0f, 1.0f);
+  layer.stamp(make_decal({ 40.0f, 40.0f }));
+  layer.stamp(make_decal({ 240.0f, 40.0f }));
+  layer.stamp(make_decal({ 50.0f, 50.0f }));
+
+  std::vector<DecalBatch> batches;
+  layer.take_pending(batches);
+
+  ASSERT_EQ(2, batches.size());
+  ASSERT_EQ(2, batches[0].decals.size());
+  ASSERT_EQ(1, batches[1].decals.size());
+  ASSERT_NE(batches[0].render_target, batches[1].render_target);
+  ASSERT_FALSE(batches[0].clear_first);
+  ASSERT_EQ(0, layer.get_pending_count());
+}
+
+TEST(DecalLayer, FadedChunkIsReleasedAndItsTargetCleared)
+{
+  DecalLayer layer(100, 1, 1.0f, 1.0f);
+  layer.stamp(make_decal({ 40.0f, 40.0f }));
+  std::vector<DecalBatch> batches;
+  layer.take_pending(batches);
+
+  layer.update(1.5f);
+  ASSERT_FLOAT_EQ(0.5f, layer.get_chunk_alpha(layer.get_chunks().begin()->second));
+
+  layer.update(1.0f);
+  ASSERT_EQ(0, layer.get_chunks().size());
+  ASSERT_EQ(1, layer.chunks_released);
+
+  // the recycled target still holds the old decal
+  layer.stamp(make_decal({ 240.0f, 40.0f }));
+  layer.take_pending(batches);
+  ASSERT_EQ(1, batches.size());
+  ASSERT_TRUE(batches[0].clear_first);
+}
+
+TEST(DecalLayer, FadedChunkDropsItsQueuedStamps)
+{
+  DecalLayer layer(100, 4, 1.0f, 1.0f);
+  layer.stamp(make_decal({ 40.0f, 40.0f }));
+  layer.stamp(make_decal({ 60.0f, 40.0f }));
+
+  // the chunk fades out before its stamps were taken
+  layer.update(2.0f);
+  ASSERT_EQ(0, layer.get_chunks().size());
+  ASSERT_EQ(0, layer.get_pending_count());
+
+  std::vector<DecalBatch> batches;
+  layer.take_pending(batches);
+  ASSERT_TRUE(batches.empty());
+}
+
+TEST(DecalLayer, RestampingKeepsChunkAlive)
+{
+  DecalLayer layer(100, 4, 1.0f, 1.0f);
+  layer.stamp(make_decal({ 40.0f, 40.0f }));
+  layer.update(1.5f);
+  layer.stamp(make_decal({ 50.0f, 50.0f }));
+  layer.update(1.5f);
+
+  ASSERT_EQ(1, layer.get_chunks().size());
+}
+
+TEST(DecalLayer, OldestChunkIsEvictedWhenOutOfTargets)
+{
+  DecalLayer layer(100, 2, 10.0f, 1.0f);
+  layer.stamp(make_decal({ 40.0f, 40.0f }));
+  layer.update(1.0f);
+  layer.stamp(make_decal({ 240.0f, 40.0f }));
+  layer.update(1.0f);
+  layer.stamp(make_decal({ 440.0f, 40.0f }));
+
+  ASSERT_EQ(2, layer.get_chunks().size());
+  ASSERT_EQ(1, layer.chunks_evicted);
+  ASSERT_EQ(0, layer.get_chunks().count({ 0, 0 }));
+
+  // the evicted chunk's stamp was dropped
+  std::vector<DecalBatch> batches;
+  layer.take_pending(batches);
+  ASSERT_EQ(2, batches.size());
+}
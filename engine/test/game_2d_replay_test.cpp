@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "engine/networking/bitstream.hpp"
+#include "engine/tools/cvars.hpp"
+using namespace fightingengine;
+
+#include "2d_game.hpp"
+#include "2d_replay.hpp"
+#include "2d_scenario.hpp"
+#include "2d_state_hash.hpp"
+using namespace game2d;
+
+static constexpr int recorded_frames = 200;
+
+// runs the game the way main.cpp's loop does, recording it, and keeps what each frame should decode to.
+// on the way it switches weapon, resizes, places a tree, spawns a scenario and changes a cvar
+static void
+record(Replay& replay, std::vector<ReplayFrame>& frames)
+{
+  ReplayRecorder recorder;
+  GameState live;
+  live.headless = true;
+  recorder.start(7, { 1280, 720 });
+  game::init(live, { 1280, 720 }, 7);
+  live.entities_player[0].invulnerable = true;
+
+  CVarBase* spawn_interval = cvars::find("spawner.interval_start_s");
+  ASSERT_NE(nullptr, spawn_interval);
+  const std::vector<CVarBase*> all_cvars = cvars::get_all(); // the recorder's order
+  const uint32_t cvar_index =
+    static_cast<uint32_t>(std::find(all_cvars.begin(), all_cvars.end(), spawn_interval) - all_cvars.begin());
+
+  frames.clear();
+  for (int f = 0; f < recorded_frames; f++) {
+    ReplayFrame frame;
+    frame.physics = live.running == GameRunning::ACTIVE;
+    if (frame.physics)
+      game::update_physics(live);
+
+    if (f == 20) {
+      game::place_tree(live, { 300.0f, 200.0f });
+      recorder.add_tree({ 300.0f, 200.0f });
+      ReplayEvent e;
+      e.type = ReplayEvent::Type::TREE;
+      e.pos = { 300.0f, 200.0f };
+      frame.events.push_back(e);
+    }
+    if (f == 50)
+      live.entities_player[0].equipped_weapon = Weapons::SHOVEL;
+    if (f == 80)
+      live.screen_wh = { 1920, 1080 };
+
+    KeysAndState& k = live.player_keys[0];
+    k.use_keyboard = false;
+    k.l_analogue_x = (f / 30) % 2 ? 1.0f : -1.0f;
+    k.angle_around_player = f / 30.0f;
+    k.r_analogue_x = std::sin(k.angle_around_player);
+    k.r_analogue_y = -std::cos(k.angle_around_player);
+    k.shoot_pressed = (f / 45) % 2 != 0;
+    k.shoot_down = f % 45 == 0;
+
+    frame.delta_time_s = 1.0f / 60.0f + 0.001f * ((f * 7) % 5);
+    recorder.capture(live, frame.delta_time_s, frame.physics);
+    frame.player_attacks_enabled = live.player_attacks_enabled;
+    frame.screen_wh = live.screen_wh;
+    frame.players.resize(live.player_keys.size());
+    for (size_t i = 0; i < live.player_keys.size(); i++) {
+      frame.players[i].keys = live.player_keys[i];
+      frame.players[i].weapon = live.entities_player[i].equipped_weapon;
+    }
+
+    game::update(live, frame.delta_time_s);
+
+    if (f == 100) {
+      ScenarioConfig config;
+      config.seed = 3;
+      config.enemies = 40;
+      config.bullets = 10;
+      scenario::populate(live, config);
+      recorder.add_scenario(config);
+      ReplayEvent e;
+      e.type = ReplayEvent::Type::SCENARIO;
+      e.scenario = config;
+      frame.events.push_back(e);
+    }
+    if (f == 150) {
+      ASSERT_TRUE(spawn_interval->set_from_string("0.5"));
+      ReplayEvent e;
+      e.type = ReplayEvent::Type::CVAR;
+      e.cvar = cvar_index;
+      float value = 0.5f;
+      std::memcpy(&e.cvar_bits, &value, sizeof(value));
+      frame.events.push_back(e);
+    }
+
+    recorder.end_frame(live);
+    frame.state_hash = static_cast<uint32_t>(state_hash::hash(live));
+    frames.push_back(frame);
+  }
+  spawn_interval->reset();
+
+  replay = recorder.get_replay();
+}
+
+static std::string
+get_replay_path(const char* name)
+{
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST(GameReplay, PlaybackMatchesEveryRecordedFrame)
+{
+  Replay recorded;
+  std::vector<ReplayFrame> frames;
+  ASSERT_NO_FATAL_FAILURE(record(recorded, frames));
+  ASSERT_EQ(static_cast<uint32_t>(recorded_frames), recorded.header.frames);
+
+  const std::string path = get_replay_path("fightingengine_replay_test.replay");
+  ASSERT_TRUE(replay::save(path, recorded));
+  Replay loaded;
+  ASSERT_TRUE(replay::load(path, loaded));
+  std::filesystem::remove(path);
+
+  GameState state;
+  state.headless = true;
+  replay::begin(loaded, state);
+  state.entities_player[0].invulnerable = true; // not an input, set the same way as the recording
+
+  ReplayReader reader(loaded);
+  ReplayFrame frame;
+  while (reader.next(frame)) {
+    replay::step(state, frame, loaded.header.cvars);
+    ASSERT_TRUE(replay::check(state, frame)) << "frame " << reader.get_frame() - 1;
+  }
+  ASSERT_FALSE(reader.is_corrupt());
+  ASSERT_EQ(static_cast<uint32_t>(recorded_frames), reader.get_frame());
+  cvars::find("spawner.interval_start_s")->reset();
+}
+
+TEST(GameReplay, DecodesTheFramesThatWereCaptured)
+{
+  Replay recorded;
+  std::vector<ReplayFrame> frames;
+  ASSERT_NO_FATAL_FAILURE(record(recorded, frames));
+
+  ReplayReader reader(recorded);
+  ReplayFrame frame;
+  for (const ReplayFrame& expected : frames) {
+    ASSERT_TRUE(reader.next(frame));
+    SCOPED_TRACE("frame " + std::to_string(reader.get_frame() - 1));
+    ASSERT_EQ(expected.delta_time_s, frame.delta_time_s);
+    ASSERT_EQ(expected.physics, frame.physics);
+    ASSERT_EQ(expected.player_attacks_enabled, frame.player_attacks_enabled);
+    ASSERT_EQ(expected.screen_wh, frame.screen_wh);
+    ASSERT_EQ(expected.state_hash, frame.state_hash);
+
+    ASSERT_EQ(expected.players.size(), frame.players.size());
+    for (size_t i = 0; i < expected.players.size(); i++) {
+      const KeysAndState& a = expected.players[i].keys;
+      const KeysAndState& b = frame.players[i].keys;
+      ASSERT_EQ(expected.players[i].weapon, frame.players[i].weapon);
+      ASSERT_EQ(a.use_keyboard, b.use_keyboard);
+      ASSERT_EQ(a.l_analogue_x, b.l_analogue_x);
+      ASSERT_EQ(a.l_analogue_y, b.l_analogue_y);
+      ASSERT_EQ(a.r_analogue_x, b.r_analogue_x);
+      ASSERT_EQ(a.r_analogue_y, b.r_analogue_y);
+      ASSERT_EQ(a.angle_around_player, b.angle_around_player);
+      ASSERT_EQ(a.pause_pressed, b.pause_pressed);
+      ASSERT_EQ(a.shoot_pressed, b.shoot_pressed);
+      ASSERT_EQ(a.shoot_down, b.shoot_down);
+      ASSERT_EQ(a.boost_pressed, b.boost_pressed);
+      ASSERT_EQ(a.camera_x, b.camera_x);
+      ASSERT_EQ(a.camera_y, b.camera_y);
+    }
+
+    ASSERT_EQ(expected.events.size(), frame.events.size());
+    for (size_t i = 0; i < expected.events.size(); i++) {
+      const ReplayEvent& a = expected.events[i];
+      const ReplayEvent& b = frame.events[i];
+      ASSERT_EQ(a.type, b.type);
+      ASSERT_EQ(a.pos, b.pos);
+      ASSERT_EQ(a.scenario.seed, b.scenario.seed);
+      ASSERT_EQ(a.scenario.radius, b.scenario.radius);
+      ASSERT_EQ(a.scenario.enemies, b.scenario.enemies);
+      ASSERT_EQ(a.scenario.enemy_layout, b.scenario.enemy_layout);
+      ASSERT_EQ(a.scenario.swarms, b.scenario.swarms);
+      ASSERT_EQ(a.scenario.swarm_radius, b.scenario.swarm_radius);
+      ASSERT_EQ(a.scenario.bullets, b.scenario.bullets);
+      ASSERT_EQ(a.scenario.trees, b.scenario.trees);
+      ASSERT_EQ(a.scenario.splats, b.scenario.splats);
+      ASSERT_EQ(a.cvar, b.cvar);
+      ASSERT_EQ(a.cvar_bits, b.cvar_bits);
+    }
+  }
+  ASSERT_FALSE(reader.next(frame));
+  ASSERT_FALSE(reader.is_corrupt());
+}
+
+TEST(GameReplay, TruncatedFileIsCorrupt)
+{
+  Replay recorded;
+  std::vector<ReplayFrame> frames;
+  ASSERT_NO_FATAL_FAILURE(record(recorded, frames));
+
+  const std::string path = get_replay_path("fightingengine_replay_truncated_test.replay");
+  ASSERT_TRUE(replay::save(path, recorded));
+  std::vector<uint8_t> bytes;
+  {
+    std::ifstream file(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  {
+    // the header is whole, the frames stop half way
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size() - recorded.frame_bytes.size() / 2);
+  }
+
+  Replay loaded;
+  ASSERT_TRUE(replay::load(path, loaded));
+  std::filesystem::remove(path);
+
+  ReplayReader reader(loaded);
+  ReplayFrame frame;
+  while (reader.next(frame)) {
+  }
+  ASSERT_TRUE(reader.is_corrupt());
+  ASSERT_LT(reader.get_frame(), static_cast<uint32_t>(recorded_frames));
+}
+
+TEST(GameReplay, CountsTheDataCantHoldAreCorrupt)
+{
+  // a frame saying it has 4 billion players
+  Replay replay;
+  replay.header.frames = 1;
+  BitWriter out;
+  out.write_bool(false); // delta_time_s unchanged
+  out.write_bool(true);  // physics
+  out.write_bool(true);  // player_attacks_enabled
+  out.write_bool(false); // not resized
+  out.write_bool(true);  // players changed
+  out.write_varuint(0xffffffff);
+  out.write_bits(0, 32);
+  out.flush();
+  replay.frame_bytes = out.get_bytes();
+
+  ReplayReader reader(replay);
+  ReplayFrame frame;
+  ASSERT_FALSE(reader.next(frame));
+  ASSERT_TRUE(reader.is_corrupt());
+  ASSERT_TRUE(frame.players.empty());
+}
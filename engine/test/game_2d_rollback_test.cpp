@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "2d_game.hpp"
+#include "2d_game_object.hpp"
+#include "2d_rollback.hpp"
+#include "2d_state_hash.hpp"
+using namespace game2d;
+
+static constexpr float dt = 1.0f / 60.0f;
+
+static void
+fill_keys(int frame, KeysAndState& keys)
+{
+  const float t = frame / 60.0f;
+  keys = KeysAndState();
+  keys.l_analogue_x = cos(t);
+  keys.l_analogue_y = sin(t);
+  keys.angle_around_player = t * 2.0f;
+  keys.shoot_pressed = true;
+}
+
+static void
+make_game(GameState& state, int enemies)
+{
+  game::init(state, { 1280, 720 }, 1);
+  state.entities_player[0].invulnerable = true;
+  state.entities_player[0].equipped_weapon = Weapons::PISTOL;
+  state.player_keys[0].use_keyboard = false;
+  for (int i = 0; i < enemies; i++) {
+    GameObject2D enemy = gameobject::create_enemy(sprite_enemy_core, tex_unit_kenny_nl, enemy_colour, state.rnd);
+    enemy.pos = glm::vec2(100.0f * i, 50.0f);
+    state.entities_enemies.push_back(enemy);
+  }
+}
+
+TEST(GameRollback, LoadingASaveSimulatesTheSameFrames)
+{
+  GameState state;
+  make_game(state, 8);
+
+  std::vector<uint8_t> start;
+  rollback::save(state, start);
+  for (int frame = 0; frame < 60; frame++) {
+    fill_keys(frame, state.player_keys[0]);
+    rollback::step(state, dt);
+  }
+  const uint64_t expected = state_hash::hash(state);
+
+  ASSERT_TRUE(rollback::load(start, state));
+  for (int frame = 0; frame < 60; frame++) {
+    fill_keys(frame, state.player_keys[0]);
+    rollback::step(state, dt);
+  }
+  ASSERT_EQ(expected, state_hash::hash(state));
+}
+
+TEST(GameRollback, CorrectedKeysResimulateToTheUninterruptedRun)
+{
+  GameState state;
+  make_game(state, 8);
+  std::vector<uint8_t> start;
+  rollback::save(state, start);
+
+  // every frame with its real keys
+  RollbackSession session(16);
+  session.reset(0);
+  for (int frame = 0; frame < 30; frame++) {
+    fill_keys(frame, state.player_keys[0]);
+    session.advance(state, dt);
+  }
+  const uint64_t expected = state_hash::hash(state);
+
+  // the last 10 frames guessed, then their real keys arrive
+  ASSERT_TRUE(rollback::load(start, state));
+  session.reset(0);
+  for (int frame = 0; frame < 30; frame++) {
+    if (frame < 20)
+      fill_keys(frame, state.player_keys[0]);
+    else
+      state.player_keys[0] = KeysAndState();
+    session.advance(state, dt);
+  }
+  ASSERT_NE(expected, state_hash::hash(state));
+
+  for (int frame = 20; frame < 30; frame++) {
+    KeysAndState keys;
+    fill_keys(frame, keys);
+    ASSERT_TRUE(session.set_keys(frame, 0, keys));
+  }
+  ASSERT_TRUE(session.rollback(state, 20, dt));
+  ASSERT_EQ(30u, session.get_frame());
+  ASSERT_EQ(expected, state_hash::hash(state));
+}
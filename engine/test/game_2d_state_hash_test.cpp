@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "2d_game.hpp"
+#include "2d_game_object.hpp"
+#include "2d_state_hash.hpp"
+using namespace game2d;
+
+static void
+make_game(GameState& state, int enemies)
+{
+  game::init(state, { 1280, 720 }, 1);
+  for (int i = 0; i < enemies; i++) {
+    GameObject2D enemy = gameobject::create_enemy(sprite_enemy_core, tex_unit_kenny_nl, enemy_colour, state.rnd);
+    enemy.pos = glm::vec2(100.0f * i, 50.0f);
+    state.entities_enemies.push_back(enemy);
+  }
+}
+
+TEST(GameStateHash, FindsTheFirstFieldThatDiffers)
+{
+  GameState a;
+  make_game(a, 4);
+  GameState b = a;
+  ASSERT_EQ(state_hash::hash(a), state_hash::hash(b));
+
+  StateMismatch mismatch;
+  ASSERT_FALSE(state_hash::find_mismatch(a, b, mismatch));
+
+  b.entities_enemies[2].pos.x += 0.5f;
+  ASSERT_NE(state_hash::hash(a), state_hash::hash(b));
+  ASSERT_TRUE(state_hash::find_mismatch(a, b, mismatch));
+  ASSERT_EQ("enemies", mismatch.group);
+  ASSERT_EQ(2u, mismatch.index);
+  ASSERT_EQ(a.entities_enemies[2].id, mismatch.id);
+  ASSERT_EQ("pos.x", mismatch.field);
+  ASSERT_EQ("200", mismatch.a);
+  ASSERT_EQ("200.5", mismatch.b);
+  ASSERT_EQ("enemies[2] id " + std::to_string(mismatch.id) + " pos.x: 200 vs 200.5", state_hash::to_string(mismatch));
+}
+
+TEST(GameStateHash, ReportsAGroupOneStateHasMoreOf)
+{
+  GameState a;
+  make_game(a, 4);
+  GameState b = a;
+  b.entities_enemies.pop_back();
+
+  StateMismatch mismatch;
+  ASSERT_TRUE(state_hash::find_mismatch(a, b, mismatch));
+  ASSERT_EQ("enemies", mismatch.group);
+  ASSERT_EQ(3u, mismatch.index); // a's first enemy b doesn't have
+  ASSERT_EQ(a.entities_enemies[3].id, mismatch.id);
+  ASSERT_EQ("count", mismatch.field);
+  ASSERT_EQ("4", mismatch.a);
+  ASSERT_EQ("3", mismatch.b);
+
+  // the other way round
+  ASSERT_TRUE(state_hash::find_mismatch(b, a, mismatch));
+  ASSERT_EQ("enemies", mismatch.group);
+  ASSERT_EQ("count", mismatch.field);
+  ASSERT_EQ("3", mismatch.a);
+  ASSERT_EQ("4", mismatch.b);
+}
+
+TEST(GameStateHash, LeavesOutTheGlobalIdCounters)
+{
+  GameState a;
+  make_game(a, 4);
+  const uint64_t before = state_hash::hash(a);
+
+  const uint32_t entity_ids = GameObject2D::get_id_counter();
+  GameObject2D::set_id_counter(entity_ids + 10);
+  const uint64_t after = state_hash::hash(a);
+  GameObject2D::set_id_counter(entity_ids);
+  ASSERT_EQ(before, after);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "engine/networking/bitstream.hpp"
+#include "engine/networking/interest.hpp"
+#include "engine/networking/snapshot.hpp"
+using namespace fightingengine;
+
+static NetEntityState
+make_entity(const SnapshotSchema& schema, uint32_t id, float x, float y)
+{
+  NetEntityState e;
+  e.id = id;
+  e.pos_x = snapshot::quantise_position(schema, x);
+  e.pos_y = snapshot::quantise_position(schema, y);
+  return e;
+}
+
+static bool
+contains(const std::vector<uint32_t>* ids, uint32_t id)
+{
+  return ids != nullptr && std::find(ids->begin(), ids->end(), id) != ids->end();
+}
+
+TEST(InterestGrid, TracksCellEnterMoveAndLeave)
+{
+  SnapshotSchema schema;
+  InterestGrid grid(100);
+
+  Snapshot world;
+  world.entities = { make_entity(schema, 1, 50, 50), make_entity(schema, 2, 60, 60), make_entity(schema, 3, 250, 50) };
+  grid.update(world, schema);
+  ASSERT_EQ(3u, grid.get_events().size());
+  ASSERT_EQ(CellEvent::Type::Enter, grid.get_events()[0].type);
+  ASSERT_EQ(2u, grid.get_entities({ 0, 0 })->size());
+  ASSERT_TRUE(contains(grid.get_entities({ 2, 0 }), 3));
+
+  // 1 moves across, 2 stays put, 3 is gone
+  world.entities = { make_entity(schema, 1, 150, 50), make_entity(schema, 2, 70, 60) };
+  grid.update(world, schema);
+  ASSERT_EQ(2u, grid.get_events().size());
+  ASSERT_EQ(CellEvent::Type::Move, grid.get_events()[0].type);
+  ASSERT_EQ(glm::ivec2(1, 0), grid.get_events()[0].to);
+  ASSERT_EQ(CellEvent::Type::Leave, grid.get_events()[1].type);
+  ASSERT_EQ(3u, grid.get_events()[1].id);
+
+  ASSERT_TRUE(contains(grid.get_entities({ 0, 0 }), 2));
+  ASSERT_FALSE(contains(grid.get_entities({ 0, 0 }), 1));
+  ASSERT_TRUE(contains(grid.get_entities({ 1, 0 }), 1));
+  ASSERT_EQ(nullptr, grid.get_entities({ 2, 0 }));
+  ASSERT_EQ(2u, grid.get_entity_count());
+
+  // nothing moved, nothing to report
+  grid.update(world, schema);
+  ASSERT_TRUE(grid.get_events().empty());
+}
+
+TEST(ClientInterest, OnlySendsNearbyEntitiesWithinBudget)
+{
+  SnapshotSchema schema;
+  InterestConfig config;
+  config.cell_size = 100;
+  config.view_radius_cells = 1;
+  config.bytes_per_tick = 200;
+  InterestGrid grid(config.cell_size);
+
+  // a 40x40 block of entities around the client, and one far away
+  Snapshot world;
+  world.tick = 1;
+  uint32_t id = 1;
+  for (int y = 0; y < 40; y++)
+    for (int x = 0; x < 40; x++)
+      world.entities.push_back(make_entity(schema, id++, -99.0f + x * 7.0f, -99.0f + y * 7.0f));
+  const uint32_t far_id = id;
+  world.entities.push_back(make_entity(schema, far_id, 5000, 5000));
+  grid.update(world, schema);
+
+  ClientInterest client;
+  client.set_camera({ 50.0f, 50.0f });
+  SnapshotHistory received;
+  Snapshot decoded;
+
+  // the budget only fits a few entities a tick, so it takes a while for the client to have everything
+  int ticks = 0;
+  for (; ticks < 200; ticks++) {
+    world.tick = 1 + ticks;
+    BitWriter out;
+    client.write_snapshot(grid, world, schema, config, out);
+    ASSERT_LE(out.get_bytes_written(), static_cast<size_t>(config.bytes_per_tick));
+
+    BitReader in(out.get_bytes().data(), out.get_bytes().size());
+    ASSERT_TRUE(snapshot::decode(schema, in, received, decoded));
+    received.add(decoded);
+    client.on_ack(decoded.tick);
+    if (client.get_stats().deferred == 0)
+      break;
+  }
+  ASSERT_GT(ticks, 1);
+  ASSERT_LT(ticks, 200);
+  ASSERT_EQ(1600, client.get_stats().relevant);
+  ASSERT_EQ(1600u, decoded.entities.size());
+  ASSERT_EQ(nullptr, snapshot::find_entity(decoded, far_id));
+
+  // once the client is up to date, an idle world costs just the header
+  world.tick += 1;
+  BitWriter idle;
+  client.write_snapshot(grid, world, schema, config, idle);
+  ASSERT_EQ(0, client.get_stats().updated);
+  ASSERT_LE(idle.get_bytes_written(), 10u);
+}
+
+TEST(ClientInterest, StaysInBudgetWithSparseIdsAndAMovingCamera)
+{
+  SnapshotSchema schema;
+  InterestConfig config;
+  config.cell_size = 100;
+  config.view_radius_cells = 1;
+  config.bytes_per_tick = 120;
+  InterestGrid grid(config.cell_size);
+
+  // a long strip of entities with ids far apart, so every id delta takes the widest varuint
+  const int count = 600;
+  std::vector<uint32_t> ids;
+  for (int i = 0; i < count; i++)
+    ids.push_back(1 + static_cast<uint32_t>(i) * 99991u);
+
+  ClientInterest client;
+  SnapshotHistory received;
+  Snapshot decoded;
+  Snapshot world;
+
+  // the camera runs along the strip, so each tick whole cells the client has drop out of view
+  // and have to be removed, while everything in view moves
+  for (int tick = 0; tick < 120; tick++) {
+    world.tick = 1 + tick;
+    world.entities.clear();
+    for (int i = 0; i < count; i++) {
+      const float jitter = static_cast<float>((tick + i) % 5);
+      world.entities.push_back(make_entity(schema, ids[i], i * 10.0f + jitter, 50.0f + jitter));
+    }
+    grid.update(world, schema);
+    client.set_camera({ 50.0f + tick * 40.0f, 50.0f });
+
+    BitWriter out;
+    client.write_snapshot(grid, world, schema, config, out);
+    ASSERT_LE(out.get_bytes().size(), static_cast<size_t>(config.bytes_per_tick)) << "tick " << tick;
+    ASSERT_GT(client.get_stats().updated, 0) << "tick " << tick;
+
+    BitReader in(out.get_bytes().data(), out.get_bytes().size());
+    ASSERT_TRUE(snapshot::decode(schema, in, received, decoded));
+    received.add(decoded);
+    client.on_ack(decoded.tick);
+  }
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "engine/tools/latency_histogram.hpp"
+#include "engine/tools/profiler.hpp"
+using namespace fightingengine;
+
+TEST(LatencyHistogram, BucketsStayWithinPrecision)
+{
+  for (uint64_t v : { 1ull, 63ull, 64ull, 100ull, 16667ull, 1000000ull }) {
+    int index = LatencyHistogram::get_bucket_index(v);
+    uint64_t upper = LatencyHistogram::get_bucket_upper_bound(index);
+    ASSERT_GE(upper, v);
+    ASSERT_LE(upper - v, v / LatencyHistogram::sub_bucket_count + 1);
+  }
+}
+
+TEST(LatencyHistogram, PercentilesOfUniformValues)
+{
+  LatencyHistogram histogram(100);
+  for (uint64_t v = 1; v <= 100; v++)
+    histogram.record(v * 100);
+
+  ASSERT_NEAR(5000.0, histogram.get_percentile(50.0f), 5000.0 * 0.035);
+  ASSERT_NEAR(9500.0, histogram.get_percentile(95.0f), 9500.0 * 0.035);
+  ASSERT_NEAR(9900.0, histogram.get_percentile(99.0f), 9900.0 * 0.035);
+  ASSERT_EQ(10000, histogram.get_max());
+}
+
+TEST(LatencyHistogram, WindowEvictsOldValues)
+{
+  LatencyHistogram histogram(4);
+  histogram.record(50000);
+  for (int i = 0; i < 4; i++)
+    histogram.record(10);
+
+  ASSERT_EQ(4, histogram.get_count());
+  ASSERT_EQ(10, histogram.get_max());
+  ASSERT_EQ(10, histogram.get_percentile(99.0f));
+}
+
+TEST(Profiler, FramesOverBudgetAreSnapshotted)
+{
+  Profiler profiler;
+  profiler.set_frame_budget_ms(1.0f);
+
+  profiler.new_frame();
+  profiler.begin(Profiler::Stage::GameTick);
+  profiler.end(Profiler::Stage::GameTick);
+  profiler.new_frame(); // fast frame
+
+  profiler.begin(Profiler::Stage::GameTick);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  profiler.end(Profiler::Stage::GameTick);
+  profiler.new_frame(); // slow frame
+
+  ASSERT_EQ(1, profiler.get_spikes().size());
+  const Profiler::SpikeSnapshot& spike = profiler.get_spikes().back();
+  ASSERT_EQ(2, spike.frame_index);
+  ASSERT_GE(spike.frame_ms, 5.0f);
+  ASSERT_EQ(1, spike.zones.events.size());
+  ASSERT_STREQ("Game Tick", spike.zones.events[0].name);
+
+  Profiler::StagePercentiles p = profiler.get_percentiles(Profiler::Stage::GameTick);
+  ASSERT_GE(p.max_ms, 5.0f);
+  ASSERT_LE(p.p50_ms, p.max_ms);
+}
+
+TEST(Profiler, StagesNotBegunAreNotRecordedAgain)
+{
+  Profiler profiler;
+  profiler.set_percentile_window(10);
+
+  profiler.new_frame();
+  profiler.begin(Profiler::Stage::GameTick);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  profiler.end(Profiler::Stage::GameTick);
+  profiler.new_frame(); // slow frame
+
+  // push the slow frame out of the window
+  for (int i = 0; i < 10; i++) {
+    profiler.begin(Profiler::Stage::GameTick);
+    profiler.end(Profiler::Stage::GameTick);
+    profiler.new_frame();
+  }
+
+  // wrap round the ring without the stage, until the slow frame's entry is reused
+  for (int i = 0; i < 50; i++)
+    profiler.new_frame();
+
+  ASSERT_LT(profiler.get_percentiles(Profiler::Stage::GameTick).max_ms, 5.0f);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/tools/logger.hpp"
+#include "engine/tools/mpsc_ring.hpp"
+using namespace fightingengine;
+
+static std::string
+read_file(const std::string& path)
+{
+  std::ifstream f(path);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+static int
+count_lines(const std::string& text)
+{
+  int lines = 0;
+  for (char c : text)
+    lines += c == '\n' ? 1 : 0;
+  return lines;
+}
+
+TEST(MpscRing, KeepsEveryProducersOrderAndRejectsWhenFull)
+{
+  MpscRing<uint64_t> ring(1024);
+  ASSERT_EQ(1024, ring.capacity());
+
+  const int producers = 4;
+  const uint64_t per_producer = 20000;
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++) {
+    threads.emplace_back([&ring, p, per_producer] {
+      for (uint64_t i = 0; i < per_producer; i++) {
+        while (!ring.try_push((static_cast<uint64_t>(p) << 32) | i))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  std::vector<uint64_t> next(producers, 0);
+  uint64_t popped = 0;
+  while (popped < producers * per_producer) {
+    uint64_t value = 0;
+    if (!ring.try_pop(value))
+      continue;
+    int p = static_cast<int>(value >> 32);
+    ASSERT_EQ(next[p], value & 0xffffffff);
+    next[p] += 1;
+    popped += 1;
+  }
+  for (auto& t : threads)
+    t.join();
+
+  MpscRing<int> small(2);
+  ASSERT_TRUE(small.try_push(1));
+  ASSERT_TRUE(small.try_push(2));
+  ASSERT_FALSE(small.try_push(3));
+}
+
+TEST(Logger, FormatsArgumentsLazily)
+{
+  LogSite site{ "engine/src/some_file.cpp", 42, LogLevel::Warn };
+  LogRecord record;
+  record.level = site.level;
+  record.file = site.file;
+  record.line = site.line;
+  record.fmt = "{} of {} at {} ok={} name={} {}";
+  std::string name = "enemy";
+  logger::detail::capture(record, 3);
+  logger::detail::capture(record, 10u);
+  logger::detail::capture(record, 0.5f);
+  logger::detail::capture(record, true);
+  logger::detail::capture(record, name);
+  name = "changed after capture";
+
+  std::string message;
+  logger::format_message(record, message);
+  ASSERT_EQ("3 of 10 at 0.5 ok=true name=enemy {}", message);
+
+  std::string line;
+  logger::format_line(record, line);
+  ASSERT_NE(std::string::npos, line.find("[WARN ]"));
+  ASSERT_NE(std::string::npos, line.find(" some_file.cpp:42 3 of 10"));
+  ASSERT_EQ('\n', line.back());
+}
+
+TEST(Logger, WritesFromManyThreadsAndRateLimitsEachSite)
+{
+  std::string path = (std::filesystem::temp_directory_path() / "fightingengine_logger_test.log").string();
+
+  LoggerConfig config;
+  config.level = LogLevel::Debug;
+  config.to_stdout = false;
+  config.file_path = path;
+  config.max_per_site_per_second = 5;
+  ASSERT_TRUE(logger::start(config));
+
+  const uint64_t written_before = logger::get_written_count();
+
+  // below the runtime level: never reaches the ring
+  FE_LOG_TRACE("not written {}", 1);
+
+  // one site per thread, each hit 100 times, only 5 get through
+  const int threads = 4;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([t] {
+      LogSite site{ __FILE__, __LINE__, LogLevel::Info };
+      for (int i = 0; i < 100; i++)
+        logger::write(site, "thread {} message {}", t, i);
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+
+  FE_LOG_DEBUG("done");
+  logger::flush();
+  ASSERT_EQ(threads * 5 + 1, logger::get_written_count() - written_before);
+  logger::stop();
+
+  std::string text = read_file(path);
+  ASSERT_EQ(threads * 5 + 1, count_lines(text));
+  ASSERT_EQ(std::string::npos, text.find("not written"));
+  ASSERT_NE(std::string::npos, text.find("thread 0 message 4"));
+  ASSERT_EQ(std::string::npos, text.find("thread 0 message 5"));
+  ASSERT_NE(std::string::npos, text.find("[DEBUG]"));
+
+  std::filesystem::remove(path);
+}
+
+TEST(Logger, StopWhileThreadsAreLoggingLosesNothing)
+{
+  LoggerConfig config;
+  config.to_stdout = false;
+  config.capacity = 64;
+  ASSERT_TRUE(logger::start(config));
+
+  const uint64_t written_before = logger::get_written_count();
+  const uint64_t dropped_before = logger::get_dropped_count();
+
+  // not rate limited, so every message is either written or counted as dropped,
+  // whether it went in the ring or came after stop() and was written straight away
+  const int threads = 4;
+  const int messages = 2000;
+  std::atomic<int> started{ 0 };
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([t, &started] {
+      LogSite site{ __FILE__, __LINE__, LogLevel::Info, false };
+      started.fetch_add(1);
+      for (int i = 0; i < messages; i++)
+        logger::write(site, "thread {} message {}", t, i);
+    });
+  }
+  while (started.load() < threads)
+    std::this_thread::yield();
+  logger::stop();
+  for (auto& w : workers)
+    w.join();
+
+  const uint64_t written = logger::get_written_count() - written_before;
+  const uint64_t dropped = logger::get_dropped_count() - dropped_before;
+  ASSERT_EQ(static_cast<uint64_t>(threads * messages), written + dropped);
+}
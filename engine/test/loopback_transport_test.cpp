@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "engine/networking/load_test.hpp"
+#include "engine/networking/loopback_transport.hpp"
+using namespace fightingengine;
+
+static constexpr uint64_t ms = 1000000;
+
+static std::vector<std::string>
+receive_all(Transport& t)
+{
+  std::vector<TransportMessage> messages;
+  t.receive(messages);
+  std::vector<std::string> out;
+  for (const TransportMessage& m : messages)
+    out.emplace_back(m.payload);
+  return out;
+}
+
+TEST(LoopbackNetwork, DeliversAfterLatencyAndReportsConnections)
+{
+  LinkConditions link;
+  link.latency_ms = 20.0f;
+  LoopbackNetwork network(link);
+  LoopbackEndpoint& client = network.connect();
+
+  std::vector<TransportEvent> events;
+  network.get_server().poll_events(events);
+  ASSERT_EQ(1u, events.size());
+  ASSERT_EQ(TransportEvent::Type::Connected, events[0].type);
+  ASSERT_EQ(client.get_id(), events[0].conn);
+
+  ASSERT_TRUE(client.send(client.get_id(), "hi", 2, true));
+  network.update(19 * ms);
+  ASSERT_TRUE(receive_all(network.get_server()).empty());
+  network.update(20 * ms);
+  ASSERT_EQ(std::vector<std::string>{ "hi" }, receive_all(network.get_server()));
+
+  // the server closes it: the client hears about it, and later sends go nowhere
+  network.get_server().close(client.get_id(), "bye");
+  ASSERT_FALSE(client.is_connected());
+  events.clear();
+  client.poll_events(events);
+  ASSERT_EQ(2u, events.size());
+  ASSERT_EQ(TransportEvent::Type::Disconnected, events[1].type);
+  ASSERT_EQ("bye", events[1].reason);
+  ASSERT_FALSE(network.get_server().send(client.get_id(), "x", 1, true));
+}
+
+TEST(LoopbackNetwork, ReliableStaysInOrderUnderJitterAndLoss)
+{
+  LinkConditions link;
+  link.latency_ms = 10.0f;
+  link.jitter_ms = 30.0f;
+  link.loss = 0.2f;
+  LoopbackNetwork network(link, 7);
+  LoopbackEndpoint& client = network.connect();
+
+  const int count = 1000;
+  for (int i = 0; i < count; i++) {
+    const std::string s = std::to_string(i);
+    network.get_server().send(client.get_id(), s.data(), static_cast<uint32_t>(s.size()), true);
+    client.send(client.get_id(), s.data(), static_cast<uint32_t>(s.size()), false);
+    network.update(network.get_time_ns() + ms);
+  }
+  network.update(network.get_time_ns() + 1000 * ms);
+
+  const std::vector<std::string> reliable = receive_all(client);
+  ASSERT_EQ(static_cast<size_t>(count), reliable.size());
+  for (int i = 0; i < count; i++)
+    ASSERT_EQ(std::to_string(i), reliable[i]);
+
+  // around a fifth of the unreliable ones are gone
+  const size_t unreliable = receive_all(network.get_server()).size();
+  ASSERT_GT(unreliable, count * 0.7);
+  ASSERT_LT(unreliable, count * 0.9);
+  ASSERT_EQ(count - unreliable, network.get_stats().messages_lost);
+  ASSERT_GT(network.get_stats().messages_resent, 0u);
+}
+
+// sends its time every tick, and times the echo
+class EchoBot : public LoadTestBot
+{
+public:
+  void update(LoadTestContext& ctx) override
+  {
+    const uint64_t now = ctx.get_time_ns();
+    ctx.send(&now, sizeof(now), false);
+  }
+  void on_message(LoadTestContext& ctx, std::string_view payload) override
+  {
+    uint64_t sent = 0;
+    ASSERT_EQ(sizeof(sent), payload.size());
+    memcpy(&sent, payload.data(), sizeof(sent));
+    ctx.record_latency(sent);
+  }
+};
+
+TEST(LoadTest, EchoServerReport)
+{
+  LoadTestConfig config;
+  config.clients = 50;
+  config.connects_per_tick = 10;
+  config.duration_s = 1.0f;
+  config.realtime = false;
+  config.link.latency_ms = 25.0f;
+  LoadTest test(config);
+
+  Transport& server = test.get_server_transport();
+  std::vector<TransportMessage> messages;
+  auto tick = [&] {
+    messages.clear();
+    server.receive(messages);
+    for (const TransportMessage& m : messages)
+      server.send(m.conn, m.payload.data(), static_cast<uint32_t>(m.payload.size()), false);
+  };
+  LoadTestReport report = test.run(tick, [](int) { return std::make_unique<EchoBot>(); });
+
+  ASSERT_EQ(50, report.clients);
+  ASSERT_EQ(60u, report.ticks);
+  ASSERT_GT(report.latency_samples, 0u);
+  ASSERT_EQ(report.bot_messages_received, report.latency_samples);
+  // two 25ms trips, each rounded up to the next 16.7ms tick
+  ASSERT_GE(report.latency_p50_us, 50000u);
+  ASSERT_LE(report.latency_max_us, 70000u);
+  ASSERT_EQ(0u, report.network.messages_lost);
+}
@@ -2,7 +2,7 @@
 #include <cstdio>
 #include <gtest/gtest.h>
 
-#include "engine/core/application.hpp"
+#include "engine/application.hpp"
 #undef main
 
 // Logical	    ASSERT_TRUE(condition)
@@ -28,13 +28,3 @@ main(int argc, char** argv)
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
 }
-
-TEST(TestSuite, HelloTest)
-{
-  ASSERT_EQ(0.0, (0.0));
-}
-
-TEST(TestSuite, HelloTest2)
-{
-  ASSERT_EQ(1.0, (0.0));
-}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/networking/loopback_transport.hpp"
+#include "engine/networking/net_thread.hpp"
+#include "engine/tools/spsc_ring.hpp"
+using namespace fightingengine;
+
+static std::vector<std::string>
+receive_all(Transport& t)
+{
+  std::vector<TransportMessage> messages;
+  t.receive(messages);
+  std::vector<std::string> out;
+  for (const TransportMessage& m : messages)
+    out.emplace_back(m.payload);
+  return out;
+}
+
+TEST(SpscRing, KeepsOrderAcrossThreadsAndRejectsWhenFull)
+{
+  SpscRing<uint64_t> ring(1000);
+  ASSERT_EQ(1024u, ring.capacity());
+
+  const uint64_t count = 200000;
+  std::thread producer([&ring, count] {
+    for (uint64_t i = 0; i < count; i++) {
+      while (!ring.try_push(i))
+        std::this_thread::yield();
+    }
+  });
+  for (uint64_t next = 0; next < count;) {
+    uint64_t* value = ring.front();
+    if (value == nullptr)
+      continue;
+    ASSERT_EQ(next, *value);
+    ring.pop();
+    next += 1;
+  }
+  producer.join();
+  ASSERT_EQ(0u, ring.size());
+
+  SpscRing<std::string> small(2);
+  ASSERT_TRUE(small.try_push("a"));
+  ASSERT_TRUE(small.try_push("b"));
+  ASSERT_FALSE(small.try_push("c"));
+  std::string s;
+  ASSERT_TRUE(small.try_pop(s));
+  ASSERT_EQ("a", s);
+  ASSERT_TRUE(small.try_push("c"));
+}
+
+TEST(NetworkThread, SpreadsConnectionsAndRoutesBothWays)
+{
+  LoopbackNetwork network;
+  NetThreadConfig config;
+  config.sim_threads = 2;
+  NetworkThread net(network.get_server(), config);
+
+  LoopbackEndpoint& a = network.connect();
+  LoopbackEndpoint& b = network.connect();
+  net.pass();
+
+  // one each
+  std::vector<TransportEvent> events0, events1;
+  net.get_sim_transport(0).poll_events(events0);
+  net.get_sim_transport(1).poll_events(events1);
+  ASSERT_EQ(1u, events0.size());
+  ASSERT_EQ(1u, events1.size());
+  ASSERT_EQ(a.get_id(), events0[0].conn);
+  ASSERT_EQ(b.get_id(), events1[0].conn);
+
+  // a message goes to its connection's simulation thread only, and the reply comes back
+  a.send(a.get_id(), "ping", 4, true);
+  network.update(0);
+  net.pass();
+  SimQueueTransport& sim = net.get_sim_transport(0);
+  events0.clear();
+  sim.poll_events(events0);
+  ASSERT_EQ(std::vector<std::string>{ "ping" }, receive_all(sim));
+  ASSERT_TRUE(receive_all(net.get_sim_transport(1)).empty());
+
+  sim.send(a.get_id(), "pong", 4, true);
+  net.pass();
+  network.update(0);
+  ASSERT_EQ(std::vector<std::string>{ "pong" }, receive_all(a));
+  ASSERT_EQ(2u, net.get_stats().connections);
+}
+
+TEST(NetworkThread, BurstsWaitInsteadOfBeingDropped)
+{
+  LoopbackNetwork network;
+  NetThreadConfig config;
+  config.sim_threads = 1;
+  config.inbound_capacity = 8;
+  config.max_connects_per_tick = 4;
+  NetworkThread net(network.get_server(), config);
+  SimQueueTransport& sim = net.get_sim_transport(0);
+
+  // 10 connections, 4 a tick
+  std::vector<ConnectionId> clients;
+  for (int i = 0; i < 10; i++)
+    clients.push_back(network.connect().get_id());
+  net.pass();
+  ASSERT_GT(net.get_stats().inbound_deferred, 0u);
+
+  std::vector<TransportEvent> events;
+  sim.poll_events(events);
+  ASSERT_EQ(4u, events.size());
+  for (int tick = 0; tick < 4; tick++) {
+    net.pass();
+    sim.poll_events(events);
+  }
+  ASSERT_EQ(10u, events.size());
+  ASSERT_GT(sim.get_stats().connects_deferred, 0u);
+  for (int i = 0; i < 10; i++)
+    ASSERT_EQ(clients[i], events[i].conn);
+
+  // more messages than the queue holds: receiving pauses until there's room, and nothing's lost
+  LoopbackEndpoint* client = network.get_client(clients[0]);
+  for (int i = 0; i < 20; i++) {
+    const std::string text = std::to_string(i);
+    client->send(client->get_id(), text.data(), static_cast<uint32_t>(text.size()), true);
+  }
+  network.update(0);
+  std::vector<std::string> got;
+  for (int tick = 0; tick < 10 && got.size() < 20; tick++) {
+    net.pass();
+    sim.poll_events(events);
+    for (std::string& s : receive_all(sim))
+      got.push_back(s);
+  }
+  ASSERT_EQ(20u, got.size());
+  for (int i = 0; i < 20; i++)
+    ASSERT_EQ(std::to_string(i), got[i]);
+  ASSERT_GT(net.get_stats().max_inbound_depth, 0u);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include "engine/opengl/render_backend.hpp"
+#include "engine/opengl/render_command.hpp"
+#include "engine/opengl/uniform_buffer.hpp"
+using namespace fightingengine;
+
+class RenderBackendTest : public ::testing::Test
+{
+protected:
+  RecordingRenderBackend recording;
+
+  void SetUp() override { RenderCommand::set_backend(&recording); }
+  void TearDown() override { RenderCommand::set_backend(nullptr); }
+};
+
+TEST_F(RenderBackendTest, RedundantStateIsNotRecorded)
+{
+  RenderCommand::use_program(3);
+  RenderCommand::use_program(3);
+  RenderCommand::bind_vertex_array(4);
+  RenderCommand::bind_vertex_array(4);
+  RenderCommand::bind_texture(0, 5);
+  RenderCommand::bind_texture(1, 5);
+  RenderCommand::bind_texture(0, 5);
+
+  ASSERT_EQ(4, recording.commands.size());
+  ASSERT_EQ(RenderOp::USE_PROGRAM, recording.commands[0].op);
+  ASSERT_EQ(RenderOp::BIND_VERTEX_ARRAY, recording.commands[1].op);
+  ASSERT_EQ(RenderOp::BIND_TEXTURE, recording.commands[2].op);
+  ASSERT_EQ(RenderOp::BIND_TEXTURE, recording.commands[3].op);
+}
+
+TEST_F(RenderBackendTest, InvalidatingTheCacheReissuesState)
+{
+  RenderCommand::use_program(3);
+  RenderCommand::invalidate_state_cache();
+  RenderCommand::use_program(3);
+
+  ASSERT_EQ(2, recording.commands.size());
+}
+
+TEST_F(RenderBackendTest, UploadsAreHashedByContent)
+{
+  float a[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+  float b[4] = { 1.0f, 2.0f, 3.0f, 5.0f };
+
+  UniformBuffer ubo(sizeof(a), 0);
+  recording.clear_recording();
+
+  ubo.update(a, sizeof(a));
+  ubo.update(a, sizeof(a));
+  ubo.update(b, sizeof(b));
+
+  std::vector<uint64_t> hashes;
+  for (const RecordedCommand& cmd : recording.commands) {
+    if (cmd.op == RenderOp::BUFFER_SUB_DATA)
+      hashes.push_back(cmd.data_hash);
+  }
+  ASSERT_EQ(3, hashes.size());
+  ASSERT_EQ(hashes[0], hashes[1]);
+  ASSERT_NE(hashes[0], hashes[2]);
+  ASSERT_EQ(3 * sizeof(a), recording.bytes_uploaded);
+}
+
+TEST_F(RenderBackendTest, SameCommandsGiveTheSameSnapshot)
+{
+  auto frame = []() {
+    RenderCommand::set_clear_colour(glm::vec4(0.1f, 0.2f, 0.3f, 1.0f));
+    RenderCommand::clear();
+    RenderCommand::use_program(1);
+    RenderCommand::get_backend().draw_indexed(600, 0);
+  };
+
+  frame();
+  std::string first = recording.to_string();
+
+  recording.clear_recording();
+  RenderCommand::invalidate_state_cache();
+  frame();
+
+  ASSERT_EQ(first, recording.to_string());
+  ASSERT_EQ(1, recording.draw_calls);
+  ASSERT_EQ(600, recording.indices_drawn);
+}
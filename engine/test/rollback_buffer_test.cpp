@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/rollback_buffer.hpp"
+using namespace fightingengine;
+
+TEST(RollbackBuffer, KeepsTheLastCapacityFrames)
+{
+  RollbackBuffer buffer(4);
+  for (uint32_t frame = 0; frame < 10; frame++) {
+    std::vector<uint8_t>& bytes = buffer.save(frame);
+    ASSERT_TRUE(bytes.empty());
+    bytes.assign(frame + 1, static_cast<uint8_t>(frame));
+  }
+
+  for (uint32_t frame = 0; frame < 6; frame++)
+    ASSERT_EQ(nullptr, buffer.find(frame));
+  for (uint32_t frame = 6; frame < 10; frame++) {
+    const std::vector<uint8_t>* bytes = buffer.find(frame);
+    ASSERT_NE(nullptr, bytes);
+    ASSERT_EQ(frame + 1, bytes->size());
+    ASSERT_EQ(frame, (*bytes)[0]);
+  }
+  ASSERT_EQ(nullptr, buffer.find(10));
+
+  buffer.clear();
+  ASSERT_EQ(nullptr, buffer.find(9));
+}
+
+TEST(RollbackBuffer, ReusesSlotMemory)
+{
+  RollbackBuffer buffer(2);
+  buffer.save(0).resize(1024);
+  const uint8_t* data = buffer.find(0)->data();
+
+  // frame 2 lands in frame 0's slot
+  std::vector<uint8_t>& bytes = buffer.save(2);
+  ASSERT_EQ(nullptr, buffer.find(0));
+  ASSERT_GE(bytes.capacity(), 1024u);
+  bytes.resize(512);
+  ASSERT_EQ(data, bytes.data());
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "engine/networking/bitstream.hpp"
+#include "engine/networking/snapshot.hpp"
+using namespace fightingengine;
+
+static Snapshot
+make_world(uint32_t tick, int count)
+{
+  SnapshotSchema schema;
+  Snapshot s;
+  s.tick = tick;
+  for (int i = 0; i < count; i++) {
+    NetEntityState e;
+    e.id = 10 + i * 3;
+    e.type = static_cast<uint8_t>(i % 6);
+    e.health = 3;
+    e.pos_x = snapshot::quantise_position(schema, i * 25.0f);
+    e.pos_y = snapshot::quantise_position(schema, -i * 10.0f);
+    e.angle = snapshot::quantise_angle(schema, i * 0.1f);
+    e.vel_x = snapshot::quantise_velocity(schema, 50.0f);
+    s.entities.push_back(e);
+  }
+  return s;
+}
+
+TEST(BitStream, RoundTrip)
+{
+  BitWriter writer;
+  writer.write_bits(5, 3);
+  writer.write_bool(true);
+  writer.write_signed(-3, 4);
+  writer.write_bits(0xDEADBEEF, 32);
+  writer.write_varuint(7);
+  writer.write_varuint(300);
+  writer.write_varuint(1u << 20);
+  writer.write_signed(-100000, 22);
+  writer.flush();
+
+  BitReader reader(writer.get_bytes().data(), writer.get_bytes().size());
+  ASSERT_EQ(5u, reader.read_bits(3));
+  ASSERT_TRUE(reader.read_bool());
+  ASSERT_EQ(-3, reader.read_signed(4));
+  ASSERT_EQ(0xDEADBEEF, reader.read_bits(32));
+  ASSERT_EQ(7u, reader.read_varuint());
+  ASSERT_EQ(300u, reader.read_varuint());
+  ASSERT_EQ(1u << 20, reader.read_varuint());
+  ASSERT_EQ(-100000, reader.read_signed(22));
+  ASSERT_FALSE(reader.is_overflowed());
+
+  // only padding left
+  ASSERT_LT(reader.get_bits_remaining(), 8u);
+  (void)reader.read_bits(8);
+  ASSERT_TRUE(reader.is_overflowed());
+}
+
+TEST(Snapshot, Quantise)
+{
+  SnapshotSchema schema;
+  ASSERT_FLOAT_EQ(100.125f, snapshot::dequantise_position(schema, snapshot::quantise_position(schema, 100.1f)));
+  ASSERT_FLOAT_EQ(-20.0f, snapshot::dequantise_velocity(schema, snapshot::quantise_velocity(schema, -20.0f)));
+
+  // angles wrap
+  ASSERT_EQ(snapshot::quantise_angle(schema, 1.0f), snapshot::quantise_angle(schema, 1.0f + 6.28318530718f));
+  ASSERT_EQ(snapshot::quantise_angle(schema, -1.0f), snapshot::quantise_angle(schema, 6.28318530718f - 1.0f));
+  ASSERT_NEAR(1.0f, snapshot::dequantise_angle(schema, snapshot::quantise_angle(schema, 1.0f)), 0.01f);
+
+  // out of range positions clamp instead of wrapping
+  ASSERT_GT(snapshot::quantise_position(schema, 1e9f), 0);
+  ASSERT_LT(snapshot::quantise_position(schema, -1e9f), 0);
+}
+
+TEST(Snapshot, FullRoundTrip)
+{
+  SnapshotSchema schema;
+  Snapshot world = make_world(1, 100);
+
+  BitWriter writer;
+  snapshot::encode(schema, world, nullptr, writer);
+
+  SnapshotHistory received;
+  Snapshot decoded;
+  BitReader reader(writer.get_bytes().data(), writer.get_bytes().size());
+  ASSERT_TRUE(snapshot::decode(schema, reader, received, decoded));
+  ASSERT_EQ(world.tick, decoded.tick);
+  ASSERT_EQ(world.entities, decoded.entities);
+}
+
+TEST(Snapshot, DeltaAgainstAckedBaseline)
+{
+  SnapshotSchema schema;
+  SnapshotHistory sent;
+  SnapshotHistory received;
+  SnapshotClientState client;
+
+  // tick 1 goes out in full
+  Snapshot world = make_world(1, 200);
+  sent.add(world);
+  BitWriter full;
+  snapshot::encode_for_client(schema, world, sent, client, full);
+  {
+    Snapshot decoded;
+    BitReader reader(full.get_bytes().data(), full.get_bytes().size());
+    ASSERT_TRUE(snapshot::decode(schema, reader, received, decoded));
+    received.add(decoded);
+    snapshot::on_ack(client, decoded.tick);
+  }
+
+  // tick 2: a few move (small and big), one is hurt, one is removed, one is new
+  Snapshot next = world;
+  next.tick = 2;
+  next.entities[0].pos_x += 3;
+  next.entities[1].pos_y -= 100000;
+  next.entities[2].health = 1;
+  next.entities[3].angle = 7;
+  next.entities.erase(next.entities.begin() + 50);
+  NetEntityState spawned;
+  spawned.id = 100000;
+  spawned.type = 1;
+  next.entities.push_back(spawned);
+  sent.add(next);
+
+  BitWriter delta;
+  snapshot::encode_for_client(schema, next, sent, client, delta);
+  ASSERT_LT(delta.get_bytes_written() * 10, full.get_bytes_written());
+
+  Snapshot decoded;
+  BitReader reader(delta.get_bytes().data(), delta.get_bytes().size());
+  ASSERT_TRUE(snapshot::decode(schema, reader, received, decoded));
+  ASSERT_EQ(next.entities, decoded.entities);
+
+  // nothing changed: just the header
+  Snapshot idle = next;
+  idle.tick = 3;
+  BitWriter empty;
+  snapshot::encode(schema, idle, &next, empty);
+  ASSERT_LE(empty.get_bytes_written(), 10u);
+}
+
+TEST(Snapshot, MissingBaselineAndTruncatedData)
+{
+  SnapshotSchema schema;
+  Snapshot base = make_world(5, 10);
+  Snapshot next = make_world(6, 11);
+
+  BitWriter writer;
+  snapshot::encode(schema, next, &base, writer);
+
+  // the receiver never got tick 5
+  SnapshotHistory received;
+  Snapshot decoded;
+  BitReader reader(writer.get_bytes().data(), writer.get_bytes().size());
+  ASSERT_FALSE(snapshot::decode(schema, reader, received, decoded));
+
+  received.add(base);
+  BitReader truncated(writer.get_bytes().data(), writer.get_bytes().size() / 2);
+  ASSERT_FALSE(snapshot::decode(schema, truncated, received, decoded));
+
+  BitReader whole(writer.get_bytes().data(), writer.get_bytes().size());
+  ASSERT_TRUE(snapshot::decode(schema, whole, received, decoded));
+  ASSERT_EQ(next.entities, decoded.entities);
+}
+
+TEST(Snapshot, AcksOnlyMoveForward)
+{
+  SnapshotClientState client;
+  snapshot::on_ack(client, 10);
+  snapshot::on_ack(client, 8);
+  ASSERT_EQ(10u, client.acked_tick);
+  snapshot::on_ack(client, 11);
+  ASSERT_EQ(11u, client.acked_tick);
+
+  // wrap around
+  client.acked_tick = 0xFFFFFFFF;
+  snapshot::on_ack(client, 1);
+  ASSERT_EQ(1u, client.acked_tick);
+}
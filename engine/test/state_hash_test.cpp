@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "engine/state_hash.hpp"
+using namespace fightingengine;
+
+static std::vector<uint32_t>
+make_words(size_t count)
+{
+  std::vector<uint32_t> words(count);
+  for (size_t i = 0; i < count; i++)
+    words[i] = static_cast<uint32_t>(i * 2654435761u + 7);
+  return words;
+}
+
+TEST(StateHasher, AddWordsMatchesAddingOneAtATime)
+{
+  const std::vector<uint32_t> words = make_words(203);
+
+  StateHasher one_at_a_time;
+  for (uint32_t w : words)
+    one_at_a_time.add(w);
+
+  // a few words first, so the blocks add_words() takes start part way through the lanes
+  for (size_t lead = 0; lead < 10; lead++) {
+    StateHasher blocks;
+    for (size_t i = 0; i < lead; i++)
+      blocks.add(words[i]);
+    blocks.add_words(words.data() + lead, words.size() - lead);
+    ASSERT_EQ(one_at_a_time.finish(), blocks.finish());
+    ASSERT_EQ(words.size(), blocks.get_word_count());
+  }
+}
+
+TEST(StateHasher, EveryBitAndPositionCounts)
+{
+  const std::vector<uint32_t> words = make_words(9);
+  StateHasher base;
+  base.add_words(words.data(), words.size());
+
+  std::set<uint64_t> seen = { base.finish() };
+  for (size_t i = 0; i < words.size(); i++) {
+    for (int bit = 0; bit < 32; bit += 7) {
+      std::vector<uint32_t> changed = words;
+      changed[i] ^= 1u << bit;
+      StateHasher h;
+      h.add_words(changed.data(), changed.size());
+      ASSERT_TRUE(seen.insert(h.finish()).second);
+    }
+  }
+
+  // the same values in a different order, one fewer, and with a different seed
+  std::vector<uint32_t> swapped = words;
+  std::swap(swapped[0], swapped[1]);
+  StateHasher order;
+  order.add_words(swapped.data(), swapped.size());
+  ASSERT_NE(base.finish(), order.finish());
+
+  // whole blocks of 16 words swapped. every block of a buffer has to count by where it is too
+  const std::vector<uint32_t> stream = make_words(64);
+  std::vector<uint32_t> blocks_swapped = stream;
+  std::swap_ranges(blocks_swapped.begin(), blocks_swapped.begin() + 16, blocks_swapped.begin() + 16);
+  StateHasher stream_hash;
+  StateHasher blocks_swapped_hash;
+  stream_hash.add_words(stream.data(), stream.size());
+  blocks_swapped_hash.add_words(blocks_swapped.data(), blocks_swapped.size());
+  ASSERT_NE(stream_hash.finish(), blocks_swapped_hash.finish());
+
+  StateHasher shorter;
+  shorter.add_words(words.data(), words.size() - 1);
+  ASSERT_NE(base.finish(), shorter.finish());
+
+  StateHasher seeded(1);
+  seeded.add_words(words.data(), words.size());
+  ASSERT_NE(base.finish(), seeded.finish());
+
+  StateHasher zero;
+  StateHasher negative_zero;
+  zero.add(0.0f);
+  negative_zero.add(-0.0f);
+  ASSERT_NE(zero.finish(), negative_zero.finish());
+
+  base.reset();
+  StateHasher empty;
+  ASSERT_EQ(empty.finish(), base.finish());
+}
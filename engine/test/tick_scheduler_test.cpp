@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "engine/tick_scheduler.hpp"
+#include "engine/tools/zone_profiler.hpp"
+using namespace fightingengine;
+
+TEST(TickScheduler, RunsAtTheTickRate)
+{
+  TickSchedulerConfig config;
+  config.tick_rate_hz = 200.0f;
+  FixedTickScheduler scheduler(config);
+
+  const uint64_t start = zone_profiler::now_ns();
+  for (uint64_t i = 0; i < 21; i++) {
+    ASSERT_EQ(i, scheduler.wait_for_next_tick());
+    scheduler.end_tick();
+  }
+  const double elapsed_ms = (zone_profiler::now_ns() - start) * 1e-6;
+
+  // 20 periods of 5ms after the first tick. generous, so a busy machine doesn't fail it
+  ASSERT_GE(elapsed_ms, 99.0);
+  ASSERT_LT(elapsed_ms, 200.0);
+  ASSERT_EQ(21u, scheduler.get_stats().ticks);
+  ASSERT_EQ(0u, scheduler.get_stats().overruns);
+  ASSERT_FLOAT_EQ(0.005f, scheduler.get_delta_time_s());
+}
+
+TEST(TickScheduler, CountsOverrunsAndSkipsWhenFarBehind)
+{
+  TickSchedulerConfig config;
+  config.tick_rate_hz = 100.0f;
+  config.max_catch_up_ticks = 2;
+  FixedTickScheduler scheduler(config);
+
+  scheduler.wait_for_next_tick();
+  std::this_thread::sleep_for(std::chrono::milliseconds(25));
+  scheduler.end_tick();
+  ASSERT_EQ(1u, scheduler.get_stats().overruns);
+  ASSERT_GE(scheduler.get_stats().last_work_ns, 25000000u);
+
+  // two and a half ticks behind is within max_catch_up_ticks, so nothing is skipped
+  scheduler.wait_for_next_tick();
+  scheduler.end_tick();
+  ASSERT_EQ(0u, scheduler.get_stats().skipped_ticks);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  scheduler.wait_for_next_tick();
+  scheduler.end_tick();
+  ASSERT_GT(scheduler.get_stats().skipped_ticks, 0u);
+  ASSERT_EQ(3u, scheduler.get_tick());
+}
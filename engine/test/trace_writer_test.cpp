@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "engine/tools/trace_writer.hpp"
+using namespace fightingengine;
+
+static std::string
+read_file(const std::string& path)
+{
+  std::ifstream f(path);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+TEST(TraceWriter, WritesZonesMarkersAndCounters)
+{
+  std::string path = (std::filesystem::temp_directory_path() / "fightingengine_trace_test.json").string();
+
+  TraceWriter trace;
+  ASSERT_TRUE(trace.start(path));
+  ASSERT_TRUE(trace.is_capturing());
+
+  ZoneFrame frame;
+  frame.start_ns = zone_profiler::now_ns();
+  ZoneEvent e;
+  e.name = "physics";
+  e.start_ns = frame.start_ns;
+  e.end_ns = frame.start_ns + 2000;
+  frame.events.push_back(e);
+
+  trace.add_counter("entities", 42);
+  trace.submit_frame(frame);
+  trace.stop();
+
+  ASSERT_FALSE(trace.is_capturing());
+  ASSERT_EQ(3, trace.get_records_written());
+
+  std::string json = read_file(path);
+  ASSERT_EQ(0, json.find("{\"traceEvents\":["));
+  ASSERT_NE(std::string::npos, json.find("\"name\":\"physics\",\"ph\":\"X\""));
+  ASSERT_NE(std::string::npos, json.find("\"dur\":2.000"));
+  ASSERT_NE(std::string::npos, json.find("\"name\":\"frame\",\"ph\":\"i\""));
+  ASSERT_NE(std::string::npos, json.find("\"name\":\"entities\",\"ph\":\"C\""));
+  ASSERT_NE(std::string::npos, json.find("]}"));
+
+  std::filesystem::remove(path);
+}
+
+TEST(TraceWriter, DropsFramesWhenOverBudget)
+{
+  std::string path = (std::filesystem::temp_directory_path() / "fightingengine_trace_drop_test.json").string();
+
+  TraceWriter trace(2);
+  ASSERT_TRUE(trace.start(path));
+
+  ZoneFrame frame;
+  frame.events.resize(4); // 5 records with the frame marker
+  for (ZoneEvent& e : frame.events)
+    e.name = "zone";
+  trace.submit_frame(frame);
+  trace.stop();
+
+  ASSERT_EQ(5, trace.get_dropped_count());
+  ASSERT_EQ(0, trace.get_records_written());
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "engine/tools/zone_profiler.hpp"
+using namespace fightingengine;
+
+static const ZoneEvent*
+find_zone(const std::vector<ZoneEvent>& events, const char* name)
+{
+  for (const ZoneEvent& e : events) {
+    if (std::string(e.name) == name)
+      return &e;
+  }
+  return nullptr;
+}
+
+TEST(ZoneProfiler, NestedZonesRecordDepth)
+{
+  std::vector<ZoneEvent> events;
+  zone_profiler::collect(events); // drain anything from earlier tests
+  events.clear();
+
+  {
+    PROFILE_ZONE("outer");
+    {
+      PROFILE_ZONE("inner");
+    }
+  }
+  zone_profiler::collect(events);
+
+  const ZoneEvent* outer = find_zone(events, "outer");
+  const ZoneEvent* inner = find_zone(events, "inner");
+  ASSERT_NE(nullptr, outer);
+  ASSERT_NE(nullptr, inner);
+  ASSERT_EQ(0, outer->depth);
+  ASSERT_EQ(1, inner->depth);
+  ASSERT_LE(outer->start_ns, inner->start_ns);
+  ASSERT_GE(outer->end_ns, inner->end_ns);
+}
+
+TEST(ZoneProfiler, CollectsZonesFromOtherThreads)
+{
+  std::vector<ZoneEvent> events;
+  zone_profiler::collect(events);
+  events.clear();
+
+  {
+    PROFILE_ZONE("main");
+  }
+
+  std::thread worker([]() {
+    zone_profiler::set_thread_name("worker");
+    PROFILE_ZONE("work");
+  });
+  worker.join();
+
+  zone_profiler::collect(events);
+  const ZoneEvent* main_zone = find_zone(events, "main");
+  const ZoneEvent* work_zone = find_zone(events, "work");
+  ASSERT_NE(nullptr, main_zone);
+  ASSERT_NE(nullptr, work_zone);
+  ASSERT_NE(main_zone->thread_id, work_zone->thread_id);
+
+  bool named = false;
+  for (const auto& name : zone_profiler::get_thread_names())
+    named |= name.first == work_zone->thread_id && name.second == "worker";
+  ASSERT_TRUE(named);
+}
+
+TEST(ZoneProfiler, ExitedThreadsBufferIsReused)
+{
+  std::vector<ZoneEvent> events;
+  zone_profiler::collect(events);
+  events.clear();
+
+  std::thread first([]() { PROFILE_ZONE("first"); });
+  first.join();
+  zone_profiler::collect(events);
+  const ZoneEvent* first_zone = find_zone(events, "first");
+  ASSERT_NE(nullptr, first_zone);
+  uint32_t first_id = first_zone->thread_id;
+  size_t threads = zone_profiler::get_thread_names().size();
+
+  // the next new thread takes over the drained buffer
+  std::thread second([]() { PROFILE_ZONE("second"); });
+  second.join();
+  events.clear();
+  zone_profiler::collect(events);
+  const ZoneEvent* second_zone = find_zone(events, "second");
+  ASSERT_NE(nullptr, second_zone);
+  ASSERT_EQ(first_id, second_zone->thread_id);
+  ASSERT_EQ(threads, zone_profiler::get_thread_names().size());
+}
+
+TEST(ZoneProfiler, FullBufferDropsZones)
+{
+  std::vector<ZoneEvent> events;
+  zone_profiler::collect(events);
+  events.clear();
+  uint64_t dropped_before = zone_profiler::get_dropped_count();
+
+  for (int i = 0; i < 5000; i++) {
+    PROFILE_ZONE("spam");
+  }
+
+  zone_profiler::collect(events);
+  ASSERT_EQ(4096, events.size());
+  ASSERT_EQ(dropped_before + 5000 - 4096, zone_profiler::get_dropped_count());
+}
@@ -0,0 +1,562 @@
+// your header
+#include "2d_bench.hpp"
+
+// c++ lib headers
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+
+// engine headers
+#include "engine/opengl/render_backend.hpp"
+#include "engine/opengl/render_command.hpp"
+#include "engine/opengl/shader.hpp"
+#include "engine/tools/alloc_tracker.hpp"
+#include "engine/tools/profiler.hpp"
+using namespace fightingengine;
+
+// game headers
+#include "2d_replay.hpp"
+#include "2d_rollback.hpp"
+#include "2d_state_hash.hpp"
+#include "opengl/decal_renderer.hpp"
+#include "opengl/sprite_renderer.hpp"
+
+namespace game2d {
+
+namespace bench {
+
+bool
+parse_args(int argc, char* argv[], BenchConfig& config)
+{
+  bool bench = false;
+  for (int i = 1; i < argc; i++) {
+    bool has_value = i + 1 < argc;
+    if (strcmp(argv[i], "--bench") == 0)
+      bench = true;
+    else if (strcmp(argv[i], "--replay") == 0 && has_value) {
+      bench = true;
+      config.replay_path = argv[++i];
+    }
+    else if (strcmp(argv[i], "--no-render") == 0)
+      config.render = false;
+    else if (strcmp(argv[i], "--seed") == 0 && has_value)
+      config.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    else if (strcmp(argv[i], "--frames") == 0 && has_value)
+      config.frames = std::atoi(argv[++i]);
+    else if (strcmp(argv[i], "--enemies") == 0 && has_value)
+      config.scenario.enemies = std::atoi(argv[++i]);
+    else if (strcmp(argv[i], "--swarms") == 0 && has_value) {
+      config.scenario.enemy_layout = ScenarioLayout::SWARMS;
+      config.scenario.swarms = std::atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--bullets") == 0 && has_value)
+      config.scenario.bullets = std::atoi(argv[++i]);
+    else if (strcmp(argv[i], "--trees") == 0 && has_value)
+      config.scenario.trees = std::atoi(argv[++i]);
+    else if (strcmp(argv[i], "--splats") == 0 && has_value)
+      config.scenario.splats = std::atoi(argv[++i]);
+    else if (strcmp(argv[i], "--radius") == 0 && has_value) {
+      config.scenario.radius = static_cast<float>(std::atof(argv[++i]));
+      if (!(config.scenario.radius >= scenario::get_min_radius())) {
+        std::cerr << "(bench) --radius " << argv[i] << " is inside the player's safe radius, using "
+                  << scenario::get_min_radius() << std::endl;
+        config.scenario.radius = scenario::get_min_radius();
+      }
+    } else if (strcmp(argv[i], "--input") == 0 && has_value)
+      config.input_path = argv[++i];
+    else if (strcmp(argv[i], "--out") == 0 && has_value)
+      config.output_path = argv[++i];
+    else if (strcmp(argv[i], "--state-frame") == 0 && has_value)
+      config.state_frame = std::atoi(argv[++i]);
+    else if (strcmp(argv[i], "--save-state") == 0 && has_value)
+      config.save_state_path = argv[++i];
+    else if (strcmp(argv[i], "--check-state") == 0 && has_value)
+      config.check_state_path = argv[++i];
+  }
+  return bench;
+}
+
+bool
+load_input_track(const std::string& path, std::vector<InputTrackKey>& track)
+{
+  std::ifstream file(path);
+  if (!file.is_open())
+    return false;
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    InputTrackKey key;
+    int shoot = 0;
+    int boost = 0;
+    int weapon = 1;
+    std::istringstream ss(line);
+    if (!(ss >> key.frame >> key.move_x >> key.move_y >> key.aim_radians >> shoot >> boost >> weapon)) {
+      std::cerr << "(bench) bad input track line: " << line << std::endl;
+      return false;
+    }
+    key.shoot = shoot != 0;
+    key.boost = boost != 0;
+    key.weapon = weapon == 0 ? Weapons::SHOVEL : Weapons::PISTOL;
+    track.push_back(key);
+  }
+
+  std::stable_sort(track.begin(), track.end(), [](const auto& a, const auto& b) { return a.frame < b.frame; });
+  return true;
+}
+
+void
+make_default_input_track(int frames, std::vector<InputTrackKey>& track)
+{
+  const int frames_per_key = 30;
+  for (int frame = 0; frame < frames; frame += frames_per_key) {
+    float t = frame / 60.0f;
+    InputTrackKey key;
+    key.frame = frame;
+    key.move_x = cos(t);
+    key.move_y = sin(t);
+    key.aim_radians = t * 2.0f;
+    key.shoot = true;
+    key.weapon = Weapons::PISTOL;
+    track.push_back(key);
+  }
+}
+
+static const InputTrackKey*
+find_key(const std::vector<InputTrackKey>& track, int frame)
+{
+  auto it = std::upper_bound(
+    track.begin(), track.end(), frame, [](int f, const InputTrackKey& key) { return f < key.frame; });
+  if (it == track.begin())
+    return nullptr;
+  return &*(it - 1);
+}
+
+void
+apply_input_track(const std::vector<InputTrackKey>& track, int frame, GameObject2D& player, KeysAndState& keys)
+{
+  keys = KeysAndState();
+
+  const InputTrackKey* key = find_key(track, frame);
+  if (key == nullptr)
+    return;
+  const InputTrackKey* last_key = find_key(track, frame - 1);
+
+  keys.l_analogue_x = key->move_x;
+  keys.l_analogue_y = key->move_y;
+  keys.angle_around_player = key->aim_radians;
+  keys.r_analogue_x = glm::sin(key->aim_radians);
+  keys.r_analogue_y = -glm::cos(key->aim_radians);
+  keys.shoot_pressed = key->shoot;
+  keys.shoot_down = key->shoot && (last_key == nullptr || !last_key->shoot);
+  keys.boost_pressed = key->boost;
+  player.equipped_weapon = key->weapon;
+}
+
+struct EntityCountStats
+{
+  size_t final_count = 0;
+  size_t max_count = 0;
+  double mean_count = 0.0;
+
+  void add(size_t count)
+  {
+    final_count = count;
+    max_count = count > max_count ? count : max_count;
+    mean_count += static_cast<double>(count);
+  }
+};
+
+static void
+write_entity_stats(std::ostream& out, const char* name, const EntityCountStats& stats, int frames, bool last)
+{
+  out << "    \"" << name << "\": { \"final\": " << stats.final_count << ", \"max\": " << stats.max_count
+      << ", \"mean\": " << stats.mean_count / frames << " }" << (last ? "\n" : ",\n");
+}
+
+static void
+write_stages(std::ostream& out, const Profiler& profiler, const std::vector<Profiler::Stage>& stages)
+{
+  out << "  \"stages\": {\n";
+  for (size_t i = 0; i < stages.size(); i++) {
+    Profiler::StagePercentiles p = profiler.get_percentiles(stages[i]);
+    out << "    \"" << profiler.stageNames[static_cast<uint8_t>(stages[i])] << "\": { \"p50_ms\": " << p.p50_ms
+        << ", \"p95_ms\": " << p.p95_ms << ", \"p99_ms\": " << p.p99_ms << ", \"max_ms\": " << p.max_ms << " }"
+        << (i + 1 < stages.size() ? ",\n" : "\n");
+  }
+  out << "  },\n";
+}
+
+// both as a rollback frame leaves them, so anything rollback::save() doesn't keep is gone from both sides
+static bool
+find_state_mismatch(const std::vector<uint8_t>& saved_bytes,
+                    const std::vector<uint8_t>& current_bytes,
+                    bool& valid,
+                    StateMismatch& mismatch)
+{
+  GameState saved;
+  GameState current;
+  // loading sets the id counters, and the replay is still using them. the current state goes last,
+  // so they end up as they were when it was saved
+  const bool saved_valid = rollback::load(saved_bytes, saved);
+  valid = rollback::load(current_bytes, current) && saved_valid;
+  return valid && state_hash::find_mismatch(saved, current, mismatch);
+}
+
+// --save-state and --check-state
+static void
+save_or_check_state(const BenchConfig& config, const GameState& state, int64_t frame)
+{
+  std::vector<uint8_t> bytes;
+  rollback::save(state, bytes);
+
+  if (!config.save_state_path.empty()) {
+    std::ofstream file(config.save_state_path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+      std::cerr << "(bench) failed to write " << config.save_state_path << std::endl;
+    else
+      std::cerr << "(bench) saved frame " << frame << "'s state to " << config.save_state_path << std::endl;
+  }
+
+  if (config.check_state_path.empty())
+    return;
+  std::ifstream file(config.check_state_path, std::ios::binary);
+  const std::vector<uint8_t> saved_bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  bool valid = false;
+  StateMismatch mismatch;
+  const bool differs = find_state_mismatch(saved_bytes, bytes, valid, mismatch);
+
+  if (!valid)
+    std::cerr << "(bench) " << config.check_state_path << " isn't a saved state" << std::endl;
+  else if (differs)
+    std::cerr << "(bench) frame " << frame << " differs from " << config.check_state_path
+              << " (saved vs this run): " << state_hash::to_string(mismatch) << std::endl;
+  else
+    std::cerr << "(bench) frame " << frame << " matches " << config.check_state_path << std::endl;
+}
+
+static int
+run_replay(const BenchConfig& config)
+{
+  Replay replay;
+  if (!replay::load(config.replay_path, replay)) {
+    std::cerr << "(bench) failed to load replay " << config.replay_path << std::endl;
+    return 1;
+  }
+
+  GameState state;
+  state.headless = true; // nothing is presented, so decals aren't stamped
+  replay::begin(replay, state);
+
+  const int frames = replay.header.frames > 0 ? static_cast<int>(replay.header.frames) : 1;
+  Profiler profiler;
+  profiler.set_percentile_window(frames);
+
+  EntityCountStats enemies;
+  EntityCountStats bullets;
+  EntityCountStats vfx;
+  ReplayReader reader(replay);
+  ReplayFrame frame;
+  double sim_time_s = 0.0;
+
+  // every frame's state against the recording's, timed on its own so it's clear what it costs
+  uint32_t mismatched_frames = 0;
+  int64_t first_mismatch_frame = -1;
+  std::chrono::nanoseconds hash_time{ 0 };
+
+  const auto start = std::chrono::steady_clock::now();
+
+  while (true) {
+    profiler.new_frame();
+    if (!reader.next(frame))
+      break;
+    profiler.begin(Profiler::Stage::UpdateLoop);
+
+    profiler.begin(Profiler::Stage::Physics);
+    if (frame.physics)
+      game::update_physics(state);
+    profiler.end(Profiler::Stage::Physics);
+
+    profiler.begin(Profiler::Stage::GameTick);
+    replay::apply_before_update(state, frame);
+    game::update(state, frame.delta_time_s);
+    replay::apply_after_update(state, frame, replay.header.cvars);
+    profiler.end(Profiler::Stage::GameTick);
+
+    sim_time_s += frame.delta_time_s;
+    enemies.add(state.entities_enemies.size());
+    bullets.add(state.entities_bullets.size());
+    vfx.add(state.entities_vfx.size());
+
+    profiler.end(Profiler::Stage::UpdateLoop);
+
+    const auto hash_start = std::chrono::steady_clock::now();
+    const bool matches = replay::check(state, frame);
+    hash_time += std::chrono::steady_clock::now() - hash_start;
+    if (!matches) {
+      if (first_mismatch_frame < 0) {
+        first_mismatch_frame = reader.get_frame() - 1;
+        std::cerr << "(bench) frame " << first_mismatch_frame << " doesn't match the recording. --state-frame "
+                  << first_mismatch_frame << " with --save-state and --check-state shows what differs" << std::endl;
+      }
+      mismatched_frames += 1;
+    }
+
+    if (reader.get_frame() - 1 == static_cast<int64_t>(config.state_frame))
+      save_or_check_state(config, state, config.state_frame);
+  }
+  if (config.state_frame < 0 && reader.get_frame() > 0)
+    save_or_check_state(config, state, reader.get_frame() - 1);
+
+  std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start;
+  if (reader.is_corrupt()) {
+    std::cerr << "(bench) replay " << config.replay_path << " is cut short at frame " << reader.get_frame()
+              << std::endl;
+    return 1;
+  }
+
+  std::ofstream file;
+  if (!config.output_path.empty()) {
+    file.open(config.output_path);
+    if (!file.is_open()) {
+      std::cerr << "(bench) failed to open " << config.output_path << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = config.output_path.empty() ? std::cout : file;
+  const double wall_time_s = wall_time.count() > 0.0 ? wall_time.count() : 1e-9;
+
+  out << std::fixed << std::setprecision(4);
+  out << "{\n";
+  out << "  \"replay\": \"" << config.replay_path << "\",\n";
+  out << "  \"seed\": " << replay.header.seed << ",\n";
+  out << "  \"frames\": " << reader.get_frame() << ",\n";
+  out << "  \"bytes\": " << replay.frame_bytes.size() << ",\n";
+  out << "  \"bytes_per_frame\": " << static_cast<double>(replay.frame_bytes.size()) / frames << ",\n";
+  out << "  \"sim_time_s\": " << sim_time_s << ",\n";
+  out << "  \"wall_time_s\": " << wall_time.count() << ",\n";
+  out << "  \"frames_per_s\": " << reader.get_frame() / wall_time_s << ",\n";
+  out << "  \"state_hash\": { \"mismatched_frames\": " << mismatched_frames
+      << ", \"first_mismatch_frame\": " << first_mismatch_frame
+      << ", \"mean_us\": " << std::chrono::duration<double, std::micro>(hash_time).count() / frames << " },\n";
+  write_stages(out, profiler, { Profiler::Stage::Physics, Profiler::Stage::GameTick, Profiler::Stage::UpdateLoop });
+
+  out << "  \"entities\": {\n";
+  write_entity_stats(out, "enemies", enemies, frames, false);
+  write_entity_stats(out, "bullets", bullets, frames, false);
+  write_entity_stats(out, "vfx", vfx, frames, true);
+  out << "  },\n";
+
+  // where it ended up, to compare two playbacks at a glance
+  out << "  \"final\": { \"running\": " << static_cast<int>(state.running)
+      << ", \"game_objects_destroyed\": " << state.game_objects_destroyed
+      << ", \"enemies\": " << state.entities_enemies.size() << ", \"bullets\": " << state.entities_bullets.size()
+      << " }\n";
+  out << "}\n";
+  return 0;
+}
+
+int
+run(const BenchConfig& config)
+{
+  if (!config.replay_path.empty())
+    return run_replay(config);
+
+  std::vector<InputTrackKey> track;
+  if (config.input_path.empty())
+    make_default_input_track(config.frames, track);
+  else if (!load_input_track(config.input_path, track)) {
+    std::cerr << "(bench) failed to load input track " << config.input_path << std::endl;
+    return 1;
+  }
+
+  const glm::ivec2 screen_wh = { 1280, 720 };
+  GameState state;
+  game::init(state, screen_wh, config.seed);
+  state.entities_player[0].invulnerable = true; // keep the load steady, rather than ending at game over
+  state.player_keys[0].use_keyboard = false;
+
+  ScenarioConfig scenario_config = config.scenario;
+  scenario_config.seed = config.seed;
+  ScenarioStats spawned = scenario::populate(state, scenario_config);
+
+  // the render stage runs the real batching code, but nothing reaches a driver
+  NullRenderBackend null_backend;
+  std::unique_ptr<Shader> instanced_quad_shader;
+  std::unique_ptr<Shader> decal_stamp_shader;
+  std::unique_ptr<Shader> decal_composite_shader;
+  std::unique_ptr<Shader> colour_shader;
+  sprite_renderer::StaticSpriteCache static_trees;
+  if (config.render) {
+    RenderCommand::set_backend(&null_backend);
+    RenderCommand::init();
+    sprite_renderer::init();
+    decal_renderer::init(state.decals, tex_unit_decals);
+    colour_shader = std::make_unique<Shader>("2d_game/shaders/2d_basic.vert", "2d_game/shaders/2d_colour.frag");
+    instanced_quad_shader =
+      std::make_unique<Shader>("2d_game/shaders/2d_instanced.vert", "2d_game/shaders/2d_instanced.frag");
+    decal_stamp_shader =
+      std::make_unique<Shader>("2d_game/shaders/2d_instanced.vert", "2d_game/shaders/2d_instanced.frag");
+    decal_composite_shader = std::make_unique<Shader>("2d_game/shaders/2d_decal.vert", "2d_game/shaders/2d_decal.frag");
+    for (const auto& tree : state.entities_trees)
+      sprite_renderer::static_add(static_trees, tree);
+  }
+
+  Profiler profiler;
+  profiler.set_percentile_window(config.frames > 0 ? config.frames : 1);
+
+  EntityCountStats enemies;
+  EntityCountStats bullets;
+  EntityCountStats vfx;
+  AllocCounters allocs_total;
+  uint64_t allocs_max = 0;
+  std::vector<DecalBatch> discarded_decals;
+
+  // the profiler has a frame's allocations once the next one starts
+  auto add_last_frame_allocs = [&]() {
+    const AllocCounters& frame_allocs = profiler.get_last_frame_allocations();
+    allocs_total.allocs += frame_allocs.allocs;
+    allocs_total.bytes_allocated += frame_allocs.bytes_allocated;
+    allocs_max = frame_allocs.allocs > allocs_max ? frame_allocs.allocs : allocs_max;
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+
+  for (int frame = 0; frame < config.frames; frame++) {
+    profiler.new_frame();
+    if (frame > 0)
+      add_last_frame_allocs();
+    profiler.begin(Profiler::Stage::UpdateLoop);
+
+    profiler.begin(Profiler::Stage::Physics);
+    game::update_physics(state);
+    profiler.end(Profiler::Stage::Physics);
+
+    profiler.begin(Profiler::Stage::GameTick);
+    apply_input_track(track, frame, state.entities_player[0], state.player_keys[0]);
+    game::update(state, config.delta_time_s);
+    profiler.end(Profiler::Stage::GameTick);
+
+    profiler.begin(Profiler::Stage::Render);
+    if (config.render) {
+      sprite_renderer::reset_stats();
+      decal_renderer::stamp_pending(state.decals, *decal_stamp_shader, screen_wh);
+      sprite_renderer::begin_batch();
+      decal_renderer::draw(state.decals, state.camera, screen_wh, *decal_composite_shader);
+
+      instanced_quad_shader->bind();
+      auto draw = [&](const std::vector<GameObject2D>& objs) {
+        for (const auto& obj : objs) {
+          if (obj.do_render)
+            sprite_renderer::draw_sprite_debug(state.camera,
+                                               screen_wh,
+                                               *instanced_quad_shader,
+                                               obj,
+                                               obj.render_size,
+                                               *colour_shader,
+                                               PALETTE_COLOUR_2_1);
+        }
+      };
+      draw(state.entities_vfx);
+      draw(state.entities_enemies);
+      draw(state.entities_bullets);
+      draw(state.entities_player);
+
+      sprite_renderer::end_batch();
+      sprite_renderer::flush(*instanced_quad_shader);
+      sprite_renderer::begin_batch();
+      sprite_renderer::static_draw(static_trees, state.camera, screen_wh, *instanced_quad_shader);
+      sprite_renderer::end_batch();
+      sprite_renderer::flush(*instanced_quad_shader);
+    } else {
+      discarded_decals.clear();
+      state.decals.take_pending(discarded_decals);
+    }
+    profiler.end(Profiler::Stage::Render);
+
+    enemies.add(state.entities_enemies.size());
+    bullets.add(state.entities_bullets.size());
+    vfx.add(state.entities_vfx.size());
+
+    profiler.end(Profiler::Stage::UpdateLoop);
+  }
+  profiler.new_frame(); // records the last frame's stages
+  if (config.frames > 0)
+    add_last_frame_allocs();
+
+  std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start;
+
+  if (config.render) {
+    sprite_renderer::static_shutdown(static_trees);
+    decal_renderer::shutdown();
+    sprite_renderer::shutdown();
+    RenderCommand::set_backend(nullptr);
+  }
+
+  //
+  // summary
+  //
+
+  std::ofstream file;
+  if (!config.output_path.empty()) {
+    file.open(config.output_path);
+    if (!file.is_open()) {
+      std::cerr << "(bench) failed to open " << config.output_path << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = config.output_path.empty() ? std::cout : file;
+  const int frames = config.frames > 0 ? config.frames : 1;
+
+  out << std::fixed << std::setprecision(4);
+  out << "{\n";
+  out << "  \"seed\": " << config.seed << ",\n";
+  out << "  \"frames\": " << config.frames << ",\n";
+  out << "  \"delta_time_s\": " << config.delta_time_s << ",\n";
+  out << "  \"scenario\": { \"layout\": \""
+      << (scenario_config.enemy_layout == ScenarioLayout::SWARMS ? "swarms" : "spread")
+      << "\", \"radius\": " << scenario_config.radius << ", \"enemies\": " << spawned.enemies
+      << ", \"bullets\": " << spawned.bullets << ", \"trees\": " << spawned.trees
+      << ", \"splats\": " << spawned.splats << " },\n";
+  out << "  \"input\": \"" << (config.input_path.empty() ? "default" : config.input_path) << "\",\n";
+  out << "  \"render\": " << (config.render ? "true" : "false") << ",\n";
+  out << "  \"wall_time_s\": " << wall_time.count() << ",\n";
+
+  write_stages(out,
+               profiler,
+               { Profiler::Stage::Physics,
+                 Profiler::Stage::GameTick,
+                 Profiler::Stage::Render,
+                 Profiler::Stage::UpdateLoop });
+
+  out << "  \"allocations\": {\n";
+  out << "    \"tracked\": " << (alloc_tracker::is_enabled() ? "true" : "false") << ",\n";
+  out << "    \"per_frame_mean\": " << static_cast<double>(allocs_total.allocs) / frames << ",\n";
+  out << "    \"per_frame_max\": " << allocs_max << ",\n";
+  out << "    \"bytes_per_frame_mean\": " << static_cast<double>(allocs_total.bytes_allocated) / frames << "\n";
+  out << "  },\n";
+
+  out << "  \"entities\": {\n";
+  write_entity_stats(out, "enemies", enemies, frames, false);
+  write_entity_stats(out, "bullets", bullets, frames, false);
+  write_entity_stats(out, "vfx", vfx, frames, true);
+  out << "  }\n";
+  out << "}\n";
+
+  return 0;
+}
+
+} // namespace bench
+
+} // namespace game2d
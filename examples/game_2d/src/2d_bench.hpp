@@ -0,0 +1,78 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// game headers
+#include "2d_game.hpp"
+#include "2d_scenario.hpp"
+
+namespace game2d {
+
+namespace bench {
+
+// game_2d --bench [--seed N] [--frames N] [--input track.txt] [--out summary.json] [--no-render]
+//                 [--enemies N] [--swarms N] [--bullets N] [--trees N] [--splats N] [--radius R]
+// Steps the game with a fixed delta time, a seeded rng and scripted input,
+// without a window or GL, then writes a json summary.
+// game_2d --replay session.replay [--out summary.json] [--state-frame N] [--save-state a.state] [--check-state a.state]
+// Plays back a game_2d --record session instead: every frame as it was recorded, headless and
+// as fast as it goes. frames_per_s is the playback speed. Each frame's state hash is checked
+// against the recording's, the first frame that doesn't match is reported.
+// A hash only says that a frame differs. To find what, --save-state the state after frame N
+// (the last frame if not given) from a build that plays it back right, then --check-state it
+// from one that doesn't: the first field that differs is reported.
+struct BenchConfig
+{
+  uint32_t seed = 1;
+  int frames = 3600;
+  ScenarioConfig scenario; // spawned up front, on top of the wave spawner. seeded from seed
+  float delta_time_s = 1.0f / 60.0f;
+  std::string input_path;  // empty for the built in track
+  std::string replay_path; // a recorded session, in place of everything above
+  std::string output_path; // empty for stdout
+  bool render = true;      // batch sprites against a NullRenderBackend
+
+  int state_frame = -1; // the replay frame --save-state and --check-state take, -1 for the last
+  std::string save_state_path;
+  std::string check_state_path;
+};
+
+// One line of an input track, held until the next line's frame.
+// file format, one per line: frame move_x move_y aim_radians shoot boost weapon
+// (weapon: 0 shovel, 1 pistol). lines starting with # are skipped.
+struct InputTrackKey
+{
+  int frame = 0;
+  float move_x = 0.0f;
+  float move_y = 0.0f;
+  float aim_radians = 0.0f;
+  bool shoot = false;
+  bool boost = false;
+  Weapons weapon = Weapons::PISTOL;
+};
+
+// returns false if neither --bench nor --replay was passed
+bool
+parse_args(int argc, char* argv[], BenchConfig& config);
+
+bool
+load_input_track(const std::string& path, std::vector<InputTrackKey>& track);
+
+// circles the player while shooting
+void
+make_default_input_track(int frames, std::vector<InputTrackKey>& track);
+
+// fills the player's keys for this frame
+void
+apply_input_track(const std::vector<InputTrackKey>& track, int frame, GameObject2D& player, KeysAndState& keys);
+
+// returns the process exit code
+int
+run(const BenchConfig& config);
+
+} // namespace bench
+
+} // namespace game2d
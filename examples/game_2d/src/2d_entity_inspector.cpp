@@ -0,0 +1,279 @@
+// your header
+#include "2d_entity_inspector.hpp"
+
+// c++ lib headers
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+// other lib headers
+#include <imgui.h>
+
+// engine headers
+#include "engine/tools/zone_profiler.hpp"
+
+// other project headers
+#include "thirdparty/magic_enum.hpp"
+
+namespace game2d {
+
+namespace entity_inspector {
+
+std::vector<GameObject2D>&
+get_list(GameState& state, EntityList list)
+{
+  switch (list) {
+    case EntityList::PLAYERS:
+      return state.entities_player;
+    case EntityList::ENEMIES:
+      return state.entities_enemies;
+    case EntityList::BULLETS:
+      return state.entities_bullets;
+    case EntityList::VFX:
+      return state.entities_vfx;
+    case EntityList::TREES:
+      return state.entities_trees;
+    default:
+      return state.entities_shops;
+  }
+}
+
+const char*
+get_list_name(EntityList list)
+{
+  static const char* names[] = { "Players", "Enemies", "Bullets", "Vfx", "Trees", "Shops" };
+  return names[static_cast<int>(list)];
+}
+
+bool
+is_filtering(const EntityInspector& inspector)
+{
+  if (inspector.collision_layer >= 0 || inspector.name_filter[0] != '\0')
+    return true;
+  for (bool show : inspector.show_list) {
+    if (!show)
+      return true;
+  }
+  return false;
+}
+
+static bool
+passes_filter(const EntityInspector& inspector, EntityList list, const GameObject2D& obj)
+{
+  if (!inspector.show_list[static_cast<int>(list)])
+    return false;
+  if (inspector.collision_layer >= 0 && static_cast<int>(obj.collision_layer) != inspector.collision_layer)
+    return false;
+  if (inspector.name_filter[0] != '\0' && strstr(obj.name.c_str(), inspector.name_filter) == nullptr)
+    return false;
+  return true;
+}
+
+void
+scan(EntityInspector& inspector, GameState& state)
+{
+  PROFILE_ZONE("entity_inspector::scan");
+  const bool filtering = is_filtering(inspector);
+  int budget = inspector.scan_budget > 0 ? inspector.scan_budget : 1;
+
+  while (budget > 0) {
+    if (inspector.scan_list == EntityList::COUNT) {
+      // finished a pass: publish it, and start the next
+      inspector.rows.swap(inspector.scan_rows);
+      inspector.layer_counts = inspector.scan_layer_counts;
+      inspector.grid_cells_total = inspector.scan_grid_cells_total;
+      inspector.scans_completed += 1;
+
+      inspector.scan_rows.clear();
+      inspector.scan_layer_counts.fill(0);
+      inspector.scan_grid_cells_total = 0;
+      inspector.scan_list = EntityList::PLAYERS;
+      inspector.scan_index = 0;
+      break; // at most one pass per frame, even for tiny worlds
+    }
+
+    std::vector<GameObject2D>& objs = get_list(state, inspector.scan_list);
+    for (; inspector.scan_index < objs.size() && budget > 0; inspector.scan_index++, budget--) {
+      const GameObject2D& obj = objs[inspector.scan_index];
+      inspector.scan_layer_counts[static_cast<int>(obj.collision_layer)] += 1;
+      inspector.scan_grid_cells_total += static_cast<int>(obj.in_physics_grid_cell.size());
+      if (filtering && passes_filter(inspector, inspector.scan_list, obj))
+        inspector.scan_rows.push_back(
+          { inspector.scan_list, static_cast<uint32_t>(inspector.scan_index), obj.id });
+    }
+    if (inspector.scan_index >= objs.size()) {
+      inspector.scan_list = static_cast<EntityList>(static_cast<int>(inspector.scan_list) + 1);
+      inspector.scan_index = 0;
+    }
+  }
+}
+
+static void
+restart_scan(EntityInspector& inspector)
+{
+  inspector.rows.clear();
+  inspector.scan_rows.clear();
+  inspector.scan_layer_counts.fill(0);
+  inspector.scan_grid_cells_total = 0;
+  inspector.scan_list = EntityList::PLAYERS;
+  inspector.scan_index = 0;
+}
+
+// without a filter, rows are every list back to back, so no scan results are needed
+static bool
+get_unfiltered_row(GameState& state, int row, EntityInspector::Row& out)
+{
+  for (int l = 0; l < static_cast<int>(EntityList::COUNT); l++) {
+    const int size = static_cast<int>(get_list(state, static_cast<EntityList>(l)).size());
+    if (row < size) {
+      out.list = static_cast<EntityList>(l);
+      out.index = row;
+      out.id = get_list(state, out.list)[row].id;
+      return true;
+    }
+    row -= size;
+  }
+  return false;
+}
+
+// rows from a scan can go stale as entities are erased, so look them up by id
+static GameObject2D*
+find_entity(GameState& state, EntityList list, uint32_t index, uint32_t id)
+{
+  std::vector<GameObject2D>& objs = get_list(state, list);
+  if (index < objs.size() && objs[index].id == id)
+    return &objs[index];
+  // entities are only erased, never reordered, so it can only have moved down.
+  // the search is capped so stale rows can't make a frame scale with the world; the next scan fixes them
+  const int max_search = 256;
+  int start = static_cast<int>(index < objs.size() ? index : objs.size()) - 1;
+  for (int i = start; i >= 0 && i > start - max_search; i--) {
+    if (objs[i].id == id)
+      return &objs[i];
+  }
+  return nullptr;
+}
+
+static void
+draw_selected(EntityInspector& inspector, GameState& state)
+{
+  GameObject2D* obj = find_entity(state, inspector.selected_list, inspector.selected_index, inspector.selected_id);
+  if (obj == nullptr) {
+    ImGui::Text("entity %i is gone", inspector.selected_id);
+    return;
+  }
+  inspector.selected_index = static_cast<uint32_t>(obj - get_list(state, inspector.selected_list).data());
+
+  ImGui::Text("id: %i name: %s (%s)", obj->id, obj->name.c_str(), get_list_name(inspector.selected_list));
+  ImGui::Text("layer: %s", std::string(magic_enum::enum_name(obj->collision_layer)).c_str());
+  ImGui::Text("pos %f %f", obj->pos.x, obj->pos.y);
+  ImGui::Text("vel x: %f y: %f", obj->velocity.x, obj->velocity.y);
+  ImGui::Text("hits taken: %i / %i", obj->hits_taken, obj->hits_able_to_be_taken);
+  if (obj->do_lifecycle_timed)
+    ImGui::Text("time alive left: %f", obj->time_alive_left);
+  for (const auto& c : obj->in_physics_grid_cell)
+    ImGui::Text("in cell: x:%i y:%i", c.x, c.y);
+}
+
+void
+draw(EntityInspector& inspector, GameState& state)
+{
+  scan(inspector, state);
+
+  PROFILE_ZONE("entity_inspector::draw");
+  ImGui::Begin("Entity Menu", NULL, ImGuiWindowFlags_NoFocusOnAppearing);
+
+  // counts: list sizes are free, layers and cells come from the scan
+  for (int l = 0; l < static_cast<int>(EntityList::COUNT); l++) {
+    EntityList list = static_cast<EntityList>(l);
+    ImGui::Text("%s: %i", get_list_name(list), static_cast<int>(get_list(state, list).size()));
+  }
+  ImGui::Text("Attacks: %i", static_cast<int>(state.live_attacks.size()));
+  if (ImGui::CollapsingHeader("Layers")) {
+    for (int i = 0; i < static_cast<int>(CollisionLayer::Count); i++) {
+      CollisionLayer layer = static_cast<CollisionLayer>(i);
+      ImGui::Text("%s: %i", std::string(magic_enum::enum_name(layer)).c_str(), inspector.layer_counts[i]);
+    }
+    ImGui::Text("grid cells occupied: %i", inspector.grid_cells_total);
+    ImGui::Text("scans: %i (%i entities per frame)", inspector.scans_completed, inspector.scan_budget);
+  }
+  ImGui::Separator();
+
+  // filter
+  bool filter_changed = false;
+  for (int l = 0; l < static_cast<int>(EntityList::COUNT); l++) {
+    if (l > 0)
+      ImGui::SameLine();
+    filter_changed |= ImGui::Checkbox(get_list_name(static_cast<EntityList>(l)), &inspector.show_list[l]);
+  }
+  // "Any", then every layer but Count (magic_enum's names are null terminated)
+  using LayerNames = std::array<const char*, static_cast<int>(CollisionLayer::Count) + 1>;
+  static const LayerNames layer_names = []() {
+    LayerNames names{};
+    names[0] = "Any";
+    for (int i = 0; i < static_cast<int>(CollisionLayer::Count); i++)
+      names[i + 1] = magic_enum::enum_names<CollisionLayer>()[i].data();
+    return names;
+  }();
+  int layer_item = inspector.collision_layer + 1;
+  filter_changed |= ImGui::Combo("layer", &layer_item, layer_names.data(), static_cast<int>(layer_names.size()));
+  inspector.collision_layer = layer_item - 1;
+  filter_changed |= ImGui::InputText("name", inspector.name_filter, IM_ARRAYSIZE(inspector.name_filter));
+  if (filter_changed)
+    restart_scan(inspector);
+
+  // rows
+  const bool filtering = is_filtering(inspector);
+  int row_count = static_cast<int>(inspector.rows.size());
+  if (!filtering) {
+    row_count = 0;
+    for (int l = 0; l < static_cast<int>(EntityList::COUNT); l++)
+      row_count += static_cast<int>(get_list(state, static_cast<EntityList>(l)).size());
+  }
+
+  ImGui::BeginChild("entities", ImVec2(0, 300), true);
+  ImGuiListClipper clipper;
+  clipper.Begin(row_count);
+  while (clipper.Step()) {
+    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+      EntityInspector::Row row;
+      if (filtering)
+        row = inspector.rows[i];
+      else if (!get_unfiltered_row(state, i, row))
+        continue;
+
+      GameObject2D* obj = find_entity(state, row.list, row.index, row.id);
+      char label[128];
+      if (obj)
+        snprintf(label,
+                 sizeof(label),
+                 "%6u %-8s %-8s %8.0f %8.0f",
+                 obj->id,
+                 obj->name.c_str(),
+                 get_list_name(row.list),
+                 obj->pos.x,
+                 obj->pos.y);
+      else
+        snprintf(label, sizeof(label), "%6u (gone)", row.id);
+
+      if (ImGui::Selectable(label, row.id == inspector.selected_id) && obj) {
+        inspector.selected_id = row.id;
+        inspector.selected_list = row.list;
+        inspector.selected_index = static_cast<uint32_t>(obj - get_list(state, row.list).data());
+      }
+    }
+  }
+  clipper.End();
+  ImGui::EndChild();
+
+  if (inspector.selected_id != 0) {
+    ImGui::Separator();
+    draw_selected(inspector, state);
+  }
+
+  ImGui::End();
+}
+
+} // namespace entity_inspector
+
+} // namespace game2d
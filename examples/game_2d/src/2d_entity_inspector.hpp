@@ -0,0 +1,84 @@
+#pragma once
+
+// c++ lib headers
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// game headers
+#include "2d_game.hpp"
+#include "2d_game_object.hpp"
+
+namespace game2d {
+
+enum class EntityList : uint8_t
+{
+  PLAYERS,
+  ENEMIES,
+  BULLETS,
+  VFX,
+  TREES,
+  SHOPS,
+
+  COUNT
+};
+
+// Lists the entities in a GameState without touching every entity each frame:
+// only the rows on screen are built (ImGuiListClipper), and the filter and the
+// per-layer counts come from a scan that looks at a fixed number of entities per frame.
+// Filtered rows and counts are from the last complete scan, so they can be a few frames old.
+struct EntityInspector
+{
+  struct Row
+  {
+    EntityList list = EntityList::PLAYERS;
+    uint32_t index = 0;
+    uint32_t id = 0;
+  };
+
+  // filter
+  std::array<bool, static_cast<size_t>(EntityList::COUNT)> show_list = { true, true, true, true, true, true };
+  int collision_layer = -1; // -1 for any
+  char name_filter[64] = "";
+  int scan_budget = 4096; // entities scanned per frame
+
+  // selection
+  uint32_t selected_id = 0;
+  EntityList selected_list = EntityList::PLAYERS;
+  uint32_t selected_index = 0;
+
+  // published by the last complete scan
+  std::vector<Row> rows;
+  std::array<int, static_cast<size_t>(CollisionLayer::Count)> layer_counts{};
+  int grid_cells_total = 0;
+  int scans_completed = 0;
+
+  // the scan in progress
+  std::vector<Row> scan_rows;
+  std::array<int, static_cast<size_t>(CollisionLayer::Count)> scan_layer_counts{};
+  int scan_grid_cells_total = 0;
+  EntityList scan_list = EntityList::PLAYERS;
+  size_t scan_index = 0;
+};
+
+namespace entity_inspector {
+
+[[nodiscard]] std::vector<GameObject2D>&
+get_list(GameState& state, EntityList list);
+
+[[nodiscard]] const char*
+get_list_name(EntityList list);
+
+[[nodiscard]] bool
+is_filtering(const EntityInspector& inspector);
+
+// looks at up to scan_budget entities, publishing the results when it gets to the end
+void
+scan(EntityInspector& inspector, GameState& state);
+
+void
+draw(EntityInspector& inspector, GameState& state);
+
+} // namespace entity_inspector
+
+} // namespace game2d
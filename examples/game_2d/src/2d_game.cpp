@@ -0,0 +1,406 @@
+// your header
+#include "2d_game.hpp"
+
+// c++ lib headers
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <map>
+
+// other lib headers
+#include <glm/gtx/compatibility.hpp>
+#include <glm/gtx/fast_square_root.hpp>
+#include <glm/gtx/vector_angle.hpp>
+
+// engine headers
+#include "engine/grid.hpp"
+#include "engine/tools/logger.hpp"
+#include "engine/tools/zone_profiler.hpp"
+
+// game headers
+#include "2d_game_logic.hpp"
+#include "2d_vfx.hpp"
+
+namespace game2d {
+
+namespace game {
+
+fightingengine::CVar<int> cvar_physics_grid_size("physics.grid_size",
+                                                 PHYSICS_GRID_SIZE,
+                                                 "broadphase cell size in pixels",
+                                                 8,
+                                                 4096);
+
+void
+init(GameState& state, glm::ivec2 screen_wh, uint32_t seed)
+{
+  state.screen_wh = screen_wh;
+  state.rnd.rng.seed(seed);
+  enemy_spawner::init(state.spawner);
+  state.slash = SlashState();
+
+  state.camera = gameobject::create_camera();
+
+  state.weapon_base = GameObject2D();
+  state.weapon_base.sprite = sprite_weapon_base;
+  state.weapon_base.pos = { screen_wh.x / 2.0f, screen_wh.y / 2.0f };
+  state.weapon_base.render_size = { 1.0f * 768.0f / 48.0f, 1.0f * 362.0f / 22.0f };
+  state.weapon_base.physics_size = { 1.0f * 768.0f / 48.0f, 1.0f * 362.0f / 22.0f };
+  state.weapon_base.collision_layer = CollisionLayer::Weapon;
+  state.weapon_base.colour = bullet_colour;
+
+  // add players
+  {
+    GameObject2D player0 = gameobject::create_player(sprite_player, tex_unit_kenny_nl, player_colour, screen_wh);
+
+    KeysAndState player0_keys;
+    player0_keys.use_keyboard = true;
+
+    state.entities_player.push_back(player0);
+    state.player_keys.push_back(player0_keys);
+  }
+}
+
+void
+update_physics(GameState& state)
+{
+  std::vector<std::reference_wrapper<GameObject2D>> collidable;
+  collidable.insert(collidable.end(), state.entities_enemies.begin(), state.entities_enemies.end());
+  collidable.insert(collidable.end(), state.entities_bullets.begin(), state.entities_bullets.end());
+  collidable.insert(collidable.end(), state.entities_player.begin(), state.entities_player.end());
+  collidable.insert(collidable.end(), state.entities_trees.begin(), state.entities_trees.end());
+  collidable.push_back(state.weapon_base);
+
+  std::vector<std::reference_wrapper<GameObject2D>> active_collidable;
+  for (auto& obj : collidable) {
+    if (obj.get().do_physics)
+      active_collidable.push_back(obj);
+  }
+
+  // pre-physics: update grid position
+  {
+    PROFILE_ZONE("physics::grid_cells");
+    const int grid_size = cvar_physics_grid_size.get();
+    for (auto& e : active_collidable) {
+      grid::get_unique_cells(e.get().pos, e.get().physics_size, grid_size, e.get().in_physics_grid_cell);
+    }
+  }
+
+  // generate filtered broadphase collisions. profiled as physics::broadphase
+  std::map<uint64_t, Collision2D> filtered_collisions;
+  generate_filtered_broadphase_collisions(active_collidable, filtered_collisions);
+
+  {
+    PROFILE_ZONE("physics::build_events");
+
+    // clear collision events this frame
+    state.collision_events.clear();
+
+    // Add collision to events
+    for (auto& c : filtered_collisions) {
+      uint32_t id_0 = c.second.ent_id_0;
+      uint32_t id_1 = c.second.ent_id_1;
+
+      // Find the objs in the read-only list
+      auto& obj_0_it = std::find_if(
+        collidable.begin(), collidable.end(), [&id_0](const auto& obj) { return obj.get().id == id_0; });
+      auto& obj_1_it = std::find_if(
+        collidable.begin(), collidable.end(), [&id_1](const auto& obj) { return obj.get().id == id_1; });
+
+      if (obj_0_it == collidable.end() || obj_1_it == collidable.end()) {
+        FE_LOG_ERROR("Collision entity not in entity list: {} {}", id_0, id_1);
+        continue;
+      }
+
+      CollisionEvent eve(obj_0_it->get(), obj_1_it->get());
+      state.collision_events.push_back(eve);
+    }
+  }
+}
+
+static void
+resolve_collision_events(GameState& state)
+{
+  state.player_at_obstacle = false;
+
+  for (auto& event : state.collision_events) {
+
+    auto& coll_layer_0 = event.go0.collision_layer;
+    auto& coll_layer_1 = event.go1.collision_layer;
+
+    if ((coll_layer_0 == CollisionLayer::Player && coll_layer_1 == CollisionLayer::Enemy) ||
+        (coll_layer_1 == CollisionLayer::Player && coll_layer_0 == CollisionLayer::Enemy)) {
+
+      GameObject2D& enemy = event.go0.collision_layer == CollisionLayer::Enemy ? event.go0 : event.go1;
+      GameObject2D& player = event.go0.collision_layer == CollisionLayer::Enemy ? event.go1 : event.go0;
+
+      if (player.hits_taken >= player.hits_able_to_be_taken)
+        continue; // player is dead
+
+      enemy.flag_for_delete = true;                   // enemy
+      player.hits_taken += 1;                         // player
+      player.flash_time_left = vfx_flash_time;        // vfx: flash
+      state.screenshake_time_left = screenshake_time; // screenshake
+
+      // vfx spawn a splat
+      fightingengine::Decal splat;
+      splat.sprite_offset = sprite::spritemap::get_sprite_offset(sprite_splat);
+      splat.colour = player_splat_colour;
+      splat.size = player.render_size;
+      splat.pos = player.pos;
+      splat.angle_radians = fightingengine::rand_det_s(state.rnd.rng, 0.0f, fightingengine::PI);
+      if (!state.resimulating && !state.headless)
+        state.decals.stamp(splat);
+    }
+
+    if ((coll_layer_0 == CollisionLayer::Enemy && coll_layer_1 == CollisionLayer::Weapon) ||
+        (coll_layer_1 == CollisionLayer::Enemy && coll_layer_0 == CollisionLayer::Weapon)) {
+
+      GameObject2D& enemy = event.go0.collision_layer == CollisionLayer::Enemy ? event.go0 : event.go1;
+      GameObject2D& weapon = event.go0.collision_layer == CollisionLayer::Enemy ? event.go1 : event.go0;
+      GameObject2D& player = state.entities_player[0]; // hack: use player 0 for the moment
+
+      for (auto& attack : state.live_attacks) {
+
+        bool is_shovel = attack.weapon_type == Weapons::SHOVEL;
+        bool collision_with_specific_shovel_attack = weapon.id == attack.entity_weapon_id;
+        bool taken_damage_from_shovel = std::find(enemy.attack_ids_taken_damage_from.begin(),
+                                                  enemy.attack_ids_taken_damage_from.end(),
+                                                  attack.id) != enemy.attack_ids_taken_damage_from.end();
+
+        if (is_shovel && collision_with_specific_shovel_attack && !taken_damage_from_shovel) {
+          // std::cout << "enemy taking damage from weapon attack ONCE!" << std::endl;
+          enemy.hits_taken += 1;
+          enemy.attack_ids_taken_damage_from.push_back(attack.id);
+          enemy.flash_time_left = vfx_flash_time; // vfx: flash
+
+          // vfx impactsplat
+          vfx::spawn_impact_splats(
+            state.rnd, enemy, player, sprite_splat, tex_unit_kenny_nl, enemy_impact_splat_colour, state.entities_vfx);
+        }
+      }
+    }
+
+    if ((coll_layer_0 == CollisionLayer::Bullet && coll_layer_1 == CollisionLayer::Enemy) ||
+        (coll_layer_1 == CollisionLayer::Bullet && coll_layer_0 == CollisionLayer::Enemy)) {
+      GameObject2D& bullet = event.go0.collision_layer == CollisionLayer::Bullet ? event.go0 : event.go1;
+      GameObject2D& enemy = event.go0.collision_layer == CollisionLayer::Bullet ? event.go1 : event.go0;
+      GameObject2D& player = state.entities_player[0]; // hack: use player 0 for the moment
+
+      for (auto& attack : state.live_attacks) {
+
+        bool is_bullet = attack.weapon_type == Weapons::PISTOL;
+        bool collision_with_specific_bullet = bullet.id == attack.entity_weapon_id;
+        bool taken_damage_from_bullet = std::find(enemy.attack_ids_taken_damage_from.begin(),
+                                                  enemy.attack_ids_taken_damage_from.end(),
+                                                  attack.id) != enemy.attack_ids_taken_damage_from.end();
+
+        if (is_bullet && collision_with_specific_bullet && !taken_damage_from_bullet) {
+          // std::cout << "enemy taking damage from bullet attack ONCE!" << std::endl;
+          enemy.hits_taken += 1;
+          enemy.attack_ids_taken_damage_from.push_back(attack.id);
+          enemy.flash_time_left = vfx_flash_time; // vfx: flash
+
+          // vfx impactsplat
+          vfx::spawn_impact_splats(
+            state.rnd, enemy, player, sprite_splat, tex_unit_kenny_nl, enemy_impact_splat_colour, state.entities_vfx);
+        }
+      }
+    }
+
+    if ((coll_layer_0 == CollisionLayer::Obstacle && coll_layer_1 == CollisionLayer::Player) ||
+        (coll_layer_1 == CollisionLayer::Obstacle && coll_layer_0 == CollisionLayer::Player)) {
+      state.player_at_obstacle = true;
+    }
+  }
+}
+
+void
+update(GameState& state, float delta_time_s)
+{
+  resolve_collision_events(state);
+
+  for (const KeysAndState& keys : state.player_keys) {
+    if (keys.pause_pressed)
+      state.running = state.running == GameRunning::PAUSED ? GameRunning::ACTIVE : GameRunning::PAUSED;
+  }
+
+  if (state.running != GameRunning::ACTIVE)
+    return;
+
+  // update: players
+
+  for (int i = 0; i < state.entities_player.size(); i++) {
+    GameObject2D& player = state.entities_player[i];
+    KeysAndState& keys = state.player_keys[i];
+
+    player.velocity.x = keys.l_analogue_x;
+    player.velocity.y = keys.l_analogue_y;
+    player.velocity *= player.speed_current;
+
+    player::ability_boost(player, keys, delta_time_s);
+    gameobject::update_position(player, delta_time_s);
+
+    if (state.player_attacks_enabled) {
+      if (player.equipped_weapon == Weapons::SHOVEL)
+        player::ability_slash(state.slash, player, keys, state.weapon_base, delta_time_s, state.live_attacks);
+      if (player.equipped_weapon == Weapons::PISTOL)
+        player::ability_shoot(player,
+                              keys,
+                              state.entities_bullets,
+                              tex_unit_kenny_nl,
+                              bullet_colour,
+                              sprite_bullet,
+                              delta_time_s,
+                              state.live_attacks);
+    }
+
+    bool player_alive = player.invulnerable || player.hits_taken < player.hits_able_to_be_taken;
+    if (!player_alive)
+      state.running = GameRunning::GAME_OVER;
+  }
+
+  // update: bullets
+
+  for (auto& bullet : state.entities_bullets) {
+    bullet::update(bullet, delta_time_s);
+  }
+
+  // update: vfx
+
+  for (auto& obj : state.entities_vfx) {
+    gameobject::update_position(obj, delta_time_s);
+  }
+
+  // update: vfx flash
+
+  for (auto& obj : state.entities_player) {
+    if (obj.flash_time_left > 0.0f) {
+      obj.flash_time_left -= delta_time_s;
+      obj.colour = enemy_impact_splat_colour;
+    } else {
+      obj.colour = player_colour;
+    }
+  }
+  for (auto& obj : state.entities_enemies) {
+    if (obj.flash_time_left > 0.0f) {
+      obj.flash_time_left -= delta_time_s;
+      obj.colour = enemy_impact_splat_colour;
+    } else {
+      obj.colour = enemy_colour;
+    }
+  }
+
+  // update: vfx screenshake
+
+  if (state.screenshake_time_left > 0.0f)
+    state.screenshake_time_left -= delta_time_s;
+
+  // update: spawn enemies
+
+  size_t players_in_game = state.entities_player.size();
+  if (players_in_game > 0) {
+
+    // for the moment, eat player 0
+    GameObject2D player_to_chase = state.entities_player[0];
+
+    // update with ai behaviour
+    for (auto& obj : state.entities_enemies) {
+
+      // check every frame: close to player?
+      float distance_squared = glm::distance2(obj.pos, player_to_chase.pos);
+      if (distance_squared < game_enemy_direct_attack_threshold) {
+        // push new ai behaviour
+        if (obj.ai_priority_list.size() > 0 && obj.ai_priority_list.back() != AiBehaviour::MOVEMENT_DIRECT) {
+          obj.ai_priority_list.push_back(AiBehaviour::MOVEMENT_DIRECT);
+        }
+      } else {
+        // far away! check if our original ai was move direct or arc angle. pop arc angle if it was pushed.
+        if (obj.ai_priority_list.size() > 1 && obj.ai_priority_list.back() == AiBehaviour::MOVEMENT_DIRECT) {
+          obj.ai_priority_list.pop_back();
+        }
+      }
+
+      // update: ai behaviour (note, currently runs every frame probably bad)
+      if (obj.ai_priority_list.size() > 0 && obj.ai_priority_list.back() == AiBehaviour::MOVEMENT_DIRECT) {
+        enemy_ai::enemy_directly_to_player(obj, player_to_chase, delta_time_s);
+      } else if (obj.ai_priority_list.size() > 0 && obj.ai_priority_list.back() == AiBehaviour::MOVEMENT_ARC_ANGLE) {
+        enemy_ai::enemy_arc_angles_to_player(obj, player_to_chase, delta_time_s);
+      }
+    }
+
+    //... and only spawn enemies if there is a player.
+    enemy_spawner::update(state.spawner,
+                          state.entities_enemies,
+                          state.entities_player,
+                          state.camera,
+                          state.rnd,
+                          state.screen_wh,
+                          game_safe_radius_around_player,
+                          tex_unit_kenny_nl,
+                          enemy_colour,
+                          sprite_enemy_core,
+                          delta_time_s);
+
+    // update camera pos
+    camera::update(state.camera, state.player_keys[0], delta_time_s);
+  }
+
+  { // object lifecycle
+
+    gameobject::update_entities_lifecycle(state.entities_enemies, delta_time_s);
+    gameobject::update_entities_lifecycle(state.entities_bullets, delta_time_s);
+    gameobject::update_entities_lifecycle(state.entities_vfx, delta_time_s);
+
+    // remove "attack" object before deleting "bullet" object (or any object that is cleaned up)
+    // e.g when deleting "player" (in the future)
+    std::vector<Attack>::iterator it = state.live_attacks.begin();
+    while (it != state.live_attacks.end()) {
+      const Attack& attack = (*it);
+      int id = attack.entity_weapon_id;
+
+      if (attack.weapon_type == Weapons::PISTOL) {
+        const auto& bullet = std::find_if(state.entities_bullets.begin(),
+                                          state.entities_bullets.end(),
+                                          [&id](const auto& obj) { return obj.id == id; });
+
+        if (bullet != state.entities_bullets.end() && bullet->flag_for_delete) {
+          // remove the attack object
+          it = state.live_attacks.erase(it);
+          continue;
+        }
+      }
+      ++it;
+    }
+
+    // enemy has died
+    for (auto& enemy : state.entities_enemies) {
+      if (enemy.flag_for_delete) {
+        fightingengine::DecalLayer* decals = state.resimulating || state.headless ? nullptr : &state.decals;
+        vfx::spawn_death_splat(state.rnd, enemy, enemy.sprite, enemy.colour, decals);
+      }
+    }
+    if (!state.resimulating && !state.headless)
+      state.decals.update(delta_time_s);
+
+    gameobject::erase_entities_that_are_flagged_for_delete(state.entities_enemies, delta_time_s);
+    gameobject::erase_entities_that_are_flagged_for_delete(state.entities_bullets, delta_time_s);
+    gameobject::erase_entities_that_are_flagged_for_delete(state.entities_vfx, delta_time_s);
+  }
+}
+
+GameObject2D&
+place_tree(GameState& state, glm::vec2 world_pos)
+{
+  GameObject2D tree = gameobject::create_tree(tex_unit_kenny_nl);
+  tree.pos = grid::convert_world_space_to_grid_space(world_pos, GAME_GRID_SIZE);
+  tree.pos = grid::convert_grid_space_to_worldspace(tree.pos, GAME_GRID_SIZE);
+  tree.render_size = glm::ivec2(GAME_GRID_SIZE);
+  tree.physics_size = glm::ivec2(GAME_GRID_SIZE);
+  state.entities_trees.push_back(tree);
+  return state.entities_trees.back();
+}
+
+} // namespace game
+
+} // namespace game2d
@@ -0,0 +1,118 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+#include <vector>
+
+// other lib headers
+#include <glm/glm.hpp>
+
+// engine headers
+#include "engine/maths_core.hpp"
+#include "engine/tools/cvars.hpp"
+#include "engine/vfx/decal_layer.hpp"
+
+// game headers
+#include "2d_game_object.hpp"
+#include "2d_physics.hpp"
+#include "spritemap.hpp"
+
+namespace game2d {
+
+enum class GameRunning
+{
+  ACTIVE,
+  PAUSED,
+  GAME_OVER
+};
+
+// textures
+const int tex_unit_kenny_nl = 0;
+const int tex_tree = 1;
+const int tex_unit_decals = 2;
+
+// colour palette; https://colorhunt.co/palette/273312
+const glm::vec4 PALETTE_COLOUR_1_1 = glm::vec4(57.0f / 255.0f, 62.0f / 255.0f, 70.0f / 255.0f, 1.0f);    // black
+const glm::vec4 PALETTE_COLOUR_2_1 = glm::vec4(0.0f / 255.0f, 173.0f / 255.0f, 181.0f / 255.0f, 1.0f);   // blue
+const glm::vec4 PALETTE_COLOUR_3_1 = glm::vec4(170.0f / 255.0f, 216.0f / 255.0f, 211.0f / 255.0f, 1.0f); // lightblue
+const glm::vec4 PALETTE_COLOUR_4_1 = glm::vec4(238.0f / 255.0f, 238.0f / 255.0f, 238.0f / 255.0f, 1.0f); // grey
+
+const glm::vec4 player_colour = PALETTE_COLOUR_2_1;                              // blue
+const glm::vec4 bullet_colour = PALETTE_COLOUR_3_1;                              // lightblue
+const glm::vec4 enemy_colour = PALETTE_COLOUR_4_1;                               // grey
+const glm::vec4 player_splat_colour = player_colour;                             // player col
+const glm::vec4 enemy_death_splat_colour = glm::vec4(0.65f, 0.65f, 0.65f, 1.0f); // greyish
+const glm::vec4 enemy_impact_splat_colour = glm::vec4(0.95f, 0.3f, 0.3f, 1.0f);  // redish
+
+const sprite::type sprite_player = sprite::type::PERSON_1;
+const sprite::type sprite_bullet = sprite::type::WEAPON_ARROW_1;
+const sprite::type sprite_enemy_core = sprite::type::PERSON_2;
+const sprite::type sprite_weapon_base = sprite::type::WEAPON_SHOVEL;
+const sprite::type sprite_splat = sprite::type::CASTLE_FLOOR;
+
+const float game_safe_radius_around_player = 7500.0f;
+const float game_enemy_direct_attack_threshold = 4000.0f;
+const float screenshake_time = 0.1f;
+const float vfx_flash_time = 0.2f;
+
+const int PHYSICS_GRID_SIZE = 100;
+const int GAME_GRID_SIZE = 32;
+
+// Everything the simulation reads and writes. No window, input device or GL,
+// so it can be stepped headless (see 2d_bench).
+struct GameState
+{
+  GameRunning running = GameRunning::ACTIVE;
+  glm::ivec2 screen_wh = { 1280, 720 };
+  fightingengine::RandomState rnd;
+
+  GameObject2D camera;
+  GameObject2D weapon_base;
+
+  std::vector<GameObject2D> entities_enemies;
+  std::vector<GameObject2D> entities_bullets;
+  std::vector<GameObject2D> entities_player;
+  std::vector<GameObject2D> entities_vfx;
+  std::vector<GameObject2D> entities_trees;
+  std::vector<GameObject2D> entities_shops;
+  std::vector<KeysAndState> player_keys; // one per player, filled before update()
+  std::vector<Attack> live_attacks;
+  std::vector<CollisionEvent> collision_events;
+  EnemySpawnerState spawner;
+  SlashState slash;
+
+  // blood splats are stamped once in to per-chunk render targets that fade out over time.
+  // presentation only: not rolled back, and not stamped while resimulating or headless
+  fightingengine::DecalLayer decals{ 512, 32, 25.0f, 5.0f };
+  bool resimulating = false; // set by rollback
+  bool headless = false;     // a server: nothing is presented
+
+  bool player_attacks_enabled = true;
+  bool player_at_obstacle = false; // set by update()
+  float screenshake_time_left = 0.0f;
+  uint32_t game_objects_destroyed = 0;
+};
+
+namespace game {
+
+// broadphase cell size in pixels, defaults to PHYSICS_GRID_SIZE
+extern fightingengine::CVar<int> cvar_physics_grid_size;
+
+void
+init(GameState& state, glm::ivec2 screen_wh, uint32_t seed);
+
+// broadphase, fills state.collision_events
+void
+update_physics(GameState& state);
+
+// resolves collision events, then steps everything by delta_time_s
+void
+update(GameState& state, float delta_time_s);
+
+// a tree snapped to the game grid cell under world_pos
+GameObject2D&
+place_tree(GameState& state, glm::vec2 world_pos);
+
+} // namespace game
+
+} // namespace game2d
@@ -10,6 +10,8 @@
 
 // engine headers
 #include "engine/maths_core.hpp"
+#include "engine/tools/cvars.hpp"
+#include "engine/tools/logger.hpp"
 
 namespace game2d {
 
@@ -25,17 +27,11 @@ bullet::update(GameObject2D& obj, float delta_time_s)
 };
 
 void
-camera::update(GameObject2D& camera, const KeysAndState& keys, fightingengine::Application& app, float delta_time_s)
+camera::update(GameObject2D& camera, const KeysAndState& keys, float delta_time_s)
 {
   // go.pos = glm::vec2(other.pos.x - screen_width / 2.0f, other.pos.y - screen_height / 2.0f);
-  if (app.get_input().get_key_held(keys.key_camera_left))
-    camera.pos.x -= delta_time_s * camera.speed_current;
-  if (app.get_input().get_key_held(keys.key_camera_right))
-    camera.pos.x += delta_time_s * camera.speed_current;
-  if (app.get_input().get_key_held(keys.key_camera_up))
-    camera.pos.y -= delta_time_s * camera.speed_current;
-  if (app.get_input().get_key_held(keys.key_camera_down))
-    camera.pos.y += delta_time_s * camera.speed_current;
+  camera.pos.x += keys.camera_x * delta_time_s * camera.speed_current;
+  camera.pos.y += keys.camera_y * delta_time_s * camera.speed_current;
 };
 
 void
@@ -77,16 +73,33 @@ enemy_ai::enemy_arc_angles_to_player(GameObject2D& obj, GameObject2D& player, fl
 
 namespace enemy_spawner {
 
-const bool game_spawn_enemies = true;
-const float game_wall_seconds_between_spawning_start = 1.0f;
-float game_wall_seconds_between_spawning_current = game_wall_seconds_between_spawning_start;
-float game_wall_seconds_between_spawning_left = 0.0f;
-const float game_wall_seconds_between_spawning_end = 0.2f;
-const float game_seconds_until_max_difficulty = 100.0f;
-float game_seconds_until_max_difficulty_spent = 0.0f;
+static fightingengine::CVar<bool> cvar_spawn_enemies("spawner.enabled", true, "spawn enemies over time");
+static fightingengine::CVar<float> cvar_spawn_interval_start_s("spawner.interval_start_s",
+                                                               1.0f,
+                                                               "seconds between spawns at the start",
+                                                               0.001f,
+                                                               60.0f);
+static fightingengine::CVar<float> cvar_spawn_interval_end_s("spawner.interval_end_s",
+                                                             0.2f,
+                                                             "seconds between spawns at max difficulty",
+                                                             0.001f,
+                                                             60.0f);
+static fightingengine::CVar<float> cvar_spawn_seconds_to_max_difficulty("spawner.seconds_to_max_difficulty",
+                                                                        100.0f,
+                                                                        "seconds to ramp the spawn interval",
+                                                                        0.1f,
+                                                                        3600.0f);
 
 void
-update(std::vector<GameObject2D>& enemies,
+init(EnemySpawnerState& spawner)
+{
+  spawner = EnemySpawnerState();
+  spawner.seconds_between_spawning_current = cvar_spawn_interval_start_s.get();
+}
+
+void
+update(EnemySpawnerState& spawner,
+       std::vector<GameObject2D>& enemies,
        std::vector<GameObject2D>& players,
        const GameObject2D& camera,
        fightingengine::RandomState& rnd,
@@ -97,9 +110,9 @@ update(std::vector<GameObject2D>& enemies,
        const sprite::type sprite,
        const float delta_time_s)
 {
-  game_wall_seconds_between_spawning_left -= delta_time_s;
-  if (game_wall_seconds_between_spawning_left <= 0.0f) {
-    game_wall_seconds_between_spawning_left = game_wall_seconds_between_spawning_current;
+  spawner.seconds_between_spawning_left -= delta_time_s;
+  if (spawner.seconds_between_spawning_left <= 0.0f) {
+    spawner.seconds_between_spawning_left = spawner.seconds_between_spawning_current;
 
     // search params
     bool continue_search = true;
@@ -116,7 +129,7 @@ update(std::vector<GameObject2D>& enemies,
       if (iteration == iterations_max) {
         // ah, screw it, just spawn at 0, 0
         continue_search = false;
-        std::cout << "(EnemySpawner) max iterations hit" << std::endl;
+        FE_LOG_WARN("(EnemySpawner) max iterations hit");
       }
 
       bool ok = true;
@@ -140,7 +153,7 @@ update(std::vector<GameObject2D>& enemies,
     // std::cout << "enemy spawning " << distance_squared << " away from player" << std::endl;
     glm::vec2 world_pos = found_pos + camera.pos;
 
-    if (game_spawn_enemies) {
+    if (cvar_spawn_enemies.get()) {
       // spawn enemy
       GameObject2D wall_copy = gameobject::create_enemy(sprite, tex_unit, col, rnd);
       // override defaults
@@ -152,81 +165,17 @@ update(std::vector<GameObject2D>& enemies,
   // increase difficulty
   // 0.5 is starting cooldown
   // after 30 seconds, cooldown should be 0
-  game_seconds_until_max_difficulty_spent += delta_time_s;
-  float percent = glm::clamp(game_seconds_until_max_difficulty_spent / game_seconds_until_max_difficulty, 0.0f, 1.0f);
-  game_wall_seconds_between_spawning_current =
-    glm::mix(game_wall_seconds_between_spawning_start, game_wall_seconds_between_spawning_end, percent);
+  spawner.seconds_until_max_difficulty_spent += delta_time_s;
+  float percent =
+    glm::clamp(spawner.seconds_until_max_difficulty_spent / cvar_spawn_seconds_to_max_difficulty.get(), 0.0f, 1.0f);
+  spawner.seconds_between_spawning_current =
+    glm::mix(cvar_spawn_interval_start_s.get(), cvar_spawn_interval_end_s.get(), percent);
 };
 
 } // namespace enemyspawner
 
 namespace player {
 
-void
-update_input(GameObject2D& obj, KeysAndState& keys, fightingengine::Application& app, GameObject2D& camera)
-{
-  keys.l_analogue_x = 0.0f;
-  keys.l_analogue_y = 0.0f;
-  keys.r_analogue_x = 0.0f;
-  keys.r_analogue_y = 0.0f;
-  keys.shoot_pressed = false;
-  keys.boost_pressed = false;
-  keys.pause_pressed = false;
-
-  // Keymaps: keyboard
-  if (keys.use_keyboard) {
-    if (app.get_input().get_key_held(keys.w)) {
-      keys.l_analogue_y = -1.0f;
-    } else if (app.get_input().get_key_held(keys.s)) {
-      keys.l_analogue_y = 1.0f;
-    } else {
-      keys.l_analogue_y = 0.0f;
-    }
-
-    if (app.get_input().get_key_held(keys.a)) {
-      keys.l_analogue_x = -1.0f;
-    } else if (app.get_input().get_key_held(keys.d)) {
-      keys.l_analogue_x = 1.0f;
-    } else {
-      keys.l_analogue_x = 0.0f;
-    }
-
-    keys.shoot_pressed = app.get_input().get_mouse_lmb_held();
-    keys.boost_pressed = app.get_input().get_key_held(keys.key_boost);
-    keys.pause_pressed = app.get_input().get_key_down(keys.key_pause);
-
-    glm::vec2 player_world_space_pos = gameobject_in_worldspace(camera, obj);
-    float mouse_angle_around_player = atan2(app.get_input().get_mouse_pos().y - player_world_space_pos.y,
-                                            app.get_input().get_mouse_pos().x - player_world_space_pos.x);
-
-    mouse_angle_around_player += fightingengine::HALF_PI;
-    keys.angle_around_player = mouse_angle_around_player;
-
-    float x_axis = glm::sin(mouse_angle_around_player);
-    float y_axis = -glm::cos(mouse_angle_around_player);
-    keys.r_analogue_x = x_axis;
-    keys.r_analogue_y = y_axis;
-  }
-
-  // }
-  // // Keymaps: Controller
-  // else {
-  //   l_analogue_x = app.get_input().get_axis_dir(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_LEFTX);
-  //   l_analogue_y = app.get_input().get_axis_dir(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_LEFTY);
-  //   r_analogue_x = app.get_input().get_axis_dir(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_RIGHTX);
-  //   r_analogue_y = app.get_input().get_axis_dir(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_RIGHTY);
-  //   shoot_pressed =
-  //     app.get_input().get_axis_held(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_TRIGGERRIGHT);
-  //   boost_pressed =
-  //     app.get_input().get_axis_held(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_TRIGGERLEFT);
-  //   pause_pressed =
-  //     app.get_input().get_button_held(controller, SDL_GameControllerButton::SDL_CONTROLLER_BUTTON_START);
-
-  //   look_angle = atan2(r_analogue_y, r_analogue_x);
-  //   look_angle += HALF_PI;
-  // }
-};
-
 void
 ability_boost(GameObject2D& player, const KeysAndState& keys, const float delta_time_s)
 {
@@ -248,8 +197,7 @@ ability_boost(GameObject2D& player, const KeysAndState& keys, const float delta_
 }
 
 void
-ability_shoot(fightingengine::Application& app,
-              GameObject2D& player,
+ability_shoot(GameObject2D& player,
               const KeysAndState& keys,
               std::vector<GameObject2D>& bullets,
               const int tex_unit,
@@ -264,7 +212,7 @@ ability_shoot(fightingengine::Application& app,
   if (player.bullet_seconds_between_spawning_left > 0.0f)
     player.bullet_seconds_between_spawning_left -= delta_time_s;
 
-  if (player.bullet_seconds_between_spawning_left <= 0.0f || app.get_input().get_mouse_lmb_down()) {
+  if (player.bullet_seconds_between_spawning_left <= 0.0f || keys.shoot_down) {
     player.bullet_seconds_between_spawning_left = player.bullet_seconds_between_spawning;
     // obj.bullets_to_fire_after_releasing_mouse_left -= 1;
     // obj.bullets_to_fire_after_releasing_mouse_left =
@@ -295,27 +243,24 @@ ability_shoot(fightingengine::Application& app,
 // slash stats
 const float weapon_radius = 30.0f;
 const float slash_attack_time = 0.15f;
-float slash_attack_time_left = 0.0f;
-float weapon_current_angle = 0.0f;
-float weapon_angle_speed = fightingengine::HALF_PI / 30.0f; // closer to 0 is faster
-bool attack_left_to_right = true;
+const float weapon_angle_speed = fightingengine::HALF_PI / 30.0f; // closer to 0 is faster
 
 void
-ability_slash(fightingengine::Application& app,
+ability_slash(SlashState& slash,
               GameObject2D& player_obj,
               const KeysAndState& keys,
               GameObject2D& weapon,
               float delta_time_s,
               std::vector<Attack>& attacks)
 {
-  if (app.get_input().get_mouse_lmb_down()) {
-    slash_attack_time_left = slash_attack_time;
-    attack_left_to_right = !attack_left_to_right; // keep swapping left to right to right to left etc
+  if (keys.shoot_down) {
+    slash.attack_time_left = slash_attack_time;
+    slash.attack_left_to_right = !slash.attack_left_to_right; // keep swapping left to right to right to left etc
 
-    if (attack_left_to_right)
-      weapon_current_angle = keys.angle_around_player - fightingengine::HALF_PI / 2.0f;
+    if (slash.attack_left_to_right)
+      slash.weapon_current_angle = keys.angle_around_player - fightingengine::HALF_PI / 2.0f;
     else
-      weapon_current_angle = keys.angle_around_player + fightingengine::HALF_PI / 2.0f;
+      slash.weapon_current_angle = keys.angle_around_player + fightingengine::HALF_PI / 2.0f;
 
     // set angle, but freezes weapon angle throughout slash?
     weapon.angle_radians = keys.angle_around_player + sprite::spritemap::get_sprite_rotation_offset(weapon.sprite);
@@ -336,8 +281,8 @@ ability_slash(fightingengine::Application& app,
     attacks.push_back(a);
   }
 
-  if (slash_attack_time_left > 0.0f) {
-    slash_attack_time_left -= delta_time_s;
+  if (slash.attack_time_left > 0.0f) {
+    slash.attack_time_left -= delta_time_s;
     weapon.do_render = true;
     weapon.do_physics = true;
   } else {
@@ -349,14 +294,14 @@ ability_slash(fightingengine::Application& app,
   pos.x += player_obj.physics_size.x / 2.0f - weapon.physics_size.x / 2.0f;
   pos.y += player_obj.physics_size.y / 2.0f - weapon.physics_size.y / 2.0f;
 
-  if (attack_left_to_right)
-    weapon_current_angle += weapon_angle_speed;
+  if (slash.attack_left_to_right)
+    slash.weapon_current_angle += weapon_angle_speed;
   else
-    weapon_current_angle -= weapon_angle_speed;
+    slash.weapon_current_angle -= weapon_angle_speed;
 
   // offset around center of circle
   glm::vec2 offset_pos =
-    glm::vec2(weapon_radius * sin(weapon_current_angle), -weapon_radius * cos(weapon_current_angle));
+    glm::vec2(weapon_radius * sin(slash.weapon_current_angle), -weapon_radius * cos(slash.weapon_current_angle));
   weapon.pos = pos + offset_pos;
 }
 
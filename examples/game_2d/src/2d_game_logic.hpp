@@ -7,7 +7,6 @@
 #include <glm/glm.hpp>
 
 // fightingengine headers
-#include "engine/application.hpp"
 #include "engine/maths_core.hpp"
 
 // game headers
@@ -25,7 +24,7 @@ update(GameObject2D& obj, float delta_time_s);
 namespace camera {
 
 void
-update(GameObject2D& camera, const KeysAndState& keys, fightingengine::Application& app, float delta_time_s);
+update(GameObject2D& camera, const KeysAndState& keys, float delta_time_s);
 
 }; // namespace camera
 
@@ -44,9 +43,14 @@ enemy_arc_angles_to_player(GameObject2D& obj, GameObject2D& player, float delta_
 
 namespace enemy_spawner {
 
+// starts the spawn interval at its cvar
+void
+init(EnemySpawnerState& spawner);
+
 // spawn a random enemy every X seconds
 void
-update(std::vector<GameObject2D>& enemies,
+update(EnemySpawnerState& spawner,
+       std::vector<GameObject2D>& enemies,
        std::vector<GameObject2D>& players,
        const GameObject2D& camera,
        fightingengine::RandomState& rnd,
@@ -61,14 +65,11 @@ update(std::vector<GameObject2D>& enemies,
 
 namespace player {
 
-void
-update_input(GameObject2D& obj, KeysAndState& keys, fightingengine::Application& app, GameObject2D& camera);
-
 void
 ability_boost(GameObject2D& player, const KeysAndState& keys, const float delta_time_s);
 
 void
-ability_slash(fightingengine::Application& app,
+ability_slash(SlashState& slash,
               GameObject2D& player_obj,
               const KeysAndState& keys,
               GameObject2D& weapon,
@@ -76,8 +77,7 @@ ability_slash(fightingengine::Application& app,
               std::vector<Attack>& attacks);
 
 void
-ability_shoot(fightingengine::Application& app,
-              GameObject2D& player,
+ability_shoot(GameObject2D& player,
               const KeysAndState& keys,
               std::vector<GameObject2D>& bullets,
               const int tex_unit,
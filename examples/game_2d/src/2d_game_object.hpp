@@ -78,7 +78,10 @@ struct KeysAndState
   float angle_around_player = 0.0f;
   bool pause_pressed = false;
   bool shoot_pressed = false;
+  bool shoot_down = false; // pressed this frame
   bool boost_pressed = false;
+  float camera_x = 0.0f;
+  float camera_y = 0.0f;
 };
 
 enum class AiBehaviour
@@ -98,7 +101,8 @@ enum class Weapons
 struct Attack
 {
 private:
-  static inline uint32_t global_attack_int_counter = 0;
+  // per thread: a server steps its matches on several threads, a match never moves between them
+  static inline thread_local uint32_t global_attack_int_counter = 0;
 
 public:
   uint32_t id = 0;
@@ -114,6 +118,26 @@ public:
   {
     id = ++Attack::global_attack_int_counter;
   };
+
+  // the last id handed out. rollback saves and rewinds it with the rest of the simulation
+  static uint32_t get_id_counter() { return global_attack_int_counter; }
+  static void set_id_counter(uint32_t counter) { global_attack_int_counter = counter; }
+};
+
+// enemy_spawner::update()'s timers
+struct EnemySpawnerState
+{
+  float seconds_between_spawning_current = 1.0f; // see enemy_spawner::init()
+  float seconds_between_spawning_left = 0.0f;
+  float seconds_until_max_difficulty_spent = 0.0f;
+};
+
+// player::ability_slash()'s swing
+struct SlashState
+{
+  float attack_time_left = 0.0f;
+  float weapon_current_angle = 0.0f;
+  bool attack_left_to_right = true;
 };
 
 //
@@ -124,7 +148,7 @@ public:
 struct GameObject2D
 {
 private:
-  static inline uint32_t global_int_counter = 0;
+  static inline thread_local uint32_t global_int_counter = 0; // per thread, like Attack's
 
 public:
   uint32_t id = 0;
@@ -187,6 +211,10 @@ public:
   std::string name = "DEFAULT";
 
   GameObject2D() { id = ++GameObject2D::global_int_counter; }
+
+  // the last id handed out. rollback saves and rewinds it with the rest of the simulation
+  static uint32_t get_id_counter() { return global_int_counter; }
+  static void set_id_counter(uint32_t counter) { global_int_counter = counter; }
 };
 
 // util
@@ -0,0 +1,94 @@
+// your header
+#include "2d_input.hpp"
+
+// c++ lib headers
+#include <cmath>
+
+// engine headers
+#include "engine/maths_core.hpp"
+
+namespace game2d {
+
+namespace player {
+
+void
+update_input(GameObject2D& obj, KeysAndState& keys, fightingengine::Application& app, GameObject2D& camera)
+{
+  keys.l_analogue_x = 0.0f;
+  keys.l_analogue_y = 0.0f;
+  keys.r_analogue_x = 0.0f;
+  keys.r_analogue_y = 0.0f;
+  keys.shoot_pressed = false;
+  keys.shoot_down = false;
+  keys.boost_pressed = false;
+  keys.pause_pressed = false;
+  keys.camera_x = 0.0f;
+  keys.camera_y = 0.0f;
+
+  // Keymaps: keyboard
+  if (keys.use_keyboard) {
+    if (app.get_input().get_key_held(keys.w)) {
+      keys.l_analogue_y = -1.0f;
+    } else if (app.get_input().get_key_held(keys.s)) {
+      keys.l_analogue_y = 1.0f;
+    } else {
+      keys.l_analogue_y = 0.0f;
+    }
+
+    if (app.get_input().get_key_held(keys.a)) {
+      keys.l_analogue_x = -1.0f;
+    } else if (app.get_input().get_key_held(keys.d)) {
+      keys.l_analogue_x = 1.0f;
+    } else {
+      keys.l_analogue_x = 0.0f;
+    }
+
+    keys.shoot_pressed = app.get_input().get_mouse_lmb_held();
+    keys.shoot_down = app.get_input().get_mouse_lmb_down();
+    keys.boost_pressed = app.get_input().get_key_held(keys.key_boost);
+    keys.pause_pressed = app.get_input().get_key_down(keys.key_pause);
+
+    glm::vec2 player_world_space_pos = gameobject_in_worldspace(camera, obj);
+    float mouse_angle_around_player = atan2(app.get_input().get_mouse_pos().y - player_world_space_pos.y,
+                                            app.get_input().get_mouse_pos().x - player_world_space_pos.x);
+
+    mouse_angle_around_player += fightingengine::HALF_PI;
+    keys.angle_around_player = mouse_angle_around_player;
+
+    float x_axis = glm::sin(mouse_angle_around_player);
+    float y_axis = -glm::cos(mouse_angle_around_player);
+    keys.r_analogue_x = x_axis;
+    keys.r_analogue_y = y_axis;
+  }
+
+  if (app.get_input().get_key_held(keys.key_camera_left))
+    keys.camera_x -= 1.0f;
+  if (app.get_input().get_key_held(keys.key_camera_right))
+    keys.camera_x += 1.0f;
+  if (app.get_input().get_key_held(keys.key_camera_up))
+    keys.camera_y -= 1.0f;
+  if (app.get_input().get_key_held(keys.key_camera_down))
+    keys.camera_y += 1.0f;
+
+  // }
+  // // Keymaps: Controller
+  // else {
+  //   l_analogue_x = app.get_input().get_axis_dir(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_LEFTX);
+  //   l_analogue_y = app.get_input().get_axis_dir(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_LEFTY);
+  //   r_analogue_x = app.get_input().get_axis_dir(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_RIGHTX);
+  //   r_analogue_y = app.get_input().get_axis_dir(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_RIGHTY);
+  //   shoot_pressed =
+  //     app.get_input().get_axis_held(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_TRIGGERRIGHT);
+  //   boost_pressed =
+  //     app.get_input().get_axis_held(controller, SDL_GameControllerAxis::SDL_CONTROLLER_AXIS_TRIGGERLEFT);
+  //   pause_pressed =
+  //     app.get_input().get_button_held(controller, SDL_GameControllerButton::SDL_CONTROLLER_BUTTON_START);
+
+  //   look_angle = atan2(r_analogue_y, r_analogue_x);
+  //   look_angle += HALF_PI;
+  // }
+};
+
+} // namespace player
+
+} // namespace game2d
@@ -0,0 +1,21 @@
+#pragma once
+
+// engine headers
+#include "engine/application.hpp"
+
+// game headers
+#include "2d_game_object.hpp"
+
+namespace game2d {
+
+namespace player {
+
+// fills keys from the keyboard and mouse. everything else only reads keys,
+// so a scripted input track (or a network client) can drive the game instead.
+// kept apart from the simulation, which has to build without SDL video or a window.
+void
+update_input(GameObject2D& obj, KeysAndState& keys, fightingengine::Application& app, GameObject2D& camera);
+
+} // namespace player
+
+} // namespace game2d
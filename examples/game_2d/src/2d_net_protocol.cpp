@@ -0,0 +1,132 @@
+// your header
+#include "2d_net_protocol.hpp"
+
+// c++ lib headers
+#include <algorithm>
+#include <cmath>
+
+// engine headers
+#include "engine/maths_core.hpp"
+
+namespace game2d {
+
+namespace net_protocol {
+
+static constexpr int type_bits = 4;
+static constexpr int move_bits = 8;  // signed, [-127, 127]
+static constexpr int angle_bits = 12;
+
+static int32_t
+quantise_move(float v)
+{
+  return static_cast<int32_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 127.0f));
+}
+
+static uint32_t
+quantise_aim(float radians)
+{
+  const float turns = radians / (2.0f * fightingengine::PI);
+  const float wrapped = turns - std::floor(turns);
+  return static_cast<uint32_t>(std::lround(wrapped * (1 << angle_bits))) & ((1 << angle_bits) - 1);
+}
+
+void
+write_welcome(const NetWelcome& welcome, fightingengine::BitWriter& out)
+{
+  out.write_bits(static_cast<uint32_t>(NetMessage::WELCOME), type_bits);
+  out.write_varuint(welcome.match_id);
+  out.write_varuint(welcome.player_id);
+  out.write_bits(welcome.tick, 32);
+  out.flush();
+}
+
+void
+write_input(const NetInput& input, fightingengine::BitWriter& out)
+{
+  out.write_bits(static_cast<uint32_t>(NetMessage::INPUT), type_bits);
+  out.write_bits(input.sequence, 32);
+  out.write_bool(input.has_ack);
+  if (input.has_ack)
+    out.write_bits(input.acked_tick, 32);
+  out.write_signed(quantise_move(input.move_x), move_bits);
+  out.write_signed(quantise_move(input.move_y), move_bits);
+  out.write_bits(quantise_aim(input.aim_radians), angle_bits);
+  out.write_bool(input.shoot);
+  out.write_bool(input.boost);
+  out.write_bool(input.weapon == Weapons::SHOVEL);
+  out.flush();
+}
+
+void
+write_snapshot_header(const NetSnapshotHeader& header, fightingengine::BitWriter& out)
+{
+  out.write_bits(static_cast<uint32_t>(NetMessage::SNAPSHOT), type_bits);
+  out.write_bits(header.last_input_sequence, 32);
+}
+
+NetMessage
+read_type(fightingengine::BitReader& in)
+{
+  const uint32_t type = in.read_bits(type_bits);
+  if (in.is_overflowed())
+    return NetMessage::INVALID;
+  switch (static_cast<NetMessage>(type)) {
+    case NetMessage::WELCOME:
+    case NetMessage::INPUT:
+    case NetMessage::SNAPSHOT:
+      return static_cast<NetMessage>(type);
+    default:
+      return NetMessage::INVALID;
+  }
+}
+
+bool
+read_welcome(fightingengine::BitReader& in, NetWelcome& welcome)
+{
+  welcome.match_id = in.read_varuint();
+  welcome.player_id = in.read_varuint();
+  welcome.tick = in.read_bits(32);
+  return !in.is_overflowed();
+}
+
+bool
+read_input(fightingengine::BitReader& in, NetInput& input)
+{
+  input.sequence = in.read_bits(32);
+  input.has_ack = in.read_bool();
+  input.acked_tick = input.has_ack ? in.read_bits(32) : 0;
+  input.move_x = in.read_signed(move_bits) / 127.0f;
+  input.move_y = in.read_signed(move_bits) / 127.0f;
+  input.aim_radians = in.read_bits(angle_bits) * (2.0f * fightingengine::PI / (1 << angle_bits));
+  input.shoot = in.read_bool();
+  input.boost = in.read_bool();
+  input.weapon = in.read_bool() ? Weapons::SHOVEL : Weapons::PISTOL;
+  return !in.is_overflowed();
+}
+
+bool
+read_snapshot_header(fightingengine::BitReader& in, NetSnapshotHeader& header)
+{
+  header.last_input_sequence = in.read_bits(32);
+  return !in.is_overflowed();
+}
+
+void
+apply_input(const NetInput& input, const NetInput& last, GameObject2D& player, KeysAndState& keys)
+{
+  // same as an input track in the bench: nothing from a keyboard, and a client can't pause a match
+  keys = KeysAndState();
+  keys.l_analogue_x = std::clamp(input.move_x, -1.0f, 1.0f);
+  keys.l_analogue_y = std::clamp(input.move_y, -1.0f, 1.0f);
+  keys.angle_around_player = input.aim_radians;
+  keys.r_analogue_x = std::sin(input.aim_radians);
+  keys.r_analogue_y = -std::cos(input.aim_radians);
+  keys.shoot_pressed = input.shoot;
+  keys.shoot_down = input.shoot && !last.shoot;
+  keys.boost_pressed = input.boost;
+  player.equipped_weapon = input.weapon;
+}
+
+} // namespace net_protocol
+
+} // namespace game2d
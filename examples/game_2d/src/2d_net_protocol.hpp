@@ -0,0 +1,79 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+
+// engine headers
+#include "engine/networking/bitstream.hpp"
+
+// game headers
+#include "2d_game_object.hpp"
+
+namespace game2d {
+
+// Every message starts with its type, then one of the structs below.
+// Welcome and snapshots go server to client, inputs client to server.
+enum class NetMessage : uint8_t
+{
+  WELCOME = 1,   // reliable, once, when the client is put in a match
+  INPUT = 2,     // unreliable, every client tick
+  SNAPSHOT = 3,  // unreliable, every server tick: NetSnapshotHeader then a snapshot::encode()
+  INVALID = 15,
+};
+
+struct NetWelcome
+{
+  uint32_t match_id = 0;
+  uint32_t player_id = 0; // the client's entity in snapshots
+  uint32_t tick = 0;      // the match's tick when the client joined
+};
+
+struct NetInput
+{
+  uint32_t sequence = 0; // counts up from 1, so the server can drop old ones that arrive late
+  bool has_ack = false;
+  uint32_t acked_tick = 0; // newest snapshot the client decoded
+  float move_x = 0.0f;     // [-1, 1]
+  float move_y = 0.0f;
+  float aim_radians = 0.0f;
+  bool shoot = false;
+  bool boost = false;
+  Weapons weapon = Weapons::PISTOL;
+};
+
+struct NetSnapshotHeader
+{
+  uint32_t last_input_sequence = 0; // the newest input from this client that went in to the snapshot
+};
+
+namespace net_protocol {
+
+void
+write_welcome(const NetWelcome& welcome, fightingengine::BitWriter& out);
+
+void
+write_input(const NetInput& input, fightingengine::BitWriter& out);
+
+// the snapshot is written straight after, in to the same writer
+void
+write_snapshot_header(const NetSnapshotHeader& header, fightingengine::BitWriter& out);
+
+// INVALID if the message is empty or unknown
+[[nodiscard]] NetMessage
+read_type(fightingengine::BitReader& in);
+
+// these return false if the message was cut short
+bool
+read_welcome(fightingengine::BitReader& in, NetWelcome& welcome);
+bool
+read_input(fightingengine::BitReader& in, NetInput& input);
+bool
+read_snapshot_header(fightingengine::BitReader& in, NetSnapshotHeader& header);
+
+// fills a player's keys for this tick. last is the input applied the tick before, for shoot_down
+void
+apply_input(const NetInput& input, const NetInput& last, GameObject2D& player, KeysAndState& keys);
+
+} // namespace net_protocol
+
+} // namespace game2d
@@ -0,0 +1,51 @@
+// your header
+#include "2d_net_snapshot.hpp"
+
+// c++ lib headers
+#include <algorithm>
+#include <vector>
+
+namespace game2d {
+
+namespace net_snapshot {
+
+static void
+add_entities(const std::vector<GameObject2D>& objs,
+             const fightingengine::SnapshotSchema& schema,
+             fightingengine::Snapshot& snapshot)
+{
+  using namespace fightingengine;
+  for (const GameObject2D& obj : objs) {
+    NetEntityState e;
+    e.id = obj.id;
+    e.type = static_cast<uint8_t>(obj.collision_layer);
+    e.flags |= obj.do_render ? NET_FLAG_RENDER : 0;
+    e.flags |= obj.invulnerable ? NET_FLAG_INVULNERABLE : 0;
+    e.flags |= obj.flash_time_left > 0.0f ? NET_FLAG_FLASHING : 0;
+    e.health = static_cast<uint8_t>(std::clamp(obj.hits_able_to_be_taken - obj.hits_taken, 0, 255));
+    e.pos_x = snapshot::quantise_position(schema, obj.pos.x);
+    e.pos_y = snapshot::quantise_position(schema, obj.pos.y);
+    e.angle = snapshot::quantise_angle(schema, obj.angle_radians);
+    e.vel_x = snapshot::quantise_velocity(schema, obj.velocity.x);
+    e.vel_y = snapshot::quantise_velocity(schema, obj.velocity.y);
+    snapshot.entities.push_back(e);
+  }
+}
+
+fightingengine::Snapshot
+make(const GameState& state, uint32_t tick, const fightingengine::SnapshotSchema& schema)
+{
+  fightingengine::Snapshot snapshot;
+  snapshot.tick = tick;
+  snapshot.entities.reserve(state.entities_player.size() + state.entities_enemies.size() +
+                            state.entities_bullets.size());
+  add_entities(state.entities_player, schema, snapshot);
+  add_entities(state.entities_enemies, schema, snapshot);
+  add_entities(state.entities_bullets, schema, snapshot);
+  fightingengine::snapshot::sort_by_id(snapshot);
+  return snapshot;
+}
+
+} // namespace net_snapshot
+
+} // namespace game2d
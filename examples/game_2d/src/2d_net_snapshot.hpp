@@ -0,0 +1,31 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+
+// engine headers
+#include "engine/networking/snapshot.hpp"
+
+// game headers
+#include "2d_game.hpp"
+
+namespace game2d {
+
+// bits in NetEntityState::flags
+enum NetEntityFlags : uint8_t
+{
+  NET_FLAG_RENDER = 1 << 0,
+  NET_FLAG_INVULNERABLE = 1 << 1,
+  NET_FLAG_FLASHING = 1 << 2,
+};
+
+namespace net_snapshot {
+
+// players, enemies and bullets, the entities that move. type is the collision layer,
+// health is the hits the entity can still take.
+[[nodiscard]] fightingengine::Snapshot
+make(const GameState& state, uint32_t tick, const fightingengine::SnapshotSchema& schema);
+
+} // namespace net_snapshot
+
+} // namespace game2d
@@ -4,6 +4,7 @@
 // engine headers
 #include "engine/grid.hpp"
 #include "engine/maths_core.hpp"
+#include "engine/tools/zone_profiler.hpp"
 
 namespace game2d {
 
@@ -119,32 +120,47 @@ void
 generate_filtered_broadphase_collisions(std::vector<std::reference_wrapper<GameObject2D>>& collidable,
                                         std::map<uint64_t, Collision2D>& filtered_collisions)
 {
+  PROFILE_ZONE("physics::broadphase");
+
   // Do broad-phase check.
   std::map<uint64_t, Collision2D> collisions;
 
   // Sort entities by X-axis
   std::vector<std::reference_wrapper<GameObject2D>> sorted_collidable_x = collidable;
-  std::sort(sorted_collidable_x.begin(),
-            sorted_collidable_x.end(),
-            [](std::reference_wrapper<GameObject2D> a, std::reference_wrapper<GameObject2D> b) {
-              return a.get().pos.x < b.get().pos.x;
-            });
+  {
+    PROFILE_ZONE("physics::sort_x");
+    std::sort(sorted_collidable_x.begin(),
+              sorted_collidable_x.end(),
+              [](std::reference_wrapper<GameObject2D> a, std::reference_wrapper<GameObject2D> b) {
+                return a.get().pos.x < b.get().pos.x;
+              });
+  }
   // SAP x-axis
   std::vector<std::pair<int, int>> potential_collisions_x;
-  generate_broadphase_collisions(sorted_collidable_x, COLLISION_AXIS::X, collisions);
+  {
+    PROFILE_ZONE("physics::sap_x");
+    generate_broadphase_collisions(sorted_collidable_x, COLLISION_AXIS::X, collisions);
+  }
 
   // Sort entities by Y-axis
   std::vector<std::reference_wrapper<GameObject2D>> sorted_collidable_y = collidable;
-  std::sort(sorted_collidable_y.begin(),
-            sorted_collidable_y.end(),
-            [](std::reference_wrapper<GameObject2D> a, std::reference_wrapper<GameObject2D> b) {
-              return a.get().pos.y < b.get().pos.y;
-            });
+  {
+    PROFILE_ZONE("physics::sort_y");
+    std::sort(sorted_collidable_y.begin(),
+              sorted_collidable_y.end(),
+              [](std::reference_wrapper<GameObject2D> a, std::reference_wrapper<GameObject2D> b) {
+                return a.get().pos.y < b.get().pos.y;
+              });
+  }
   // SAP y-axis
   std::vector<std::pair<int, int>> potential_collisions_y;
-  generate_broadphase_collisions(sorted_collidable_y, COLLISION_AXIS::Y, collisions);
+  {
+    PROFILE_ZONE("physics::sap_y");
+    generate_broadphase_collisions(sorted_collidable_y, COLLISION_AXIS::Y, collisions);
+  }
 
   // use broad-phase results....
+  PROFILE_ZONE("physics::filter_pairs");
   for (auto& coll : collisions) {
     Collision2D c = coll.second;
     if (c.collision_x && c.collision_y) {
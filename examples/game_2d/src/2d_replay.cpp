@@ -0,0 +1,585 @@
+// your header
+#include "2d_replay.hpp"
+
+// c++ lib headers
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// engine headers
+#include "engine/tools/logger.hpp"
+
+// game headers
+#include "2d_state_hash.hpp"
+
+namespace game2d {
+
+static constexpr uint32_t replay_magic = 0x52443246; // "F2DR"
+static constexpr uint32_t replay_version = 4; // 4: state hashes leave out the id counters
+
+//
+// values, bit for bit
+//
+
+static uint32_t
+float_bits(float value)
+{
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static float
+bits_float(uint32_t bits)
+{
+  float value = 0.0f;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static uint32_t
+get_cvar_bits(const fightingengine::CVarBase& cvar)
+{
+  switch (cvar.get_type()) {
+    case fightingengine::CVarBase::Type::Int:
+      return static_cast<uint32_t>(static_cast<const fightingengine::CVar<int>&>(cvar).get());
+    case fightingengine::CVarBase::Type::Float:
+      return float_bits(static_cast<const fightingengine::CVar<float>&>(cvar).get());
+    case fightingengine::CVarBase::Type::Bool:
+      return static_cast<const fightingengine::CVar<bool>&>(cvar).get() ? 1 : 0;
+  }
+  return 0;
+}
+
+static void
+set_cvar(const ReplayCVar& recorded, uint32_t bits)
+{
+  fightingengine::CVarBase* cvar = fightingengine::cvars::find(recorded.name);
+  if (cvar == nullptr || cvar->get_type() != recorded.type) {
+    FE_LOG_WARN("(replay) cvar {} isn't in this build, playback may differ", recorded.name);
+    return;
+  }
+  switch (recorded.type) {
+    case fightingengine::CVarBase::Type::Int:
+      static_cast<fightingengine::CVar<int>*>(cvar)->set(static_cast<int>(bits));
+      break;
+    case fightingengine::CVarBase::Type::Float:
+      static_cast<fightingengine::CVar<float>*>(cvar)->set(bits_float(bits));
+      break;
+    case fightingengine::CVarBase::Type::Bool:
+      static_cast<fightingengine::CVar<bool>*>(cvar)->set(bits != 0);
+      break;
+  }
+}
+
+//
+// frames
+//
+
+static void
+write_float(fightingengine::BitWriter& out, float value)
+{
+  out.write_bits(float_bits(value), 32);
+}
+
+static float
+read_float(fightingengine::BitReader& in)
+{
+  return bits_float(in.read_bits(32));
+}
+
+// a changed bit, then the value if it changed
+static void
+write_float_delta(fightingengine::BitWriter& out, float value, float base)
+{
+  const bool changed = float_bits(value) != float_bits(base);
+  out.write_bool(changed);
+  if (changed)
+    write_float(out, value);
+}
+
+static float
+read_float_delta(fightingengine::BitReader& in, float base)
+{
+  return in.read_bool() ? read_float(in) : base;
+}
+
+// a bool that changed can only have flipped, so the changed bit is all there is
+static void
+write_bool_delta(fightingengine::BitWriter& out, bool value, bool base)
+{
+  out.write_bool(value != base);
+}
+
+static bool
+read_bool_delta(fightingengine::BitReader& in, bool base)
+{
+  return in.read_bool() ? !base : base;
+}
+
+// a count from the file, read before the things it counts. false if there can't be that many
+// in what's left, each taking at least min_bits, so a bad count isn't allocated for
+static bool
+read_count(fightingengine::BitReader& in, size_t min_bits, size_t& count)
+{
+  count = in.read_varuint();
+  return !in.is_overflowed() && count <= in.get_bits_remaining() / min_bits;
+}
+
+static bool
+same_input(const ReplayPlayerInput& a, const ReplayPlayerInput& b)
+{
+  const KeysAndState& x = a.keys;
+  const KeysAndState& y = b.keys;
+  return a.weapon == b.weapon && x.use_keyboard == y.use_keyboard &&
+         float_bits(x.l_analogue_x) == float_bits(y.l_analogue_x) &&
+         float_bits(x.l_analogue_y) == float_bits(y.l_analogue_y) &&
+         float_bits(x.r_analogue_x) == float_bits(y.r_analogue_x) &&
+         float_bits(x.r_analogue_y) == float_bits(y.r_analogue_y) &&
+         float_bits(x.angle_around_player) == float_bits(y.angle_around_player) &&
+         x.pause_pressed == y.pause_pressed && x.shoot_pressed == y.shoot_pressed && x.shoot_down == y.shoot_down &&
+         x.boost_pressed == y.boost_pressed && float_bits(x.camera_x) == float_bits(y.camera_x) &&
+         float_bits(x.camera_y) == float_bits(y.camera_y);
+}
+
+static void
+write_player(fightingengine::BitWriter& out, const ReplayPlayerInput& in, const ReplayPlayerInput& base)
+{
+  const bool changed = !same_input(in, base);
+  out.write_bool(changed);
+  if (!changed)
+    return;
+
+  const KeysAndState& k = in.keys;
+  const KeysAndState& b = base.keys;
+  write_bool_delta(out, k.use_keyboard, b.use_keyboard);
+  write_float_delta(out, k.l_analogue_x, b.l_analogue_x);
+  write_float_delta(out, k.l_analogue_y, b.l_analogue_y);
+  write_float_delta(out, k.r_analogue_x, b.r_analogue_x);
+  write_float_delta(out, k.r_analogue_y, b.r_analogue_y);
+  write_float_delta(out, k.angle_around_player, b.angle_around_player);
+  write_bool_delta(out, k.pause_pressed, b.pause_pressed);
+  write_bool_delta(out, k.shoot_pressed, b.shoot_pressed);
+  write_bool_delta(out, k.shoot_down, b.shoot_down);
+  write_bool_delta(out, k.boost_pressed, b.boost_pressed);
+  write_float_delta(out, k.camera_x, b.camera_x);
+  write_float_delta(out, k.camera_y, b.camera_y);
+  out.write_bool(in.weapon != base.weapon);
+  if (in.weapon != base.weapon)
+    out.write_bits(static_cast<uint32_t>(in.weapon), 2);
+}
+
+static void
+read_player(fightingengine::BitReader& in, ReplayPlayerInput& player, const ReplayPlayerInput& base)
+{
+  player = base;
+  if (!in.read_bool())
+    return;
+
+  KeysAndState& k = player.keys;
+  const KeysAndState& b = base.keys;
+  k.use_keyboard = read_bool_delta(in, b.use_keyboard);
+  k.l_analogue_x = read_float_delta(in, b.l_analogue_x);
+  k.l_analogue_y = read_float_delta(in, b.l_analogue_y);
+  k.r_analogue_x = read_float_delta(in, b.r_analogue_x);
+  k.r_analogue_y = read_float_delta(in, b.r_analogue_y);
+  k.angle_around_player = read_float_delta(in, b.angle_around_player);
+  k.pause_pressed = read_bool_delta(in, b.pause_pressed);
+  k.shoot_pressed = read_bool_delta(in, b.shoot_pressed);
+  k.shoot_down = read_bool_delta(in, b.shoot_down);
+  k.boost_pressed = read_bool_delta(in, b.boost_pressed);
+  k.camera_x = read_float_delta(in, b.camera_x);
+  k.camera_y = read_float_delta(in, b.camera_y);
+  if (in.read_bool())
+    player.weapon = static_cast<Weapons>(in.read_bits(2));
+}
+
+static void
+write_event(fightingengine::BitWriter& out, const ReplayEvent& e)
+{
+  out.write_bits(static_cast<uint32_t>(e.type), 2);
+  switch (e.type) {
+    case ReplayEvent::Type::TREE:
+      write_float(out, e.pos.x);
+      write_float(out, e.pos.y);
+      break;
+    case ReplayEvent::Type::SCENARIO: {
+      const ScenarioConfig& s = e.scenario;
+      out.write_bits(s.seed, 32);
+      write_float(out, s.radius);
+      out.write_varuint(static_cast<uint32_t>(s.enemies));
+      out.write_bool(s.enemy_layout == ScenarioLayout::SWARMS);
+      out.write_varuint(static_cast<uint32_t>(s.swarms));
+      write_float(out, s.swarm_radius);
+      out.write_varuint(static_cast<uint32_t>(s.bullets));
+      out.write_varuint(static_cast<uint32_t>(s.trees));
+      out.write_varuint(static_cast<uint32_t>(s.splats));
+      break;
+    }
+    case ReplayEvent::Type::CVAR:
+      out.write_varuint(e.cvar);
+      out.write_bits(e.cvar_bits, 32);
+      break;
+  }
+}
+
+static void
+read_event(fightingengine::BitReader& in, ReplayEvent& e)
+{
+  e = ReplayEvent();
+  e.type = static_cast<ReplayEvent::Type>(in.read_bits(2));
+  switch (e.type) {
+    case ReplayEvent::Type::TREE:
+      e.pos.x = read_float(in);
+      e.pos.y = read_float(in);
+      break;
+    case ReplayEvent::Type::SCENARIO: {
+      ScenarioConfig& s = e.scenario;
+      s.seed = in.read_bits(32);
+      s.radius = read_float(in);
+      s.enemies = static_cast<int>(in.read_varuint());
+      s.enemy_layout = in.read_bool() ? ScenarioLayout::SWARMS : ScenarioLayout::SPREAD;
+      s.swarms = static_cast<int>(in.read_varuint());
+      s.swarm_radius = read_float(in);
+      s.bullets = static_cast<int>(in.read_varuint());
+      s.trees = static_cast<int>(in.read_varuint());
+      s.splats = static_cast<int>(in.read_varuint());
+      break;
+    }
+    case ReplayEvent::Type::CVAR:
+      e.cvar = in.read_varuint();
+      e.cvar_bits = in.read_bits(32);
+      break;
+  }
+}
+
+static void
+write_frame(fightingengine::BitWriter& out, const ReplayFrame& frame, const ReplayFrame& base)
+{
+  write_float_delta(out, frame.delta_time_s, base.delta_time_s);
+  out.write_bool(frame.physics);
+  out.write_bool(frame.player_attacks_enabled);
+
+  const bool resized = frame.screen_wh != base.screen_wh;
+  out.write_bool(resized);
+  if (resized) {
+    out.write_varuint(static_cast<uint32_t>(frame.screen_wh.x));
+    out.write_varuint(static_cast<uint32_t>(frame.screen_wh.y));
+  }
+
+  const bool players_changed = frame.players.size() != base.players.size();
+  out.write_bool(players_changed);
+  if (players_changed)
+    out.write_varuint(static_cast<uint32_t>(frame.players.size()));
+  const ReplayPlayerInput nobody;
+  for (size_t i = 0; i < frame.players.size(); i++)
+    write_player(out, frame.players[i], i < base.players.size() ? base.players[i] : nobody);
+
+  out.write_bool(!frame.events.empty());
+  if (!frame.events.empty()) {
+    out.write_varuint(static_cast<uint32_t>(frame.events.size()));
+    for (const ReplayEvent& e : frame.events)
+      write_event(out, e);
+  }
+  out.write_bits(frame.state_hash, 32);
+}
+
+// false if a count in the frame is more than the data left could hold
+static bool
+read_frame(fightingengine::BitReader& in, ReplayFrame& frame, const ReplayFrame& base)
+{
+  frame.delta_time_s = read_float_delta(in, base.delta_time_s);
+  frame.physics = in.read_bool();
+  frame.player_attacks_enabled = in.read_bool();
+
+  frame.screen_wh = base.screen_wh;
+  if (in.read_bool()) {
+    frame.screen_wh.x = static_cast<int>(in.read_varuint());
+    frame.screen_wh.y = static_cast<int>(in.read_varuint());
+  }
+
+  size_t players = base.players.size();
+  if (in.read_bool() && !read_count(in, 1, players)) // an unchanged player is 1 bit
+    return false;
+  frame.players.resize(players);
+  const ReplayPlayerInput nobody;
+  for (size_t i = 0; i < players; i++)
+    read_player(in, frame.players[i], i < base.players.size() ? base.players[i] : nobody);
+
+  frame.events.clear();
+  if (in.read_bool()) {
+    size_t events = 0;
+    if (!read_count(in, 2, events)) // the event type is 2 bits
+      return false;
+    frame.events.resize(events);
+    for (ReplayEvent& e : frame.events)
+      read_event(in, e);
+  }
+  frame.state_hash = in.read_bits(32);
+  return true;
+}
+
+//
+// files
+//
+
+namespace replay {
+
+bool
+save(const std::string& path, const Replay& replay)
+{
+  const ReplayHeader& h = replay.header;
+  fightingengine::BitWriter out;
+  out.write_bits(replay_magic, 32);
+  out.write_bits(replay_version, 32);
+  out.write_bits(h.seed, 32);
+  out.write_varuint(static_cast<uint32_t>(h.screen_wh.x));
+  out.write_varuint(static_cast<uint32_t>(h.screen_wh.y));
+  out.write_bits(h.entity_id_counter, 32);
+  out.write_bits(h.attack_id_counter, 32);
+  out.write_bits(h.frames, 32);
+  out.write_varuint(static_cast<uint32_t>(h.cvars.size()));
+  for (const ReplayCVar& cvar : h.cvars) {
+    out.write_varuint(static_cast<uint32_t>(cvar.name.size()));
+    for (char c : cvar.name)
+      out.write_bits(static_cast<uint8_t>(c), 8);
+    out.write_bits(static_cast<uint32_t>(cvar.type), 2);
+    out.write_bits(cvar.bits, 32);
+  }
+  out.flush();
+
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open())
+    return false;
+  file.write(reinterpret_cast<const char*>(out.get_bytes().data()), out.get_bytes().size());
+  file.write(reinterpret_cast<const char*>(replay.frame_bytes.data()), replay.frame_bytes.size());
+  return file.good();
+}
+
+bool
+load(const std::string& path, Replay& replay)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+    return false;
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  fightingengine::BitReader in(bytes.data(), bytes.size());
+  if (in.read_bits(32) != replay_magic || in.read_bits(32) != replay_version)
+    return false;
+  ReplayHeader& h = replay.header;
+  h = ReplayHeader();
+  h.seed = in.read_bits(32);
+  h.screen_wh.x = static_cast<int>(in.read_varuint());
+  h.screen_wh.y = static_cast<int>(in.read_varuint());
+  h.entity_id_counter = in.read_bits(32);
+  h.attack_id_counter = in.read_bits(32);
+  h.frames = in.read_bits(32);
+  size_t cvar_count = 0;
+  if (!read_count(in, 1, cvar_count))
+    return false;
+  for (size_t i = 0; i < cvar_count && !in.is_overflowed(); i++) {
+    ReplayCVar cvar;
+    size_t name_size = 0;
+    if (!read_count(in, 8, name_size))
+      return false;
+    cvar.name.resize(name_size);
+    for (char& c : cvar.name)
+      c = static_cast<char>(in.read_bits(8));
+    cvar.type = static_cast<fightingengine::CVarBase::Type>(in.read_bits(2));
+    cvar.bits = in.read_bits(32);
+    h.cvars.push_back(std::move(cvar));
+  }
+  if (in.is_overflowed())
+    return false;
+
+  const size_t header_bytes = (in.get_bits_read() + 7) / 8;
+  replay.frame_bytes.assign(bytes.begin() + header_bytes, bytes.end());
+  return true;
+}
+
+void
+begin(const Replay& replay, GameState& state)
+{
+  for (const ReplayCVar& cvar : replay.header.cvars)
+    set_cvar(cvar, cvar.bits);
+  GameObject2D::set_id_counter(replay.header.entity_id_counter);
+  Attack::set_id_counter(replay.header.attack_id_counter);
+  game::init(state, replay.header.screen_wh, replay.header.seed);
+}
+
+void
+apply_before_update(GameState& state, const ReplayFrame& frame)
+{
+  state.screen_wh = frame.screen_wh;
+  for (const ReplayEvent& e : frame.events) {
+    if (e.type == ReplayEvent::Type::TREE)
+      game::place_tree(state, e.pos);
+  }
+  for (size_t i = 0; i < frame.players.size() && i < state.player_keys.size(); i++) {
+    state.player_keys[i] = frame.players[i].keys;
+    if (i < state.entities_player.size())
+      state.entities_player[i].equipped_weapon = frame.players[i].weapon;
+  }
+  state.player_attacks_enabled = frame.player_attacks_enabled;
+}
+
+void
+apply_after_update(GameState& state, const ReplayFrame& frame, const std::vector<ReplayCVar>& cvars)
+{
+  for (const ReplayEvent& e : frame.events) {
+    if (e.type == ReplayEvent::Type::SCENARIO)
+      scenario::populate(state, e.scenario);
+    else if (e.type == ReplayEvent::Type::CVAR && e.cvar < cvars.size())
+      set_cvar(cvars[e.cvar], e.cvar_bits);
+  }
+}
+
+void
+step(GameState& state, const ReplayFrame& frame, const std::vector<ReplayCVar>& cvars)
+{
+  if (frame.physics)
+    game::update_physics(state);
+  apply_before_update(state, frame);
+  game::update(state, frame.delta_time_s);
+  apply_after_update(state, frame, cvars);
+}
+
+bool
+check(const GameState& state, const ReplayFrame& frame)
+{
+  return static_cast<uint32_t>(state_hash::hash(state)) == frame.state_hash;
+}
+
+} // namespace replay
+
+//
+// ReplayReader
+//
+
+ReplayReader::ReplayReader(const Replay& replay)
+  : replay(replay)
+  , reader(replay.frame_bytes.data(), replay.frame_bytes.size())
+{
+  previous.screen_wh = replay.header.screen_wh;
+}
+
+bool
+ReplayReader::next(ReplayFrame& frame)
+{
+  if (corrupt || frame_index >= replay.header.frames)
+    return false;
+  if (!read_frame(reader, frame, previous) || reader.is_overflowed()) {
+    corrupt = true;
+    return false;
+  }
+  previous = frame;
+  frame_index += 1;
+  return true;
+}
+
+//
+// ReplayRecorder
+//
+
+void
+ReplayRecorder::start(uint32_t seed, glm::ivec2 screen_wh)
+{
+  replay = Replay();
+  replay.header.seed = seed;
+  replay.header.screen_wh = screen_wh;
+  replay.header.entity_id_counter = GameObject2D::get_id_counter();
+  replay.header.attack_id_counter = Attack::get_id_counter();
+
+  cvars = fightingengine::cvars::get_all();
+  cvar_bits.clear();
+  for (const fightingengine::CVarBase* cvar : cvars) {
+    cvar_bits.push_back(get_cvar_bits(*cvar));
+    replay.header.cvars.push_back({ cvar->get_name(), cvar->get_type(), cvar_bits.back() });
+  }
+
+  writer.reset();
+  frame = ReplayFrame();
+  previous = ReplayFrame();
+  previous.screen_wh = screen_wh;
+  recording = true;
+  captured = false;
+}
+
+void
+ReplayRecorder::add_tree(glm::vec2 world_pos)
+{
+  if (!recording)
+    return;
+  ReplayEvent e;
+  e.type = ReplayEvent::Type::TREE;
+  e.pos = world_pos;
+  frame.events.push_back(e);
+}
+
+void
+ReplayRecorder::capture(const GameState& state, float delta_time_s, bool physics)
+{
+  if (!recording)
+    return;
+  frame.delta_time_s = delta_time_s;
+  frame.physics = physics;
+  frame.player_attacks_enabled = state.player_attacks_enabled;
+  frame.screen_wh = state.screen_wh;
+  frame.players.resize(state.player_keys.size());
+  for (size_t i = 0; i < state.player_keys.size(); i++) {
+    frame.players[i].keys = state.player_keys[i];
+    if (i < state.entities_player.size())
+      frame.players[i].weapon = state.entities_player[i].equipped_weapon;
+  }
+  captured = true;
+}
+
+void
+ReplayRecorder::add_scenario(const ScenarioConfig& config)
+{
+  if (!recording)
+    return;
+  ReplayEvent e;
+  e.type = ReplayEvent::Type::SCENARIO;
+  e.scenario = config;
+  frame.events.push_back(e);
+}
+
+void
+ReplayRecorder::end_frame(const GameState& state)
+{
+  if (!recording || !captured)
+    return;
+
+  for (size_t i = 0; i < cvars.size(); i++) {
+    const uint32_t bits = get_cvar_bits(*cvars[i]);
+    if (bits == cvar_bits[i])
+      continue;
+    cvar_bits[i] = bits;
+    ReplayEvent e;
+    e.type = ReplayEvent::Type::CVAR;
+    e.cvar = static_cast<uint32_t>(i);
+    e.cvar_bits = bits;
+    frame.events.push_back(e);
+  }
+  frame.state_hash = static_cast<uint32_t>(state_hash::hash(state));
+
+  write_frame(writer, frame, previous);
+  previous = frame;
+  frame.events.clear();
+  replay.header.frames += 1;
+  captured = false;
+}
+
+Replay
+ReplayRecorder::get_replay() const
+{
+  Replay out = replay;
+  fightingengine::BitWriter tail = writer; // flushing pads to a byte, the recording may go on
+  tail.flush();
+  out.frame_bytes = tail.get_bytes();
+  return out;
+}
+
+} // namespace game2d
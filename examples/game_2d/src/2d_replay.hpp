@@ -0,0 +1,165 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// other lib headers
+#include <glm/glm.hpp>
+
+// engine headers
+#include "engine/networking/bitstream.hpp"
+#include "engine/tools/cvars.hpp"
+
+// game headers
+#include "2d_game.hpp"
+#include "2d_game_object.hpp"
+#include "2d_scenario.hpp"
+
+namespace game2d {
+
+// What the simulation reads from one player each frame
+struct ReplayPlayerInput
+{
+  KeysAndState keys;
+  Weapons weapon = Weapons::PISTOL;
+};
+
+// Something done to the world that isn't a player's input
+struct ReplayEvent
+{
+  enum class Type : uint8_t
+  {
+    TREE,     // placed in the editor, before update()
+    SCENARIO, // spawned from the ui, after update()
+    CVAR,     // changed from the console, after update()
+  };
+  Type type = Type::TREE;
+  glm::vec2 pos{ 0.0f };
+  ScenarioConfig scenario;
+  uint32_t cvar = 0; // index in to the replay's cvars
+  uint32_t cvar_bits = 0;
+};
+
+// Everything one frame of the game loop fed the simulation, in the order it's applied:
+//   update_physics() if physics, events before update(), the inputs, update(), events after update()
+struct ReplayFrame
+{
+  float delta_time_s = 0.0f;
+  bool physics = true; // it doesn't run while paused
+  bool player_attacks_enabled = true;
+  glm::ivec2 screen_wh{ 0 };
+  std::vector<ReplayPlayerInput> players;
+  std::vector<ReplayEvent> events;
+  uint32_t state_hash = 0; // the low half of state_hash::hash() once the frame is done
+};
+
+struct ReplayCVar
+{
+  std::string name;
+  fightingengine::CVarBase::Type type = fightingengine::CVarBase::Type::Int;
+  uint32_t bits = 0; // the value as it is in memory, so floats come back exactly
+};
+
+// What the world was before the first frame
+struct ReplayHeader
+{
+  uint32_t seed = 0;
+  glm::ivec2 screen_wh{ 0 };
+  uint32_t entity_id_counter = 0;
+  uint32_t attack_id_counter = 0;
+  uint32_t frames = 0;
+  std::vector<ReplayCVar> cvars;
+};
+
+// A recorded session: the header, then every frame delta encoded against the one before.
+// A frame where nothing changed is a few bits, a float that changed is 32 bits exactly as it was,
+// a bool that changed is just the bit that says so. Every frame ends with the 32 bit state hash,
+// so playback can tell which frame it stopped matching the recording on.
+struct Replay
+{
+  ReplayHeader header;
+  std::vector<uint8_t> frame_bytes;
+};
+
+namespace replay {
+
+bool
+save(const std::string& path, const Replay& replay);
+
+// false if path isn't a replay, is from a different version, or its header is cut short
+bool
+load(const std::string& path, Replay& replay);
+
+// the world as it was when recording started: the cvars, the id counters, then game::init() with the seed
+void
+begin(const Replay& replay, GameState& state);
+
+// one frame, the way main.cpp's loop runs it. split up so a caller can time the stages
+void
+apply_before_update(GameState& state, const ReplayFrame& frame);
+void
+apply_after_update(GameState& state, const ReplayFrame& frame, const std::vector<ReplayCVar>& cvars);
+void
+step(GameState& state, const ReplayFrame& frame, const std::vector<ReplayCVar>& cvars);
+
+// false if state isn't what it was when the frame was recorded
+[[nodiscard]] bool
+check(const GameState& state, const ReplayFrame& frame);
+
+} // namespace replay
+
+// Decodes a Replay's frames in order
+class ReplayReader
+{
+public:
+  explicit ReplayReader(const Replay& replay);
+
+  // false once every frame has been read, or if the data is cut short or has a count the rest can't hold
+  bool next(ReplayFrame& frame);
+  [[nodiscard]] uint32_t get_frame() const { return frame_index; }
+  [[nodiscard]] bool is_corrupt() const { return corrupt; }
+
+private:
+  const Replay& replay;
+  fightingengine::BitReader reader;
+  ReplayFrame previous;
+  uint32_t frame_index = 0;
+  bool corrupt = false;
+};
+
+// Records the game loop, a frame at a time:
+//   recorder.start(seed, screen_wh);          after the GameState is made, before game::init()
+//   every frame:
+//     recorder.add_tree(world_pos);          as trees are placed
+//     recorder.capture(state, dt, physics);  just before update()
+//     recorder.add_scenario(config);         as scenarios are spawned
+//     recorder.end_frame(state);             at the end of the frame, picks up cvar changes
+//   replay::save(path, recorder.get_replay());
+class ReplayRecorder
+{
+public:
+  void start(uint32_t seed, glm::ivec2 screen_wh);
+  [[nodiscard]] bool is_recording() const { return recording; }
+
+  void add_tree(glm::vec2 world_pos);
+  void capture(const GameState& state, float delta_time_s, bool physics);
+  void add_scenario(const ScenarioConfig& config);
+  void end_frame(const GameState& state);
+
+  // the frames so far
+  [[nodiscard]] Replay get_replay() const;
+
+private:
+  Replay replay;
+  fightingengine::BitWriter writer;
+  ReplayFrame frame;
+  ReplayFrame previous;
+  std::vector<fightingengine::CVarBase*> cvars; // in the same order as the header's
+  std::vector<uint32_t> cvar_bits;               // their values as of the last frame
+  bool recording = false;
+  bool captured = false;
+};
+
+} // namespace game2d
@@ -0,0 +1,396 @@
+// your header
+#include "2d_rollback.hpp"
+
+// c++ lib headers
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+// engine headers
+#include "engine/tools/zone_profiler.hpp"
+
+namespace game2d {
+
+static_assert(std::is_trivially_copyable_v<SimEntity>);
+static_assert(std::is_trivially_copyable_v<SimHeader>);
+static_assert(std::is_trivially_copyable_v<Attack>);
+static_assert(std::is_trivially_copyable_v<KeysAndState>);
+
+namespace rollback {
+
+static void
+pack(const GameObject2D& obj, SimEntity& e)
+{
+  std::memset(&e, 0, sizeof(e)); // padding too
+  e.id = obj.id;
+  e.do_render = obj.do_render;
+  e.do_lifecycle_timed = obj.do_lifecycle_timed;
+  e.do_lifecycle_health = obj.do_lifecycle_health;
+  e.do_physics = obj.do_physics;
+  e.flag_for_delete = obj.flag_for_delete;
+  e.invulnerable = obj.invulnerable;
+
+  e.tex_slot = obj.tex_slot;
+  e.sprite = obj.sprite;
+  e.pos = obj.pos;
+  e.angle_radians = obj.angle_radians;
+  e.colour = obj.colour;
+  e.render_size = obj.render_size;
+  e.physics_size = obj.physics_size;
+  e.collision_layer = obj.collision_layer;
+
+  e.speed_current = obj.speed_current;
+  e.speed_default = obj.speed_default;
+  e.velocity = obj.velocity;
+  e.velocity_boost_modifier = obj.velocity_boost_modifier;
+  e.shift_boost_time = obj.shift_boost_time;
+  e.shift_boost_time_left = obj.shift_boost_time_left;
+
+  // the end of the list is the highest priority, keep that
+  const size_t ai_count = std::min(obj.ai_priority_list.size(), static_cast<size_t>(SimEntity::max_ai_behaviours));
+  e.ai_behaviour_count = static_cast<int>(ai_count);
+  std::copy(obj.ai_priority_list.end() - ai_count, obj.ai_priority_list.end(), e.ai_priority_list);
+  e.approach_theta_degrees = obj.approach_theta_degrees;
+
+  e.equipped_weapon = obj.equipped_weapon;
+  e.bullet_seconds_between_spawning = obj.bullet_seconds_between_spawning;
+  e.bullet_seconds_between_spawning_left = obj.bullet_seconds_between_spawning_left;
+  e.bullets_in_a_clip = obj.bullets_in_a_clip;
+  e.bullets_in_a_clip_left = obj.bullets_in_a_clip_left;
+  e.reload_time = obj.reload_time;
+  e.reload_time_left = obj.reload_time_left;
+
+  e.time_alive_left = obj.time_alive_left;
+  e.hits_able_to_be_taken = obj.hits_able_to_be_taken;
+  e.hits_taken = obj.hits_taken;
+  const std::vector<int>& ids = obj.attack_ids_taken_damage_from;
+  const size_t id_count = std::min(ids.size(), static_cast<size_t>(SimEntity::max_attack_ids));
+  e.attack_id_count = static_cast<int>(id_count);
+  std::copy(ids.end() - id_count, ids.end(), e.attack_ids_taken_damage_from);
+
+  e.flash_time_left = obj.flash_time_left;
+  const size_t name_length = std::min(obj.name.size(), static_cast<size_t>(SimEntity::max_name - 1));
+  std::memcpy(e.name, obj.name.data(), name_length);
+}
+
+static void
+unpack(const SimEntity& e, GameObject2D& obj)
+{
+  obj.id = e.id;
+  obj.do_render = e.do_render;
+  obj.do_lifecycle_timed = e.do_lifecycle_timed;
+  obj.do_lifecycle_health = e.do_lifecycle_health;
+  obj.do_physics = e.do_physics;
+  obj.flag_for_delete = e.flag_for_delete;
+  obj.invulnerable = e.invulnerable;
+
+  obj.tex_slot = e.tex_slot;
+  obj.sprite = e.sprite;
+  obj.pos = e.pos;
+  obj.angle_radians = e.angle_radians;
+  obj.colour = e.colour;
+  obj.render_size = e.render_size;
+  obj.physics_size = e.physics_size;
+  obj.collision_layer = e.collision_layer;
+
+  obj.speed_current = e.speed_current;
+  obj.speed_default = e.speed_default;
+  obj.velocity = e.velocity;
+  obj.velocity_boost_modifier = e.velocity_boost_modifier;
+  obj.shift_boost_time = e.shift_boost_time;
+  obj.shift_boost_time_left = e.shift_boost_time_left;
+
+  // assign() reuses the vectors' memory
+  obj.ai_priority_list.assign(e.ai_priority_list, e.ai_priority_list + e.ai_behaviour_count);
+  obj.approach_theta_degrees = e.approach_theta_degrees;
+
+  obj.equipped_weapon = e.equipped_weapon;
+  obj.bullet_seconds_between_spawning = e.bullet_seconds_between_spawning;
+  obj.bullet_seconds_between_spawning_left = e.bullet_seconds_between_spawning_left;
+  obj.bullets_in_a_clip = e.bullets_in_a_clip;
+  obj.bullets_in_a_clip_left = e.bullets_in_a_clip_left;
+  obj.reload_time = e.reload_time;
+  obj.reload_time_left = e.reload_time_left;
+
+  obj.time_alive_left = e.time_alive_left;
+  obj.hits_able_to_be_taken = e.hits_able_to_be_taken;
+  obj.hits_taken = e.hits_taken;
+  obj.attack_ids_taken_damage_from.assign(e.attack_ids_taken_damage_from,
+                                          e.attack_ids_taken_damage_from + e.attack_id_count);
+
+  obj.flash_time_left = e.flash_time_left;
+  obj.name.assign(e.name, strnlen(e.name, SimEntity::max_name));
+}
+
+static size_t
+get_frame_size(const SimHeader& h)
+{
+  const size_t entities = 2 + h.enemies + h.bullets + h.players + h.vfx + h.trees + h.shops;
+  return sizeof(SimHeader) + entities * sizeof(SimEntity) + h.attacks * sizeof(Attack) +
+         h.keys * sizeof(KeysAndState);
+}
+
+static void
+save_entity(const GameObject2D& obj, uint8_t*& at)
+{
+  SimEntity e;
+  pack(obj, e);
+  std::memcpy(at, &e, sizeof(e));
+  at += sizeof(e);
+}
+
+static void
+save_entities(const std::vector<GameObject2D>& objs, uint8_t*& at)
+{
+  for (const GameObject2D& obj : objs)
+    save_entity(obj, at);
+}
+
+static void
+load_entity(const uint8_t*& at, GameObject2D& obj)
+{
+  SimEntity e;
+  std::memcpy(&e, at, sizeof(e));
+  at += sizeof(e);
+  unpack(e, obj);
+}
+
+static void
+load_entities(const uint8_t*& at, uint32_t count, std::vector<GameObject2D>& objs)
+{
+  // reuses the objects already there, and their vectors and strings
+  objs.resize(count);
+  for (GameObject2D& obj : objs)
+    load_entity(at, obj);
+}
+
+void
+save(const GameState& state, std::vector<uint8_t>& out)
+{
+  SimHeader h;
+  std::memset(&h, 0, sizeof(h));
+  h.running = state.running;
+  h.screen_wh = state.screen_wh;
+  h.rnd = state.rnd;
+  h.spawner = state.spawner;
+  h.slash = state.slash;
+  h.player_attacks_enabled = state.player_attacks_enabled;
+  h.player_at_obstacle = state.player_at_obstacle;
+  h.screenshake_time_left = state.screenshake_time_left;
+  h.game_objects_destroyed = state.game_objects_destroyed;
+  h.entity_id_counter = GameObject2D::get_id_counter();
+  h.attack_id_counter = Attack::get_id_counter();
+  h.enemies = static_cast<uint32_t>(state.entities_enemies.size());
+  h.bullets = static_cast<uint32_t>(state.entities_bullets.size());
+  h.players = static_cast<uint32_t>(state.entities_player.size());
+  h.vfx = static_cast<uint32_t>(state.entities_vfx.size());
+  h.trees = static_cast<uint32_t>(state.entities_trees.size());
+  h.shops = static_cast<uint32_t>(state.entities_shops.size());
+  h.attacks = static_cast<uint32_t>(state.live_attacks.size());
+  h.keys = static_cast<uint32_t>(state.player_keys.size());
+
+  out.resize(get_frame_size(h));
+  uint8_t* at = out.data();
+  std::memcpy(at, &h, sizeof(h));
+  at += sizeof(h);
+
+  save_entity(state.camera, at);
+  save_entity(state.weapon_base, at);
+  save_entities(state.entities_enemies, at);
+  save_entities(state.entities_bullets, at);
+  save_entities(state.entities_player, at);
+  save_entities(state.entities_vfx, at);
+  save_entities(state.entities_trees, at);
+  save_entities(state.entities_shops, at);
+
+  if (!state.live_attacks.empty())
+    std::memcpy(at, state.live_attacks.data(), h.attacks * sizeof(Attack));
+  at += h.attacks * sizeof(Attack);
+  if (!state.player_keys.empty())
+    std::memcpy(at, state.player_keys.data(), h.keys * sizeof(KeysAndState));
+}
+
+bool
+load(const std::vector<uint8_t>& in, GameState& state)
+{
+  if (in.size() < sizeof(SimHeader))
+    return false;
+  SimHeader h;
+  std::memcpy(&h, in.data(), sizeof(h));
+  if (in.size() != get_frame_size(h))
+    return false;
+
+  state.running = h.running;
+  state.screen_wh = h.screen_wh;
+  state.rnd = h.rnd;
+  state.spawner = h.spawner;
+  state.slash = h.slash;
+  state.player_attacks_enabled = h.player_attacks_enabled;
+  state.player_at_obstacle = h.player_at_obstacle;
+  state.screenshake_time_left = h.screenshake_time_left;
+  state.game_objects_destroyed = h.game_objects_destroyed;
+  state.collision_events.clear(); // they point in to the vectors about to be resized
+
+  const uint8_t* at = in.data() + sizeof(h);
+  load_entity(at, state.camera);
+  load_entity(at, state.weapon_base);
+  load_entities(at, h.enemies, state.entities_enemies);
+  load_entities(at, h.bullets, state.entities_bullets);
+  load_entities(at, h.players, state.entities_player);
+  load_entities(at, h.vfx, state.entities_vfx);
+  load_entities(at, h.trees, state.entities_trees);
+  load_entities(at, h.shops, state.entities_shops);
+
+  // Attack has no default constructor
+  state.live_attacks.clear();
+  for (uint32_t i = 0; i < h.attacks; i++) {
+    Attack attack(0, 0, Weapons::PISTOL);
+    std::memcpy(&attack, at, sizeof(Attack));
+    at += sizeof(Attack);
+    state.live_attacks.push_back(attack);
+  }
+  state.player_keys.resize(h.keys);
+  if (h.keys > 0)
+    std::memcpy(state.player_keys.data(), at, h.keys * sizeof(KeysAndState));
+
+  // last, constructing the objects above handed out ids
+  GameObject2D::set_id_counter(h.entity_id_counter);
+  Attack::set_id_counter(h.attack_id_counter);
+  return true;
+}
+
+// where player_keys start, or 0 if in isn't a whole frame
+static size_t
+get_keys_offset(const std::vector<uint8_t>& in, uint32_t& count)
+{
+  if (in.size() < sizeof(SimHeader))
+    return 0;
+  SimHeader h;
+  std::memcpy(&h, in.data(), sizeof(h));
+  if (in.size() != get_frame_size(h))
+    return 0;
+  count = h.keys;
+  return in.size() - h.keys * sizeof(KeysAndState);
+}
+
+bool
+load_keys(const std::vector<uint8_t>& in, std::vector<KeysAndState>& keys)
+{
+  uint32_t count = 0;
+  const size_t offset = get_keys_offset(in, count);
+  if (offset == 0)
+    return false;
+  keys.resize(count);
+  if (count > 0)
+    std::memcpy(keys.data(), in.data() + offset, count * sizeof(KeysAndState));
+  return true;
+}
+
+bool
+store_keys(std::vector<uint8_t>& in, size_t player, const KeysAndState& keys)
+{
+  uint32_t count = 0;
+  const size_t offset = get_keys_offset(in, count);
+  if (offset == 0 || player >= count)
+    return false;
+  std::memcpy(in.data() + offset + player * sizeof(KeysAndState), &keys, sizeof(KeysAndState));
+  return true;
+}
+
+void
+step(GameState& state, float delta_time_s)
+{
+  game::update_physics(state);
+  game::update(state, delta_time_s);
+}
+
+} // namespace rollback
+
+//
+// RollbackSession
+//
+
+RollbackSession::RollbackSession(size_t capacity)
+  : buffer(capacity)
+{}
+
+void
+RollbackSession::reset(uint32_t f)
+{
+  buffer.clear();
+  frame = f;
+  stats = RollbackStats();
+}
+
+void
+RollbackSession::advance(GameState& state, float delta_time_s)
+{
+  const uint64_t start = fightingengine::zone_profiler::now_ns();
+  std::vector<uint8_t>& bytes = buffer.save(frame);
+  rollback::save(state, bytes);
+  stats.last_save_ns = fightingengine::zone_profiler::now_ns() - start;
+  stats.frame_bytes = bytes.size();
+
+  rollback::step(state, delta_time_s);
+  frame += 1;
+}
+
+bool
+RollbackSession::set_keys(uint32_t f, size_t player, const KeysAndState& keys)
+{
+  if (f >= frame)
+    return false;
+  std::vector<uint8_t>* bytes = buffer.find(f);
+  return bytes != nullptr && rollback::store_keys(*bytes, player, keys);
+}
+
+bool
+RollbackSession::rollback(GameState& state, uint32_t f, float delta_time_s)
+{
+  if (f >= frame)
+    return false;
+  const std::vector<uint8_t>* bytes = buffer.find(f);
+  if (bytes == nullptr)
+    return false;
+
+  const uint64_t start = fightingengine::zone_profiler::now_ns();
+  if (!rollback::load(*bytes, state))
+    return false;
+  stats.last_load_ns = fightingengine::zone_profiler::now_ns() - start;
+
+  state.resimulating = true;
+  for (uint32_t resim = f; resim < frame; resim++) {
+    // frames after the first were saved from the old, wrong, timeline. keep their keys, save them again
+    if (resim != f) {
+      std::vector<uint8_t>& resim_bytes = *buffer.find(resim);
+      rollback::load_keys(resim_bytes, state.player_keys);
+      rollback::save(state, resim_bytes);
+    }
+    rollback::step(state, delta_time_s);
+  }
+  state.resimulating = false;
+
+  stats.last_resimulated_frames = static_cast<int>(frame - f);
+  stats.last_resimulate_ns = fightingengine::zone_profiler::now_ns() - start;
+  stats.max_resimulated_frames = std::max(stats.max_resimulated_frames, stats.last_resimulated_frames);
+  return true;
+}
+
+bool
+RollbackSession::restore(GameState& state, uint32_t f)
+{
+  if (f >= frame)
+    return false;
+  const std::vector<uint8_t>* bytes = buffer.find(f);
+  if (bytes == nullptr)
+    return false;
+
+  const uint64_t start = fightingengine::zone_profiler::now_ns();
+  if (!rollback::load(*bytes, state))
+    return false;
+  stats.last_load_ns = fightingengine::zone_profiler::now_ns() - start;
+  frame = f;
+  return true;
+}
+
+} // namespace game2d
@@ -0,0 +1,172 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+#include <vector>
+
+// engine headers
+#include "engine/maths_core.hpp"
+#include "engine/rollback_buffer.hpp"
+
+// game headers
+#include "2d_game.hpp"
+#include "2d_game_object.hpp"
+
+namespace game2d {
+
+// The part of a GameObject2D the simulation reads and writes, with nothing on the heap:
+// the nested vectors become small fixed arrays, the name a fixed length string.
+// in_physics_grid_cell isn't kept, update_physics() works it out again.
+struct SimEntity
+{
+  static constexpr int max_ai_behaviours = 4;
+  static constexpr int max_attack_ids = 8; // the newest, older attacks are long gone from live_attacks
+  static constexpr int max_name = 16;
+
+  uint32_t id;
+  bool do_render;
+  bool do_lifecycle_timed;
+  bool do_lifecycle_health;
+  bool do_physics;
+  bool flag_for_delete;
+  bool invulnerable;
+
+  int tex_slot;
+  sprite::type sprite;
+  glm::vec2 pos;
+  float angle_radians;
+  glm::vec4 colour;
+  glm::vec2 render_size;
+  glm::vec2 physics_size;
+  CollisionLayer collision_layer;
+
+  float speed_current;
+  float speed_default;
+  glm::vec2 velocity;
+  float velocity_boost_modifier;
+  float shift_boost_time;
+  float shift_boost_time_left;
+
+  int ai_behaviour_count;
+  AiBehaviour ai_priority_list[max_ai_behaviours];
+  float approach_theta_degrees;
+
+  Weapons equipped_weapon;
+  float bullet_seconds_between_spawning;
+  float bullet_seconds_between_spawning_left;
+  int bullets_in_a_clip;
+  int bullets_in_a_clip_left;
+  float reload_time;
+  float reload_time_left;
+
+  float time_alive_left;
+  int hits_able_to_be_taken;
+  int hits_taken;
+  int attack_id_count;
+  int attack_ids_taken_damage_from[max_attack_ids];
+
+  float flash_time_left;
+  char name[max_name];
+};
+
+// The rest of GameState, and how many of each thing follow it in the frame
+struct SimHeader
+{
+  GameRunning running;
+  glm::ivec2 screen_wh;
+  fightingengine::RandomState rnd;
+  EnemySpawnerState spawner;
+  SlashState slash;
+  bool player_attacks_enabled;
+  bool player_at_obstacle;
+  float screenshake_time_left;
+  uint32_t game_objects_destroyed;
+  uint32_t entity_id_counter;
+  uint32_t attack_id_counter;
+
+  uint32_t enemies;
+  uint32_t bullets;
+  uint32_t players;
+  uint32_t vfx;
+  uint32_t trees;
+  uint32_t shops;
+  uint32_t attacks;
+  uint32_t keys;
+};
+
+namespace rollback {
+
+// A frame is one flat block of bytes:
+//   SimHeader, SimEntity camera, weapon_base, enemies, bullets, players, vfx, trees, shops,
+//   then live_attacks and player_keys as they are.
+// SimHeader and SimEntity are zeroed before they're filled in, so their padding doesn't vary.
+// The decal layer is presentation and isn't saved. collision_events are rebuilt by update_physics().
+
+void
+save(const GameState& state, std::vector<uint8_t>& out);
+
+// returns false if in isn't a whole frame
+bool
+load(const std::vector<uint8_t>& in, GameState& state);
+
+// just the player_keys of a saved frame, or replace one player's
+bool
+load_keys(const std::vector<uint8_t>& in, std::vector<KeysAndState>& keys);
+bool
+store_keys(std::vector<uint8_t>& in, size_t player, const KeysAndState& keys);
+
+// one frame: update_physics() then update()
+void
+step(GameState& state, float delta_time_s);
+
+} // namespace rollback
+
+struct RollbackStats
+{
+  size_t frame_bytes = 0;
+  uint64_t last_save_ns = 0;
+  uint64_t last_load_ns = 0;
+  int last_resimulated_frames = 0;
+  uint64_t last_resimulate_ns = 0; // load and every resimulated frame
+  int max_resimulated_frames = 0;
+};
+
+// Saves every frame before it's simulated, with the keys it's simulated with,
+// so it can go back to any of the last capacity frames:
+//   session.reset(0);
+//   every frame: fill state.player_keys, session.advance(state, dt)
+//   when a player's real keys for an earlier frame arrive:
+//     session.set_keys(frame, player, keys); session.rollback(state, frame, dt);
+class RollbackSession
+{
+public:
+  explicit RollbackSession(size_t capacity = 16);
+
+  // forgets every saved frame. the next advance() simulates frame
+  void reset(uint32_t frame = 0);
+
+  void advance(GameState& state, float delta_time_s);
+
+  // replaces a player's keys for a frame already simulated. false if the frame is gone
+  bool set_keys(uint32_t frame, size_t player, const KeysAndState& keys);
+
+  // goes back to the start of frame and simulates up to where it was, with each frame's saved keys.
+  // false (and state is untouched) if the frame is gone
+  bool rollback(GameState& state, uint32_t frame, float delta_time_s);
+
+  // goes back to the start of frame and stays there, the frames after it are dropped
+  bool restore(GameState& state, uint32_t frame);
+
+  // the next frame advance() will simulate
+  [[nodiscard]] uint32_t get_frame() const { return frame; }
+  [[nodiscard]] size_t get_capacity() const { return buffer.get_capacity(); }
+  [[nodiscard]] const RollbackStats& get_stats() const { return stats; }
+  [[nodiscard]] const std::vector<uint8_t>* find_frame(uint32_t f) const { return buffer.find(f); }
+
+private:
+  fightingengine::RollbackBuffer buffer;
+  uint32_t frame = 0;
+  RollbackStats stats;
+};
+
+} // namespace game2d
@@ -0,0 +1,138 @@
+// your header
+#include "2d_scenario.hpp"
+
+// c++ lib headers
+#include <set>
+#include <utility>
+#include <vector>
+
+// engine headers
+#include "engine/grid.hpp"
+#include "engine/maths_core.hpp"
+
+namespace game2d {
+
+namespace scenario {
+
+// uniform in the ring between inner and outer, not clumped towards the middle
+static glm::vec2
+random_in_annulus(fightingengine::RandomState& rnd, float inner, float outer)
+{
+  float t = fightingengine::rand_det_s(rnd.rng, 0.0f, 1.0f);
+  float r = sqrt(inner * inner + t * (outer * outer - inner * inner));
+  float theta = fightingengine::rand_det_s(rnd.rng, 0.0f, 2.0f * fightingengine::PI);
+  return glm::vec2(r * cos(theta), r * sin(theta));
+}
+
+static glm::vec2
+random_in_disc(fightingengine::RandomState& rnd, float radius)
+{
+  return random_in_annulus(rnd, 0.0f, radius);
+}
+
+float
+get_min_radius()
+{
+  return sqrt(game_safe_radius_around_player); // it's squared
+}
+
+ScenarioStats
+populate(GameState& state, const ScenarioConfig& config)
+{
+  ScenarioStats stats;
+  if (state.entities_player.size() == 0)
+    return stats;
+
+  fightingengine::RandomState rnd;
+  rnd.rng.seed(config.seed);
+
+  const GameObject2D& player = state.entities_player[0];
+  const glm::vec2 centre = player.pos;
+
+  // a replay can carry any radius, so clamp here as well as on the command line
+  const float safe_radius = get_min_radius();
+  const float radius = glm::max(config.radius, safe_radius);
+
+  // enemies
+
+  std::vector<glm::vec2> swarm_centres;
+  if (config.enemy_layout == ScenarioLayout::SWARMS) {
+    for (int i = 0; i < (config.swarms > 0 ? config.swarms : 1); i++)
+      swarm_centres.push_back(centre + random_in_disc(rnd, radius));
+  }
+
+  state.entities_enemies.reserve(state.entities_enemies.size() + config.enemies);
+  for (int i = 0; i < config.enemies; i++) {
+    glm::vec2 pos;
+    if (swarm_centres.empty()) {
+      // keep out of the player's safe radius
+      pos = centre + random_in_annulus(rnd, safe_radius, radius);
+    } else
+      pos = swarm_centres[i % swarm_centres.size()] + random_in_disc(rnd, config.swarm_radius);
+
+    GameObject2D enemy = gameobject::create_enemy(sprite_enemy_core, tex_unit_kenny_nl, enemy_colour, rnd);
+    enemy.pos = pos;
+    state.entities_enemies.push_back(enemy);
+    stats.enemies += 1;
+  }
+
+  // bullets
+
+  state.entities_bullets.reserve(state.entities_bullets.size() + config.bullets);
+  for (int i = 0; i < config.bullets; i++) {
+    GameObject2D bullet = gameobject::create_bullet(sprite_bullet, tex_unit_kenny_nl, bullet_colour);
+    glm::vec2 offset = random_in_disc(rnd, radius);
+    float length = glm::length(offset);
+    glm::vec2 dir = length > 0.0f ? offset / length : glm::vec2(1.0f, 0.0f);
+    bullet.pos = centre + offset;
+    bullet.velocity = dir * bullet.speed_current;
+    // spread the expiry out, so the storm doesn't vanish in one frame
+    bullet.time_alive_left = fightingengine::rand_det_s(rnd.rng, 1.0f, bullet.time_alive_left);
+    state.entities_bullets.push_back(bullet);
+
+    Attack a = Attack(player.id, bullet.id, Weapons::PISTOL);
+    state.live_attacks.push_back(a);
+    stats.bullets += 1;
+  }
+
+  // trees
+
+  std::set<std::pair<int, int>> occupied;
+  for (const auto& tree : state.entities_trees) {
+    glm::ivec2 cell = grid::convert_world_space_to_grid_space(tree.pos, GAME_GRID_SIZE);
+    occupied.insert({ cell.x, cell.y });
+  }
+  for (int i = 0; i < config.trees; i++) {
+    glm::vec2 world_pos = centre + random_in_disc(rnd, radius);
+    glm::ivec2 cell = grid::convert_world_space_to_grid_space(world_pos, GAME_GRID_SIZE);
+    if (!occupied.insert({ cell.x, cell.y }).second)
+      continue;
+
+    GameObject2D tree = gameobject::create_tree(tex_unit_kenny_nl);
+    tree.pos = grid::convert_grid_space_to_worldspace(cell, GAME_GRID_SIZE);
+    tree.render_size = glm::ivec2(GAME_GRID_SIZE);
+    tree.physics_size = glm::ivec2(GAME_GRID_SIZE);
+    state.entities_trees.push_back(tree);
+    stats.trees += 1;
+  }
+
+  // splats
+
+  for (int i = 0; i < config.splats; i++) {
+    fightingengine::Decal splat;
+    splat.sprite_offset = sprite::spritemap::get_sprite_offset(sprite_splat);
+    splat.colour = fightingengine::rand_det_s(rnd.rng, 0.0f, 1.0f) < 0.5f ? enemy_death_splat_colour
+                                                                           : enemy_impact_splat_colour;
+    splat.size = glm::vec2(fightingengine::rand_det_s(rnd.rng, 8.0f, 32.0f));
+    splat.pos = centre + random_in_disc(rnd, radius);
+    splat.angle_radians = fightingengine::rand_det_s(rnd.rng, -fightingengine::PI, fightingengine::PI);
+    state.decals.stamp(splat);
+    stats.splats += 1;
+  }
+
+  return stats;
+}
+
+} // namespace scenario
+
+} // namespace game2d
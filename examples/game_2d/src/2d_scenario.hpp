@@ -0,0 +1,55 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+
+// game headers
+#include "2d_game.hpp"
+
+namespace game2d {
+
+enum class ScenarioLayout
+{
+  SPREAD, // uniform over the whole area
+  SWARMS, // clumped around a few centres
+};
+
+// Procedurally populates a GameState, to reproduce loads the wave spawner never reaches.
+// Everything is placed around player 0, and the same seed gives the same world.
+struct ScenarioConfig
+{
+  uint32_t seed = 1;
+  float radius = 2000.0f; // around player 0, in pixels. at least scenario::get_min_radius()
+
+  int enemies = 0;
+  ScenarioLayout enemy_layout = ScenarioLayout::SPREAD;
+  int swarms = 8;
+  float swarm_radius = 150.0f;
+
+  int bullets = 0; // a storm, flying outwards from player 0
+  int trees = 0;   // snapped to the game grid, duplicates skipped
+  int splats = 0;  // stamped in to the decal layer
+};
+
+struct ScenarioStats
+{
+  int enemies = 0;
+  int bullets = 0;
+  int trees = 0;
+  int splats = 0;
+};
+
+namespace scenario {
+
+// spread out enemies spawn outside the player's safe radius, so the area can't be smaller than it
+[[nodiscard]] float
+get_min_radius();
+
+// adds to whatever is already in state. trees are appended to state.entities_trees,
+// callers with a StaticSpriteCache should add anything past the previous size.
+ScenarioStats
+populate(GameState& state, const ScenarioConfig& config);
+
+} // namespace scenario
+
+} // namespace game2d
@@ -0,0 +1,331 @@
+// your header
+#include "2d_state_hash.hpp"
+
+// c++ lib headers
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+
+// engine headers
+#include "engine/state_hash.hpp"
+#include "engine/tools/zone_profiler.hpp"
+
+// game headers
+#include "2d_game_object.hpp"
+
+namespace game2d {
+
+//
+// what's hashed, and in what order. hash() and find_mismatch() both walk the state with this,
+// so they can't disagree on what's covered
+//
+
+// the next number the rng would give. minstd_rand's output is its whole state
+static uint32_t
+get_rng_state(const fightingengine::RandomState& rnd)
+{
+  std::minstd_rand copy = rnd.rng;
+  return static_cast<uint32_t>(copy());
+}
+
+template<class Visitor>
+static void
+visit_entity(Visitor& v, const GameObject2D& e)
+{
+  v.field("id", e.id);
+  v.field("flag_for_delete", e.flag_for_delete);
+  v.field("pos.x", e.pos.x);
+  v.field("pos.y", e.pos.y);
+  v.field("angle_radians", e.angle_radians);
+  v.field("velocity.x", e.velocity.x);
+  v.field("velocity.y", e.velocity.y);
+  v.field("speed_current", e.speed_current);
+  v.field("shift_boost_time_left", e.shift_boost_time_left);
+  v.field("approach_theta_degrees", e.approach_theta_degrees);
+  v.field("equipped_weapon", static_cast<uint32_t>(e.equipped_weapon));
+  v.field("bullet_seconds_between_spawning_left", e.bullet_seconds_between_spawning_left);
+  v.field("bullets_in_a_clip_left", e.bullets_in_a_clip_left);
+  v.field("reload_time_left", e.reload_time_left);
+  v.field("time_alive_left", e.time_alive_left);
+  v.field("hits_able_to_be_taken", e.hits_able_to_be_taken);
+  v.field("hits_taken", e.hits_taken);
+  v.field("invulnerable", e.invulnerable);
+  v.field("attacks_taken_damage_from", static_cast<uint32_t>(e.attack_ids_taken_damage_from.size()));
+  v.field("flash_time_left", e.flash_time_left);
+}
+
+template<class Visitor>
+static void
+visit_entities(Visitor& v, const char* group, const GameObject2D* entities, size_t count)
+{
+  v.begin_group(group, count);
+  for (size_t i = 0; i < count; i++) {
+    v.begin_item(i, entities[i].id);
+    visit_entity(v, entities[i]);
+  }
+  v.end_group(group, count);
+}
+
+template<class Visitor>
+static void
+visit_entities(Visitor& v, const char* group, const std::vector<GameObject2D>& entities)
+{
+  visit_entities(v, group, entities.data(), entities.size());
+}
+
+template<class Visitor>
+static void
+visit_state(Visitor& v, const GameState& s)
+{
+  v.begin_group("state", 1);
+  v.begin_item(0, 0);
+  v.field("running", static_cast<uint32_t>(s.running));
+  v.field("rng", get_rng_state(s.rnd));
+  // the id counters are globals, not in GameState, so they'd read the same for any two states.
+  // the ids they hand out are hashed with each entity and attack
+  v.field("game_objects_destroyed", s.game_objects_destroyed);
+  v.field("player_at_obstacle", s.player_at_obstacle);
+  v.field("screenshake_time_left", s.screenshake_time_left);
+  v.field("spawner.seconds_between_spawning_current", s.spawner.seconds_between_spawning_current);
+  v.field("spawner.seconds_between_spawning_left", s.spawner.seconds_between_spawning_left);
+  v.field("spawner.seconds_until_max_difficulty_spent", s.spawner.seconds_until_max_difficulty_spent);
+  v.field("slash.attack_time_left", s.slash.attack_time_left);
+  v.field("slash.weapon_current_angle", s.slash.weapon_current_angle);
+  v.field("slash.attack_left_to_right", s.slash.attack_left_to_right);
+  v.end_group("state", 1);
+
+  visit_entities(v, "camera", &s.camera, 1);
+  visit_entities(v, "weapon_base", &s.weapon_base, 1);
+  visit_entities(v, "players", s.entities_player);
+  visit_entities(v, "enemies", s.entities_enemies);
+  visit_entities(v, "bullets", s.entities_bullets);
+  visit_entities(v, "vfx", s.entities_vfx);
+  visit_entities(v, "trees", s.entities_trees);
+  visit_entities(v, "shops", s.entities_shops);
+
+  v.begin_group("attacks", s.live_attacks.size());
+  for (size_t i = 0; i < s.live_attacks.size(); i++) {
+    const Attack& a = s.live_attacks[i];
+    v.begin_item(i, a.id);
+    v.field("id", a.id);
+    v.field("entity_weapon_owner_id", a.entity_weapon_owner_id);
+    v.field("entity_weapon_id", a.entity_weapon_id);
+    v.field("weapon_type", static_cast<uint32_t>(a.weapon_type));
+  }
+  v.end_group("attacks", s.live_attacks.size());
+}
+
+//
+// hash
+//
+
+// how many words hash() reads. the counts are the only thing that changes, so this is a few multiplies
+struct CountVisitor
+{
+  size_t words = 0;
+
+  void begin_group(const char*, size_t) { words += 1; }
+  void end_group(const char*, size_t) {}
+  void begin_item(size_t, uint32_t) {}
+  template<class T>
+  void field(const char*, T)
+  {
+    words += 1;
+  }
+};
+
+// each value in to a flat array, each group's count before its items. writing through a pointer that
+// stays in a register is much cheaper than the hasher's add() a value at a time
+struct WriteVisitor
+{
+  uint32_t* out;
+
+  void begin_group(const char*, size_t count) { *out++ = static_cast<uint32_t>(count); }
+  void end_group(const char*, size_t) {}
+  void begin_item(size_t, uint32_t) {}
+  void field(const char*, uint32_t value) { *out++ = value; }
+  void field(const char*, int value) { *out++ = static_cast<uint32_t>(value); }
+  void field(const char*, bool value) { *out++ = value ? 1 : 0; }
+  void field(const char*, float value)
+  {
+    // a copy to the stack then a plain store. copying straight to out could alias out itself
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    *out++ = bits;
+  }
+};
+
+//
+// mismatches
+//
+
+enum class ValueType : uint8_t
+{
+  UINT,
+  INT,
+  BOOL,
+  FLOAT,
+};
+
+struct TracedValue
+{
+  const char* group;
+  uint32_t index;
+  uint32_t id;
+  const char* field;
+  ValueType type;
+  uint32_t bits;
+};
+
+// every value, and where it came from. each group's count goes after its items, so when one state
+// has more of a group than the other the two traces line up until the first extra item
+struct TraceVisitor
+{
+  std::vector<TracedValue>& out;
+  const char* group = "";
+  uint32_t index = 0;
+  uint32_t id = 0;
+
+  void begin_group(const char* name, size_t)
+  {
+    group = name;
+    index = 0;
+    id = 0;
+  }
+  void end_group(const char* name, size_t count)
+  {
+    out.push_back({ name, static_cast<uint32_t>(count), 0, "count", ValueType::UINT, static_cast<uint32_t>(count) });
+  }
+  void begin_item(size_t i, uint32_t item_id)
+  {
+    index = static_cast<uint32_t>(i);
+    id = item_id;
+  }
+  void field(const char* name, uint32_t value) { add(name, ValueType::UINT, value); }
+  void field(const char* name, int value) { add(name, ValueType::INT, static_cast<uint32_t>(value)); }
+  void field(const char* name, bool value) { add(name, ValueType::BOOL, value ? 1 : 0); }
+  void field(const char* name, float value)
+  {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    add(name, ValueType::FLOAT, bits);
+  }
+  void add(const char* name, ValueType type, uint32_t bits) { out.push_back({ group, index, id, name, type, bits }); }
+};
+
+static std::string
+value_to_string(ValueType type, uint32_t bits)
+{
+  std::ostringstream ss;
+  switch (type) {
+    case ValueType::UINT:
+      ss << bits;
+      break;
+    case ValueType::INT:
+      ss << static_cast<int>(bits);
+      break;
+    case ValueType::BOOL:
+      ss << (bits != 0 ? "true" : "false");
+      break;
+    case ValueType::FLOAT: {
+      float value = 0.0f;
+      std::memcpy(&value, &bits, sizeof(value));
+      ss.precision(9); // enough to tell any two floats apart
+      ss << value;
+      break;
+    }
+  }
+  return ss.str();
+}
+
+static bool
+same_place(const TracedValue& a, const TracedValue& b)
+{
+  return a.index == b.index && std::strcmp(a.group, b.group) == 0 && std::strcmp(a.field, b.field) == 0;
+}
+
+// the first count in a trace from start: the group the two traces stopped lining up in
+static const TracedValue&
+find_count(const std::vector<TracedValue>& trace, size_t start)
+{
+  for (size_t i = start; i < trace.size(); i++) {
+    if (std::strcmp(trace[i].field, "count") == 0)
+      return trace[i];
+  }
+  return trace.back(); // every trace ends with the attacks' count
+}
+
+namespace state_hash {
+
+uint64_t
+hash(const GameState& state)
+{
+  PROFILE_ZONE("state_hash::hash");
+  static thread_local std::vector<uint32_t> words; // per thread, like the id counters
+
+  CountVisitor count;
+  visit_state(count, state);
+  words.resize(count.words);
+  WriteVisitor write{ words.data() };
+  visit_state(write, state);
+
+  fightingengine::StateHasher hasher;
+  hasher.add_words(words.data(), words.size());
+  return hasher.finish();
+}
+
+bool
+find_mismatch(const GameState& a, const GameState& b, StateMismatch& mismatch)
+{
+  std::vector<TracedValue> trace_a;
+  std::vector<TracedValue> trace_b;
+  TraceVisitor visit_a{ trace_a };
+  TraceVisitor visit_b{ trace_b };
+  visit_state(visit_a, a);
+  visit_state(visit_b, b);
+
+  for (size_t i = 0; i < trace_a.size() && i < trace_b.size(); i++) {
+    const TracedValue& x = trace_a[i];
+    const TracedValue& y = trace_b[i];
+    if (same_place(x, y)) {
+      if (x.bits == y.bits)
+        continue;
+      mismatch.group = x.group;
+      mismatch.index = x.index;
+      mismatch.id = x.id;
+      mismatch.field = x.field;
+      mismatch.a = value_to_string(x.type, x.bits);
+      mismatch.b = value_to_string(y.type, y.bits);
+      return true;
+    }
+
+    // one of them has run out of a group the other still has items in
+    const TracedValue& count_a = find_count(trace_a, i);
+    const TracedValue& count_b = find_count(trace_b, i);
+    const TracedValue& extra = std::strcmp(x.field, "count") == 0 ? y : x;
+    mismatch.group = count_a.group;
+    mismatch.index = extra.index;
+    mismatch.id = extra.id;
+    mismatch.field = "count";
+    mismatch.a = value_to_string(ValueType::UINT, count_a.bits);
+    mismatch.b = value_to_string(ValueType::UINT, count_b.bits);
+    return true;
+  }
+  return false;
+}
+
+std::string
+to_string(const StateMismatch& mismatch)
+{
+  std::ostringstream ss;
+  ss << mismatch.group << "[" << mismatch.index << "]";
+  if (mismatch.id != 0)
+    ss << " id " << mismatch.id;
+  ss << " " << mismatch.field << ": " << mismatch.a << " vs " << mismatch.b;
+  return ss.str();
+}
+
+} // namespace state_hash
+
+} // namespace game2d
@@ -0,0 +1,43 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+#include <string>
+
+// game headers
+#include "2d_game.hpp"
+
+namespace game2d {
+
+// Where two states first differ, and what each of them has there
+struct StateMismatch
+{
+  std::string group;  // "state" for GameState's own fields, or "enemies", "bullets", "attacks"...
+  uint32_t index = 0; // in the group
+  uint32_t id = 0;    // of the entity or attack, as the first state has it
+  std::string field;  // "count" if one state has more of the group than the other
+  std::string a;
+  std::string b;
+};
+
+namespace state_hash {
+
+// Positions, velocities, health and timers of everything simulated, and the rng.
+// What's only drawn (colours, sprites, decals) and the player keys going in aren't included,
+// nor are the global id counters: a state doesn't hold them, only the ids they gave out.
+// Cheap enough to do every frame: peers, a rollback or a replay can swap these to check they agree
+[[nodiscard]] uint64_t
+hash(const GameState& state);
+
+// The first value hash() reads that's different between a and b, in the order hash() reads them.
+// false if there isn't one. Much slower than hash(), for once a hash hasn't matched
+bool
+find_mismatch(const GameState& a, const GameState& b, StateMismatch& mismatch);
+
+// "enemies[12] id 345 pos.x: 120.5 vs 120.500008"
+[[nodiscard]] std::string
+to_string(const StateMismatch& mismatch);
+
+} // namespace state_hash
+
+} // namespace game2d
@@ -10,21 +10,18 @@ void
 spawn_death_splat(fightingengine::RandomState& rnd,
                   const GameObject2D& enemy,
                   const sprite::type s,
-                  const int tex_unit,
                   const glm::vec4 colour,
-                  std::vector<GameObject2D>& ents)
+                  fightingengine::DecalLayer* decals)
 {
-  GameObject2D splat = gameobject::create_generic(s, tex_unit, colour);
-  splat.do_lifecycle_timed = true;
-  splat.time_alive_left = 30.0f; // long splat
-  splat.render_size = enemy.render_size;
-  splat.physics_size = splat.render_size;
-
+  fightingengine::Decal splat;
+  splat.sprite_offset = sprite::spritemap::get_sprite_offset(s);
+  splat.colour = colour;
+  splat.size = enemy.render_size;
   splat.pos = enemy.pos;
   splat.angle_radians = fightingengine::rand_det_s(rnd.rng, -fightingengine::PI, fightingengine::PI);
 
-  if (enemy.hits_taken >= enemy.hits_able_to_be_taken) {
-    ents.push_back(splat);
+  if (decals != nullptr && enemy.hits_taken >= enemy.hits_able_to_be_taken) {
+    decals->stamp(splat);
   }
 }
 
@@ -8,6 +8,7 @@
 
 // engine headers
 #include "engine/maths_core.hpp"
+#include "engine/vfx/decal_layer.hpp"
 
 // game headers
 #include "2d_game_object.hpp"
@@ -17,14 +18,14 @@ namespace game2d {
 
 namespace vfx {
 
-// vfx death "splat"
+// vfx death "splat", stamped in to the decal layer rather than spawned as an entity.
+// decals can be null to skip the stamp, rnd advances the same either way
 void
 spawn_death_splat(fightingengine::RandomState& rnd,
                   const GameObject2D& enemy,
                   const sprite::type s,
-                  const int tex_unit,
                   const glm::vec4 colour,
-                  std::vector<GameObject2D>& ents);
+                  fightingengine::DecalLayer* decals);
 
 // vfx impact "splats"
 void
@@ -1,13 +1,25 @@
 #pragma once
 
 // c++ lib headers
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <string>
+#include <vector>
 
 // other project libs
 #include <imgui.h>
 
-// Demonstrate creating a simple console window, with scrolling, filtering, completion and history.
-// For the console example, we are using a more C++ like approach of declaring a class to hold both data and functions.
+// engine headers
+#include "engine/tools/cvar_bench.hpp"
+#include "engine/tools/cvars.hpp"
+
+// A console window, with scrolling, filtering, completion and history (started from the imgui demo).
+// Anything that isn't a built in command is run as a cvar command (see cvars::execute),
+// and "bench" A/B tests a cvar if a CVarBench is hooked up.
 struct Console
 {
   char InputBuf[256];
@@ -18,6 +30,7 @@ struct Console
   ImGuiTextFilter Filter;
   bool AutoScroll;
   bool ScrollToBottom;
+  fightingengine::CVarBench* Bench = nullptr; // ticked by the owner, once per frame
 
   Console()
   {
@@ -30,9 +43,14 @@ struct Console
     Commands.push_back("HISTORY");
     Commands.push_back("CLEAR");
     Commands.push_back("CLASSIFY");
+    Commands.push_back("list");
+    Commands.push_back("get");
+    Commands.push_back("set");
+    Commands.push_back("reset");
+    Commands.push_back("bench");
     AutoScroll = true;
     ScrollToBottom = false;
-    AddLog("Welcome to Dear ImGui!");
+    AddLog("Type 'list' to see the cvars.");
   }
   ~Console()
   {
@@ -113,11 +131,21 @@ struct Console
       ImGui::EndPopup();
     }
 
-    ImGui::TextWrapped(
-      "This example implements a console with basic coloring, completion (TAB key) and history (Up/Down keys). A more "
-      "elaborate "
-      "implementation may want to store entries along with extra data such as timestamp, emitter, etc.");
-    ImGui::TextWrapped("Enter 'HELP' for help.");
+    ImGui::TextWrapped("Enter 'HELP' for help. TAB completes commands and cvar names.");
+
+    // bench results arrive a few seconds after the command
+    if (Bench) {
+      std::vector<std::string> report;
+      if (Bench->take_report(report)) {
+        for (const std::string& line : report)
+          AddLog("%s", line.c_str());
+        ScrollToBottom = true;
+      }
+      if (Bench->is_running()) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.6f, 1.0f), "(benching...)");
+      }
+    }
 
     // TODO: display items starting from the bottom
 
@@ -272,7 +300,14 @@ struct Console
       for (int i = first > 0 ? first : 0; i < History.Size; i++)
         AddLog("%3d: %s\n", i, History[i]);
     } else {
-      AddLog("Unknown command: '%s'\n", command_line);
+      std::vector<std::string> output;
+      bool handled = Bench && Bench->execute(command_line, output);
+      if (!handled)
+        handled = fightingengine::cvars::execute(command_line, output);
+      for (const std::string& line : output)
+        AddLog("%s", line.c_str());
+      if (!handled)
+        AddLog("Unknown command: '%s'\n", command_line);
     }
 
     // On command input, we scroll to bottom even if AutoScroll==false
@@ -308,6 +343,9 @@ struct Console
         for (int i = 0; i < Commands.Size; i++)
           if (Strnicmp(Commands[i], word_start, (int)(word_end - word_start)) == 0)
             candidates.push_back(Commands[i]);
+        for (fightingengine::CVarBase* cvar : fightingengine::cvars::get_all())
+          if (Strnicmp(cvar->get_name(), word_start, (int)(word_end - word_start)) == 0)
+            candidates.push_back(cvar->get_name());
 
         if (candidates.Size == 0) {
           // No match
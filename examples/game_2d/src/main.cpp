@@ -3,7 +3,12 @@
 //
 
 // c++ lib headers
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <optional>
+#include <string>
 #include <vector>
 
 // other library headers
@@ -23,67 +28,56 @@
 #include "engine/maths_core.hpp"
 #include "engine/opengl/render_command.hpp"
 #include "engine/opengl/shader.hpp"
+#include "engine/opengl/uniform_buffer.hpp"
+#include "engine/tools/alloc_tracker.hpp"
+#include "engine/tools/logger.hpp"
+#include "engine/tools/trace_writer.hpp"
+#include "engine/tools/zone_profiler.hpp"
 #include "engine/ui/profiler_panel.hpp"
 #include "engine/util.hpp"
+#include "engine/vfx/decal_layer.hpp"
 using namespace fightingengine;
 
 // game headers
+#include "2d_bench.hpp"
+#include "2d_entity_inspector.hpp"
+#include "2d_game.hpp"
 #include "2d_game_logic.hpp"
 #include "2d_game_object.hpp"
+#include "2d_input.hpp"
 #include "2d_physics.hpp"
+#include "2d_replay.hpp"
+#include "2d_scenario.hpp"
 #include "2d_vfx.hpp"
+#include "in_progress/console.hpp"
+#include "opengl/decal_renderer.hpp"
 #include "opengl/sprite_renderer.hpp"
 #include "spritemap.hpp"
 using namespace game2d;
 
-enum class GameRunning
-{
-  ACTIVE,
-  PAUSED,
-  GAME_OVER
-};
-GameRunning state = GameRunning::ACTIVE;
-
 SDL_Scancode debug_key_quit = SDL_SCANCODE_ESCAPE;
 SDL_Scancode debug_key_advance_one_frame = SDL_SCANCODE_RSHIFT;
 SDL_Scancode debug_key_advance_one_frame_held = SDL_SCANCODE_F10;
 SDL_Scancode debug_key_force_gameover = SDL_SCANCODE_F11;
+SDL_Scancode debug_key_toggle_trace = SDL_SCANCODE_F9;
+SDL_Scancode debug_key_toggle_console = SDL_SCANCODE_GRAVE;
 
 bool debug_advance_one_frame = false;
 bool debug_show_imgui_demo_window = false;
 bool debug_render_spritesheet = true;
 bool debug_show_profiler = true;
 
-// textures
-const int tex_unit_kenny_nl = 0;
-const int tex_tree = 1;
-
-// colour palette; https://colorhunt.co/palette/273312
-const glm::vec4 PALETTE_COLOUR_1_1 = glm::vec4(57.0f / 255.0f, 62.0f / 255.0f, 70.0f / 255.0f, 1.0f);    // black
-const glm::vec4 PALETTE_COLOUR_2_1 = glm::vec4(0.0f / 255.0f, 173.0f / 255.0f, 181.0f / 255.0f, 1.0f);   // blue
-const glm::vec4 PALETTE_COLOUR_3_1 = glm::vec4(170.0f / 255.0f, 216.0f / 255.0f, 211.0f / 255.0f, 1.0f); // lightblue
-const glm::vec4 PALETTE_COLOUR_4_1 = glm::vec4(238.0f / 255.0f, 238.0f / 255.0f, 238.0f / 255.0f, 1.0f); // grey
-
-glm::vec4 background_colour = PALETTE_COLOUR_1_1;                          // black
-glm::vec4 debug_line_colour = PALETTE_COLOUR_2_1;                          // blue
-glm::vec4 player_colour = PALETTE_COLOUR_2_1;                              // blue
-glm::vec4 bullet_colour = PALETTE_COLOUR_3_1;                              // lightblue
-glm::vec4 enemy_colour = PALETTE_COLOUR_4_1;                               // grey
-glm::vec4 player_splat_colour = player_colour;                             // player col
-glm::vec4 enemy_death_splat_colour = glm::vec4(0.65f, 0.65f, 0.65f, 1.0f); // greyish
-glm::vec4 enemy_impact_splat_colour = glm::vec4(0.95f, 0.3f, 0.3f, 1.0f);  // redish
-
-sprite::type sprite_player = sprite::type::PERSON_1;
-sprite::type sprite_bullet = sprite::type::WEAPON_ARROW_1;
-sprite::type sprite_enemy_core = sprite::type::PERSON_2;
-sprite::type sprite_weapon_base = sprite::type::WEAPON_SHOVEL;
-sprite::type sprite_splat = sprite::type::CASTLE_FLOOR;
-
-const float game_safe_radius_around_player = 7500.0f;
-const float game_enemy_direct_attack_threshold = 4000.0f;
-float screenshake_time = 0.1f;
-float screenshake_time_left = 0.0f;
-float vfx_flash_time = 0.2f;
+// matches the std140 FrameData block in the 2d shaders
+struct FrameData
+{
+  glm::mat4 projection;
+  float time = 0.0f;
+  float padding[3];
+};
+const unsigned int ubo_binding_frame_data = 0;
+
+glm::vec4 background_colour = PALETTE_COLOUR_1_1; // black
+glm::vec4 debug_line_colour = PALETTE_COLOUR_2_1; // blue
 
 enum class EditorMode
 {
@@ -92,12 +86,50 @@ enum class EditorMode
   PLAYER_ATTACK,
 };
 
+void
+toggle_trace_capture(TraceWriter& trace)
+{
+  if (trace.is_capturing()) {
+    trace.stop();
+    return;
+  }
+  std::string path = "trace_" + std::to_string(std::time(nullptr)) + ".json";
+  trace.start(path);
+}
+
 int
-main()
+main(int argc, char* argv[])
 {
+  logger::start();
+
+  bench::BenchConfig bench_config;
+  if (bench::parse_args(argc, argv, bench_config)) {
+    int exit_code = bench::run(bench_config);
+    logger::stop();
+    return exit_code;
+  }
+
   std::cout << "booting up..." << std::endl;
   const auto app_start = std::chrono::high_resolution_clock::now();
 
+  // --alloc-budget N: exit with an error if a steady-state frame makes more than N heap allocations
+  std::optional<AllocationBudget> alloc_budget;
+  const int alloc_budget_warmup_frames = 300;
+  const int alloc_budget_checked_frames = 600;
+  // --record path: writes every frame's input to a replay when the game closes, see game_2d --replay
+  std::string record_path;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--alloc-budget") == 0 && i + 1 < argc)
+      alloc_budget.emplace(std::strtoull(argv[++i], nullptr, 10), alloc_budget_warmup_frames);
+    else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+      record_path = argv[++i];
+  }
+  if (alloc_budget && !alloc_tracker::is_enabled()) {
+    std::cerr << "--alloc-budget needs a build with FIGHTINGENGINE_TRACK_ALLOCATIONS" << std::endl;
+    logger::stop();
+    return 1;
+  }
+
   bool hide_console = false;
   if (hide_console)
     fightingengine::hide_console();
@@ -106,13 +138,15 @@ main()
   bool ui_mute_sfx = true;
   bool ui_show_game_info = true;
   bool ui_show_entity_menu = true;
+  bool ui_show_scenario = false;
+  bool ui_show_console = false;
   bool ui_use_vsync = true;
   bool ui_fullscreen = false;
 
   glm::ivec2 screen_wh = { 1280, 720 };
-  RandomState rnd;
   Application app("2D Game", screen_wh.x, screen_wh.y, ui_use_vsync);
   Profiler profiler;
+  TraceWriter trace;
 
   // textures
 
@@ -146,60 +180,60 @@ main()
   RenderCommand::set_depth_testing(false); // disable depth testing for 2d
   sprite_renderer::init();
 
-  glm::mat4 projection =
+  // projection and time are shared by all the 2d shaders, and uploaded once per frame
+  FrameData frame_data;
+  frame_data.projection =
     glm::ortho(0.0f, static_cast<float>(screen_wh.x), static_cast<float>(screen_wh.y), 0.0f, -1.0f, 1.0f);
+  UniformBuffer frame_data_ubo(sizeof(FrameData), ubo_binding_frame_data);
 
   Shader colour_shader = Shader("2d_game/shaders/2d_basic.vert", "2d_game/shaders/2d_colour.frag");
   colour_shader.bind();
 
   Shader instanced_quad_shader = Shader("2d_game/shaders/2d_instanced.vert", "2d_game/shaders/2d_instanced.frag");
+  instanced_quad_shader.bind_uniform_block("FrameData", ubo_binding_frame_data);
   instanced_quad_shader.bind();
-  instanced_quad_shader.set_mat4("projection", projection);
+  instanced_quad_shader.set_mat4("view", glm::mat4(1.0f));
+  UniformHandle u_instanced_shake = instanced_quad_shader.get_uniform("shake");
+  UniformHandle u_instanced_tex = instanced_quad_shader.get_uniform("tex");
+
+  // blood splats are stamped once in to per-chunk render targets that fade out over time
+  Shader decal_stamp_shader = Shader("2d_game/shaders/2d_instanced.vert", "2d_game/shaders/2d_instanced.frag");
+  decal_stamp_shader.bind_uniform_block("FrameData", ubo_binding_frame_data);
+  decal_stamp_shader.bind();
+  decal_stamp_shader.set_int("tex", tex_unit_kenny_nl);
+  decal_stamp_shader.set_bool("shake", false);
+
+  Shader decal_composite_shader = Shader("2d_game/shaders/2d_decal.vert", "2d_game/shaders/2d_decal.frag");
+  decal_composite_shader.bind_uniform_block("FrameData", ubo_binding_frame_data);
 
   // Game
 
-  uint32_t game_objects_destroyed = 0;
+  const uint32_t seed = std::minstd_rand::default_seed;
+  GameState game_state;
+  ReplayRecorder recorder;
+  if (!record_path.empty())
+    recorder.start(seed, screen_wh); // before init, it creates the first entities
+  game::init(game_state, screen_wh, seed);
+  GameObject2D& camera = game_state.camera;
+  DecalLayer& decals = game_state.decals;
+  decal_renderer::init(decals, tex_unit_decals);
 
   GameObject2D tex_obj = gameobject::create_kennynl_texture(tex_unit_kenny_nl);
-  GameObject2D camera = gameobject::create_camera();
-  GameObject2D weapon_base;
-  weapon_base.sprite = sprite_weapon_base;
-  weapon_base.pos = { screen_wh.x / 2.0f, screen_wh.y / 2.0f };
-  weapon_base.render_size = { 1.0f * 768.0f / 48.0f, 1.0f * 362.0f / 22.0f };
-  weapon_base.physics_size = { 1.0f * 768.0f / 48.0f, 1.0f * 362.0f / 22.0f };
-  weapon_base.collision_layer = CollisionLayer::Weapon;
-  weapon_base.colour = bullet_colour;
-
-  std::vector<GameObject2D> entities_enemies;
-  std::vector<GameObject2D> entities_bullets;
-  std::vector<GameObject2D> entities_player;
-  std::vector<GameObject2D> entities_vfx;
-  std::vector<KeysAndState> player_keys;
-  std::vector<Attack> live_attacks;
   EditorMode editor_left_click_mode = EditorMode::EDITOR_PLACE_MODE;
 
-  std::vector<GameObject2D> entities_trees;
-  std::vector<GameObject2D> entities_shops;
-  int PHYSICS_GRID_SIZE = 100;
-  // std::vector<std::reference_wrapper<GameObject2D>> physics_grid_refs;
-  int GAME_GRID_SIZE = 32;
-  // std::vector<std::reference_wrapper<GameObject2D>> game_grid_refs;
+  // things that never move are rendered from cached chunks
+  sprite_renderer::StaticSpriteCache static_trees;
 
-  int enemies_this_wave = 1;
-  int enemies_left_this_wave = enemies_this_wave;
+  // stress scenarios, spawned from the ui
+  ScenarioConfig ui_scenario;
+  ui_scenario.radius = 1000.0f;
 
-  std::vector<CollisionEvent> collision_events;
+  EntityInspector entity_inspector;
 
-  // add players
-  {
-    GameObject2D player0 = gameobject::create_player(sprite_player, tex_unit_kenny_nl, player_colour, screen_wh);
-
-    KeysAndState player0_keys;
-    player0_keys.use_keyboard = true;
-
-    entities_player.push_back(player0);
-    player_keys.push_back(player0_keys);
-  }
+  // cvars can be changed and A/B benched from the console
+  Console console;
+  CVarBench cvar_bench;
+  console.Bench = &cvar_bench;
 
   std::cout << "GameObject2D is " << sizeof(GameObject2D) << " bytes" << std::endl;
 
@@ -209,6 +243,21 @@ main()
 
     Uint64 frame_start_time = SDL_GetPerformanceCounter();
     profiler.new_frame();
+    trace.submit_frame(profiler.get_last_zone_frame());
+    cvar_bench.update(profiler);
+
+    if (alloc_budget) {
+      const AllocCounters& frame_allocs = profiler.get_last_frame_allocations();
+      if (!alloc_budget->check_frame(frame_allocs)) {
+        std::cerr << "(alloc budget) frame made " << frame_allocs.allocs << " allocations" << std::endl;
+        for (const ZoneEvent& e : profiler.get_last_zone_frame().events) {
+          if (e.allocs > 0)
+            std::cerr << "  " << e.name << ": " << e.allocs << " (" << e.alloc_bytes << " bytes)" << std::endl;
+        }
+      }
+      if (alloc_budget->get_frames_checked() >= alloc_budget_checked_frames)
+        app.shutdown();
+    }
     profiler.begin(Profiler::Stage::UpdateLoop);
 
     app.frame_begin(); // get input events
@@ -216,55 +265,12 @@ main()
     if (delta_time_s >= 0.25f)
       delta_time_s = 0.25f;
 
+    const bool step_physics = game_state.running == GameRunning::ACTIVE ||
+                              (game_state.running == GameRunning::PAUSED && debug_advance_one_frame);
     profiler.begin(Profiler::Stage::Physics);
     {
-      if (state == GameRunning::ACTIVE || (state == GameRunning::PAUSED && debug_advance_one_frame)) {
-
-        std::vector<std::reference_wrapper<GameObject2D>> collidable;
-        collidable.insert(collidable.end(), entities_enemies.begin(), entities_enemies.end());
-        collidable.insert(collidable.end(), entities_bullets.begin(), entities_bullets.end());
-        collidable.insert(collidable.end(), entities_player.begin(), entities_player.end());
-        collidable.insert(collidable.end(), entities_trees.begin(), entities_trees.end());
-        collidable.push_back(weapon_base);
-
-        std::vector<std::reference_wrapper<GameObject2D>> active_collidable;
-        for (auto& obj : collidable) {
-          if (obj.get().do_physics)
-            active_collidable.push_back(obj);
-        }
-
-        // pre-physics: update grid position
-        for (auto& e : active_collidable) {
-          grid::get_unique_cells(e.get().pos, e.get().physics_size, PHYSICS_GRID_SIZE, e.get().in_physics_grid_cell);
-        }
-
-        // generate filtered broadphase collisions.
-        std::map<uint64_t, Collision2D> filtered_collisions;
-        generate_filtered_broadphase_collisions(active_collidable, filtered_collisions);
-
-        // clear collision events this frame
-        collision_events.clear();
-
-        // Add collision to events
-        for (auto& c : filtered_collisions) {
-          uint32_t id_0 = c.second.ent_id_0;
-          uint32_t id_1 = c.second.ent_id_1;
-
-          // Find the objs in the read-only list
-          auto& obj_0_it = std::find_if(
-            collidable.begin(), collidable.end(), [&id_0](const auto& obj) { return obj.get().id == id_0; });
-          auto& obj_1_it = std::find_if(
-            collidable.begin(), collidable.end(), [&id_1](const auto& obj) { return obj.get().id == id_1; });
-
-          if (obj_0_it == collidable.end() || obj_1_it == collidable.end()) {
-            std::cerr << "Collision entity not in entity list" << std::endl;
-            continue;
-          }
-
-          CollisionEvent eve(obj_0_it->get(), obj_1_it->get());
-          collision_events.push_back(eve);
-        }
-      }
+      if (step_physics)
+        game::update_physics(game_state);
     }
     profiler.end(Profiler::Stage::Physics);
     profiler.begin(Profiler::Stage::SdlInput);
@@ -273,12 +279,10 @@ main()
         app.window_was_resized = false;
 
         screen_wh = app.get_window().get_size();
+        game_state.screen_wh = screen_wh;
         RenderCommand::set_viewport(0, 0, screen_wh.x, screen_wh.y);
-        glm::mat4 projection =
+        frame_data.projection =
           glm::ortho(0.0f, static_cast<float>(screen_wh.x), static_cast<float>(screen_wh.y), 0.0f, -1.0f, 1.0f);
-
-        instanced_quad_shader.bind();
-        instanced_quad_shader.set_mat4("projection", projection);
       }
 
 #ifdef _DEBUG
@@ -296,11 +300,13 @@ main()
       }
       // Debug: Start camera shake
       if (app.get_input().get_key_held(SDL_SCANCODE_COMMA)) {
-        instanced_quad_shader.set_bool("shake", true);
+        instanced_quad_shader.bind();
+        instanced_quad_shader.set_bool(u_instanced_shake, true);
       }
       // Debug: Stop camera shake
       if (app.get_input().get_key_held(SDL_SCANCODE_PERIOD)) {
-        instanced_quad_shader.set_bool("shake", false);
+        instanced_quad_shader.bind();
+        instanced_quad_shader.set_bool(u_instanced_shake, false);
       }
 
 #endif // _DEBUG
@@ -312,16 +318,16 @@ main()
         // std::cout << "wheel int: " << wheel_int << std::endl;
 
         // temp: cycle through weapons for p0
-        Weapons current_wep = entities_player[0].equipped_weapon;
+        Weapons current_wep = game_state.entities_player[0].equipped_weapon;
 
         if (current_wep == Weapons::SHOVEL)
           current_wep = Weapons::PISTOL;
         else if (current_wep == Weapons::PISTOL)
           current_wep = Weapons::SHOVEL;
 
-        entities_player[0].equipped_weapon = current_wep;
+        game_state.entities_player[0].equipped_weapon = current_wep;
 
-        auto wep = std::string(magic_enum::enum_name(entities_player[0].equipped_weapon));
+        auto wep = std::string(magic_enum::enum_name(game_state.entities_player[0].equipped_weapon));
         std::cout << "equipped: " << wep << std::endl;
       }
 
@@ -345,343 +351,84 @@ main()
         printf("(game) clicked gamegrid %i %i \n", mouse_pos.x, mouse_pos.y);
         glm::vec2 world_pos = glm::vec2(mouse_pos) + camera.pos;
 
-        GameObject2D tree = gameobject::create_tree(tex_unit_kenny_nl);
-        tree.pos = grid::convert_world_space_to_grid_space(world_pos, GAME_GRID_SIZE);
-        tree.pos = grid::convert_grid_space_to_worldspace(tree.pos, GAME_GRID_SIZE);
-        tree.render_size = glm::ivec2(GAME_GRID_SIZE);
-        tree.physics_size = glm::ivec2(GAME_GRID_SIZE);
-
-        entities_trees.push_back(tree);
+        GameObject2D& tree = game::place_tree(game_state, world_pos);
+        sprite_renderer::static_add(static_trees, tree);
+        recorder.add_tree(world_pos);
       }
 
       // Shader hot reloading
       // if (app.get_input().get_key_down(SDL_SCANCODE_R)) {
-      //   reload_shader_program(&fun_shader.ID, "2d_texture.vert", "effects/posterized_water.frag");
+      //   fun_shader.reload();
       //   fun_shader.bind();
       //   fun_shader.set_mat4("projection", projection);
       //   fun_shader.set_int("tex", tex_unit_kenny_nl);
       // }
+      // Debug: Toggle trace capture
+      if (app.get_input().get_key_down(debug_key_toggle_trace))
+        toggle_trace_capture(trace);
+      // Debug: Toggle console
+      if (app.get_input().get_key_down(debug_key_toggle_console))
+        ui_show_console = !ui_show_console;
     }
     profiler.end(Profiler::Stage::SdlInput);
     profiler.begin(Profiler::Stage::GameTick);
     {
-      { // Resolve collision events
-
-        for (auto& event : collision_events) {
-
-          auto& coll_layer_0 = event.go0.collision_layer;
-          auto& coll_layer_1 = event.go1.collision_layer;
-
-          if ((coll_layer_0 == CollisionLayer::Player && coll_layer_1 == CollisionLayer::Enemy) ||
-              (coll_layer_1 == CollisionLayer::Player && coll_layer_0 == CollisionLayer::Enemy)) {
-
-            GameObject2D& enemy = event.go0.collision_layer == CollisionLayer::Enemy ? event.go0 : event.go1;
-            GameObject2D& player = event.go0.collision_layer == CollisionLayer::Enemy ? event.go1 : event.go0;
-
-            if (player.hits_taken >= player.hits_able_to_be_taken)
-              continue; // player is dead
-
-            enemy.flag_for_delete = true;             // enemy
-            player.hits_taken += 1;                   // player
-            player.flash_time_left = vfx_flash_time;  // vfx: flash
-            screenshake_time_left = screenshake_time; // screenshake
-
-            // vfx spawn a splat
-            GameObject2D splat = gameobject::create_generic(sprite_splat, tex_unit_kenny_nl, player_splat_colour);
-            splat.pos = player.pos;
-            splat.angle_radians = fightingengine::rand_det_s(rnd.rng, 0.0f, fightingengine::PI);
-            entities_vfx.push_back(splat);
-          }
-
-          if ((coll_layer_0 == CollisionLayer::Enemy && coll_layer_1 == CollisionLayer::Weapon) ||
-              (coll_layer_1 == CollisionLayer::Enemy && coll_layer_0 == CollisionLayer::Weapon)) {
-
-            GameObject2D& enemy = event.go0.collision_layer == CollisionLayer::Enemy ? event.go0 : event.go1;
-            GameObject2D& weapon = event.go0.collision_layer == CollisionLayer::Enemy ? event.go1 : event.go0;
-            GameObject2D& player = entities_player[0]; // hack: use player 0 for the moment
-
-            for (auto& attack : live_attacks) {
-
-              bool is_shovel = attack.weapon_type == Weapons::SHOVEL;
-              bool collision_with_specific_shovel_attack = weapon.id == attack.entity_weapon_id;
-              bool taken_damage_from_shovel = std::find(enemy.attack_ids_taken_damage_from.begin(),
-                                                        enemy.attack_ids_taken_damage_from.end(),
-                                                        attack.id) != enemy.attack_ids_taken_damage_from.end();
-
-              if (is_shovel && collision_with_specific_shovel_attack && !taken_damage_from_shovel) {
-                // std::cout << "enemy taking damage from weapon attack ONCE!" << std::endl;
-                enemy.hits_taken += 1;
-                enemy.attack_ids_taken_damage_from.push_back(attack.id);
-                enemy.flash_time_left = vfx_flash_time; // vfx: flash
-
-                // vfx impactsplat
-                vfx::spawn_impact_splats(
-                  rnd, enemy, player, sprite_splat, tex_unit_kenny_nl, enemy_impact_splat_colour, entities_vfx);
-              }
-            }
-          }
-
-          if ((coll_layer_0 == CollisionLayer::Bullet && coll_layer_1 == CollisionLayer::Enemy) ||
-              (coll_layer_1 == CollisionLayer::Bullet && coll_layer_0 == CollisionLayer::Enemy)) {
-            GameObject2D& bullet = event.go0.collision_layer == CollisionLayer::Bullet ? event.go0 : event.go1;
-            GameObject2D& enemy = event.go0.collision_layer == CollisionLayer::Bullet ? event.go1 : event.go0;
-            GameObject2D& player = entities_player[0]; // hack: use player 0 for the moment
-
-            for (auto& attack : live_attacks) {
-
-              bool is_bullet = attack.weapon_type == Weapons::PISTOL;
-              bool collision_with_specific_bullet = bullet.id == attack.entity_weapon_id;
-              bool taken_damage_from_bullet = std::find(enemy.attack_ids_taken_damage_from.begin(),
-                                                        enemy.attack_ids_taken_damage_from.end(),
-                                                        attack.id) != enemy.attack_ids_taken_damage_from.end();
-
-              if (is_bullet && collision_with_specific_bullet && !taken_damage_from_bullet) {
-                // std::cout << "enemy taking damage from bullet attack ONCE!" << std::endl;
-                enemy.hits_taken += 1;
-                enemy.attack_ids_taken_damage_from.push_back(attack.id);
-                enemy.flash_time_left = vfx_flash_time; // vfx: flash
-
-                // vfx impactsplat
-                vfx::spawn_impact_splats(
-                  rnd, enemy, player, sprite_splat, tex_unit_kenny_nl, enemy_impact_splat_colour, entities_vfx);
-              }
-            }
-          }
-
-          if ((coll_layer_0 == CollisionLayer::Obstacle && coll_layer_1 == CollisionLayer::Player) ||
-              (coll_layer_1 == CollisionLayer::Obstacle && coll_layer_0 == CollisionLayer::Player)) {
-
-            GameObject2D& obstacle = event.go0.collision_layer == CollisionLayer::Obstacle ? event.go0 : event.go1;
-            GameObject2D& player = event.go0.collision_layer == CollisionLayer::Obstacle ? event.go1 : event.go0;
-
-            ImGui::Begin("Huh. Well then.", NULL, ImGuiWindowFlags_NoFocusOnAppearing);
-            ImGui::Text("You are standing at a tree. Cool!");
-            ImGui::End();
-          }
-        }
-      }
-
       { // Update player's input
-        for (int i = 0; i < entities_player.size(); i++) {
-          GameObject2D& player = entities_player[i];
-          KeysAndState& keys = player_keys[i];
-
-          player::update_input(player, keys, app, camera);
-
-          if (keys.pause_pressed)
-            state = state == GameRunning::PAUSED ? GameRunning::ACTIVE : GameRunning::PAUSED;
-        }
+        for (int i = 0; i < game_state.entities_player.size(); i++)
+          player::update_input(game_state.entities_player[i], game_state.player_keys[i], app, camera);
       }
 
-      // Update game state
-
-      if (state == GameRunning::ACTIVE) {
+      game_state.player_attacks_enabled = editor_left_click_mode == EditorMode::PLAYER_ATTACK;
+      recorder.capture(game_state, delta_time_s, step_physics);
+      game::update(game_state, delta_time_s);
 
-        // update: players
-
-        for (int i = 0; i < entities_player.size(); i++) {
-          GameObject2D& player = entities_player[i];
-          KeysAndState& keys = player_keys[i];
-
-          player.velocity.x = keys.l_analogue_x;
-          player.velocity.y = keys.l_analogue_y;
-          player.velocity *= player.speed_current;
-
-          player::ability_boost(player, keys, delta_time_s);
-          gameobject::update_position(player, delta_time_s);
-
-          if (editor_left_click_mode == EditorMode::PLAYER_ATTACK) {
-            if (player.equipped_weapon == Weapons::SHOVEL)
-              player::ability_slash(app, player, keys, weapon_base, delta_time_s, live_attacks);
-            if (player.equipped_weapon == Weapons::PISTOL)
-              player::ability_shoot(app,
-                                    player,
-                                    keys,
-                                    entities_bullets,
-                                    tex_unit_kenny_nl,
-                                    bullet_colour,
-                                    sprite_bullet,
-                                    delta_time_s,
-                                    live_attacks);
-          }
-
-          bool player_alive = player.invulnerable || player.hits_taken < player.hits_able_to_be_taken;
-          if (!player_alive)
-            state = GameRunning::GAME_OVER;
-        }
-
-        // update: bullets
-
-        for (auto& bullet : entities_bullets) {
-          bullet::update(bullet, delta_time_s);
-        }
-
-        // update: vfx
-
-        for (auto& obj : entities_vfx) {
-          gameobject::update_position(obj, delta_time_s);
-        }
-
-        // update: vfx flash
-
-        for (auto& obj : entities_player) {
-          if (obj.flash_time_left > 0.0f) {
-            obj.flash_time_left -= delta_time_s;
-            obj.colour = enemy_impact_splat_colour;
-          } else {
-            obj.colour = player_colour;
-          }
-        }
-        for (auto& obj : entities_enemies) {
-          if (obj.flash_time_left > 0.0f) {
-            obj.flash_time_left -= delta_time_s;
-            obj.colour = enemy_impact_splat_colour;
-          } else {
-            obj.colour = enemy_colour;
-          }
-        }
-
-        // update: vfx screenshake
-
-        if (screenshake_time_left > 0.0f) {
-          screenshake_time_left -= delta_time_s;
-          instanced_quad_shader.bind();
-          instanced_quad_shader.set_bool("shake", true);
-        }
-        if (screenshake_time_left <= 0.0f) {
-          instanced_quad_shader.bind();
-          instanced_quad_shader.set_bool("shake", false);
-        }
-
-        // update: spawn enemies
-
-        size_t players_in_game = entities_player.size();
-        if (players_in_game > 0) {
-
-          // for the moment, eat player 0
-          GameObject2D player_to_chase = entities_player[0];
-
-          // update with ai behaviour
-          for (auto& obj : entities_enemies) {
-
-            // check every frame: close to player?
-            float distance_squared = glm::distance2(obj.pos, player_to_chase.pos);
-            if (distance_squared < game_enemy_direct_attack_threshold) {
-              // push new ai behaviour
-              if (obj.ai_priority_list.size() > 0 && obj.ai_priority_list.back() != AiBehaviour::MOVEMENT_DIRECT) {
-                obj.ai_priority_list.push_back(AiBehaviour::MOVEMENT_DIRECT);
-              }
-            } else {
-              // far away! check if our original ai was move direct or arc angle. pop arc angle if it was pushed.
-              if (obj.ai_priority_list.size() > 1 && obj.ai_priority_list.back() == AiBehaviour::MOVEMENT_DIRECT) {
-                obj.ai_priority_list.pop_back();
-              }
-            }
-
-            // update: ai behaviour (note, currently runs every frame probably bad)
-            if (obj.ai_priority_list.size() > 0 && obj.ai_priority_list.back() == AiBehaviour::MOVEMENT_DIRECT) {
-              enemy_ai::enemy_directly_to_player(obj, player_to_chase, delta_time_s);
-            } else if (obj.ai_priority_list.size() > 0 &&
-                       obj.ai_priority_list.back() == AiBehaviour::MOVEMENT_ARC_ANGLE) {
-              enemy_ai::enemy_arc_angles_to_player(obj, player_to_chase, delta_time_s);
-            }
-          }
-
-          //... and only spawn enemies if there is a player.
-          enemy_spawner::update(entities_enemies,
-                                entities_player,
-                                camera,
-                                rnd,
-                                screen_wh,
-                                game_safe_radius_around_player,
-                                tex_unit_kenny_nl,
-                                enemy_colour,
-                                sprite_enemy_core,
-                                delta_time_s);
-
-          // update camera pos
-          camera::update(camera, player_keys[0], app, delta_time_s);
-        }
-
-        { // object lifecycle
-
-          gameobject::update_entities_lifecycle(entities_enemies, delta_time_s);
-          gameobject::update_entities_lifecycle(entities_bullets, delta_time_s);
-          gameobject::update_entities_lifecycle(entities_vfx, delta_time_s);
-
-          // remove "attack" object before deleting "bullet" object (or any object that is cleaned up)
-          // e.g when deleting "player" (in the future)
-          std::vector<Attack>::iterator it = live_attacks.begin();
-          while (it != live_attacks.end()) {
-            const Attack& attack = (*it);
-            int id = attack.entity_weapon_id;
-
-            if (attack.weapon_type == Weapons::PISTOL) {
-              const auto& bullet = std::find_if(
-                entities_bullets.begin(), entities_bullets.end(), [&id](const auto& obj) { return obj.id == id; });
-
-              if (bullet != entities_bullets.end() && bullet->flag_for_delete) {
-                // remove the attack object
-                it = live_attacks.erase(it);
-                continue;
-              }
-            }
-            ++it;
-          }
-
-          // enemy has died
-          for (auto& enemy : entities_enemies) {
-            if (enemy.flag_for_delete) {
-              vfx::spawn_death_splat(rnd, enemy, enemy.sprite, tex_unit_kenny_nl, enemy.colour, entities_vfx);
-            }
-          }
+      if (game_state.player_at_obstacle) {
+        ImGui::Begin("Huh. Well then.", NULL, ImGuiWindowFlags_NoFocusOnAppearing);
+        ImGui::Text("You are standing at a tree. Cool!");
+        ImGui::End();
+      }
 
-          gameobject::erase_entities_that_are_flagged_for_delete(entities_enemies, delta_time_s);
-          gameobject::erase_entities_that_are_flagged_for_delete(entities_bullets, delta_time_s);
-          gameobject::erase_entities_that_are_flagged_for_delete(entities_vfx, delta_time_s);
-        }
+      // update: vfx screenshake
+      if (game_state.running == GameRunning::ACTIVE) {
+        instanced_quad_shader.bind();
+        instanced_quad_shader.set_bool(u_instanced_shake, game_state.screenshake_time_left > 0.0f);
       }
+
       profiler.end(Profiler::Stage::GameTick);
       profiler.begin(Profiler::Stage::Render);
       {
         RenderCommand::set_clear_colour(background_colour);
         RenderCommand::clear();
         sprite_renderer::reset_stats();
+        RenderCommand::reset_state_stats();
+
+        frame_data.time = app.seconds_since_launch;
+        frame_data_ubo.update(&frame_data, sizeof(FrameData));
+
+        decal_renderer::stamp_pending(decals, decal_stamp_shader, screen_wh);
         sprite_renderer::begin_batch();
-        instanced_quad_shader.bind();
-        instanced_quad_shader.set_float("time", app.seconds_since_launch);
 
-        if (state == GameRunning::ACTIVE || state == GameRunning::PAUSED || state == GameRunning::GAME_OVER) {
+        if (game_state.running == GameRunning::ACTIVE || game_state.running == GameRunning::PAUSED ||
+            game_state.running == GameRunning::GAME_OVER) {
 
           std::vector<std::reference_wrapper<GameObject2D>> renderables;
-          renderables.insert(renderables.end(), entities_vfx.begin(), entities_vfx.end());
-          renderables.insert(renderables.end(), entities_enemies.begin(), entities_enemies.end());
-          renderables.insert(renderables.end(), entities_bullets.begin(), entities_bullets.end());
-          renderables.insert(renderables.end(), entities_player.begin(), entities_player.end());
-          renderables.insert(renderables.end(), entities_trees.begin(), entities_trees.end());
-          renderables.push_back(weapon_base);
-
-          if (ui_show_entity_menu) {
-            ImGui::Begin("Entity Menu", NULL, ImGuiWindowFlags_NoFocusOnAppearing);
-            {
-              ImGui::Text("Players: %i", entities_player.size());
-              ImGui::Text("Bullets: %i", entities_bullets.size());
-              ImGui::Text("Enemies: %i", entities_enemies.size());
-              ImGui::Text("Vfx: %i", entities_vfx.size());
-              ImGui::Text("Attacks: %i", live_attacks.size());
-              ImGui::Separator();
+          renderables.insert(renderables.end(), game_state.entities_vfx.begin(), game_state.entities_vfx.end());
+          renderables.insert(
+            renderables.end(), game_state.entities_enemies.begin(), game_state.entities_enemies.end());
+          renderables.insert(
+            renderables.end(), game_state.entities_bullets.begin(), game_state.entities_bullets.end());
+          renderables.insert(renderables.end(), game_state.entities_player.begin(), game_state.entities_player.end());
+          renderables.push_back(game_state.weapon_base);
 
-              for (auto& e : renderables) {
-                for (auto& c : e.get().in_physics_grid_cell) {
-                  ImGui::Text("id: %i entity: %s in cell: x:%i y:%i", e.get().id, e.get().name.c_str(), c.x, c.y);
-                }
-              }
-            }
-            ImGui::End();
-          }
+          if (ui_show_entity_menu)
+            entity_inspector::draw(entity_inspector, game_state);
+
+          // decals are drawn first, so they sit underneath everything
+          decal_renderer::draw(decals, camera, screen_wh, decal_composite_shader);
 
           // all sprites from kennynl
-          instanced_quad_shader.set_int("tex", tex_unit_kenny_nl);
+          instanced_quad_shader.bind();
+          instanced_quad_shader.set_int(u_instanced_tex, tex_unit_kenny_nl);
 
           for (auto& obj : renderables) {
             if (!obj.get().do_render)
@@ -708,12 +455,9 @@ main()
           // other sprites
 
           instanced_quad_shader.bind();
-          instanced_quad_shader.set_int("tex", tex_tree);
+          instanced_quad_shader.set_int(u_instanced_tex, tex_tree);
 
-          for (auto& obj : entities_trees) {
-            sprite_renderer::draw_sprite_debug(
-              camera, screen_wh, instanced_quad_shader, obj, obj.render_size, colour_shader, debug_line_colour);
-          }
+          sprite_renderer::static_draw(static_trees, camera, screen_wh, instanced_quad_shader);
         }
 
         sprite_renderer::end_batch();
@@ -766,14 +510,22 @@ main()
               app.get_window().toggle_fullscreen(); // SDL2 window toggle
               glm::ivec2 screen_wh = app.get_window().get_size();
               RenderCommand::set_viewport(0, 0, screen_wh.x, screen_wh.y);
-              glm::mat4 projection =
+              frame_data.projection =
                 glm::ortho(0.0f, static_cast<float>(screen_wh.x), static_cast<float>(screen_wh.y), 0.0f, -1.0f, 1.0f);
-              instanced_quad_shader.bind();
-              instanced_quad_shader.set_mat4("projection", projection);
             }
             ui_fullscreen = temp;
           }
 
+          { // trace capture
+            temp = trace.is_capturing();
+            ImGui::Checkbox("Trace (F9)", &temp);
+            if (temp != trace.is_capturing())
+              toggle_trace_capture(trace);
+          }
+
+          ImGui::Checkbox("Scenario", &ui_show_scenario);
+          ImGui::Checkbox("Console (`)", &ui_show_console);
+
           ImGui::SameLine(screen_wh.x - 50.0f);
           if (ImGui::MenuItem("Quit", "Esc"))
             app.shutdown();
@@ -784,9 +536,9 @@ main()
         if (ui_show_game_info) {
           ImGui::Begin("Game Info", NULL, ImGuiWindowFlags_NoFocusOnAppearing);
           {
-            for (int i = 0; i < entities_player.size(); i++) {
-              GameObject2D& player = entities_player[i];
-              ImGui::Text("GO Destroyed: %i", game_objects_destroyed);
+            for (int i = 0; i < game_state.entities_player.size(); i++) {
+              GameObject2D& player = game_state.entities_player[i];
+              ImGui::Text("GO Destroyed: %i", game_state.game_objects_destroyed);
               ImGui::Text("PLAYER_ID: %i", player.id);
               ImGui::Text("PLAYER_HP_MAX %i", player.hits_able_to_be_taken);
               ImGui::Text("PLAYER_HITS_TAKEN %i", player.hits_taken);
@@ -800,7 +552,7 @@ main()
             ImGui::Text("game running for: %f", app.seconds_since_launch);
             ImGui::Text("camera pos %f %f", camera.pos.x, camera.pos.y);
             ImGui::Text("mouse pos %f %f", app.get_input().get_mouse_pos().x, app.get_input().get_mouse_pos().y);
-            ImGui::Text("PhysicsGridSize %i", PHYSICS_GRID_SIZE);
+            ImGui::Text("PhysicsGridSize %i", game::cvar_physics_grid_size.get());
 
             // collect number of ARC_ANGLE ai
 
@@ -809,11 +561,72 @@ main()
             ImGui::Separator();
             ImGui::Text("draw_calls: %i", sprite_renderer::get_draw_calls());
             ImGui::Text("quad_verts: %i", sprite_renderer::get_quad_count());
+            ImGui::Text("static chunks drawn: %i (rebuilt: %i)",
+                        static_trees.chunks_drawn,
+                        static_trees.chunk_rebuilds);
+            ImGui::Text("decal chunks live: %i drawn: %i (evicted: %i)",
+                        decals.get_chunks().size(),
+                        decal_renderer::get_chunks_drawn(),
+                        decals.chunks_evicted);
+            ImGui::Text("decals stamped: %i pending: %i",
+                        decal_renderer::get_stamps_last_frame(),
+                        decals.get_pending_count());
           }
           ImGui::End();
         }
       }
 
+      if (ui_show_console)
+        console.Draw("Console", &ui_show_console);
+
+      if (ui_show_scenario) {
+        ImGui::Begin("Scenario", &ui_show_scenario, ImGuiWindowFlags_NoFocusOnAppearing);
+        {
+          int seed = static_cast<int>(ui_scenario.seed);
+          ImGui::InputInt("seed", &seed);
+          ui_scenario.seed = static_cast<uint32_t>(seed);
+          ImGui::SliderFloat("radius", &ui_scenario.radius, 100.0f, 10000.0f);
+
+          ImGui::Separator();
+          ImGui::SliderInt("enemies", &ui_scenario.enemies, 0, 20000);
+          bool swarms = ui_scenario.enemy_layout == ScenarioLayout::SWARMS;
+          ImGui::Checkbox("swarms", &swarms);
+          ui_scenario.enemy_layout = swarms ? ScenarioLayout::SWARMS : ScenarioLayout::SPREAD;
+          if (swarms) {
+            ImGui::SliderInt("swarm count", &ui_scenario.swarms, 1, 64);
+            ImGui::SliderFloat("swarm radius", &ui_scenario.swarm_radius, 10.0f, 1000.0f);
+          }
+
+          ImGui::Separator();
+          ImGui::SliderInt("bullets", &ui_scenario.bullets, 0, 20000);
+          ImGui::SliderInt("trees", &ui_scenario.trees, 0, 20000);
+          ImGui::SliderInt("splats", &ui_scenario.splats, 0, 20000);
+
+          if (ImGui::Button("Spawn")) {
+            size_t trees_before = game_state.entities_trees.size();
+            ScenarioStats stats = scenario::populate(game_state, ui_scenario);
+            recorder.add_scenario(ui_scenario);
+            for (size_t i = trees_before; i < game_state.entities_trees.size(); i++)
+              sprite_renderer::static_add(static_trees, game_state.entities_trees[i]);
+            std::cout << "(scenario) seed " << ui_scenario.seed << " spawned " << stats.enemies << " enemies, "
+                      << stats.bullets << " bullets, " << stats.trees << " trees, " << stats.splats << " splats"
+                      << std::endl;
+          }
+          ImGui::SameLine();
+          if (ImGui::Button("Next seed"))
+            ui_scenario.seed += 1;
+        }
+        ImGui::End();
+      }
+
+      if (trace.is_capturing()) {
+        trace.add_counter("entities_enemies", static_cast<double>(game_state.entities_enemies.size()));
+        trace.add_counter("entities_bullets", static_cast<double>(game_state.entities_bullets.size()));
+        trace.add_counter("entities_vfx", static_cast<double>(game_state.entities_vfx.size()));
+        trace.add_counter("draw_calls", sprite_renderer::get_draw_calls());
+        trace.add_counter("quads", sprite_renderer::get_quad_count());
+      }
+
       if (debug_show_profiler)
         profiler_panel::draw(profiler, delta_time_s);
       if (debug_show_imgui_demo_window)
@@ -822,10 +635,30 @@ main()
     profiler.end(Profiler::Stage::GuiLoop);
     profiler.begin(Profiler::Stage::FrameEnd);
     {
+      recorder.end_frame(game_state); // after the console, so cvar changes land on the frame they were made
       debug_advance_one_frame = false;
       app.frame_end(frame_start_time);
     }
     profiler.end(Profiler::Stage::FrameEnd);
     profiler.end(Profiler::Stage::UpdateLoop);
   }
+
+  if (recorder.is_recording()) {
+    const Replay replay = recorder.get_replay();
+    if (replay::save(record_path, replay))
+      std::cout << "(replay) " << replay.header.frames << " frames, " << replay.frame_bytes.size()
+                << " bytes, saved to " << record_path << std::endl;
+    else
+      std::cerr << "(replay) failed to save " << record_path << std::endl;
+  }
+
+  logger::stop();
+
+  if (alloc_budget) {
+    std::cout << "(alloc budget) " << alloc_budget->get_frames_over_budget() << " of "
+              << alloc_budget->get_frames_checked()
+              << " frames over budget, worst: " << alloc_budget->get_worst_frame_allocs() << std::endl;
+    return alloc_budget->passed() ? 0 : 1;
+  }
+  return 0;
 }
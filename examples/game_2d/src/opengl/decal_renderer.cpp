@@ -0,0 +1,219 @@
+// header
+#include "opengl/decal_renderer.hpp"
+
+// standard lib headers
+#include <vector>
+
+// other project headers
+#include <GL/glew.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+// engine project headers
+#include "engine/opengl/render_command.hpp"
+#include "engine/tools/zone_profiler.hpp"
+
+// game headers
+#include "opengl/sprite_renderer.hpp"
+
+namespace game2d {
+
+namespace decal_renderer {
+
+struct decal_data
+{
+  int chunk_size = 0;
+  int tex_unit = 0;
+
+  std::vector<unsigned int> fbos;
+  std::vector<unsigned int> textures;
+
+  // unit quad used to composite a chunk
+  unsigned int VAO = 0;
+  unsigned int VBO = 0;
+
+  std::vector<fightingengine::DecalBatch> batches; // scratch
+
+  // stats
+  int chunks_drawn = 0;
+  int stamps_last_frame = 0;
+};
+static decal_data s_decal_data;
+
+void
+init(const fightingengine::DecalLayer& layer, const int tex_unit)
+{
+  fightingengine::RenderBackend& backend = fightingengine::RenderCommand::get_backend();
+
+  s_decal_data.chunk_size = layer.get_chunk_size();
+  s_decal_data.tex_unit = tex_unit;
+
+  // render targets start out empty
+  fightingengine::RenderCommand::set_clear_colour(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+
+  int count = layer.get_max_chunks();
+  for (int i = 0; i < count; i++) {
+    unsigned int texture = backend.create_texture(s_decal_data.chunk_size, s_decal_data.chunk_size);
+    unsigned int fbo = backend.create_framebuffer(texture);
+    s_decal_data.textures.push_back(texture);
+    s_decal_data.fbos.push_back(fbo);
+
+    backend.bind_framebuffer(fbo);
+    fightingengine::RenderCommand::clear();
+  }
+  backend.bind_framebuffer(0);
+
+  // clang-format off
+  float quad[] = {
+    // pos       // tex (render targets are upside down)
+    0.0f, 0.0f,  0.0f, 1.0f,
+    1.0f, 0.0f,  1.0f, 1.0f,
+    0.0f, 1.0f,  0.0f, 0.0f,
+    1.0f, 1.0f,  1.0f, 0.0f,
+  };
+  // clang-format on
+  s_decal_data.VAO = backend.create_vertex_array();
+  s_decal_data.VBO = backend.create_buffer();
+  fightingengine::RenderCommand::bind_vertex_array(s_decal_data.VAO);
+  fightingengine::RenderCommand::bind_array_buffer(s_decal_data.VBO);
+  backend.buffer_data(fightingengine::BufferTarget::ARRAY, sizeof(quad), quad, fightingengine::BufferUsage::STATIC);
+  backend.vertex_attribute(0, 4, 4 * sizeof(float), 0);
+  fightingengine::RenderCommand::bind_vertex_array(0);
+}
+
+void
+shutdown()
+{
+  fightingengine::RenderBackend& backend = fightingengine::RenderCommand::get_backend();
+  for (unsigned int fbo : s_decal_data.fbos)
+    backend.delete_framebuffer(fbo);
+  for (unsigned int texture : s_decal_data.textures)
+    backend.delete_texture(texture);
+  backend.delete_vertex_array(s_decal_data.VAO);
+  backend.delete_buffer(s_decal_data.VBO);
+  s_decal_data.fbos.clear();
+  s_decal_data.textures.clear();
+}
+
+void
+stamp_pending(fightingengine::DecalLayer& layer,
+              fightingengine::Shader& stamp_shader,
+              const glm::ivec2& screen_size)
+{
+  PROFILE_ZONE("decal_renderer::stamp");
+  s_decal_data.stamps_last_frame = 0;
+
+  layer.take_pending(s_decal_data.batches);
+  if (s_decal_data.batches.empty())
+    return;
+
+  float size = static_cast<float>(s_decal_data.chunk_size);
+  fightingengine::RenderCommand::set_viewport(0, 0, s_decal_data.chunk_size, s_decal_data.chunk_size);
+
+  // the projection in the shared FrameData block maps the screen to clip space,
+  // so scale chunk space up to fill the screen to map the chunk to clip space
+  glm::vec2 chunk_to_screen = glm::vec2(screen_size) / size;
+  stamp_shader.bind();
+  stamp_shader.set_mat4(stamp_shader.get_uniform("view"),
+                        glm::scale(glm::mat4(1.0f), glm::vec3(chunk_to_screen.x, chunk_to_screen.y, 1.0f)));
+
+  fightingengine::RenderBackend& backend = fightingengine::RenderCommand::get_backend();
+  fightingengine::RenderCommand::set_clear_colour(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+
+  // stamps are straight alpha, blended over a transparent target. rgb is weighted by each stamp's alpha
+  // and alpha adds up coverage, so the chunk ends up premultiplied
+  fightingengine::RenderCommand::set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+  for (const fightingengine::DecalBatch& batch : s_decal_data.batches) {
+    backend.bind_framebuffer(s_decal_data.fbos[batch.render_target]);
+    if (batch.clear_first)
+      fightingengine::RenderCommand::clear();
+
+    // decals that overhang the chunk are clipped by the render target,
+    // the rest of them lands in the neighbouring chunk's stamp
+    glm::vec2 chunk_origin = glm::vec2(batch.coord) * size;
+
+    sprite_renderer::begin_batch();
+    for (const fightingengine::Decal& d : batch.decals) {
+      sprite_renderer::draw_instanced_quad(
+        stamp_shader, d.pos - chunk_origin, d.size, d.angle_radians, d.sprite_offset, d.colour);
+    }
+    sprite_renderer::end_batch();
+    sprite_renderer::flush(stamp_shader);
+
+    s_decal_data.stamps_last_frame += static_cast<int>(batch.decals.size());
+  }
+
+  backend.bind_framebuffer(0);
+  fightingengine::RenderCommand::set_viewport(
+    0, 0, static_cast<uint32_t>(screen_size.x), static_cast<uint32_t>(screen_size.y));
+}
+
+void
+draw(const fightingengine::DecalLayer& layer,
+     const GameObject2D& cam,
+     const glm::ivec2& screen_size,
+     fightingengine::Shader& composite_shader)
+{
+  s_decal_data.chunks_drawn = 0;
+
+  float size = static_cast<float>(s_decal_data.chunk_size);
+  glm::vec2 view_tl = cam.pos;
+  glm::vec2 view_br = cam.pos + glm::vec2(screen_size);
+
+  // resolved once per call rather than once per chunk, so they follow the shader if it's reloaded
+  fightingengine::UniformHandle u_model = composite_shader.get_uniform("model");
+  fightingengine::UniformHandle u_last_stamp_time = composite_shader.get_uniform("last_stamp_time");
+  fightingengine::UniformHandle u_decal_time = composite_shader.get_uniform("decal_time");
+  fightingengine::UniformHandle u_hold_time = composite_shader.get_uniform("hold_time");
+  fightingengine::UniformHandle u_fade_time = composite_shader.get_uniform("fade_time");
+  fightingengine::UniformHandle u_tex = composite_shader.get_uniform("tex");
+
+  composite_shader.bind();
+  composite_shader.set_float(u_decal_time, layer.get_time());
+  composite_shader.set_float(u_hold_time, layer.get_hold_time());
+  composite_shader.set_float(u_fade_time, layer.get_fade_time());
+  composite_shader.set_int(u_tex, s_decal_data.tex_unit);
+
+  fightingengine::RenderCommand::bind_vertex_array(s_decal_data.VAO);
+
+  // the chunks are premultiplied (see stamp_pending)
+  fightingengine::RenderCommand::set_blend_func(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+  for (const auto& kv : layer.get_chunks()) {
+    const fightingengine::DecalChunk& chunk = kv.second;
+
+    glm::vec2 tl = glm::vec2(chunk.coord) * size;
+    glm::vec2 br = tl + glm::vec2(size, size);
+    if (br.x < view_tl.x || br.y < view_tl.y || tl.x > view_br.x || tl.y > view_br.y)
+      continue;
+
+    // chunk position in camera space
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, glm::vec3(tl - cam.pos, 0.0f));
+    model = glm::scale(model, glm::vec3(size, size, 1.0f));
+    composite_shader.set_mat4(u_model, model);
+    composite_shader.set_float(u_last_stamp_time, chunk.last_stamp_time_s);
+
+    fightingengine::RenderCommand::bind_texture(s_decal_data.tex_unit, s_decal_data.textures[chunk.render_target]);
+    fightingengine::RenderCommand::get_backend().draw_triangle_strip(0, 4);
+    s_decal_data.chunks_drawn += 1;
+  }
+
+  fightingengine::RenderCommand::set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+int
+get_chunks_drawn()
+{
+  return s_decal_data.chunks_drawn;
+}
+
+int
+get_stamps_last_frame()
+{
+  return s_decal_data.stamps_last_frame;
+}
+
+} // namespace decal_renderer
+
+} // namespace game2d
@@ -0,0 +1,52 @@
+#pragma once
+
+// other project headers
+#include <glm/glm.hpp>
+
+// your project headers
+#include "2d_game_object.hpp"
+#include "engine/opengl/shader.hpp"
+#include "engine/vfx/decal_layer.hpp"
+
+namespace game2d {
+
+namespace decal_renderer {
+
+// Each live chunk in the DecalLayer owns one RGBA render target. New decals are
+// rendered into their chunk's target once, then the chunk is composited each frame
+// as a single textured quad. The fade-out is done in the composition shader, so
+// nothing on the CPU scales with the number of decals that have been stamped.
+
+// allocates a render target for each of the layer's chunk slots
+void
+init(const fightingengine::DecalLayer& layer, const int tex_unit);
+
+void
+shutdown();
+
+// renders any queued stamps in to their chunk's render target.
+// stamp_shader should be an instanced sprite shader not used for anything else,
+// as its view matrix is changed.
+// note: changes the bound framebuffer, viewport and clear colour.
+// the framebuffer and viewport are restored after
+void
+stamp_pending(fightingengine::DecalLayer& layer,
+              fightingengine::Shader& stamp_shader,
+              const glm::ivec2& screen_size);
+
+// composites the visible chunks
+void
+draw(const fightingengine::DecalLayer& layer,
+     const GameObject2D& cam,
+     const glm::ivec2& screen_size,
+     fightingengine::Shader& composite_shader);
+
+// stats
+int
+get_chunks_drawn();
+int
+get_stamps_last_frame();
+
+} // namespace decal_renderer
+
+} // namespace game2d
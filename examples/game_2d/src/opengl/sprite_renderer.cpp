@@ -3,16 +3,22 @@
 #include "opengl/sprite_renderer.hpp"
 
 // standard lib headers
+#include <algorithm>
 #include <array>
 #include <iostream>
+#include <vector>
 
 // other project headers
 #include <GL/glew.h>
 #include <glm/gtc/matrix_transform.hpp>
 
 // engine project headers
+#include "engine/grid.hpp"
 #include "engine/maths_core.hpp"
+#include "engine/opengl/render_command.hpp"
 #include "engine/opengl/util.hpp"
+#include "engine/tools/cvars.hpp"
+#include "engine/tools/zone_profiler.hpp"
 using namespace fightingengine; // used for opengl macro
 #include "2d_game_object.hpp"
 #include "spritemap.hpp"
@@ -37,6 +43,13 @@ static const size_t max_quad = 5000;
 static const size_t max_quad_vert_count = max_quad * 4;
 static const size_t max_quad_index_count = max_quad * 6;
 
+// the buffers are sized for max_quad, this only flushes sooner
+static CVar<int> cvar_batch_quads("render.batch_quads",
+                                  static_cast<int>(max_quad),
+                                  "quads per batched draw call",
+                                  64,
+                                  static_cast<int>(max_quad));
+
 struct renderer_data
 {
   unsigned int VAO = 0;
@@ -44,6 +57,7 @@ struct renderer_data
   unsigned int EBO = 0;
 
   uint32_t index_count = 0;
+  uint32_t index_limit = max_quad_index_count; // from cvar_batch_quads, each begin_batch()
 
   Vertex* buffer;
   Vertex* buffer_ptr;
@@ -71,42 +85,35 @@ get_quad_count()
   return s_data.quad_vertex;
 }
 
+// expects the vao and vbo to be bound
+static void
+setup_vertex_attributes()
+{
+  RenderBackend& backend = RenderCommand::get_backend();
+  backend.vertex_attribute(0, 4, sizeof(Vertex), offsetof(Vertex, pos_and_tex));
+  backend.vertex_attribute(1, 4, sizeof(Vertex), offsetof(Vertex, colour));
+  backend.vertex_attribute(2, 4, sizeof(Vertex), offsetof(Vertex, sprite_pos));
+  backend.vertex_attribute(3, 4, sizeof(Vertex), offsetof(Vertex, model));
+  backend.vertex_attribute(4, 4, sizeof(Vertex), offsetof(Vertex, model) + 1 * sizeof(glm::vec4));
+  backend.vertex_attribute(5, 4, sizeof(Vertex), offsetof(Vertex, model) + 2 * sizeof(glm::vec4));
+  backend.vertex_attribute(6, 4, sizeof(Vertex), offsetof(Vertex, model) + 3 * sizeof(glm::vec4));
+}
+
 void
 init()
 {
   s_data.buffer = new Vertex[max_quad_vert_count];
 
-  glGenVertexArrays(1, &s_data.VAO);
-  glGenBuffers(1, &s_data.VBO);
-  glGenBuffers(1, &s_data.EBO);
-  glBindVertexArray(s_data.VAO); // bind the vao
-
-  glBindBuffer(GL_ARRAY_BUFFER, s_data.VBO);
-  glBufferData(GL_ARRAY_BUFFER, max_quad_vert_count * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW); // dynamic
-
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, pos_and_tex));
+  RenderBackend& backend = RenderCommand::get_backend();
+  s_data.VAO = backend.create_vertex_array();
+  s_data.VBO = backend.create_buffer();
+  s_data.EBO = backend.create_buffer();
+  RenderCommand::bind_vertex_array(s_data.VAO); // bind the vao
 
-  glEnableVertexAttribArray(1);
-  glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, colour));
+  RenderCommand::bind_array_buffer(s_data.VBO);
+  backend.buffer_data(BufferTarget::ARRAY, max_quad_vert_count * sizeof(Vertex), nullptr, BufferUsage::DYNAMIC);
 
-  glEnableVertexAttribArray(2);
-  glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, sprite_pos));
-
-  glEnableVertexAttribArray(3);
-  glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, model));
-
-  glEnableVertexAttribArray(4);
-  glVertexAttribPointer(
-    4, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)(offsetof(Vertex, model) + 1 * sizeof(glm::vec4)));
-
-  glEnableVertexAttribArray(5);
-  glVertexAttribPointer(
-    5, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)(offsetof(Vertex, model) + 2 * sizeof(glm::vec4)));
-
-  glEnableVertexAttribArray(6);
-  glVertexAttribPointer(
-    6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)(offsetof(Vertex, model) + 3 * sizeof(glm::vec4)));
+  setup_vertex_attributes();
 
   uint32_t indices[max_quad_index_count];
   uint32_t index_offset = 0;
@@ -122,20 +129,20 @@ init()
     index_offset += 4;
   }
 
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_data.EBO);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+  backend.bind_buffer(BufferTarget::ELEMENT, s_data.EBO);
+  backend.buffer_data(BufferTarget::ELEMENT, sizeof(indices), indices, BufferUsage::STATIC);
 
-  // unbind vbo and vao
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindVertexArray(0);
+  // unbind vao, so nothing else modifies it
+  RenderCommand::bind_vertex_array(0);
 }
 
 void
 shutdown()
 {
-  glDeleteVertexArrays(1, &s_data.VAO);
-  glDeleteBuffers(1, &s_data.VBO);
-  glDeleteBuffers(1, &s_data.EBO);
+  RenderBackend& backend = RenderCommand::get_backend();
+  backend.delete_vertex_array(s_data.VAO);
+  backend.delete_buffer(s_data.VBO);
+  backend.delete_buffer(s_data.EBO);
 
   delete[] s_data.buffer;
 }
@@ -143,34 +150,82 @@ shutdown()
 void
 end_batch()
 {
-  GLsizeiptr size = (uint8_t*)s_data.buffer_ptr - (uint8_t*)s_data.buffer;
+  PROFILE_ZONE("sprite_renderer::upload");
+  size_t size = (uint8_t*)s_data.buffer_ptr - (uint8_t*)s_data.buffer;
   // Set dynamic vertex buffer & upload data
-  glBindBuffer(GL_ARRAY_BUFFER, s_data.VBO);
-  // glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
-  glBufferSubData(GL_ARRAY_BUFFER, 0, size, s_data.buffer);
+  RenderCommand::bind_array_buffer(s_data.VBO);
+  RenderCommand::get_backend().buffer_sub_data(BufferTarget::ARRAY, 0, size, s_data.buffer);
 }
 
 // submit quads for a drawcall
 void
 flush(fightingengine::Shader& shader)
 {
+  // note: both of these are no-ops if already bound, so the vao is left bound
   shader.bind();
+  RenderCommand::bind_vertex_array(s_data.VAO);
 
-  glBindVertexArray(s_data.VAO);
-  glDrawElements(GL_TRIANGLES, s_data.index_count, GL_UNSIGNED_INT, nullptr);
+  RenderCommand::get_backend().draw_indexed(s_data.index_count, 0);
 
   s_data.draw_calls += 1;
   s_data.index_count = 0;
-
-  // unbind
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindVertexArray(0);
 }
 
 void
 begin_batch()
 {
   s_data.buffer_ptr = s_data.buffer;
+  s_data.index_limit = static_cast<uint32_t>(cvar_batch_quads.get()) * 6;
+}
+
+static glm::mat4
+sprite_model(const glm::vec2& pos, const glm::vec2& draw_size, const float angle_radians)
+{
+  glm::mat4 model = glm::mat4(1.0f);
+  model = glm::translate(model, glm::vec3(glm::vec2(pos.x, pos.y), 0.0f));
+  model = glm::translate(model, glm::vec3(0.5f * draw_size.x, 0.5f * draw_size.y, 0.0f));
+  model = glm::rotate(model, angle_radians, glm::vec3(0.0f, 0.0f, 1.0f));
+  model = glm::translate(model, glm::vec3(-0.5f * draw_size.x, -0.5f * draw_size.y, 0.0f));
+  model = glm::scale(model, glm::vec3(draw_size, 1.0f));
+  return model;
+}
+
+static void
+write_quad(Vertex*& ptr,
+           const glm::mat4& model,
+           const glm::ivec2& sprite_offset,
+           const glm::vec4& colour_tl,
+           const glm::vec4& colour_tr,
+           const glm::vec4& colour_bl,
+           const glm::vec4& colour_br)
+{
+  // tl
+  ptr->pos_and_tex = { 0.0f, 0.0f, 0.0f, 0.0f };
+  ptr->colour = colour_tl;
+  ptr->sprite_pos = sprite_offset;
+  ptr->model = model;
+  ptr++;
+
+  // tr
+  ptr->pos_and_tex = { 1.0f, 0.0f, 1.0f, 0.0f };
+  ptr->colour = colour_tr;
+  ptr->sprite_pos = sprite_offset;
+  ptr->model = model;
+  ptr++;
+
+  // br
+  ptr->pos_and_tex = { 1.0f, 1.0f, 1.0f, 1.0f };
+  ptr->colour = colour_br;
+  ptr->sprite_pos = sprite_offset;
+  ptr->model = model;
+  ptr++;
+
+  // bl
+  ptr->pos_and_tex = { 0.0f, 1.0f, 0.0f, 1.0f };
+  ptr->colour = colour_bl;
+  ptr->sprite_pos = sprite_offset;
+  ptr->model = model;
+  ptr++;
 }
 
 void
@@ -194,7 +249,7 @@ draw_instanced_sprite(const GameObject2D& cam,
                       const glm::vec4 colour_bl,
                       const glm::vec4 colour_br)
 {
-  if (s_data.index_count >= max_quad_index_count) {
+  if (s_data.index_count >= s_data.index_limit) {
     end_batch();
     flush(shader);
     begin_batch();
@@ -205,42 +260,30 @@ draw_instanced_sprite(const GameObject2D& cam,
     return; // skip rendering
   }
 
-  glm::mat4 model = glm::mat4(1.0f);
-  model = glm::translate(model, glm::vec3(glm::vec2(worldspace_pos.x, worldspace_pos.y), 0.0f));
-  model = glm::translate(model, glm::vec3(0.5f * draw_size.x, 0.5f * draw_size.y, 0.0f));
-  model = glm::rotate(model, go.angle_radians, glm::vec3(0.0f, 0.0f, 1.0f));
-  model = glm::translate(model, glm::vec3(-0.5f * draw_size.x, -0.5f * draw_size.y, 0.0f));
-  model = glm::scale(model, glm::vec3(draw_size, 1.0f));
-
+  glm::mat4 model = sprite_model(worldspace_pos, draw_size, go.angle_radians);
   glm::ivec2 sprite_offset = sprite::spritemap::get_sprite_offset(go.sprite);
+  write_quad(s_data.buffer_ptr, model, sprite_offset, colour_tl, colour_tr, colour_bl, colour_br);
 
-  // tl
-  s_data.buffer_ptr->pos_and_tex = { 0.0f, 0.0f, 0.0f, 0.0f };
-  s_data.buffer_ptr->colour = colour_tl;
-  s_data.buffer_ptr->sprite_pos = sprite_offset;
-  s_data.buffer_ptr->model = model;
-  s_data.buffer_ptr++;
-
-  // tr
-  s_data.buffer_ptr->pos_and_tex = { 1.0f, 0.0f, 1.0f, 0.0f };
-  s_data.buffer_ptr->colour = colour_tr;
-  s_data.buffer_ptr->sprite_pos = sprite_offset;
-  s_data.buffer_ptr->model = model;
-  s_data.buffer_ptr++;
+  s_data.index_count += 6;
+  s_data.quad_vertex += 4;
+}
 
-  // br
-  s_data.buffer_ptr->pos_and_tex = { 1.0f, 1.0f, 1.0f, 1.0f };
-  s_data.buffer_ptr->colour = colour_br;
-  s_data.buffer_ptr->sprite_pos = sprite_offset;
-  s_data.buffer_ptr->model = model;
-  s_data.buffer_ptr++;
+void
+draw_instanced_quad(fightingengine::Shader& shader,
+                    const glm::vec2& pos,
+                    const glm::vec2& draw_size,
+                    const float angle_radians,
+                    const glm::ivec2& sprite_offset,
+                    const glm::vec4& colour)
+{
+  if (s_data.index_count >= s_data.index_limit) {
+    end_batch();
+    flush(shader);
+    begin_batch();
+  }
 
-  // bl
-  s_data.buffer_ptr->pos_and_tex = { 0.0f, 1.0f, 0.0f, 1.0f };
-  s_data.buffer_ptr->colour = colour_bl;
-  s_data.buffer_ptr->sprite_pos = sprite_offset;
-  s_data.buffer_ptr->model = model;
-  s_data.buffer_ptr++;
+  glm::mat4 model = sprite_model(pos, draw_size, angle_radians);
+  write_quad(s_data.buffer_ptr, model, sprite_offset, colour, colour, colour, colour);
 
   s_data.index_count += 6;
   s_data.quad_vertex += 4;
@@ -284,6 +327,180 @@ draw_sprite_debug(const GameObject2D& cam,
 #endif
 }
 
+//
+// V3 Static Sprite Chunks
+//
+
+// scratch space used when rebuilding a chunk, kept around between rebuilds
+static std::vector<Vertex> s_static_scratch;
+
+static std::pair<int, int>
+static_chunk_key(const StaticSpriteCache& cache, const glm::vec2& pos)
+{
+  glm::ivec2 chunk = grid::convert_world_space_to_grid_space(pos, cache.chunk_size);
+  return { chunk.x, chunk.y };
+}
+
+static void
+static_rebuild_chunk(StaticChunk& chunk)
+{
+  RenderBackend& backend = RenderCommand::get_backend();
+
+  if (chunk.VAO == 0) {
+    chunk.VAO = backend.create_vertex_array();
+    chunk.VBO = backend.create_buffer();
+    RenderCommand::bind_vertex_array(chunk.VAO);
+    RenderCommand::bind_array_buffer(chunk.VBO);
+    setup_vertex_attributes();
+    // share the (static) quad index buffer with the dynamic renderer
+    backend.bind_buffer(BufferTarget::ELEMENT, s_data.EBO);
+  } else {
+    RenderCommand::bind_vertex_array(chunk.VAO);
+    RenderCommand::bind_array_buffer(chunk.VBO);
+  }
+
+  s_static_scratch.resize(chunk.sprites.size() * 4);
+  Vertex* ptr = s_static_scratch.data();
+
+  if (chunk.sprites.size() > 0) {
+    chunk.bounds_tl = chunk.sprites[0].pos;
+    chunk.bounds_br = chunk.sprites[0].pos;
+  }
+  for (const StaticSprite& s : chunk.sprites) {
+    // note: the model matrix is in world space, the camera is applied via the "view" uniform
+    glm::mat4 model = sprite_model(s.pos, s.size, s.angle_radians);
+    glm::ivec2 sprite_offset = sprite::spritemap::get_sprite_offset(s.sprite);
+    write_quad(ptr, model, sprite_offset, s.colour, s.colour, s.colour, s.colour);
+
+    // sprites can rotate, so be generous with the bounds
+    float radius = glm::max(s.size.x, s.size.y);
+    chunk.bounds_tl.x = glm::min(chunk.bounds_tl.x, s.pos.x - radius);
+    chunk.bounds_tl.y = glm::min(chunk.bounds_tl.y, s.pos.y - radius);
+    chunk.bounds_br.x = glm::max(chunk.bounds_br.x, s.pos.x + radius);
+    chunk.bounds_br.y = glm::max(chunk.bounds_br.y, s.pos.y + radius);
+  }
+
+  // immutable until the chunk changes again
+  size_t size = s_static_scratch.size() * sizeof(Vertex);
+  backend.buffer_data(BufferTarget::ARRAY, size, s_static_scratch.data(), BufferUsage::STATIC);
+
+  chunk.uploaded_quads = static_cast<int>(chunk.sprites.size());
+  chunk.dirty = false;
+}
+
+void
+static_add(StaticSpriteCache& cache, const GameObject2D& go)
+{
+  StaticSprite s;
+  s.id = go.id;
+  s.sprite = go.sprite;
+  s.pos = go.pos;
+  s.size = go.render_size;
+  s.angle_radians = go.angle_radians;
+  s.colour = go.colour;
+
+  StaticChunk& chunk = cache.chunks[static_chunk_key(cache, go.pos)];
+  chunk.sprites.push_back(s);
+  chunk.dirty = true;
+}
+
+void
+static_add_timed(StaticSpriteCache& cache, const GameObject2D& go)
+{
+  static_add(cache, go);
+  cache.expiries.push({ cache.time_s + go.time_alive_left, { go.id, go.pos } });
+}
+
+void
+static_remove(StaticSpriteCache& cache, uint32_t id, glm::vec2 pos)
+{
+  auto chunk_it = cache.chunks.find(static_chunk_key(cache, pos));
+  if (chunk_it == cache.chunks.end())
+    return;
+
+  StaticChunk& chunk = chunk_it->second;
+  auto it = std::find_if(
+    chunk.sprites.begin(), chunk.sprites.end(), [&id](const StaticSprite& s) { return s.id == id; });
+  if (it == chunk.sprites.end())
+    return;
+
+  // order within a chunk doesn't matter
+  *it = chunk.sprites.back();
+  chunk.sprites.pop_back();
+  chunk.dirty = true;
+}
+
+void
+static_update_lifecycle(StaticSpriteCache& cache, const float delta_time_s)
+{
+  cache.time_s += delta_time_s;
+
+  while (!cache.expiries.empty() && cache.expiries.top().first <= cache.time_s) {
+    const auto& expired = cache.expiries.top().second;
+    static_remove(cache, expired.first, expired.second);
+    cache.expiries.pop();
+  }
+}
+
+void
+static_draw(StaticSpriteCache& cache,
+            const GameObject2D& cam,
+            const glm::ivec2& screen_size,
+            fightingengine::Shader& shader)
+{
+  PROFILE_ZONE("sprite_renderer::static_draw");
+  cache.chunk_rebuilds = 0;
+  cache.chunks_drawn = 0;
+
+  glm::vec2 view_tl = cam.pos;
+  glm::vec2 view_br = cam.pos + glm::vec2(screen_size);
+
+  fightingengine::UniformHandle u_view = shader.get_uniform("view");
+  shader.bind();
+  glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(-cam.pos.x, -cam.pos.y, 0.0f));
+  shader.set_mat4(u_view, view);
+
+  for (auto& kv : cache.chunks) {
+    StaticChunk& chunk = kv.second;
+
+    if (chunk.dirty) {
+      static_rebuild_chunk(chunk);
+      cache.chunk_rebuilds += 1;
+    }
+    if (chunk.uploaded_quads == 0)
+      continue;
+
+    // cull the whole chunk
+    if (chunk.bounds_br.x < view_tl.x || chunk.bounds_br.y < view_tl.y || chunk.bounds_tl.x > view_br.x ||
+        chunk.bounds_tl.y > view_br.y)
+      continue;
+
+    RenderCommand::bind_vertex_array(chunk.VAO);
+
+    // the shared index buffer only covers max_quad quads, so draw large chunks in slices
+    for (int first = 0; first < chunk.uploaded_quads; first += static_cast<int>(max_quad)) {
+      int quads = glm::min(chunk.uploaded_quads - first, static_cast<int>(max_quad));
+      RenderCommand::get_backend().draw_indexed(quads * 6, first * 4);
+      s_data.draw_calls += 1;
+      s_data.quad_vertex += quads * 4;
+    }
+    cache.chunks_drawn += 1;
+  }
+
+  // the dynamic renderer works in camera space
+  shader.set_mat4(u_view, glm::mat4(1.0f));
+}
+
+void
+static_shutdown(StaticSpriteCache& cache)
+{
+  for (auto& kv : cache.chunks) {
+    RenderCommand::get_backend().delete_vertex_array(kv.second.VAO);
+    RenderCommand::get_backend().delete_buffer(kv.second.VBO);
+  }
+  cache.chunks.clear();
+}
+
 } // namespace sprite_renderer
 
 } // namespace game2d
\ No newline at end of file
@@ -1,5 +1,11 @@
 #pragma once
 
+// c++ lib headers
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
 // other project headers
 #include <glm/glm.hpp>
 
@@ -52,6 +58,16 @@ draw_instanced_sprite(const GameObject2D& cam,
                       const glm::vec4 colour_bl,
                       const glm::vec4 colour_br);
 
+// no camera transform or culling, pos is in whatever space the shader's projection expects.
+// e.g. used when stamping into an off-screen render target
+void
+draw_instanced_quad(fightingengine::Shader& shader,
+                    const glm::vec2& pos,
+                    const glm::vec2& draw_size,
+                    const float angle_radians,
+                    const glm::ivec2& sprite_offset,
+                    const glm::vec4& colour);
+
 void
 draw_sprite_debug(const GameObject2D& cam,
                   const glm::ivec2& screen_size,
@@ -61,6 +77,81 @@ draw_sprite_debug(const GameObject2D& cam,
                   fightingengine::Shader& debug_line_shader,
                   const glm::vec4& debug_line_shader_colour);
 
+//
+// V3 Static Sprite Chunks
+//
+// Sprites that never move (e.g. trees, long-lived splats) are grouped by world-space
+// chunk and uploaded once into an immutable buffer per chunk. A chunk is only rebuilt
+// when a sprite is added to it or removed from it, so drawing thousands of static props
+// costs one draw call per visible chunk instead of re-writing every quad each frame.
+
+struct StaticSprite
+{
+  uint32_t id = 0;
+  sprite::type sprite = sprite::type::EMPTY;
+  glm::vec2 pos = { 0.0f, 0.0f };
+  glm::vec2 size = { 0.0f, 0.0f };
+  float angle_radians = 0.0f;
+  glm::vec4 colour = { 1.0f, 1.0f, 1.0f, 1.0f };
+};
+
+struct StaticChunk
+{
+  unsigned int VAO = 0;
+  unsigned int VBO = 0;
+  int uploaded_quads = 0;
+  bool dirty = true;
+
+  // world-space bounds of everything in the chunk (sprites can overhang the chunk)
+  glm::vec2 bounds_tl = { 0.0f, 0.0f };
+  glm::vec2 bounds_br = { 0.0f, 0.0f };
+
+  std::vector<StaticSprite> sprites;
+};
+
+struct StaticSpriteCache
+{
+  int chunk_size = 512; // in pixels
+  std::map<std::pair<int, int>, StaticChunk> chunks;
+
+  // timed sprites are expired via a min-heap on their expiry time,
+  // so the per-frame cost does not scale with the number of sprites
+  float time_s = 0.0f;
+  using Expiry = std::pair<float, std::pair<uint32_t, glm::vec2>>;
+  struct ExpiryCompare
+  {
+    bool operator()(const Expiry& a, const Expiry& b) const { return a.first > b.first; }
+  };
+  std::priority_queue<Expiry, std::vector<Expiry>, ExpiryCompare> expiries;
+
+  // stats
+  int chunk_rebuilds = 0;
+  int chunks_drawn = 0;
+};
+
+void
+static_add(StaticSpriteCache& cache, const GameObject2D& go);
+
+// go.time_alive_left is used as the lifetime of the static sprite
+void
+static_add_timed(StaticSpriteCache& cache, const GameObject2D& go);
+
+void
+static_remove(StaticSpriteCache& cache, uint32_t id, glm::vec2 pos);
+
+void
+static_update_lifecycle(StaticSpriteCache& cache, const float delta_time_s);
+
+// note: issues draw calls immediately, so call between a flush() and the next batch
+void
+static_draw(StaticSpriteCache& cache,
+            const GameObject2D& cam,
+            const glm::ivec2& screen_size,
+            fightingengine::Shader& shader);
+
+void
+static_shutdown(StaticSpriteCache& cache);
+
 } // namespace sprite_renderer
 
 } // namespace game2d
\ No newline at end of file
@@ -155,7 +155,10 @@ main(int argc, char** argv)
     }
 
     if (app.get_input().get_key_down(SDL_SCANCODE_R)) {
-      reload_shader_program(&texture_shader.ID, "lit.vert", "basic_shader.frag");
+      if (texture_shader.reload()) {
+        texture_shader.bind();
+        texture_shader.set_int("texture_diffuse1", tex_unit_player_diffuse);
+      }
     }
 
     profiler.end(Profiler::Stage::SdlInput);
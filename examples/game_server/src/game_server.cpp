@@ -0,0 +1,109 @@
+// your header
+#include "game_server.hpp"
+
+// c++ lib headers
+#include <algorithm>
+
+// engine headers
+#include "engine/networking/bitstream.hpp"
+#include "engine/tools/zone_profiler.hpp"
+
+// game headers
+#include "2d_net_protocol.hpp"
+
+namespace game2d {
+
+GameServer::GameServer(fightingengine::Transport& transport, const GameServerConfig& config)
+  : transport(transport)
+  , config(config)
+  , next_match_id(config.first_match_id)
+{}
+
+void
+GameServer::on_connected(fightingengine::ConnectionId conn)
+{
+  for (auto& match : matches) {
+    if (match->add_player(conn)) {
+      match_of[conn] = match.get();
+      return;
+    }
+  }
+
+  const uint32_t id = next_match_id;
+  next_match_id += config.match_id_step;
+  matches.push_back(std::make_unique<Match>(id, config.match, config.seed + id, transport));
+  stats.matches_created += 1;
+  matches.back()->add_player(conn);
+  match_of[conn] = matches.back().get();
+}
+
+void
+GameServer::on_disconnected(fightingengine::ConnectionId conn)
+{
+  auto it = match_of.find(conn);
+  if (it == match_of.end())
+    return;
+  Match* match = it->second;
+  match_of.erase(it);
+
+  match->remove_player(conn);
+  if (match->get_player_count() == 0) {
+    matches.erase(std::find_if(
+      matches.begin(), matches.end(), [match](const std::unique_ptr<Match>& m) { return m.get() == match; }));
+  }
+}
+
+void
+GameServer::on_message(const fightingengine::TransportMessage& msg)
+{
+  auto it = match_of.find(msg.conn);
+  if (it == match_of.end())
+    return; // it's just gone
+
+  fightingengine::BitReader in(reinterpret_cast<const uint8_t*>(msg.payload.data()), msg.payload.size());
+  NetInput input;
+  if (net_protocol::read_type(in) != NetMessage::INPUT || !net_protocol::read_input(in, input)) {
+    stats.bad_messages += 1;
+    return;
+  }
+  stats.inputs += 1;
+  it->second->on_input(msg.conn, input);
+}
+
+void
+GameServer::tick(float delta_time_s)
+{
+  PROFILE_ZONE("game_server::tick");
+
+  events.clear();
+  transport.poll_events(events);
+  for (const fightingengine::TransportEvent& e : events) {
+    if (e.type == fightingengine::TransportEvent::Type::Connected)
+      on_connected(e.conn);
+    else
+      on_disconnected(e.conn);
+  }
+
+  messages.clear();
+  transport.receive(messages);
+  for (const fightingengine::TransportMessage& msg : messages)
+    on_message(msg);
+
+  for (auto& match : matches)
+    match->tick(delta_time_s);
+
+  // snapshots go now, rather than waiting to be batched with the next tick's
+  for (const auto& [conn, match] : match_of)
+    transport.flush(conn);
+}
+
+void
+GameServer::shutdown()
+{
+  for (const auto& [conn, match] : match_of)
+    transport.close(conn, "Server Shutdown");
+  match_of.clear();
+  matches.clear();
+}
+
+} // namespace game2d
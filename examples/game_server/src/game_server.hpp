@@ -0,0 +1,69 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// engine headers
+#include "engine/networking/transport.hpp"
+
+// game headers
+#include "server_match.hpp"
+
+namespace game2d {
+
+struct GameServerConfig
+{
+  MatchConfig match;
+  uint32_t seed = 1; // each match is seeded from this and its id
+  // servers on their own simulation threads count from 1, 2, 3... in steps of the thread count, so ids don't clash
+  uint32_t first_match_id = 1;
+  uint32_t match_id_step = 1;
+};
+
+struct GameServerStats
+{
+  uint32_t matches_created = 0;
+  uint64_t inputs = 0;
+  uint64_t bad_messages = 0; // unknown type, or cut short
+};
+
+// Hosts any number of matches over one Transport, ticked together.
+// A new client goes in to the first match with room, or a new one. Empty matches are closed.
+//   GameServer server(transport, config);
+//   every tick: server.tick(delta_time_s);
+class GameServer
+{
+public:
+  GameServer(fightingengine::Transport& transport, const GameServerConfig& config);
+
+  // connections, then inputs, then every match steps and sends its snapshots
+  void tick(float delta_time_s);
+  // closes every connection
+  void shutdown();
+
+  [[nodiscard]] size_t get_match_count() const { return matches.size(); }
+  [[nodiscard]] size_t get_player_count() const { return match_of.size(); }
+  [[nodiscard]] const std::vector<std::unique_ptr<Match>>& get_matches() const { return matches; }
+  [[nodiscard]] const GameServerStats& get_stats() const { return stats; }
+
+private:
+  fightingengine::Transport& transport;
+  GameServerConfig config;
+  std::vector<std::unique_ptr<Match>> matches;
+  std::unordered_map<fightingengine::ConnectionId, Match*> match_of;
+  uint32_t next_match_id = 1;
+  GameServerStats stats;
+
+  // reused every tick
+  std::vector<fightingengine::TransportEvent> events;
+  std::vector<fightingengine::TransportMessage> messages;
+
+  void on_connected(fightingengine::ConnectionId conn);
+  void on_disconnected(fightingengine::ConnectionId conn);
+  void on_message(const fightingengine::TransportMessage& msg);
+};
+
+} // namespace game2d
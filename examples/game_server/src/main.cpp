@@ -0,0 +1,340 @@
+// c++ lib headers
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// engine headers
+#define STEAMNETWORKINGSOCKETS_OPENSOURCE
+#include "engine/networking/load_test.hpp"
+#include "engine/networking/net_common.hpp"
+#include "engine/networking/net_thread.hpp"
+#include "engine/networking/steam_transport.hpp"
+#include "engine/tick_scheduler.hpp"
+using namespace net_common;
+
+// game headers
+#include "game_server.hpp"
+#include "server_bot.hpp"
+#include "sim_thread.hpp"
+using namespace game2d;
+
+// A dedicated game_2d server: the simulation, with no window, GL, ImGui or audio.
+// Ticks every match at a fixed rate and sends each player snapshots of what's near them.
+// With --sim-threads N, a network thread owns the sockets and the matches are shared between
+// N simulation threads, each ticking on its own.
+
+static void
+print_usage_and_exit(int rc = 1)
+{
+  fflush(stderr);
+  printf(
+    R"usage(Usage:
+    game_server [--port PORT] [--tick-rate HZ] [--players-per-match N] [--seed N] [--sim-threads N]
+    game_server --loadtest CLIENTS [--duration S] [--fast] [--latency MS] [--jitter MS] [--loss P]
+                [--tick-rate HZ] [--players-per-match N] [--seed N] [--sim-threads N]
+
+    --loadtest runs the server in process against simulated players, with no sockets,
+    and prints a json report. --fast doesn't wait for real time between ticks.
+    --sim-threads N runs the matches on N threads, and the network on another (0, the default,
+    runs everything on one). Its load test keeps real time, server_tick is then the network
+    thread's pass, and the simulation threads' ticks and queues are under "extra".
+)usage");
+  fflush(stdout);
+  exit(rc);
+}
+
+static const char*
+next_arg(int argc, const char* argv[], int& i)
+{
+  if (++i >= argc)
+    print_usage_and_exit();
+  return argv[i];
+}
+
+static void
+print_stats(const GameServer& server, const fightingengine::FixedTickScheduler& scheduler)
+{
+  const fightingengine::TickStats& ticks = scheduler.get_stats();
+  Printf("matches: %zu players: %zu inputs: %llu bad messages: %llu",
+         server.get_match_count(),
+         server.get_player_count(),
+         (unsigned long long)server.get_stats().inputs,
+         (unsigned long long)server.get_stats().bad_messages);
+  Printf("ticks: %llu overruns: %llu late: %llu skipped: %llu, work: last %.3fms max %.3fms (period %.3fms)",
+         (unsigned long long)ticks.ticks,
+         (unsigned long long)ticks.overruns,
+         (unsigned long long)ticks.late_ticks,
+         (unsigned long long)ticks.skipped_ticks,
+         ticks.last_work_ns * 1e-6,
+         ticks.max_work_ns * 1e-6,
+         scheduler.get_period_ns() * 1e-6);
+  for (const auto& match : server.get_matches()) {
+    const GameState& state = match->get_state();
+    Printf("  match %u: tick %u players %d enemies %zu bullets %zu restarts %u snapshot bytes %llu",
+           match->get_id(),
+           match->get_tick(),
+           match->get_player_count(),
+           state.entities_enemies.size(),
+           state.entities_bullets.size(),
+           match->get_stats().restarts,
+           (unsigned long long)match->get_stats().snapshot_bytes);
+  }
+}
+
+static std::vector<std::unique_ptr<SimThread>>
+make_sim_threads(fightingengine::NetworkThread& net, const GameServerConfig& config, float tick_rate_hz)
+{
+  std::vector<std::unique_ptr<SimThread>> sims;
+  for (int i = 0; i < net.get_sim_count(); i++) {
+    GameServerConfig sim_config = config;
+    sim_config.first_match_id = 1 + i;
+    sim_config.match_id_step = net.get_sim_count();
+    sims.push_back(std::make_unique<SimThread>(net.get_sim_transport(i), sim_config, tick_rate_hz));
+  }
+  return sims;
+}
+
+static void
+print_threaded_stats(const fightingengine::NetworkThread& net, const std::vector<std::unique_ptr<SimThread>>& sims)
+{
+  const fightingengine::NetThreadStats n = net.get_stats();
+  Printf("network: connections: %llu in: %llu out: %llu, waited for a full queue: %llu, receive paused: %llu passes, "
+         "deepest queue: %llu",
+         (unsigned long long)n.connections,
+         (unsigned long long)n.inbound_messages,
+         (unsigned long long)n.outbound_messages,
+         (unsigned long long)n.inbound_deferred,
+         (unsigned long long)n.receive_paused_passes,
+         (unsigned long long)n.max_inbound_depth);
+  for (size_t i = 0; i < sims.size(); i++) {
+    const SimThreadStats s = sims[i]->get_stats();
+    const fightingengine::SimQueueStats q = sims[i]->get_transport().get_stats();
+    Printf("  sim %zu: matches: %llu players: %llu inputs: %llu, ticks: %llu overruns: %llu, work: last %.3fms max "
+           "%.3fms, connects deferred: %llu, outbound dropped: %llu deferred: %llu",
+           i,
+           (unsigned long long)s.matches,
+           (unsigned long long)s.players,
+           (unsigned long long)s.inputs,
+           (unsigned long long)s.ticks,
+           (unsigned long long)s.overruns,
+           s.last_work_ns * 1e-6,
+           s.max_work_ns * 1e-6,
+           (unsigned long long)q.connects_deferred,
+           (unsigned long long)q.outbound_dropped,
+           (unsigned long long)q.outbound_deferred);
+  }
+}
+
+// the simulation threads' ticks (the slowest thread's) and where the queues backed up
+static void
+add_threaded_report(fightingengine::LoadTestReport& report,
+                    const fightingengine::NetworkThread& net,
+                    const std::vector<std::unique_ptr<SimThread>>& sims)
+{
+  uint64_t p50_us = 0, p99_us = 0, max_us = 0, overruns = 0;
+  fightingengine::SimQueueStats queues;
+  for (const auto& sim : sims) {
+    const fightingengine::LatencyHistogram& ticks = sim->get_tick_times();
+    const uint64_t sim_max_us = ticks.get_max();
+    p50_us = std::max(p50_us, std::min(ticks.get_percentile(50.0f), sim_max_us));
+    p99_us = std::max(p99_us, std::min(ticks.get_percentile(99.0f), sim_max_us));
+    max_us = std::max(max_us, sim_max_us);
+    overruns += sim->get_stats().overruns;
+
+    const fightingengine::SimQueueStats q = sim->get_transport().get_stats();
+    queues.connects_deferred += q.connects_deferred;
+    queues.inbound_budget_hits += q.inbound_budget_hits;
+    queues.outbound_dropped += q.outbound_dropped;
+    queues.outbound_deferred += q.outbound_deferred;
+  }
+  const fightingengine::NetThreadStats n = net.get_stats();
+  report.extra = {
+    { "sim_threads", static_cast<double>(sims.size()) },
+    { "sim_tick_p50_ms", p50_us * 1e-3 },
+    { "sim_tick_p99_ms", p99_us * 1e-3 },
+    { "sim_tick_max_ms", max_us * 1e-3 },
+    { "sim_overruns", static_cast<double>(overruns) },
+    { "inbound_deferred", static_cast<double>(n.inbound_deferred) },
+    { "receive_paused_passes", static_cast<double>(n.receive_paused_passes) },
+    { "max_inbound_depth", static_cast<double>(n.max_inbound_depth) },
+    { "connects_deferred", static_cast<double>(queues.connects_deferred) },
+    { "inbound_budget_hits", static_cast<double>(queues.inbound_budget_hits) },
+    { "outbound_dropped", static_cast<double>(queues.outbound_dropped) },
+    { "outbound_deferred", static_cast<double>(queues.outbound_deferred) },
+  };
+}
+
+static void
+run_threaded(fightingengine::Transport& transport, const GameServerConfig& config, float tick_rate_hz, int sim_threads)
+{
+  fightingengine::NetThreadConfig net_config;
+  net_config.sim_threads = sim_threads;
+  fightingengine::NetworkThread net(transport, net_config);
+  std::vector<std::unique_ptr<SimThread>> sims = make_sim_threads(net, config, tick_rate_hz);
+  net.start();
+  for (size_t i = 0; i < sims.size(); i++)
+    sims[i]->start("sim " + std::to_string(i));
+  Printf("Server ticking at %.0f Hz on %d simulation threads\n", tick_rate_hz, sim_threads);
+
+  while (!g_bQuit) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::string cmd;
+    while (!g_bQuit && LocalUserInput_GetNext(cmd)) {
+      if (cmd == "/quit") {
+        g_bQuit = true;
+        Printf("Shutting down server");
+      } else if (cmd == "/stats")
+        print_threaded_stats(net, sims);
+      else
+        Printf("Commands: /quit /stats");
+    }
+  }
+
+  Printf("Closing connections...\n");
+  for (auto& sim : sims)
+    sim->stop();
+  net.stop(); // sends the closes
+}
+
+static void
+run(GameServer& server, float tick_rate_hz)
+{
+  fightingengine::TickSchedulerConfig tick_config;
+  tick_config.tick_rate_hz = tick_rate_hz;
+  fightingengine::FixedTickScheduler scheduler(tick_config);
+  Printf("Server ticking at %.0f Hz\n", tick_rate_hz);
+
+  while (!g_bQuit) {
+    scheduler.wait_for_next_tick();
+    server.tick(scheduler.get_delta_time_s());
+
+    std::string cmd;
+    while (!g_bQuit && LocalUserInput_GetNext(cmd)) {
+      if (cmd == "/quit") {
+        g_bQuit = true;
+        Printf("Shutting down server");
+      } else if (cmd == "/stats")
+        print_stats(server, scheduler);
+      else
+        Printf("Commands: /quit /stats");
+    }
+
+    scheduler.end_tick();
+  }
+
+  Printf("Closing connections...\n");
+  server.shutdown();
+}
+
+int
+main(int argc, const char* argv[])
+{
+  const uint16 default_port = 27021;
+  int port = default_port;
+  float tick_rate_hz = 60.0f;
+  GameServerConfig config;
+  int sim_threads = 0;
+
+  int loadtest_clients = 0;
+  fightingengine::LoadTestConfig loadtest;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--port")) {
+      port = atoi(next_arg(argc, argv, i));
+      if (port <= 0 || port > 65535)
+        FatalError("Invalid port %d", port);
+    } else if (!strcmp(argv[i], "--tick-rate")) {
+      tick_rate_hz = (float)atof(next_arg(argc, argv, i));
+      if (tick_rate_hz < 1.0f || tick_rate_hz > 1000.0f)
+        FatalError("Invalid tick rate %s", argv[i]);
+    } else if (!strcmp(argv[i], "--players-per-match")) {
+      config.match.max_players = atoi(next_arg(argc, argv, i));
+      if (config.match.max_players <= 0)
+        FatalError("Invalid players per match %s", argv[i]);
+    } else if (!strcmp(argv[i], "--seed")) {
+      config.seed = (uint32_t)strtoul(next_arg(argc, argv, i), nullptr, 10);
+    } else if (!strcmp(argv[i], "--sim-threads")) {
+      sim_threads = atoi(next_arg(argc, argv, i));
+      if (sim_threads < 0 || sim_threads > 64)
+        FatalError("Invalid simulation thread count %s", argv[i]);
+    } else if (!strcmp(argv[i], "--loadtest")) {
+      loadtest_clients = atoi(next_arg(argc, argv, i));
+      if (loadtest_clients <= 0)
+        FatalError("Invalid client count %s", argv[i]);
+    } else if (!strcmp(argv[i], "--duration")) {
+      loadtest.duration_s = (float)atof(next_arg(argc, argv, i));
+    } else if (!strcmp(argv[i], "--latency")) {
+      loadtest.link.latency_ms = (float)atof(next_arg(argc, argv, i));
+    } else if (!strcmp(argv[i], "--jitter")) {
+      loadtest.link.jitter_ms = (float)atof(next_arg(argc, argv, i));
+    } else if (!strcmp(argv[i], "--loss")) {
+      loadtest.link.loss = (float)atof(next_arg(argc, argv, i));
+      if (loadtest.link.loss < 0.0f || loadtest.link.loss > 1.0f)
+        FatalError("Invalid loss %s", argv[i]);
+    } else if (!strcmp(argv[i], "--fast")) {
+      loadtest.realtime = false;
+    } else
+      print_usage_and_exit();
+  }
+
+  if (loadtest_clients > 0) {
+    loadtest.clients = loadtest_clients;
+    loadtest.tick_rate_hz = tick_rate_hz;
+    loadtest.seed = config.seed;
+    fightingengine::LoadTest test(loadtest);
+    auto make_bot = [&](int) { return std::make_unique<GameBot>(config.match.schema); };
+
+    if (sim_threads > 0) {
+      // the loopback network isn't thread safe, so the load test's thread is the network thread too
+      if (!loadtest.realtime)
+        FatalError("--fast can't be used with --sim-threads: the simulation threads keep real time");
+      fightingengine::NetThreadConfig net_config;
+      net_config.sim_threads = sim_threads;
+      fightingengine::NetworkThread net(test.get_server_transport(), net_config);
+      std::vector<std::unique_ptr<SimThread>> sims = make_sim_threads(net, config, tick_rate_hz);
+      for (size_t i = 0; i < sims.size(); i++)
+        sims[i]->start("sim " + std::to_string(i));
+
+      fightingengine::LoadTestReport report = test.run([&] { net.pass(); }, make_bot);
+      for (auto& sim : sims)
+        sim->stop();
+      net.pass();
+      add_threaded_report(report, net, sims);
+      report.write_json(std::cout);
+      return 0;
+    }
+
+    GameServer server(test.get_server_transport(), config);
+    const float delta_time_s = 1.0f / tick_rate_hz;
+    fightingengine::LoadTestReport report = test.run([&] { server.tick(delta_time_s); }, make_bot);
+    report.write_json(std::cout);
+    return 0;
+  }
+
+  InitSteamDatagramConnectionSockets();
+  LocalUserInput_Init();
+  {
+    SteamServerTransport transport;
+    if (!transport.listen((uint16)port))
+      FatalError("Failed to listen on port %d", port);
+    Printf("Server listening on port %d\n", port);
+
+    if (sim_threads > 0)
+      run_threaded(transport, config, tick_rate_hz, sim_threads);
+    else {
+      GameServer server(transport, config);
+      run(server, tick_rate_hz);
+    }
+  }
+  ShutdownSteamDatagramConnectionSockets();
+  NukeProcess(0);
+  return 0;
+}
@@ -0,0 +1,74 @@
+// your header
+#include "server_bot.hpp"
+
+// c++ lib headers
+#include <cmath>
+#include <random>
+
+// engine headers
+#include "engine/maths_core.hpp"
+
+namespace game2d {
+
+GameBot::GameBot(const fightingengine::SnapshotSchema& schema)
+  : schema(schema)
+{}
+
+void
+GameBot::update(fightingengine::LoadTestContext& ctx)
+{
+  if (!welcomed)
+    return;
+
+  seconds_until_turn -= ctx.get_delta_time_s();
+  if (seconds_until_turn <= 0.0f) {
+    std::uniform_real_distribution<float> angle(0.0f, 2.0f * fightingengine::PI);
+    const float heading = angle(ctx.get_rng());
+    input.move_x = std::cos(heading);
+    input.move_y = std::sin(heading);
+    input.aim_radians = angle(ctx.get_rng());
+    input.shoot = true;
+    seconds_until_turn = std::uniform_real_distribution<float>(0.5f, 2.0f)(ctx.get_rng());
+  }
+
+  input.sequence += 1;
+  sent_ns[input.sequence % sent_history] = ctx.get_time_ns();
+  out.reset();
+  net_protocol::write_input(input, out);
+  ctx.send(out.get_bytes().data(), static_cast<uint32_t>(out.get_bytes().size()), false);
+}
+
+void
+GameBot::on_message(fightingengine::LoadTestContext& ctx, std::string_view payload)
+{
+  fightingengine::BitReader in(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+  switch (net_protocol::read_type(in)) {
+    case NetMessage::WELCOME:
+      welcomed = net_protocol::read_welcome(in, welcome);
+      break;
+
+    case NetMessage::SNAPSHOT: {
+      NetSnapshotHeader header;
+      if (!net_protocol::read_snapshot_header(in, header))
+        break;
+      // fails if the baseline it's against has been dropped, the next one will be against an older ack
+      if (!fightingengine::snapshot::decode(schema, in, received, decoded))
+        break;
+      received.add(decoded);
+      input.has_ack = true;
+      input.acked_tick = decoded.tick;
+
+      const uint32_t seq = header.last_input_sequence;
+      if (seq > last_timed_sequence && input.sequence - seq < sent_history) {
+        ctx.record_latency(sent_ns[seq % sent_history]);
+        last_timed_sequence = seq;
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+} // namespace game2d
@@ -0,0 +1,45 @@
+#pragma once
+
+// c++ lib headers
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// engine headers
+#include "engine/networking/bitstream.hpp"
+#include "engine/networking/load_test.hpp"
+#include "engine/networking/snapshot.hpp"
+
+// game headers
+#include "2d_net_protocol.hpp"
+
+namespace game2d {
+
+// A simulated player for game_server --loadtest. Wanders and shoots, sends its input
+// every tick, and decodes every snapshot like a real client would.
+// Latency is input to snapshot: from sending an input to the first snapshot that used it.
+class GameBot : public fightingengine::LoadTestBot
+{
+public:
+  explicit GameBot(const fightingengine::SnapshotSchema& schema);
+
+  void update(fightingengine::LoadTestContext& ctx) override;
+  void on_message(fightingengine::LoadTestContext& ctx, std::string_view payload) override;
+
+private:
+  static constexpr int sent_history = 64;
+
+  fightingengine::SnapshotSchema schema;
+  bool welcomed = false;
+  NetWelcome welcome;
+  NetInput input;
+  float seconds_until_turn = 0.0f;
+
+  fightingengine::SnapshotHistory received;
+  fightingengine::Snapshot decoded;
+  fightingengine::BitWriter out;
+  std::array<uint64_t, sent_history> sent_ns = {}; // by input sequence
+  uint32_t last_timed_sequence = 0;
+};
+
+} // namespace game2d
@@ -0,0 +1,162 @@
+// your header
+#include "server_match.hpp"
+
+// engine headers
+#include "engine/tools/zone_profiler.hpp"
+
+// game headers
+#include "2d_game_object.hpp"
+#include "2d_net_snapshot.hpp"
+
+namespace game2d {
+
+Match::Match(uint32_t id, const MatchConfig& config, uint32_t seed, fightingengine::Transport& transport)
+  : id(id)
+  , config(config)
+  , seed(seed)
+  , transport(transport)
+  , grid(config.interest.cell_size)
+{
+  state.headless = true;
+  game::init(state, config.screen_wh, seed);
+  // init() adds a local player, players here come from add_player()
+  state.entities_player.clear();
+  state.player_keys.clear();
+}
+
+Match::Player*
+Match::find_player(fightingengine::ConnectionId conn)
+{
+  for (Player& p : players) {
+    if (p.conn == conn)
+      return &p;
+  }
+  return nullptr;
+}
+
+void
+Match::spawn_player(Player& player)
+{
+  state.entities_player.push_back(
+    gameobject::create_player(sprite_player, tex_unit_kenny_nl, player_colour, config.screen_wh));
+  state.player_keys.push_back(KeysAndState());
+  player.applied = NetInput();
+}
+
+bool
+Match::add_player(fightingengine::ConnectionId conn)
+{
+  if (is_full() || find_player(conn) != nullptr)
+    return false;
+
+  players.emplace_back();
+  players.back().conn = conn;
+  spawn_player(players.back());
+  send_welcome(players.size() - 1);
+  return true;
+}
+
+void
+Match::remove_player(fightingengine::ConnectionId conn)
+{
+  for (size_t i = 0; i < players.size(); i++) {
+    if (players[i].conn != conn)
+      continue;
+    players.erase(players.begin() + i);
+    state.entities_player.erase(state.entities_player.begin() + i);
+    state.player_keys.erase(state.player_keys.begin() + i);
+    return;
+  }
+}
+
+void
+Match::on_input(fightingengine::ConnectionId conn, const NetInput& input)
+{
+  Player* p = find_player(conn);
+  if (p == nullptr)
+    return;
+  // unreliable, so they can arrive out of order
+  if (input.sequence <= p->input.sequence) {
+    stats.inputs_dropped += 1;
+    return;
+  }
+  if (input.has_ack)
+    p->interest.on_ack(input.acked_tick);
+  p->input = input;
+}
+
+void
+Match::send_welcome(size_t index)
+{
+  NetWelcome welcome;
+  welcome.match_id = id;
+  welcome.player_id = state.entities_player[index].id;
+  welcome.tick = tick_count;
+  out.reset();
+  net_protocol::write_welcome(welcome, out);
+  transport.send(players[index].conn, out.get_bytes().data(), static_cast<uint32_t>(out.get_bytes().size()), true);
+}
+
+void
+Match::restart()
+{
+  stats.restarts += 1;
+  state = GameState();
+  state.headless = true;
+  game::init(state, config.screen_wh, seed + stats.restarts);
+  state.entities_player.clear();
+  state.player_keys.clear();
+
+  for (size_t i = 0; i < players.size(); i++) {
+    spawn_player(players[i]);
+    send_welcome(i); // a new player entity
+  }
+}
+
+void
+Match::tick(float delta_time_s)
+{
+  if (players.empty())
+    return;
+  PROFILE_ZONE("match::tick");
+
+  for (size_t i = 0; i < players.size(); i++) {
+    Player& p = players[i];
+    net_protocol::apply_input(p.input, p.applied, state.entities_player[i], state.player_keys[i]);
+    p.applied = p.input;
+  }
+
+  game::update_physics(state);
+  game::update(state, delta_time_s);
+  tick_count += 1;
+
+  if (state.running == GameRunning::GAME_OVER)
+    restart();
+
+  send_snapshots();
+}
+
+void
+Match::send_snapshots()
+{
+  const fightingengine::Snapshot world = net_snapshot::make(state, tick_count, config.schema);
+  grid.update(world, config.schema);
+
+  for (size_t i = 0; i < players.size(); i++) {
+    Player& p = players[i];
+    p.interest.set_camera(state.entities_player[i].pos);
+
+    NetSnapshotHeader header;
+    header.last_input_sequence = p.applied.sequence;
+    out.reset();
+    net_protocol::write_snapshot_header(header, out);
+    p.interest.write_snapshot(grid, world, config.schema, config.interest, out);
+
+    const std::vector<uint8_t>& bytes = out.get_bytes();
+    transport.send(p.conn, bytes.data(), static_cast<uint32_t>(bytes.size()), false);
+    stats.snapshots_sent += 1;
+    stats.snapshot_bytes += bytes.size();
+  }
+}
+
+} // namespace game2d
@@ -0,0 +1,90 @@
+#pragma once
+
+// c++ lib headers
+#include <cstdint>
+#include <vector>
+
+// other lib headers
+#include <glm/glm.hpp>
+
+// engine headers
+#include "engine/networking/bitstream.hpp"
+#include "engine/networking/interest.hpp"
+#include "engine/networking/snapshot.hpp"
+#include "engine/networking/transport.hpp"
+
+// game headers
+#include "2d_game.hpp"
+#include "2d_net_protocol.hpp"
+
+namespace game2d {
+
+struct MatchConfig
+{
+  int max_players = 8;
+  glm::ivec2 screen_wh = { 1280, 720 }; // players spawn in the middle
+  fightingengine::SnapshotSchema schema;
+  fightingengine::InterestConfig interest;
+};
+
+struct MatchStats
+{
+  uint32_t restarts = 0;
+  uint64_t snapshots_sent = 0;
+  uint64_t snapshot_bytes = 0;
+  uint64_t inputs_dropped = 0; // arrived after a newer one
+};
+
+// One game: a GameState stepped headless, and the clients playing in it.
+// Each client has a player entity, and is sent the part of the world around it every tick.
+class Match
+{
+public:
+  Match(uint32_t id, const MatchConfig& config, uint32_t seed, fightingengine::Transport& transport);
+
+  // false if the match is full. the client is sent a welcome
+  bool add_player(fightingengine::ConnectionId conn);
+  void remove_player(fightingengine::ConnectionId conn);
+  void on_input(fightingengine::ConnectionId conn, const NetInput& input);
+
+  // applies everyone's newest input, steps the game, then sends each client a snapshot.
+  // an empty match doesn't step
+  void tick(float delta_time_s);
+
+  [[nodiscard]] uint32_t get_id() const { return id; }
+  [[nodiscard]] uint32_t get_tick() const { return tick_count; }
+  [[nodiscard]] int get_player_count() const { return static_cast<int>(players.size()); }
+  [[nodiscard]] bool is_full() const { return get_player_count() >= config.max_players; }
+  [[nodiscard]] const GameState& get_state() const { return state; }
+  [[nodiscard]] const MatchStats& get_stats() const { return stats; }
+
+private:
+  struct Player
+  {
+    fightingengine::ConnectionId conn = fightingengine::invalid_connection;
+    NetInput input;   // the newest
+    NetInput applied; // what the last tick used
+    fightingengine::ClientInterest interest;
+  };
+
+  uint32_t id;
+  MatchConfig config;
+  uint32_t seed;
+  fightingengine::Transport& transport;
+
+  GameState state;
+  std::vector<Player> players; // players[i] is state.entities_player[i]
+  fightingengine::InterestGrid grid;
+  fightingengine::BitWriter out;
+  uint32_t tick_count = 0;
+  MatchStats stats;
+
+  // the game ends when any player dies. a new one starts straight away, with the same players
+  void restart();
+  void spawn_player(Player& player);
+  void send_welcome(size_t index);
+  void send_snapshots();
+  [[nodiscard]] Player* find_player(fightingengine::ConnectionId conn);
+};
+
+} // namespace game2d
@@ -0,0 +1,92 @@
+// your header
+#include "sim_thread.hpp"
+
+// engine headers
+#include "engine/tools/zone_profiler.hpp"
+
+namespace game2d {
+
+static fightingengine::TickSchedulerConfig
+make_tick_config(float tick_rate_hz)
+{
+  fightingengine::TickSchedulerConfig config;
+  config.tick_rate_hz = tick_rate_hz;
+  return config;
+}
+
+SimThread::SimThread(fightingengine::SimQueueTransport& transport, const GameServerConfig& config, float tick_rate_hz)
+  : transport(transport)
+  , server(transport, config)
+  , scheduler(make_tick_config(tick_rate_hz))
+  , tick_times(1 << 20)
+{}
+
+SimThread::~SimThread()
+{
+  stop();
+}
+
+void
+SimThread::start(const std::string& name)
+{
+  if (running.exchange(true))
+    return;
+  thread = std::thread([this, name]() { run(name); });
+}
+
+void
+SimThread::stop()
+{
+  if (!running.exchange(false))
+    return;
+  thread.join();
+}
+
+void
+SimThread::run(const std::string& name)
+{
+  fightingengine::zone_profiler::set_thread_name(name);
+  scheduler.reset();
+  while (running.load(std::memory_order_acquire)) {
+    scheduler.wait_for_next_tick();
+    server.tick(scheduler.get_delta_time_s());
+    scheduler.end_tick();
+    tick_times.record(scheduler.get_stats().last_work_ns / 1000);
+    publish();
+  }
+  server.shutdown();
+  publish();
+}
+
+void
+SimThread::publish()
+{
+  const fightingengine::TickStats& s = scheduler.get_stats();
+  ticks.store(s.ticks, std::memory_order_relaxed);
+  overruns.store(s.overruns, std::memory_order_relaxed);
+  late_ticks.store(s.late_ticks, std::memory_order_relaxed);
+  skipped_ticks.store(s.skipped_ticks, std::memory_order_relaxed);
+  last_work_ns.store(s.last_work_ns, std::memory_order_relaxed);
+  max_work_ns.store(s.max_work_ns, std::memory_order_relaxed);
+  matches.store(server.get_match_count(), std::memory_order_relaxed);
+  players.store(server.get_player_count(), std::memory_order_relaxed);
+  inputs.store(server.get_stats().inputs, std::memory_order_relaxed);
+}
+
+SimThreadStats
+SimThread::get_stats() const
+{
+  SimThreadStats s;
+  s.ticks = ticks.load(std::memory_order_relaxed);
+  s.overruns = overruns.load(std::memory_order_relaxed);
+  s.late_ticks = late_ticks.load(std::memory_order_relaxed);
+  s.skipped_ticks = skipped_ticks.load(std::memory_order_relaxed);
+  s.last_work_ns = last_work_ns.load(std::memory_order_relaxed);
+  s.max_work_ns = max_work_ns.load(std::memory_order_relaxed);
+  s.matches = matches.load(std::memory_order_relaxed);
+  s.players = players.load(std::memory_order_relaxed);
+  s.inputs = inputs.load(std::memory_order_relaxed);
+  return s;
+}
+
+} // namespace game2d
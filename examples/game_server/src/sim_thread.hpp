@@ -0,0 +1,78 @@
+#pragma once
+
+// c++ lib headers
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// engine headers
+#include "engine/networking/net_thread.hpp"
+#include "engine/tick_scheduler.hpp"
+#include "engine/tools/latency_histogram.hpp"
+
+// game headers
+#include "game_server.hpp"
+
+namespace game2d {
+
+// what a SimThread last published, readable from any thread
+struct SimThreadStats
+{
+  uint64_t ticks = 0;
+  uint64_t overruns = 0;
+  uint64_t late_ticks = 0;
+  uint64_t skipped_ticks = 0;
+  uint64_t last_work_ns = 0;
+  uint64_t max_work_ns = 0;
+  uint64_t matches = 0;
+  uint64_t players = 0;
+  uint64_t inputs = 0;
+};
+
+// A GameServer on a thread of its own, at a fixed tick rate, over one of a NetworkThread's queues.
+// Its matches never leave it, so nothing in a match is shared between threads.
+//   SimThread sim(net.get_sim_transport(i), config, tick_rate_hz);
+//   sim.start("sim 0"); ... sim.stop();
+class SimThread
+{
+public:
+  SimThread(fightingengine::SimQueueTransport& transport, const GameServerConfig& config, float tick_rate_hz);
+  ~SimThread();
+  SimThread(const SimThread&) = delete;
+  SimThread& operator=(const SimThread&) = delete;
+
+  void start(const std::string& name);
+  // finishes the tick it's on, then closes its connections
+  void stop();
+
+  // any thread
+  [[nodiscard]] SimThreadStats get_stats() const;
+  [[nodiscard]] const fightingengine::SimQueueTransport& get_transport() const { return transport; }
+  // after stop(): the work time of every tick, microseconds
+  [[nodiscard]] const fightingengine::LatencyHistogram& get_tick_times() const { return tick_times; }
+
+private:
+  fightingengine::SimQueueTransport& transport;
+  GameServer server;
+  fightingengine::FixedTickScheduler scheduler;
+  fightingengine::LatencyHistogram tick_times;
+
+  std::thread thread;
+  std::atomic<bool> running{ false };
+
+  std::atomic<uint64_t> ticks{ 0 };
+  std::atomic<uint64_t> overruns{ 0 };
+  std::atomic<uint64_t> late_ticks{ 0 };
+  std::atomic<uint64_t> skipped_ticks{ 0 };
+  std::atomic<uint64_t> last_work_ns{ 0 };
+  std::atomic<uint64_t> max_work_ns{ 0 };
+  std::atomic<uint64_t> matches{ 0 };
+  std::atomic<uint64_t> players{ 0 };
+  std::atomic<uint64_t> inputs{ 0 };
+
+  void run(const std::string& name);
+  void publish();
+};
+
+} // namespace game2d
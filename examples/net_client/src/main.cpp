@@ -12,10 +12,13 @@
 #include <stdio.h>
 #include <string.h>
 #include <string>
+#include <string_view>
 #include <thread>
 
 #define STEAMNETWORKINGSOCKETS_OPENSOURCE
+#include "engine/networking/net_batch.hpp"
 #include "engine/networking/net_common.hpp"
+#include "engine/tick_scheduler.hpp"
 using namespace net_common;
 
 class ChatClient
@@ -37,35 +40,46 @@ public:
     if (m_hConnection == k_HSteamNetConnection_Invalid)
       FatalError("Failed to create connection");
 
+    // Same fixed rate loop as the server, rather than sleeping a fixed 10ms after the work
+    fightingengine::FixedTickScheduler scheduler;
     while (!g_bQuit) {
+      scheduler.wait_for_next_tick();
       PollIncomingMessages();
       PollConnectionStateChanges();
       PollLocalUserInput();
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      m_pInterface->FlushMessagesOnConnection(m_hConnection);
+      scheduler.end_tick();
     }
   }
 
 private:
   HSteamNetConnection m_hConnection;
   ISteamNetworkingSockets* m_pInterface;
+  ReceiveBatch m_receiveBatch;
 
   void PollIncomingMessages()
   {
     while (!g_bQuit) {
-      ISteamNetworkingMessage* pIncomingMsg = nullptr;
-      int numMsgs = m_pInterface->ReceiveMessagesOnConnection(m_hConnection, &pIncomingMsg, 1);
+      int numMsgs = m_receiveBatch.receive_on_connection(m_pInterface, m_hConnection);
       if (numMsgs == 0)
         break;
       if (numMsgs < 0)
         FatalError("Error checking for messages");
 
       // Just echo anything we get from the server
-      fwrite(pIncomingMsg->m_pData, 1, pIncomingMsg->m_cbSize, stdout);
-      fputc('\n', stdout);
+      for (int i = 0; i < m_receiveBatch.size(); i++) {
+        std::string_view msg = m_receiveBatch.get_payload(i);
+        fwrite(msg.data(), 1, msg.size(), stdout);
+        fputc('\n', stdout);
+      }
 
-      // We don't need this anymore.
-      pIncomingMsg->Release();
+      // A batch that isn't full means there's nothing else waiting
+      if (!m_receiveBatch.is_full())
+        break;
     }
+
+    // We don't need these anymore.
+    m_receiveBatch.release();
   }
 
   void PollLocalUserInput()
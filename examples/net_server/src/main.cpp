@@ -4,6 +4,7 @@
 #include <assert.h>
 #include <cctype>
 #include <chrono>
+#include <iostream>
 #include <map>
 #include <mutex>
 #include <queue>
@@ -12,136 +13,153 @@
 #include <stdio.h>
 #include <string.h>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 #define STEAMNETWORKINGSOCKETS_OPENSOURCE
+#include "engine/networking/load_test.hpp"
 #include "engine/networking/net_common.hpp"
+#include "engine/networking/net_thread.hpp"
+#include "engine/networking/steam_transport.hpp"
+#include "engine/tick_scheduler.hpp"
 using namespace net_common;
 
 class ChatServer
 {
 public:
-  void Run(uint16 nPort)
+  explicit ChatServer(fightingengine::Transport& transport, bool bVerbose = true)
+    : m_transport(transport)
+    , m_bVerbose(bVerbose)
+  {}
+
+  void Run(float tickRateHz)
   {
-    // Select instance to use.  For now we'll always use the default.
-    // But we could use SteamGameServerNetworkingSockets() on Steam.
-    m_pInterface = SteamNetworkingSockets();
-
-    // Start listening
-    SteamNetworkingIPAddr serverLocalAddr;
-    serverLocalAddr.Clear();
-    serverLocalAddr.m_port = nPort;
-    SteamNetworkingConfigValue_t opt;
-    opt.SetPtr(k_ESteamNetworkingConfig_Callback_ConnectionStatusChanged,
-               (void*)SteamNetConnectionStatusChangedCallback);
-    m_hListenSock = m_pInterface->CreateListenSocketIP(serverLocalAddr, 1, &opt);
-    if (m_hListenSock == k_HSteamListenSocket_Invalid)
-      FatalError("Failed to listen on port %d", nPort);
-    m_hPollGroup = m_pInterface->CreatePollGroup();
-    if (m_hPollGroup == k_HSteamNetPollGroup_Invalid)
-      FatalError("Failed to listen on port %d", nPort);
-    Printf("Server listening on port %d\n", nPort);
+    fightingengine::TickSchedulerConfig tickConfig;
+    tickConfig.tick_rate_hz = tickRateHz;
+    m_scheduler = fightingengine::FixedTickScheduler(tickConfig);
+    Printf("Server ticking at %.0f Hz\n", tickRateHz);
 
     while (!g_bQuit) {
-      PollIncomingMessages();
-      PollConnectionStateChanges();
+      m_scheduler.wait_for_next_tick();
+      Tick();
       PollLocalUserInput();
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      m_scheduler.end_tick();
     }
 
+    Shutdown();
+  }
+
+  // One tick: everything that arrived since the last one, then send the replies
+  void Tick()
+  {
+    // Network: connections first, so their messages have somewhere to go
+    PollConnectionStateChanges();
+    PollIncomingMessages();
+
+    // Simulate: nothing yet, it's a chat server
+
+    // Send: replies were queued while handling messages, push them out now
+    // instead of waiting on Nagle, so nothing sits in a queue past the end of the tick
+    SendQueuedMessages();
+  }
+
+  void Shutdown()
+  {
     // Close all the connections
     Printf("Closing connections...\n");
-    for (auto it : m_mapClients) {
+    for (auto& it : m_mapClients) {
       // Send them one more goodbye message.  Note that we also have the
       // connection close reason as a place to send final data.  However,
       // that's usually best left for more diagnostic/debug text not actual
       // protocol strings.
       SendStringToClient(it.first, "Server is shutting down.  Goodbye.");
 
-      // Close the connection.  We use "linger mode" to ask SteamNetworkingSockets
-      // to flush this out and close gracefully.
-      m_pInterface->CloseConnection(it.first, 0, "Server Shutdown", true);
+      // Close the connection.  The transport flushes this out and closes gracefully.
+      m_transport.close(it.first, "Server Shutdown");
     }
     m_mapClients.clear();
-
-    m_pInterface->CloseListenSocket(m_hListenSock);
-    m_hListenSock = k_HSteamListenSocket_Invalid;
-
-    m_pInterface->DestroyPollGroup(m_hPollGroup);
-    m_hPollGroup = k_HSteamNetPollGroup_Invalid;
   }
 
 private:
-  HSteamListenSocket m_hListenSock;
-  HSteamNetPollGroup m_hPollGroup;
-  ISteamNetworkingSockets* m_pInterface;
+  fightingengine::Transport& m_transport;
+  bool m_bVerbose;
 
   struct Client_t
   {
     std::string m_sNick;
   };
 
-  std::map<HSteamNetConnection, Client_t> m_mapClients;
+  std::map<fightingengine::ConnectionId, Client_t> m_mapClients;
+
+  // Reused every poll, so the hot path doesn't allocate
+  std::vector<fightingengine::TransportEvent> m_events;
+  std::vector<fightingengine::TransportMessage> m_messages;
+  std::vector<fightingengine::ConnectionId> m_broadcastConns;
 
-  void SendStringToClient(HSteamNetConnection conn, const char* str)
+  fightingengine::FixedTickScheduler m_scheduler;
+
+  void SendQueuedMessages()
   {
-    m_pInterface->SendMessageToConnection(conn, str, (uint32)strlen(str), k_nSteamNetworkingSend_Reliable, nullptr);
+    for (auto& c : m_mapClients)
+      m_transport.flush(c.first);
   }
 
-  void SendStringToAllClients(const char* str, HSteamNetConnection except = k_HSteamNetConnection_Invalid)
+  void SendStringToClient(fightingengine::ConnectionId conn, const char* str)
   {
+    m_transport.send(conn, str, (uint32)strlen(str), true);
+  }
+
+  // One copy of the payload shared by every client
+  void SendStringToAllClients(const char* str, fightingengine::ConnectionId except = fightingengine::invalid_connection)
+  {
+    m_broadcastConns.clear();
     for (auto& c : m_mapClients) {
       if (c.first != except)
-        SendStringToClient(c.first, str);
+        m_broadcastConns.push_back(c.first);
     }
+    m_transport.broadcast(m_broadcastConns.data(), (int)m_broadcastConns.size(), str, (uint32)strlen(str), true);
   }
 
   void PollIncomingMessages()
   {
     char temp[1024];
 
-    while (!g_bQuit) {
-      ISteamNetworkingMessage* pIncomingMsg = nullptr;
-      int numMsgs = m_pInterface->ReceiveMessagesOnPollGroup(m_hPollGroup, &pIncomingMsg, 1);
-      if (numMsgs == 0)
-        break;
-      if (numMsgs < 0)
-        FatalError("Error checking for messages");
-      assert(numMsgs == 1 && pIncomingMsg);
-      auto itClient = m_mapClients.find(pIncomingMsg->m_conn);
-      assert(itClient != m_mapClients.end());
-
-      // '\0'-terminate it to make it easier to parse
-      std::string sCmd;
-      sCmd.assign((const char*)pIncomingMsg->m_pData, pIncomingMsg->m_cbSize);
-      const char* cmd = sCmd.c_str();
+    m_messages.clear();
+    m_transport.receive(m_messages);
+    for (const fightingengine::TransportMessage& msg : m_messages) {
+      // A message can still arrive from a client that has just gone
+      auto itClient = m_mapClients.find(msg.conn);
+      if (itClient == m_mapClients.end())
+        continue;
 
-      // We don't need this anymore.
-      pIncomingMsg->Release();
+      // Parsed in place, the payload isn't copied (or '\0'-terminated)
+      std::string_view cmd = msg.payload;
 
       // Check for known commands.  None of this example code is secure or robust.
       // Don't write a real server like this, please.
 
-      if (strncmp(cmd, "/nick", 5) == 0) {
-        const char* nick = cmd + 5;
-        while (isspace(*nick))
-          ++nick;
+      if (cmd.substr(0, 5) == "/nick") {
+        std::string_view nick = cmd.substr(5);
+        while (!nick.empty() && isspace(nick.front()))
+          nick.remove_prefix(1);
+        const std::string sNick(nick);
 
         // Let everybody else know they changed their name
-        sprintf_s(temp, "%s shall henceforth be known as %s", itClient->second.m_sNick.c_str(), nick);
+        sprintf_s(temp, "%s shall henceforth be known as %s", itClient->second.m_sNick.c_str(), sNick.c_str());
         SendStringToAllClients(temp, itClient->first);
 
         // Respond to client
-        sprintf_s(temp, "Ye shall henceforth be known as %s", nick);
+        sprintf_s(temp, "Ye shall henceforth be known as %s", sNick.c_str());
         SendStringToClient(itClient->first, temp);
 
         // Actually change their name
-        SetClientNick(itClient->first, nick);
+        SetClientNick(itClient->first, sNick.c_str());
         continue;
       }
 
       // Assume it's just a ordinary chat message, dispatch to everybody else
-      sprintf_s(temp, "%s: %s", itClient->second.m_sNick.c_str(), cmd);
+      sprintf_s(temp, "%s: %.*s", itClient->second.m_sNick.c_str(), (int)cmd.size(), cmd.data());
       SendStringToAllClients(temp, itClient->first);
     }
   }
@@ -159,6 +177,22 @@ private:
       if (strcmp(cmd.c_str(), "/help") == 0) {
         Printf("Command: /quit");
         Printf("Command: /help");
+        Printf("Command: /stats");
+        break;
+      }
+
+      if (strcmp(cmd.c_str(), "/stats") == 0) {
+        const fightingengine::TickStats& stats = m_scheduler.get_stats();
+        Printf("ticks: %llu overruns: %llu late: %llu skipped: %llu",
+               (unsigned long long)stats.ticks,
+               (unsigned long long)stats.overruns,
+               (unsigned long long)stats.late_ticks,
+               (unsigned long long)stats.skipped_ticks);
+        Printf("work: last %.3fms max %.3fms, max wake error %.3fms (period %.3fms)",
+               stats.last_work_ns * 1e-6,
+               stats.max_work_ns * 1e-6,
+               stats.max_wake_error_ns * 1e-6,
+               m_scheduler.get_period_ns() * 1e-6);
         break;
       }
 
@@ -172,165 +206,146 @@ private:
     }
   }
 
-  void SetClientNick(HSteamNetConnection hConn, const char* nick)
+  void SetClientNick(fightingengine::ConnectionId conn, const char* nick)
   {
 
     // Remember their nick
-    m_mapClients[hConn].m_sNick = nick;
+    m_mapClients[conn].m_sNick = nick;
 
     // Set the connection name, too, which is useful for debugging
-    m_pInterface->SetConnectionName(hConn, nick);
+    m_transport.set_name(conn, nick);
   }
 
-  void OnSteamNetConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t* pInfo)
+  void OnDisconnected(const fightingengine::TransportEvent& e)
   {
     char temp[1024];
 
-    // What's the state of the connection?
-    switch (pInfo->m_info.m_eState) {
-      case k_ESteamNetworkingConnectionState_None:
-        // NOTE: We will get callbacks here when we destroy connections.  You can ignore
-        // these.
-        break;
+    // Locate the client.  Note that it should have been found, because this
+    // is the only codepath where we remove clients (except on shutdown).
+    auto itClient = m_mapClients.find(e.conn);
+    assert(itClient != m_mapClients.end());
+
+    // Select appropriate log messages
+    const char* pszDebugLogAction;
+    if (e.problem) {
+      pszDebugLogAction = "problem detected locally";
+      sprintf_s(temp, "Alas, %s hath fallen into shadow.  (%s)", itClient->second.m_sNick.c_str(), e.reason.c_str());
+    } else {
+      pszDebugLogAction = "closed by peer";
+      sprintf_s(temp, "%s hath departed", itClient->second.m_sNick.c_str());
+    }
 
-      case k_ESteamNetworkingConnectionState_ClosedByPeer:
-      case k_ESteamNetworkingConnectionState_ProblemDetectedLocally: {
-        // Ignore if they were not previously connected.  (If they disconnected
-        // before we accepted the connection.)
-        if (pInfo->m_eOldState == k_ESteamNetworkingConnectionState_Connected) {
-
-          // Locate the client.  Note that it should have been found, because this
-          // is the only codepath where we remove clients (except on shutdown),
-          // and connection change callbacks are dispatched in queue order.
-          auto itClient = m_mapClients.find(pInfo->m_hConn);
-          assert(itClient != m_mapClients.end());
-
-          // Select appropriate log messages
-          const char* pszDebugLogAction;
-          if (pInfo->m_info.m_eState == k_ESteamNetworkingConnectionState_ProblemDetectedLocally) {
-            pszDebugLogAction = "problem detected locally";
-            sprintf_s(temp,
-                      "Alas, %s hath fallen into shadow.  (%s)",
-                      itClient->second.m_sNick.c_str(),
-                      pInfo->m_info.m_szEndDebug);
-          } else {
-            // Note that here we could check the reason code to see if
-            // it was a "usual" connection or an "unusual" one.
-            pszDebugLogAction = "closed by peer";
-            sprintf_s(temp, "%s hath departed", itClient->second.m_sNick.c_str());
-          }
-
-          // Spew something to our own log.  Note that because we put their nick
-          // as the connection description, it will show up, along with their
-          // transport-specific data (e.g. their IP address)
-          Printf("Connection %s %s, reason %d: %s\n",
-                 pInfo->m_info.m_szConnectionDescription,
-                 pszDebugLogAction,
-                 pInfo->m_info.m_eEndReason,
-                 pInfo->m_info.m_szEndDebug);
-
-          m_mapClients.erase(itClient);
-
-          // Send a message so everybody else knows what happened
-          SendStringToAllClients(temp);
-        } else {
-          assert(pInfo->m_eOldState == k_ESteamNetworkingConnectionState_Connecting);
-        }
-
-        // Clean up the connection.  This is important!
-        // The connection is "closed" in the network sense, but
-        // it has not been destroyed.  We must close it on our end, too
-        // to finish up.  The reason information do not matter in this case,
-        // and we cannot linger because it's already closed on the other end,
-        // so we just pass 0's.
-        m_pInterface->CloseConnection(pInfo->m_hConn, 0, nullptr, false);
-        break;
-      }
+    // Spew something to our own log.  Note that because we put their nick
+    // as the connection description, it will show up, along with their
+    // transport-specific data (e.g. their IP address)
+    if (m_bVerbose)
+      Printf("Connection %s %s: %s\n", e.description.c_str(), pszDebugLogAction, e.reason.c_str());
 
-      case k_ESteamNetworkingConnectionState_Connecting: {
-        // This must be a new connection
-        assert(m_mapClients.find(pInfo->m_hConn) == m_mapClients.end());
-
-        Printf("Connection request from %s", pInfo->m_info.m_szConnectionDescription);
-
-        // A client is attempting to connect
-        // Try to accept the connection.
-        if (m_pInterface->AcceptConnection(pInfo->m_hConn) != k_EResultOK) {
-          // This could fail.  If the remote host tried to connect, but then
-          // disconnected, the connection may already be half closed.  Just
-          // destroy whatever we have on our side.
-          m_pInterface->CloseConnection(pInfo->m_hConn, 0, nullptr, false);
-          Printf("Can't accept connection.  (It was already closed?)");
-          break;
-        }
-
-        // Assign the poll group
-        if (!m_pInterface->SetConnectionPollGroup(pInfo->m_hConn, m_hPollGroup)) {
-          m_pInterface->CloseConnection(pInfo->m_hConn, 0, nullptr, false);
-          Printf("Failed to set poll group?");
-          break;
-        }
-
-        // Generate a random nick.  A random temporary nick
-        // is really dumb and not how you would write a real chat server.
-        // You would want them to have some sort of signon message,
-        // and you would keep their client in a state of limbo (connected,
-        // but not logged on) until them.  I'm trying to keep this example
-        // code really simple.
-        char nick[64];
-        sprintf_s(nick, "BraveWarrior%d", 10000 + (rand() % 100000));
-
-        // Send them a welcome message
-        sprintf_s(temp,
-                  "Welcome, stranger.  Thou art known to us for now as '%s'; upon thine "
-                  "command '/nick' we shall know thee otherwise.",
-                  nick);
-        SendStringToClient(pInfo->m_hConn, temp);
-
-        // Also send them a list of everybody who is already connected
-        if (m_mapClients.empty()) {
-          SendStringToClient(pInfo->m_hConn, "Thou art utterly alone.");
-        } else {
-          sprintf_s(temp, "%d companions greet you:", (int)m_mapClients.size());
-          for (auto& c : m_mapClients)
-            SendStringToClient(pInfo->m_hConn, c.second.m_sNick.c_str());
-        }
-
-        // Let everybody else know who they are for now
-        sprintf_s(temp,
-                  "Hark!  A stranger hath joined this merry host.  For now we shall call "
-                  "them '%s'",
-                  nick);
-        SendStringToAllClients(temp, pInfo->m_hConn);
-
-        // Add them to the client list, using std::map wacky syntax
-        m_mapClients[pInfo->m_hConn];
-        SetClientNick(pInfo->m_hConn, nick);
-        break;
-      }
+    m_mapClients.erase(itClient);
 
-      case k_ESteamNetworkingConnectionState_Connected:
-        // We will get a callback immediately after accepting the connection.
-        // Since we are the server, we can ignore this, it's not news to us.
-        break;
+    // Send a message so everybody else knows what happened
+    SendStringToAllClients(temp);
+  }
 
-      default:
-        // Silences -Wswitch
-        break;
+  void OnConnected(const fightingengine::TransportEvent& e)
+  {
+    char temp[1024];
+
+    // This must be a new connection, the transport has already accepted it
+    assert(m_mapClients.find(e.conn) == m_mapClients.end());
+
+    if (m_bVerbose)
+      Printf("Connection request from %s", e.description.c_str());
+
+    // Generate a random nick.  A random temporary nick
+    // is really dumb and not how you would write a real chat server.
+    // You would want them to have some sort of signon message,
+    // and you would keep their client in a state of limbo (connected,
+    // but not logged on) until them.  I'm trying to keep this example
+    // code really simple.
+    char nick[64];
+    sprintf_s(nick, "BraveWarrior%d", 10000 + (rand() % 100000));
+
+    // Send them a welcome message
+    sprintf_s(temp,
+              "Welcome, stranger.  Thou art known to us for now as '%s'; upon thine "
+              "command '/nick' we shall know thee otherwise.",
+              nick);
+    SendStringToClient(e.conn, temp);
+
+    // Also send them a list of everybody who is already connected
+    if (m_mapClients.empty()) {
+      SendStringToClient(e.conn, "Thou art utterly alone.");
+    } else {
+      sprintf_s(temp, "%d companions greet you:", (int)m_mapClients.size());
+      for (auto& c : m_mapClients)
+        SendStringToClient(e.conn, c.second.m_sNick.c_str());
+    }
+
+    // Let everybody else know who they are for now
+    sprintf_s(temp,
+              "Hark!  A stranger hath joined this merry host.  For now we shall call "
+              "them '%s'",
+              nick);
+    SendStringToAllClients(temp, e.conn);
+
+    // Add them to the client list, using std::map wacky syntax
+    m_mapClients[e.conn];
+    SetClientNick(e.conn, nick);
+  }
+
+  void PollConnectionStateChanges()
+  {
+    m_events.clear();
+    m_transport.poll_events(m_events);
+    for (const fightingengine::TransportEvent& e : m_events) {
+      if (e.type == fightingengine::TransportEvent::Type::Connected)
+        OnConnected(e);
+      else
+        OnDisconnected(e);
     }
   }
+};
 
-  static ChatServer* s_pCallbackInstance;
-  static void SteamNetConnectionStatusChangedCallback(SteamNetConnectionStatusChangedCallback_t* pInfo)
+// A simulated chat client for --loadtest. Sends "ping <time>" a few times a second,
+// and times everybody else's pings as the server relays them ("nick: ping <time>").
+class ChatBot : public fightingengine::LoadTestBot
+{
+public:
+  explicit ChatBot(float pingsPerSecond)
+    : m_flSecondsBetweenPings(1.0f / pingsPerSecond)
+  {}
+
+  void on_connected(fightingengine::LoadTestContext& ctx) override
   {
-    s_pCallbackInstance->OnSteamNetConnectionStatusChanged(pInfo);
+    // Spread the pings out, rather than every bot sending on the same tick
+    m_flSecondsUntilPing = std::uniform_real_distribution<float>(0.0f, m_flSecondsBetweenPings)(ctx.get_rng());
   }
 
-  void PollConnectionStateChanges()
+  void update(fightingengine::LoadTestContext& ctx) override
   {
-    s_pCallbackInstance = this;
-    m_pInterface->RunCallbacks();
+    m_flSecondsUntilPing -= ctx.get_delta_time_s();
+    if (m_flSecondsUntilPing > 0.0f)
+      return;
+    m_flSecondsUntilPing += m_flSecondsBetweenPings;
+
+    char temp[64];
+    int len = snprintf(temp, sizeof(temp), "ping %llu", (unsigned long long)ctx.get_time_ns());
+    ctx.send(temp, (uint32)len, true);
   }
+
+  void on_message(fightingengine::LoadTestContext& ctx, std::string_view payload) override
+  {
+    const size_t at = payload.find(": ping ");
+    if (at == std::string_view::npos)
+      return;
+    const std::string sSent(payload.substr(at + 7));
+    ctx.record_latency(strtoull(sSent.c_str(), nullptr, 10));
+  }
+
+private:
+  float m_flSecondsBetweenPings;
+  float m_flSecondsUntilPing = 0.0f;
 };
 
 void
@@ -339,26 +354,34 @@ PrintUsageAndExit(int rc = 1)
   fflush(stderr);
   printf(
     R"usage(Usage:
-    example_chat server [--port PORT]
+    example_chat server [--port PORT] [--tick-rate HZ] [--net-thread]
+    example_chat server --loadtest CLIENTS [--loadtest-rate PINGS_PER_S] [--duration S] [--fast]
+                        [--latency MS] [--jitter MS] [--loss P] [--tick-rate HZ]
+
+    --loadtest runs the server in process against simulated clients, with no sockets,
+    and prints a json report. --fast doesn't wait for real time between ticks.
+    --net-thread moves the sockets to a thread of their own, the ticks only see queues.
 )usage");
   fflush(stdout);
   exit(rc);
 }
 
-ChatServer* ChatServer::s_pCallbackInstance = nullptr;
-
 int
 main(int argc, const char* argv[])
 {
   const uint16 DEFAULT_SERVER_PORT = 27020;
   int nPort = DEFAULT_SERVER_PORT;
+  float tickRateHz = 60.0f;
   SteamNetworkingIPAddr addrServer;
   addrServer.Clear();
 
   bool bServer = false;
   bool bClient = false;
+  bool bNetThread = false;
 
-  printf("starting server on port: %i \n", DEFAULT_SERVER_PORT);
+  int nLoadTestClients = 0;
+  float flLoadTestPingsPerSecond = 1.0f;
+  fightingengine::LoadTestConfig loadTest;
 
   for (int i = 1; i < argc; ++i) {
     printf("arg: %s \n", argv[i]);
@@ -382,6 +405,72 @@ main(int argc, const char* argv[])
         FatalError("Invalid port %d", nPort);
       continue;
     }
+    if (!strcmp(argv[i], "--tick-rate")) {
+      ++i;
+      if (i >= argc)
+        PrintUsageAndExit();
+      tickRateHz = (float)atof(argv[i]);
+      if (tickRateHz < 1.0f || tickRateHz > 1000.0f)
+        FatalError("Invalid tick rate %s", argv[i]);
+      continue;
+    }
+
+    if (!strcmp(argv[i], "--loadtest")) {
+      ++i;
+      if (i >= argc)
+        PrintUsageAndExit();
+      nLoadTestClients = atoi(argv[i]);
+      if (nLoadTestClients <= 0)
+        FatalError("Invalid client count %s", argv[i]);
+      continue;
+    }
+    if (!strcmp(argv[i], "--loadtest-rate")) {
+      ++i;
+      if (i >= argc)
+        PrintUsageAndExit();
+      flLoadTestPingsPerSecond = (float)atof(argv[i]);
+      if (flLoadTestPingsPerSecond <= 0.0f)
+        FatalError("Invalid ping rate %s", argv[i]);
+      continue;
+    }
+    if (!strcmp(argv[i], "--duration")) {
+      ++i;
+      if (i >= argc)
+        PrintUsageAndExit();
+      loadTest.duration_s = (float)atof(argv[i]);
+      continue;
+    }
+    if (!strcmp(argv[i], "--latency")) {
+      ++i;
+      if (i >= argc)
+        PrintUsageAndExit();
+      loadTest.link.latency_ms = (float)atof(argv[i]);
+      continue;
+    }
+    if (!strcmp(argv[i], "--jitter")) {
+      ++i;
+      if (i >= argc)
+        PrintUsageAndExit();
+      loadTest.link.jitter_ms = (float)atof(argv[i]);
+      continue;
+    }
+    if (!strcmp(argv[i], "--loss")) {
+      ++i;
+      if (i >= argc)
+        PrintUsageAndExit();
+      loadTest.link.loss = (float)atof(argv[i]);
+      if (loadTest.link.loss < 0.0f || loadTest.link.loss > 1.0f)
+        FatalError("Invalid loss %s", argv[i]);
+      continue;
+    }
+    if (!strcmp(argv[i], "--fast")) {
+      loadTest.realtime = false;
+      continue;
+    }
+    if (!strcmp(argv[i], "--net-thread")) {
+      bNetThread = true;
+      continue;
+    }
 
     // Anything else, must be server address to connect to
     if (bClient && addrServer.IsIPv6AllZeros()) {
@@ -398,13 +487,38 @@ main(int argc, const char* argv[])
   if (bClient == bServer || (bClient && addrServer.IsIPv6AllZeros()))
     PrintUsageAndExit();
 
+  if (nLoadTestClients > 0) {
+    loadTest.clients = nLoadTestClients;
+    loadTest.tick_rate_hz = tickRateHz;
+    fightingengine::LoadTest test(loadTest);
+    ChatServer server(test.get_server_transport(), false);
+    fightingengine::LoadTestReport report = test.run(
+      [&] { server.Tick(); },
+      [&](int) { return std::make_unique<ChatBot>(flLoadTestPingsPerSecond); });
+    report.write_json(std::cout);
+    return 0;
+  }
+
   // Create client and server sockets
   InitSteamDatagramConnectionSockets();
   LocalUserInput_Init();
 
   {
-    ChatServer server;
-    server.Run((uint16)nPort);
+    SteamServerTransport transport;
+    if (!transport.listen((uint16)nPort))
+      FatalError("Failed to listen on port %d", nPort);
+    Printf("Server listening on port %d\n", nPort);
+
+    if (bNetThread) {
+      fightingengine::NetworkThread net(transport);
+      ChatServer server(net.get_sim_transport(0));
+      net.start();
+      server.Run(tickRateHz);
+      net.stop(); // sends the goodbyes
+    } else {
+      ChatServer server(transport);
+      server.Run(tickRateHz);
+    }
   }
 
   ShutdownSteamDatagramConnectionSockets();